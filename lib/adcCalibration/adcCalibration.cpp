@@ -0,0 +1,77 @@
+/**
+ * @file adcCalibration.cpp
+ * @brief ADC电压校准模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现转换表的生成：
+ * - 每个段端点对应的12位读数为 i × 16，直接调用芯片特性曲线；最后一个端点（4096）超出读数范围，
+ *   按最后一段的斜率外推
+ * - 引脚电压（微伏）乘以分压比并四舍五入到毫伏，得到未校正的端子电压，再按两点校正直线修正，结果限幅到 0~65535 毫伏
+ *
+ * @note
+ * 注意事项：
+ * - 生成转换表只在启动或校正参数变化时进行，可以使用64位整数运算
+ */
+
+#include "adcCalibration.h"
+
+/**
+ * 没有芯片特性参数时使用的理想曲线（满量程3300毫伏，与原来的 (adc * 6600) >> 12 等效，输出微伏）
+ */
+uint32_t adcCalLinearCurve(uint32_t raw, void *context) {
+    (void) context;
+    return (uint32_t) (((uint64_t) raw * 3300000U) >> 12);
+}
+
+/**
+ * 两点校正是否可用（版本正确且两点的未校正读数不同）
+ */
+bool adcCalPointsValid(const adc_cal_points_t *points) {
+    return points != nullptr && points->version == ADC_CAL_VERSION && points->measured[0] != points->measured[1];
+}
+
+/**
+ * 按两点校正直线修正一个未校正电压
+ */
+static int64_t correct(int64_t mv, const adc_cal_points_t *points) {
+    int64_t m0 = points->measured[0], m1 = points->measured[1];
+    int64_t a0 = points->actual[0], a1 = points->actual[1];
+    int64_t numerator = (mv - m0) * (a1 - a0);
+    int64_t denominator = m1 - m0;
+    /* 四舍五入的有符号除法 */
+    int64_t offset = (numerator >= 0) == (denominator > 0) ? (numerator + denominator / 2) / denominator
+                                                          : (numerator - denominator / 2) / denominator;
+    return a0 + offset;
+}
+
+/**
+ * 生成转换表
+ * 参数：curve、context - 芯片特性曲线（12位读数 -> 引脚微伏）；dividerNum/dividerDen - 分压比的倒数（端子电压/引脚电压）；
+ *       points - 两点校正，nullptr 或无效时不校正
+ */
+void adcCalBuild(adc_cal_table_t *table, adc_cal_curve_t curve, void *context,
+                 uint32_t dividerNum, uint32_t dividerDen, const adc_cal_points_t *points) {
+    bool corrected = adcCalPointsValid(points);
+    int64_t previous = 0, beforePrevious = 0;
+    for (uint32_t i = 0; i <= ADC_CAL_SEGMENTS; i++) {
+        uint32_t raw = i << (ADC_CAL_SEGMENT_SHIFT - 4);    // 16位输入 i × 256 对应的12位读数
+        int64_t pin;
+        if (raw <= ADC_CAL_RAW_MAX) {
+            pin = curve(raw, context);
+        }
+        else {
+            pin = 2 * previous - beforePrevious;            // 超出读数范围，按最后一段外推
+        }
+        beforePrevious = previous;
+        previous = pin;
+        int64_t mv = (pin * dividerNum + dividerDen * 500) / ((int64_t) dividerDen * 1000);
+        if (corrected) {
+            mv = correct(mv, points);
+        }
+        table->mv[i] = (uint16_t) (mv < 0 ? 0 : (mv > 65535 ? 65535 : mv));
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file adcCalibration.h
+ * @brief ADC电压校准模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为ADC电压校准模块头文件，包含如下内容：
+ * - 两点校正结构体（每台设备在NVS中保存）
+ * - 预计算的整数转换表结构体
+ * - 转换表生成与查表转换的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 转换表把芯片特性曲线（由eFuse特性参数给出，引脚微伏）、分压比和两点校正合并为一张表，
+ *   运行时每次转换只是一次查表加一次整数插值，不做浮点运算
+ * - 输入为16位过采样值（12位读数 × 16 满量程），按高8位分为256段，每段端点存放端子电压（毫伏），
+ *   低8位在段内线性插值（四舍五入），不损失过采样带来的分辨率
+ * - 特性曲线输出微伏：理想曲线可以保留小数部分，乘以分压比后端点误差不超过0.5毫伏，
+ *   结果与原来的 (adc * 6600) >> 12 相同或高1毫伏（原公式截断，转换表四舍五入）
+ * - 两点校正：measured 为未校正时的读数（毫伏），actual 为同一时刻用万用表测得的实际电压，
+ *   两点之间及以外按直线修正，同时修正分压电阻误差与芯片曲线的残余误差
+ * - 芯片特性曲线以函数指针传入，主机上可以用参考曲线生成转换表并核对精度
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_ADCCALIBRATION_H
+#define LIGHTPROJECT_ADCCALIBRATION_H
+
+#include <cstdint>
+
+#define ADC_CAL_SEGMENTS 256            // 转换表段数（按16位输入的高8位分段）
+#define ADC_CAL_SEGMENT_SHIFT 8         // 段内位数
+#define ADC_CAL_RAW_MAX 4095            // 12位读数最大值
+#define ADC_CAL_VERSION 1               // 两点校正结构体版本（NVS中保存的数据版本不符时丢弃）
+
+/* 两点校正（每个通道一份） */
+typedef struct {
+    uint8_t version;                    // 结构体版本
+    uint16_t measured[2];               // 未校正读数（毫伏）
+    uint16_t actual[2];                 // 实际电压（毫伏）
+} adc_cal_points_t;
+
+/* 转换表：第 i 项为16位输入 i × 256 对应的端子电压（毫伏） */
+typedef struct {
+    uint16_t mv[ADC_CAL_SEGMENTS + 1];
+} adc_cal_table_t;
+
+/* 芯片特性曲线：12位读数 -> 引脚电压（微伏） */
+typedef uint32_t (*adc_cal_curve_t)(uint32_t raw, void *context);
+
+uint32_t adcCalLinearCurve(uint32_t raw, void *context);
+bool adcCalPointsValid(const adc_cal_points_t *points);
+void adcCalBuild(adc_cal_table_t *table, adc_cal_curve_t curve, void *context,
+                 uint32_t dividerNum, uint32_t dividerDen, const adc_cal_points_t *points);
+
+/**
+ * 查表转换：16位过采样值 -> 端子电压（毫伏）
+ */
+static inline uint16_t adcCalConvert(const adc_cal_table_t *table, uint16_t value) {
+    uint32_t index = value >> ADC_CAL_SEGMENT_SHIFT;
+    int32_t low = table->mv[index];
+    int32_t high = table->mv[index + 1];
+    int32_t fraction = value & ((1 << ADC_CAL_SEGMENT_SHIFT) - 1);
+    return (uint16_t) (low + (((high - low) * fraction + (1 << (ADC_CAL_SEGMENT_SHIFT - 1))) >> ADC_CAL_SEGMENT_SHIFT));
+}
+
+#endif //LIGHTPROJECT_ADCCALIBRATION_H
@@ -2,24 +2,31 @@
  * @file adcReading.cpp
  * @brief ADC读取电压值模块实现
  * @author cepvor
- * @version 1.0
+ * @version 1.1
  * @date 2025-09-25
  * @license MIT License
  *
  * @attention
  * 此文件主要用于ADC读取电压值，包括电池电压和太阳能电压
- * 通过位运算和整数化简化计算，提升运行效率
+ * - ADC1 以连续转换模式在后台轮流转换两个通道，结果经DMA写入驱动缓冲区
+ * - 采样任务阻塞读取DMA结果，每个通道累加 ADC_OVERSAMPLE 个样本后抽取为一个16位值（64个12位样本之和右移2位）
+ * - 电压换算查预计算的转换表（adcCalibration）：芯片eFuse特性曲线、分压比与NVS中的两点校正合并在表中
  *
  * @note
  * 注意事项：
- *  - 3300 是 ESP32 参考电压的毫伏值
- *  - L 后缀确保计算在 long（32位）整数中进行，防止 adcValue * 6600 溢出
- *  - 使用 >> 12 代替 / 4095 会引入约 0.024% 的系统误差，对于电池4.2V满充电压来说约为1mV
- *  - 对于太阳能6V满充电压来说约为1.47mV，这个误差在本应用中是可以接受的
+ *  - 芯片未烧录eFuse特性参数时使用理想线性曲线（满量程3300mV，与原来的 (adc * 6600L) >> 12 等效）
+ *  - 两点校正在现场取点：把实际电压告诉设备，设备记录当时的未校正读数，两点都取到后重新生成转换表并保存到NVS
+ *  - 转换表双缓冲：MQTT任务生成新表后切换指针，采样任务每次转换只读取一次指针，不需要加锁
+ *  - 64倍平均把随机噪声降为单次读数的1/8，电压读数不再随单个样本跳动
+ *  - 电量由 batterySoc 估计（OCV曲线 + LED负载补偿 + 卡尔曼滤波），开灯时的电压跌落不会让电量跳变
+ *  - 太阳能收益由 solarHarvest 按估计电量的增量与负载积分，统计状态由 solarMux 保护（采样任务写入，MQTT任务查询）
  */
 
 #include "adcReading.h"
 #include "taskCreate.h"
+#include "clockSync.h"
+#include <Preferences.h>
+#include <esp_adc_cal.h>
 
 int battery_mV = 0;   // 电池电压，单位：毫伏
 int solar_mV = 0;     // 太阳能电压，单位：毫伏
@@ -33,95 +40,372 @@ int adcSunPin = ADC_SOLAR_PIN;              // 自制核心板
 int adcBatteryPin = ADC_BATTERY_PIN;        // 自制核心板
 #endif
 
-void adcReadingInit() {
-    analogReadResolution(12);
+/* 单个通道：过采样累加器与校准转换表 */
+typedef struct {
+    int8_t channel;                         // ADC1通道号，-1 表示该引脚不在ADC1上
+    uint32_t sum;                           // 样本累加和
+    uint16_t count;                         // 已累加的样本数
+    volatile uint16_t lastValue;            // 最近一个16位过采样值（校准取点用）
+    uint32_t dividerNum;                    // 端子电压/引脚电压（分子）
+    uint32_t dividerDen;                    // 端子电压/引脚电压（分母）
+    const char *key;                        // NVS中两点校正的键名
+    adc_cal_points_t points;                // 两点校正（version 为0表示未校正）
+    uint8_t captured;                       // 本次取点进度（位0、位1对应两个点）
+    adc_cal_table_t base;                   // 未校正的转换表（取点时使用）
+    adc_cal_table_t tables[2];              // 校正后的转换表（双缓冲）
+    const adc_cal_table_t *volatile active; // 采样任务使用的转换表
+} adc_channel_t;
+
+static adc_channel_t adcChannels[ADC_CHANNELS];
+static bool adcRunning = false;     // 连续转换是否已启动
+static esp_adc_cal_characteristics_t adcChars;  // 芯片特性参数（来自eFuse）
+static adc_cal_curve_t adcCurve = adcCalLinearCurve;    // 12位读数 -> 引脚微伏
+static const char *adcCalSourceName = "default";       // 特性参数来源（用于上报）
+static battery_soc_t batterySoc;    // 电量估计器（只由采样任务更新）
+static solar_harvest_t solarHarvest;        // 太阳能收益统计（采样任务更新，由 solarMux 保护）
+static solar_expectation_t solarExpectation;    // 发电量期望（MQTT任务设置，由 solarMux 保护）
+static portMUX_TYPE solarMux = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * 引脚对应的ADC1通道号（S3上GPIO1~10为ADC1通道0~9），不在ADC1上时返回 -1
+ */
+static int8_t adc1Channel(int pin) {
+    int8_t channel = digitalPinToAnalogChannel(pin);
+    return (channel >= 0 && channel < SOC_ADC_CHANNEL_NUM(0)) ? channel : -1;
+}
+
+/**
+ * 累加一个样本，满 ADC_OVERSAMPLE 个时输出16位过采样值
+ * 返回值：是否输出了新值
+ */
+static bool accumulate(adc_channel_t *acc, uint16_t raw, uint16_t *value) {
+    acc->sum += raw;
+    if (++acc->count < ADC_OVERSAMPLE) {
+        return false;
+    }
+    *value = (uint16_t) (acc->sum >> 2);    // 64 × 4095 >> 2 = 65520，16位满量程
+    acc->sum = 0;
+    acc->count = 0;
+    return true;
 }
 
-void getVoltage() {
-    // --- 电池电压 (分压比 1/2) ---
-    int batteryAdc = analogRead(adcBatteryPin);
-    battery_mV = (batteryAdc * 6600L) >> 12; // ≈ (adc * 6600) / 4096
+/**
+ * eFuse特性曲线（esp_adc_cal，输出毫伏，换算为微伏）
+ */
+static uint32_t efuseCurve(uint32_t raw, void *context) {
+    return esp_adc_cal_raw_to_voltage(raw, (const esp_adc_cal_characteristics_t *) context) * 1000U;
+}
+
+/**
+ * 按当前两点校正生成新的转换表并切换（写入未使用的缓冲区）
+ */
+static void rebuildTable(adc_channel_t *ch) {
+    adc_cal_table_t *next = (ch->active == &ch->tables[0]) ? &ch->tables[1] : &ch->tables[0];
+    void *context = (adcCurve == efuseCurve) ? (void *) &adcChars : nullptr;
+    adcCalBuild(next, adcCurve, context, ch->dividerNum, ch->dividerDen, &ch->points);
+    ch->active = next;
+}
+
+/**
+ * 初始化单个通道：读取NVS中的两点校正，生成转换表
+ */
+static void channelInit(adc_channel_t *ch, int pin, uint32_t dividerNum, uint32_t dividerDen, const char *key) {
+    ch->channel = adc1Channel(pin);
+    ch->dividerNum = dividerNum;
+    ch->dividerDen = dividerDen;
+    ch->key = key;
+    Preferences prefs;
+    if (prefs.begin(ADC_CAL_PREFS_NAMESPACE, true)) {
+        if (prefs.getBytesLength(key) == sizeof(ch->points)) {
+            prefs.getBytes(key, &ch->points, sizeof(ch->points));
+        }
+        prefs.end();
+    }
+    if (!adcCalPointsValid(&ch->points)) {
+        memset(&ch->points, 0, sizeof(ch->points));
+    }
+    void *context = (adcCurve == efuseCurve) ? (void *) &adcChars : nullptr;
+    adcCalBuild(&ch->base, adcCurve, context, dividerNum, dividerDen, nullptr);
+    ch->active = nullptr;
+    rebuildTable(ch);
+}
 
+/**
+ * 读取NVS中的每日记录与发电量期望（记录长度或位置不符时丢弃）
+ */
+static void solarInit() {
+    solarHarvestInit(&solarHarvest);
+    memset(&solarExpectation, 0, sizeof(solarExpectation));
+    Preferences prefs;
+    if (!prefs.begin(SOLAR_PREFS_NAMESPACE, true)) {
+        return;
+    }
+    uint8_t head = prefs.getUChar("head", 0);
+    uint8_t count = prefs.getUChar("count", 0);
+    if (head < SOLAR_HISTORY_DAYS && count <= SOLAR_HISTORY_DAYS
+        && prefs.getBytesLength("days") == sizeof(solarHarvest.history)) {
+        prefs.getBytes("days", solarHarvest.history, sizeof(solarHarvest.history));
+        solarHarvest.head = head;
+        solarHarvest.count = count;
+    }
+    if (prefs.getBytesLength("expect") == sizeof(solarExpectation)) {
+        prefs.getBytes("expect", &solarExpectation, sizeof(solarExpectation));
+    }
+    if (!solarExpectationValid(&solarExpectation)) {
+        memset(&solarExpectation, 0, sizeof(solarExpectation));
+    }
+    prefs.end();
+}
 
-    // --- 太阳能电压 (分压比 33/133) ---
-    int sunAdc = analogRead(adcSunPin);
+/**
+ * 初始化ADC1连续转换（两个通道、11dB衰减、DMA），生成校准转换表并启动转换
+ */
+void adcReadingInit() {
+    /* 芯片特性参数：S3出厂烧录两点拟合参数（TP_FIT），没有时使用理想曲线 */
+    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_TP_FIT) == ESP_OK) {
+        esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_CAL_DEFAULT_VREF, &adcChars);
+        adcCurve = efuseCurve;
+        adcCalSourceName = "efuse";
+    }
+    channelInit(&adcChannels[ADC_CH_BATTERY], adcBatteryPin, 2, 1, "bat");      // 分压比 1/2
 #ifdef isJLC
-    solar_mV = (sunAdc * 6600L) >> 12; // ≈ (adc * 6600) / 4096
+    channelInit(&adcChannels[ADC_CH_SOLAR], adcSunPin, 2, 1, "sun");            // 分压比 1/2
 #else
-    solar_mV = (sunAdc * 13300L) >> 12; // ≈ (adc * 13300) / 4096
+    channelInit(&adcChannels[ADC_CH_SOLAR], adcSunPin, 133, 33, "sun");         // 分压比 33/133
 #endif
+    socInit(&batterySoc);
+    solarInit();
+    adc_channel_t *battery = &adcChannels[ADC_CH_BATTERY];
+    adc_channel_t *solar = &adcChannels[ADC_CH_SOLAR];
+    if (battery->channel < 0 || solar->channel < 0) {
+        Serial.println("ADC引脚不在ADC1上，无法使用连续转换");
+        return;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = ADC_POOL_BYTES;
+    init.conv_num_each_intr = ADC_FRAME_BYTES;
+    init.adc1_chan_mask = BIT(battery->channel) | BIT(solar->channel);
+    init.adc2_chan_mask = 0;
+
+    adc_digi_pattern_config_t pattern[ADC_CHANNELS] = {};
+    for (uint8_t i = 0; i < ADC_CHANNELS; i++) {
+        pattern[i].atten = ADC_ATTEN_DB_11;         // 与 analogRead 默认衰减一致（满量程约3.1V）
+        pattern[i].channel = adcChannels[i].channel;
+        pattern[i].unit = 0;                        // ADC1
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
 
-    // --- 计算电池剩余电量百分比 ---
-    battery_percentage = calculateBatteryPercentage(battery_mV);
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.pattern_num = ADC_CHANNELS;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = ADC_SAMPLE_FREQ_HZ;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    if (adc_digi_initialize(&init) != ESP_OK
+        || adc_digi_controller_configure(&config) != ESP_OK
+        || adc_digi_start() != ESP_OK) {
+        Serial.println("ADC连续转换启动失败");
+        return;
+    }
+    adcRunning = true;
 }
 
 /**
- * 根据电池电压计算剩余电量百分比
- * 功能说明：基于锂电池的放电特性曲线，将电池电压转换为剩余电量百分比
- * 参数：voltage_mV - 电池电压值（毫伏）
- * 返回值：电池剩余电量百分比（0-100）
- *
- * 锂电池电压与电量对应关系：
- * - 4200mV (4.2V) = 100% 满电
- * - 4000mV (4.0V) = 85%  高电量
- * - 3800mV (3.8V) = 60%  中等电量
- * - 3700mV (3.7V) = 40%  较低电量
- * - 3600mV (3.6V) = 20%  低电量
- * - 3300mV (3.3V) = 5%   极低电量
- * - 3000mV (3.0V) = 0%   电池耗尽（保护电压）
+ * 两点校正取点（在MQTT任务中调用）
+ * 参数：channel - ADC_CH_BATTERY / ADC_CH_SOLAR；index - 0 或 1；actualMv - 此刻用万用表测得的端子电压
+ * 返回值：两点都已取到并保存时返回 true
+ * 说明：记录此刻的未校正读数；两点都取到后重新生成转换表并保存到NVS。
+ *      还没有采样值、实际电压为0、超出通道量程或与未校正读数相差超过 ADC_CAL_MAX_DEVIATION_PERCENT 时拒绝取点
  */
-int calculateBatteryPercentage(int voltage_mV) {
-    // 电池电压范围限制：3000mV(0%) 到 4200mV(100%)
-    const int BATTERY_MIN_VOLTAGE = 3000;  // 电池保护电压，3.0V
-    const int BATTERY_MAX_VOLTAGE = 4200;  // 电池满电电压，4.2V
+bool adcCalibrationCapture(uint8_t channel, uint8_t index, uint16_t actualMv) {
+    if (channel >= ADC_CHANNELS || index > 1 || !adcRunning) {
+        return false;
+    }
+    adc_channel_t *ch = &adcChannels[channel];
+    uint16_t value = ch->lastValue;
+    if (value == 0) {
+        Serial.println("ADC校正取点被拒绝：还没有采样值");
+        return false;
+    }
+    uint32_t measured = adcCalConvert(&ch->base, value);
+    uint32_t fullScale = ch->base.mv[ADC_CAL_SEGMENTS];     // 通道量程（端子电压）
+    uint32_t deviation = measured * ADC_CAL_MAX_DEVIATION_PERCENT / 100;
+    if (actualMv == 0 || actualMv > fullScale
+        || actualMv + deviation < measured || actualMv > measured + deviation) {
+        Serial.printf("ADC校正取点被拒绝：实际电压%umV，未校正读数%umV，量程%umV\n",
+                      (unsigned) actualMv, (unsigned) measured, (unsigned) fullScale);
+        return false;
+    }
+    ch->points.measured[index] = (uint16_t) measured;
+    ch->points.actual[index] = actualMv;
+    ch->captured |= (uint8_t) (1 << index);
+    if (ch->captured != 0x03) {
+        return false;
+    }
+    ch->captured = 0;
+    ch->points.version = ADC_CAL_VERSION;
+    if (!adcCalPointsValid(&ch->points)) {          // 两点读数相同，无法确定直线
+        memset(&ch->points, 0, sizeof(ch->points));
+        return false;
+    }
+    rebuildTable(ch);
+    Preferences prefs;
+    if (prefs.begin(ADC_CAL_PREFS_NAMESPACE, false)) {
+        prefs.putBytes(ch->key, &ch->points, sizeof(ch->points));
+        prefs.end();
+    }
+    return true;
+}
 
-    // 电压范围检查和限制
-    if (voltage_mV <= BATTERY_MIN_VOLTAGE) {
-        return 0;   // 电池耗尽或异常
+/**
+ * 清除两点校正（恢复芯片特性曲线与标称分压比），并从NVS中删除
+ */
+void adcCalibrationClear(uint8_t channel) {
+    if (channel >= ADC_CHANNELS) {
+        return;
     }
-    if (voltage_mV >= BATTERY_MAX_VOLTAGE) {
-        return 100; // 电池满电
+    adc_channel_t *ch = &adcChannels[channel];
+    memset(&ch->points, 0, sizeof(ch->points));
+    ch->captured = 0;
+    rebuildTable(ch);
+    Preferences prefs;
+    if (prefs.begin(ADC_CAL_PREFS_NAMESPACE, false)) {
+        prefs.remove(ch->key);
+        prefs.end();
     }
+}
 
-    /* 使用分段线性插值算法，模拟锂电池真实的放电曲线 */
-    /* 锂电池的放电曲线并非线性，在不同电压区间有不同的斜率 */
+/**
+ * 校准状态（用于上报）：特性参数来源，以及各通道是否有两点校正
+ */
+const char *adcCalibrationSource() {
+    return adcCalSourceName;
+}
 
-    int percentage = 0;
+bool adcCalibrationIsCorrected(uint8_t channel) {
+    return channel < ADC_CHANNELS && adcCalPointsValid(&adcChannels[channel].points);
+}
 
-    if (voltage_mV >= 4000) {
-        // 高电压区间：4000mV-4200mV，对应85%-100%
-        // 这个区间电压变化快，电量变化相对慢
-        percentage = 85 + ((voltage_mV - 4000) * 15) / 200;
-    }
-    else if (voltage_mV >= 3800) {
-        // 中高电压区间：3800mV-4000mV，对应60%-85%
-        // 这是电池使用的主要区间，线性关系较好
-        percentage = 60 + ((voltage_mV - 3800) * 25) / 200;
-    }
-    else if (voltage_mV >= 3700) {
-        // 中电压区间：3700mV-3800mV，对应40%-60%
-        // 电量下降开始加快
-        percentage = 40 + ((voltage_mV - 3700) * 20) / 100;
+/**
+ * 太阳能收益摘要（在MQTT任务中调用）
+ */
+void solarHarvestGetReport(solar_report_t *report) {
+    portENTER_CRITICAL(&solarMux);
+    solarHarvestReport(&solarHarvest, &solarExpectation, report);
+    portEXIT_CRITICAL(&solarMux);
+}
+
+/**
+ * 设置发电量期望并保存到NVS（在MQTT任务中调用），参数无效时清除
+ */
+void solarExpectationSet(const solar_expectation_t *expectation) {
+    solar_expectation_t value = {};
+    if (solarExpectationValid(expectation)) {
+        value = *expectation;
     }
-    else if (voltage_mV >= 3600) {
-        // 低电压区间：3600mV-3700mV，对应20%-40%
-        // 电量下降明显加快
-        percentage = 20 + ((voltage_mV - 3600) * 20) / 100;
+    portENTER_CRITICAL(&solarMux);
+    solarExpectation = value;
+    portEXIT_CRITICAL(&solarMux);
+    Preferences prefs;
+    if (prefs.begin(SOLAR_PREFS_NAMESPACE, false)) {
+        if (value.version != 0) {
+            prefs.putBytes("expect", &value, sizeof(value));
+        }
+        else {
+            prefs.remove("expect");
+        }
+        prefs.end();
     }
-    else if (voltage_mV >= 3300) {
-        // 极低电压区间：3300mV-3600mV，对应5%-20%
-        // 电池电量急剧下降，需要及时充电
-        percentage = 5 + ((voltage_mV - 3300) * 15) / 300;
+}
+
+/**
+ * 把每日记录保存到NVS（每天一次，在采样任务中调用）
+ */
+static void solarSave() {
+    static solar_day_t days[SOLAR_HISTORY_DAYS];    // 复制后在临界区外写入，不占用采样任务栈
+    portENTER_CRITICAL(&solarMux);
+    memcpy(days, solarHarvest.history, sizeof(days));
+    uint8_t head = solarHarvest.head;
+    uint8_t count = solarHarvest.count;
+    portEXIT_CRITICAL(&solarMux);
+    Preferences prefs;
+    if (prefs.begin(SOLAR_PREFS_NAMESPACE, false)) {
+        prefs.putBytes("days", days, sizeof(days));
+        prefs.putUChar("head", head);
+        prefs.putUChar("count", count);
+        prefs.end();
     }
-    else {
-        // 危险低电压区间：3000mV-3300mV，对应0%-5%
-        // 电池即将耗尽，系统应该进入低功耗模式
-        percentage = ((voltage_mV - 3000) * 5) / 300;
+}
+
+/**
+ * 更新电量估计与太阳能收益（每个电池电压值一次，约8次/秒）
+ * 负载电流由灯控任务计量的LED功率折算，充电状态由太阳能电压判断；未接电池时不更新
+ * 收益按本地时间分小时、分日统计（时区取自时间表配置），未对时只累计当天总量
+ */
+static void updateBatterySoc() {
+    if (battery_mV < POWER_BATTERY_PRESENT_MV) {
+        socInit(&batterySoc);               // 接上电池后重新从OCV开始估计
+        battery_percentage = 0;
+        return;
     }
+    uint32_t now = millis();
+    float loadMa = socBatteryCurrentMa((float) battery_mV, (float) ledPower.powerMw);
+    bool charging = solar_mV >= SOC_CHARGE_SOLAR_MV;
+    float soc = socUpdate(&batterySoc, (float) battery_mV, loadMa, charging, now);
+    battery_percentage = (int) (soc + 0.5f);
 
-    // 确保返回值在合理范围内
-    if (percentage < 0) percentage = 0;
-    if (percentage > 100) percentage = 100;
+    uint32_t epoch = clockNow();
+    uint32_t local = epoch == 0 ? 0 : epoch + (int32_t) scheduleConfig.utcOffsetMin * 60;
+    portENTER_CRITICAL(&solarMux);
+    bool dayClosed = solarHarvestUpdate(&solarHarvest, now, local, soc, (float) battery_mV, loadMa, charging, solarForecast);
+    portEXIT_CRITICAL(&solarMux);
+    if (dayClosed) {
+        solarSave();
+    }
+}
 
-    return percentage;
+/*
+ * ———————— ADC采样任务 ————————
+ * 阻塞等待DMA交出一批转换结果，按通道过采样抽取后更新电压与电量
+ * 转换由硬件在后台完成，传感器任务不再等待ADC
+ */
+void adcSampleTask(void *pvParameters) {
+    (void) pvParameters;
+    static uint8_t frame[ADC_FRAME_BYTES];
+    while (true) {
+        if (!adcRunning) {
+            vTaskDelay(DELAY_10S);                  // 连续转换未启动，保持原有电压值
+            continue;
+        }
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(frame, sizeof(frame), &length, ADC_READ_TIMEOUT_MS);
+        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {   // INVALID_STATE：缓冲区曾满而丢弃了旧结果，本次数据仍然有效
+            continue;
+        }
+        for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            const adc_digi_output_data_t *result = (const adc_digi_output_data_t *) &frame[i];
+            if (result->type2.unit != 0) {
+                continue;
+            }
+            for (uint8_t c = 0; c < ADC_CHANNELS; c++) {
+                adc_channel_t *ch = &adcChannels[c];
+                uint16_t value;
+                if (result->type2.channel != (uint32_t) ch->channel || !accumulate(ch, result->type2.data, &value)) {
+                    continue;
+                }
+                ch->lastValue = value;
+                int mv = adcCalConvert(ch->active, value);     // 查表：芯片曲线、分压比与两点校正
+                if (c == ADC_CH_BATTERY) {
+                    battery_mV = mv;
+                    updateBatterySoc();
+                }
+                else {
+                    solar_mV = mv;
+                }
+            }
+        }
+    }
 }
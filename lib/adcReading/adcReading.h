@@ -2,17 +2,21 @@
  * @file timerManager.h
  * @brief ADC读取模块头文件
  * @author cepvor
- * @version 1.0
+ * @version 1.1
  * @date 2025/9/25
  * @license MIT License
  *
  * @attention
  * 本文件为ADC读取模块头文件，包含如下内容：
- * - 初始化和读取电压的函数声明
+ * - 初始化ADC连续转换与采样任务的函数声明
  * - 电压变量声明
- * - ADC引脚定义
+ * - ADC引脚定义与连续转换（DMA）参数
  *
  * @note
+ * - 两个通道由ADC数字控制器在后台连续转换，结果经DMA写入驱动缓冲区，不占用CPU
+ * - 专用采样任务每个通道累加 ADC_OVERSAMPLE 个样本后抽取一次，按自己的节奏（每通道约8次/秒）更新电压
+ * - 电压由校准转换表换算（eFuse芯片特性 + 分压比 + NVS两点校正，见 adcCalibration.h）
+ * - 每个电池电压值同时更新电量估计与太阳能收益统计（见 solarHarvest.h），每日记录在跨本地零点时保存到NVS
  * 具体引脚定义请根据实际硬件选择
  * - 立创开发板：JLC_ADC_SOLAR_PIN (GPIO8), JCL_ADC_BATTERY_PIN (GPIO9)
  * - 自制核心板：ADC_SOLAR_PIN (GPIO7), ADC_BATTERY_PIN (GPIO10)
@@ -22,20 +26,44 @@
 #define LIGHTPROJECT_ADCREADING_H
 
 #include <Arduino.h>
-
+#include <driver/adc.h>
+#include "adcCalibration.h"
+#include "batterySoc.h"
+#include "solarHarvest.h"
 
 #define JLC_ADC_SOLAR_PIN 8
 #define JCL_ADC_BATTERY_PIN 9
 #define ADC_SOLAR_PIN 7
 #define ADC_BATTERY_PIN 10
 
+/* 连续转换（DMA）参数 */
+#define ADC_SAMPLE_FREQ_HZ 1000         // 两个通道合计的转换频率（每通道500Hz；S3的下限为611Hz）
+#define ADC_OVERSAMPLE 64               // 每个输出值平均的样本数（每通道约7.8次/秒）
+#define ADC_FRAME_BYTES 256             // 每次DMA中断交出的字节数（每个结果4字节）
+#define ADC_POOL_BYTES 1024             // 驱动缓冲区大小（采样任务来不及读取时暂存）
+#define ADC_READ_TIMEOUT_MS 1000        // 等待DMA数据的最长时间
+
+/* 通道与校准 */
+#define ADC_CH_BATTERY 0                // 电池电压通道
+#define ADC_CH_SOLAR 1                  // 太阳能电压通道
+#define ADC_CHANNELS 2
+#define ADC_CAL_DEFAULT_VREF 1100       // 芯片没有eFuse参数时 esp_adc_cal 使用的参考电压（mV）
+#define ADC_CAL_PREFS_NAMESPACE "adc_cal"   // 两点校正保存的NVS命名空间
+#define ADC_CAL_MAX_DEVIATION_PERCENT 25    // 实际电压与未校正读数相差超过此比例时拒绝取点（单位或通道填错）
+#define SOLAR_PREFS_NAMESPACE "solar"       // 太阳能每日记录与发电量期望保存的NVS命名空间
+
 extern int battery_mV;
 extern int solar_mV;
-extern int battery_percentage;      // 电池剩余电量百分比 (0-100)
+extern int battery_percentage;      // 电池剩余电量百分比 (0-100)，由电量估计器给出，放电过程中单调
 
 void adcReadingInit();
-void getVoltage();
-int calculateBatteryPercentage(int voltage_mV);  // 计算电池剩余电量百分比
+void adcSampleTask(void *pvParameters);         // 读取DMA结果、过采样抽取并更新电压
+bool adcCalibrationCapture(uint8_t channel, uint8_t index, uint16_t actualMv);  // 两点校正取点，两点取齐后保存
+void adcCalibrationClear(uint8_t channel);      // 清除两点校正
+const char *adcCalibrationSource();             // 芯片特性参数来源（"efuse" 或 "default"）
+bool adcCalibrationIsCorrected(uint8_t channel);    // 通道是否有两点校正
+void solarHarvestGetReport(solar_report_t *report);     // 太阳能收益摘要（当天、最近完整日与欠发标记）
+void solarExpectationSet(const solar_expectation_t *expectation);  // 设置发电量期望并保存（version 为0表示清除）
 
 
 #endif //LIGHTPROJECT_ADCREADING_H
\ No newline at end of file
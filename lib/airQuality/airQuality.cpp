@@ -0,0 +1,269 @@
+/**
+ * @file airQuality.cpp
+ * @brief 颗粒物滚动统计与空气质量指数模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现分桶环形累加器、NowCast 与 AQI 计算：
+ * - 时间前进时按经过的桶数逐个清空过期桶并从总和中减去，一次最多清空 bucketCount 个桶（长时间无数据时整体清空）
+ * - AQI 按EPA分级表分段线性插值，PM2.5截断到0.1μg/m³、PM10截断到1μg/m³后计算
+ *
+ * @note
+ * 注意事项：
+ * - 查询前应先调用 airQualityAdvance()，否则传感器停止发送后窗口中仍保留旧数据
+ */
+
+#include "airQuality.h"
+#include <cstring>
+
+/* 各窗口的桶时长与桶数 */
+static const uint32_t windowBucketMs[AQ_WINDOWS] = {5000, 60000, 300000, 3600000};
+static const uint8_t windowBuckets[AQ_WINDOWS] = {12, 15, 12, 24};
+
+/* AQI分级（EPA 2024）：浓度下限、浓度上限、指数下限、指数上限 */
+typedef struct {
+    float cLow;
+    float cHigh;
+    int16_t iLow;
+    int16_t iHigh;
+} aqi_breakpoint_t;
+
+static const aqi_breakpoint_t pm25Breakpoints[] = {
+    {0.0f, 9.0f, 0, 50},
+    {9.1f, 35.4f, 51, 100},
+    {35.5f, 55.4f, 101, 150},
+    {55.5f, 125.4f, 151, 200},
+    {125.5f, 225.4f, 201, 300},
+    {225.5f, 325.4f, 301, 500},
+};
+
+static const aqi_breakpoint_t pm10Breakpoints[] = {
+    {0.0f, 54.0f, 0, 50},
+    {55.0f, 154.0f, 51, 100},
+    {155.0f, 254.0f, 101, 150},
+    {255.0f, 354.0f, 151, 200},
+    {355.0f, 424.0f, 201, 300},
+    {425.0f, 604.0f, 301, 500},
+};
+
+/**
+ * 初始化单个窗口
+ */
+static void windowInit(aq_window_t *window, uint32_t bucketMs, uint8_t bucketCount) {
+    memset(window, 0, sizeof(*window));
+    window->bucketMs = bucketMs;
+    window->bucketCount = bucketCount;
+}
+
+/**
+ * 前进到 nowMs 所在的桶，清空期间经过的桶
+ */
+static void windowAdvance(aq_window_t *window, uint32_t nowMs) {
+    if (!window->started) {
+        window->started = true;
+        window->headStartMs = nowMs;
+        return;
+    }
+    uint32_t steps = (nowMs - window->headStartMs) / window->bucketMs;
+    if (steps == 0) {
+        return;
+    }
+    window->headStartMs += steps * window->bucketMs;
+    if (steps >= window->bucketCount) {         // 整个窗口都已过期
+        memset(window->buckets, 0, sizeof(window->buckets));
+        window->sum = 0;
+        window->count = 0;
+        window->head = 0;
+        return;
+    }
+    while (steps-- > 0) {
+        window->head = (uint8_t) ((window->head + 1) % window->bucketCount);
+        aq_bucket_t *bucket = &window->buckets[window->head];
+        window->sum -= bucket->sum;
+        window->count -= bucket->count;
+        bucket->sum = 0;
+        bucket->count = 0;
+    }
+}
+
+/**
+ * 把一个样本（0.1μg/m³）加入窗口的当前桶
+ */
+static void windowAdd(aq_window_t *window, uint32_t value, uint32_t nowMs) {
+    windowAdvance(window, nowMs);
+    aq_bucket_t *bucket = &window->buckets[window->head];
+    if (bucket->count == UINT16_MAX) {
+        return;                                 // 单个桶的样本数饱和（样本过于密集），丢弃
+    }
+    bucket->sum += value;
+    bucket->count++;
+    window->sum += value;
+    window->count++;
+}
+
+/**
+ * 浓度转换为0.1μg/m³整数（限幅）
+ */
+static uint32_t toTenths(float concentration) {
+    if (concentration > AQ_MAX_CONCENTRATION) {
+        concentration = AQ_MAX_CONCENTRATION;
+    }
+    return (uint32_t) (concentration * 10.0f + 0.5f);
+}
+
+/**
+ * 按分级表计算指数（超出最高一档时为 AQI_MAX）
+ */
+static int16_t aqiFromTable(const aqi_breakpoint_t *table, uint8_t count, float concentration) {
+    if (concentration < 0.0f) {
+        return -1;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (concentration <= table[i].cHigh) {
+            const aqi_breakpoint_t *bp = &table[i];
+            float index = (float) (bp->iHigh - bp->iLow) / (bp->cHigh - bp->cLow) * (concentration - bp->cLow) + (float) bp->iLow;
+            return (int16_t) (index + 0.5f);
+        }
+    }
+    return AQI_MAX;                     // 超出分级表（EPA 指数到500为止，不外推）
+}
+
+/**
+ * 两个指数中的较大者（-1 表示无效）
+ */
+static int16_t aqiMax(int16_t a, int16_t b) {
+    return a > b ? a : b;
+}
+
+/**
+ * 初始化统计（清空全部窗口）
+ */
+void airQualityInit(air_quality_t *aq) {
+    for (uint8_t i = 0; i < AQ_WINDOWS; i++) {
+        windowInit(&aq->pm25[i], windowBucketMs[i], windowBuckets[i]);
+        windowInit(&aq->pm10[i], windowBucketMs[i], windowBuckets[i]);
+    }
+}
+
+/**
+ * 加入一个样本
+ * 参数：pm25、pm10 - 浓度（μg/m³），负数表示该样本不含此项；nowMs - 当前时间（毫秒）
+ */
+void airQualityAdd(air_quality_t *aq, float pm25, float pm10, uint32_t nowMs) {
+    for (uint8_t i = 0; i < AQ_WINDOWS; i++) {
+        if (pm25 >= 0.0f) {
+            windowAdd(&aq->pm25[i], toTenths(pm25), nowMs);
+        }
+        if (pm10 >= 0.0f) {
+            windowAdd(&aq->pm10[i], toTenths(pm10), nowMs);
+        }
+    }
+}
+
+/**
+ * 把全部窗口前进到当前时间（查询前调用，使过期数据离开窗口）
+ */
+void airQualityAdvance(air_quality_t *aq, uint32_t nowMs) {
+    for (uint8_t i = 0; i < AQ_WINDOWS; i++) {
+        if (aq->pm25[i].started) {
+            windowAdvance(&aq->pm25[i], nowMs);
+        }
+        if (aq->pm10[i].started) {
+            windowAdvance(&aq->pm10[i], nowMs);
+        }
+    }
+}
+
+/**
+ * 窗口平均值（μg/m³），窗口内没有数据时返回 -1
+ */
+float airQualityMean(const aq_window_t *window) {
+    if (window->count == 0) {
+        return -1.0f;
+    }
+    return (float) window->sum / (float) window->count / 10.0f;
+}
+
+/**
+ * NowCast（μg/m³）
+ * 参数：hourly - 1小时桶的窗口（24小时窗口）
+ * 返回值：最近3小时中不足2小时有数据时返回 -1
+ */
+float airQualityNowCast(const aq_window_t *hourly) {
+    float hours[AQ_NOWCAST_HOURS];
+    uint8_t span = hourly->bucketCount < AQ_NOWCAST_HOURS ? hourly->bucketCount : AQ_NOWCAST_HOURS;
+    uint8_t recent = 0;
+    float cMin = 0.0f, cMax = 0.0f;
+    bool any = false;
+    for (uint8_t i = 0; i < span; i++) {        // 从当前小时向前取各小时平均值
+        const aq_bucket_t *bucket = &hourly->buckets[(hourly->head + hourly->bucketCount - i) % hourly->bucketCount];
+        if (bucket->count == 0) {
+            hours[i] = -1.0f;
+            continue;
+        }
+        hours[i] = (float) bucket->sum / (float) bucket->count / 10.0f;
+        if (i < 3) {
+            recent++;
+        }
+        if (!any || hours[i] < cMin) {
+            cMin = hours[i];
+        }
+        if (!any || hours[i] > cMax) {
+            cMax = hours[i];
+        }
+        any = true;
+    }
+    if (recent < 2) {
+        return -1.0f;
+    }
+    float weight = cMax > 0.0f ? cMin / cMax : 1.0f;
+    if (weight < AQ_NOWCAST_MIN_WEIGHT) {
+        weight = AQ_NOWCAST_MIN_WEIGHT;
+    }
+    float numerator = 0.0f, denominator = 0.0f, factor = 1.0f;
+    for (uint8_t i = 0; i < span; i++) {
+        if (hours[i] >= 0.0f) {
+            numerator += factor * hours[i];
+            denominator += factor;
+        }
+        factor *= weight;
+    }
+    return numerator / denominator;
+}
+
+/**
+ * PM2.5浓度对应的AQI（浓度截断到0.1μg/m³），负数浓度返回 -1
+ */
+int16_t aqiFromPm25(float pm25) {
+    if (pm25 >= 0.0f) {
+        pm25 = (float) (int32_t) (pm25 * 10.0f + 0.001f) / 10.0f;
+    }
+    return aqiFromTable(pm25Breakpoints, sizeof(pm25Breakpoints) / sizeof(pm25Breakpoints[0]), pm25);
+}
+
+/**
+ * PM10浓度对应的AQI（浓度截断到1μg/m³），负数浓度返回 -1
+ */
+int16_t aqiFromPm10(float pm10) {
+    if (pm10 >= 0.0f) {
+        pm10 = (float) (int32_t) (pm10 + 0.001f);
+    }
+    return aqiFromTable(pm10Breakpoints, sizeof(pm10Breakpoints) / sizeof(pm10Breakpoints[0]), pm10);
+}
+
+/**
+ * 生成统计报告（调用前先用 airQualityAdvance() 前进到当前时间）
+ */
+void airQualityReport(const air_quality_t *aq, air_quality_report_t *report) {
+    for (uint8_t i = 0; i < AQ_WINDOWS; i++) {
+        report->pm25Mean[i] = airQualityMean(&aq->pm25[i]);
+        report->pm10Mean[i] = airQualityMean(&aq->pm10[i]);
+    }
+    report->pm25NowCast = airQualityNowCast(&aq->pm25[AQ_WINDOW_24H]);
+    report->pm10NowCast = airQualityNowCast(&aq->pm10[AQ_WINDOW_24H]);
+    report->aqi = aqiMax(aqiFromPm25(report->pm25NowCast), aqiFromPm10(report->pm10NowCast));
+    report->aqi24h = aqiMax(aqiFromPm25(report->pm25Mean[AQ_WINDOW_24H]), aqiFromPm10(report->pm10Mean[AQ_WINDOW_24H]));
+}
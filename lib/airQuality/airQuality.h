@@ -0,0 +1,86 @@
+/**
+ * @file airQuality.h
+ * @brief 颗粒物滚动统计与空气质量指数模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为颗粒物滚动统计与空气质量指数模块头文件，包含如下内容：
+ * - 1分钟、15分钟、1小时、24小时滚动窗口（分桶环形累加器）
+ * - PM2.5与PM10的 NowCast 与 AQI（美国EPA 2024年分级）计算
+ * - 统计报告结构体与更新、查询函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 每个窗口由固定数量的时间桶组成，桶内只保存累加和与样本数；窗口同时维护全部桶的总和，
+ *   新样本只加到当前桶，时间前进时减去过期桶，更新与查询都是 O(1)，内存固定
+ * - 浓度以 0.1μg/m³ 为单位的整数累加（上限 AQ_MAX_CONCENTRATION），长时间运行不会出现浮点累加误差
+ * - 时间使用 millis()，窗口边界从第一个样本开始计算（与整点无关），millis() 回绕不影响结果
+ * - NowCast 使用24小时窗口中最近12个1小时桶（当前桶为最近一小时，可能不完整），
+ *   最近3小时中至少2小时有数据才有效
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_AIRQUALITY_H
+#define LIGHTPROJECT_AIRQUALITY_H
+
+#include <cstdint>
+
+#define AQ_WINDOW_1MIN 0                // 1分钟窗口（12个5秒桶）
+#define AQ_WINDOW_15MIN 1               // 15分钟窗口（15个1分钟桶）
+#define AQ_WINDOW_1H 2                  // 1小时窗口（12个5分钟桶）
+#define AQ_WINDOW_24H 3                 // 24小时窗口（24个1小时桶，同时用于 NowCast）
+#define AQ_WINDOWS 4                    // 窗口数
+#define AQ_MAX_BUCKETS 24               // 单个窗口最多的桶数
+
+#define AQ_MAX_CONCENTRATION 2000.0f    // 计入统计的浓度上限（μg/m³，24小时1Hz样本的累加和不会溢出32位）
+#define AQ_NOWCAST_HOURS 12             // NowCast 使用的小时数
+#define AQ_NOWCAST_MIN_WEIGHT 0.5f      // NowCast 权重下限
+#define AQI_MAX 500                     // AQI上限（超出分级表的浓度报告为此值）
+
+/* 时间桶 */
+typedef struct {
+    uint32_t sum;                       // 浓度累加和（0.1μg/m³）
+    uint16_t count;                     // 样本数
+} aq_bucket_t;
+
+/* 滚动窗口 */
+typedef struct {
+    uint32_t bucketMs;                  // 每个桶覆盖的时长
+    uint8_t bucketCount;                // 桶数
+    uint8_t head;                       // 当前桶下标
+    bool started;                       // 是否已开始计时（第一个样本或查询时）
+    uint32_t headStartMs;               // 当前桶的起始时间
+    uint32_t sum;                       // 全部桶的累加和
+    uint32_t count;                     // 全部桶的样本数
+    aq_bucket_t buckets[AQ_MAX_BUCKETS];
+} aq_window_t;
+
+/* 颗粒物统计 */
+typedef struct {
+    aq_window_t pm25[AQ_WINDOWS];
+    aq_window_t pm10[AQ_WINDOWS];
+} air_quality_t;
+
+/* 统计报告（浓度单位 μg/m³，负数表示窗口内没有数据） */
+typedef struct {
+    float pm25Mean[AQ_WINDOWS];         // 各窗口的PM2.5平均值
+    float pm10Mean[AQ_WINDOWS];         // 各窗口的PM10平均值
+    float pm25NowCast;                  // PM2.5 NowCast
+    float pm10NowCast;                  // PM10 NowCast
+    int16_t aqi;                        // 当前AQI（由 NowCast 计算，取PM2.5与PM10的较大者），-1 表示数据不足
+    int16_t aqi24h;                     // 24小时AQI（由24小时平均值计算）
+} air_quality_report_t;
+
+void airQualityInit(air_quality_t *aq);
+void airQualityAdd(air_quality_t *aq, float pm25, float pm10, uint32_t nowMs);
+void airQualityAdvance(air_quality_t *aq, uint32_t nowMs);
+float airQualityMean(const aq_window_t *window);
+float airQualityNowCast(const aq_window_t *hourly);
+int16_t aqiFromPm25(float pm25);
+int16_t aqiFromPm10(float pm10);
+void airQualityReport(const air_quality_t *aq, air_quality_report_t *report);
+
+#endif //LIGHTPROJECT_AIRQUALITY_H
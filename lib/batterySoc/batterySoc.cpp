@@ -0,0 +1,84 @@
+/**
+ * @file batterySoc.cpp
+ * @brief 电池荷电状态（SoC）估计模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现负载补偿与一维卡尔曼滤波：
+ * - 预测：soc -= 负载电流 × Δt / 容量；方差 += 过程噪声 × Δt
+ * - 观测：OCV = 端子电压 + 负载电流 × 内阻，查表得到观测电量，按卡尔曼增益修正
+ * - 充电时负载电流未知（充电电流没有测量），只用OCV观测，不做库仑计数
+ *
+ * @note
+ * 注意事项：
+ * - 充电时端子电压高于开路电压，观测值偏高；充电结束后放电过程中的观测会逐步修正回来
+ */
+
+#include "batterySoc.h"
+
+/**
+ * 电池侧负载电流（mA）：系统静态电流 + 灯带功率经升压后折算到电池的电流
+ */
+float socBatteryCurrentMa(float batteryMv, float ledPowerMw) {
+    if (batteryMv < 1000.0f) {
+        return SOC_SYSTEM_MA;
+    }
+    return SOC_SYSTEM_MA + ledPowerMw / (SOC_LED_EFFICIENCY * batteryMv / 1000.0f);
+}
+
+/**
+ * 初始化估计器（下一次更新直接采用OCV观测）
+ */
+void socInit(battery_soc_t *est) {
+    est->soc = 0.0f;
+    est->variance = SOC_INITIAL_VARIANCE;
+    est->ocvSoc = 0.0f;
+    est->lastMs = 0;
+    est->started = false;
+}
+
+/**
+ * 更新电量估计
+ * 参数：batteryMv - 端子电压；loadMa - 电池侧负载电流；charging - 是否正在充电；nowMs - 当前时间
+ * 返回值：估计电量（0~100%）
+ */
+float socUpdate(battery_soc_t *est, float batteryMv, float loadMa, bool charging, uint32_t nowMs) {
+    float ocv = batteryMv + loadMa * SOC_INTERNAL_MOHM / 1000.0f;   // 还原开路电压
+    est->ocvSoc = socFromOcv(ocv);
+    if (!est->started) {
+        est->started = true;
+        est->soc = est->ocvSoc;
+        est->variance = SOC_MEASURE_NOISE + loadMa * SOC_MEASURE_NOISE_PER_MA;
+        est->lastMs = nowMs;
+        return est->soc;
+    }
+
+    uint32_t dt = nowMs - est->lastMs;
+    est->lastMs = nowMs;
+    if (dt > SOC_MAX_STEP_MS) {
+        dt = SOC_MAX_STEP_MS;
+    }
+
+    /* 预测：库仑计数 */
+    float previous = est->soc;
+    float predicted = est->soc;
+    if (!charging) {
+        predicted -= loadMa * ((float) dt / 3600000.0f) / SOC_CAPACITY_MAH * 100.0f;
+    }
+    float variance = est->variance + SOC_PROCESS_NOISE * ((float) dt / 1000.0f);
+
+    /* 观测：负载补偿后的OCV电量 */
+    float noise = SOC_MEASURE_NOISE + loadMa * SOC_MEASURE_NOISE_PER_MA;
+    float gain = variance / (variance + noise);
+    float soc = predicted + gain * (est->ocvSoc - predicted);
+    est->variance = (1.0f - gain) * variance;
+
+    if (!charging && soc > previous) {
+        soc = previous;                     // 放电过程中只降不升
+    }
+    est->soc = soc < 0.0f ? 0.0f : (soc > 100.0f ? 100.0f : soc);
+    return est->soc;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file batterySoc.h
+ * @brief 电池荷电状态（SoC）估计模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为电池荷电状态估计模块头文件，包含如下内容：
+ * - 锂电池开路电压（OCV）曲线（constexpr 插值表，编译期检查单调性）
+ * - 负载模型参数（内阻、系统静态电流、灯带升压效率、容量）
+ * - 一维卡尔曼滤波器状态与更新函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 端子电压加上 负载电流 × 内阻 还原为开路电压，再查OCV曲线得到电量观测值，开灯时的电压跌落不再被当成电量下降
+ * - 预测步按负载电流做库仑计数，观测步按卡尔曼增益向OCV观测值修正；观测噪声随负载电流增大，
+ *   重负载时更多依赖库仑计数
+ * - 未充电（太阳能电压低于充电门限）时输出只降不升，放电过程中电量单调
+ * - 每次更新只有几次乘加与一次查表，可以每100ms调用
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_BATTERYSOC_H
+#define LIGHTPROJECT_BATTERYSOC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* 电池与负载模型 */
+#define SOC_CAPACITY_MAH 3000.0f        // 电池容量（mAh）
+#define SOC_INTERNAL_MOHM 150.0f        // 电池内阻与线路电阻（mΩ）
+#define SOC_SYSTEM_MA 60.0f             // 主控、传感器与无线的平均电流（mA）
+#define SOC_LED_EFFICIENCY 0.85f        // 灯带5V升压效率（电池侧电流 = LED功率 / (效率 × 电池电压)）
+#define SOC_CHARGE_SOLAR_MV 4500        // 太阳能电压高于此值视为正在充电（充电芯片最低输入电压）
+
+/* 卡尔曼滤波参数（电量单位为百分比） */
+#define SOC_INITIAL_VARIANCE 100.0f     // 初始方差（首次观测直接采用OCV电量）
+#define SOC_PROCESS_NOISE 0.0005f       // 每秒过程噪声（%²/s，容量与电流模型误差）
+#define SOC_MEASURE_NOISE 400.0f        // 空载时OCV观测噪声（%²，曲线平坦区与ADC误差）
+#define SOC_MEASURE_NOISE_PER_MA 4.0f   // 每 mA 负载增加的观测噪声（%²，内阻模型误差）
+#define SOC_MAX_STEP_MS 10000           // 两次更新间隔上限（超过按此值计算，避免长时间停顿后一次跳变）
+
+/* OCV曲线点 */
+struct soc_ocv_point_t {
+    uint16_t mv;        // 开路电压（mV）
+    uint8_t percent;    // 电量（%）
+};
+
+/* 锂电池开路电压曲线（与原来的分段电量表一致，电压与电量都必须递增） */
+static constexpr soc_ocv_point_t socOcvTable[] = {
+    {3000, 0},
+    {3300, 5},
+    {3600, 20},
+    {3700, 40},
+    {3800, 60},
+    {4000, 85},
+    {4200, 100},
+};
+static constexpr size_t SOC_OCV_POINTS = sizeof(socOcvTable) / sizeof(socOcvTable[0]);
+
+/* 编译期检查曲线单调（C++11 constexpr 只能递归） */
+constexpr bool socOcvMonotone(size_t i = 1) {
+    return i >= SOC_OCV_POINTS
+           || (socOcvTable[i].mv > socOcvTable[i - 1].mv && socOcvTable[i].percent >= socOcvTable[i - 1].percent
+               && socOcvMonotone(i + 1));
+}
+static_assert(socOcvMonotone(), "OCV曲线的电压与电量必须递增");
+static_assert(socOcvTable[0].percent == 0 && socOcvTable[SOC_OCV_POINTS - 1].percent == 100, "OCV曲线必须覆盖0~100%");
+
+/**
+ * 开路电压 -> 电量（%），分段线性插值，两端限幅
+ */
+constexpr float socFromOcv(float mv, size_t i = 1) {
+    return mv <= socOcvTable[0].mv ? 0.0f
+           : i >= SOC_OCV_POINTS ? 100.0f
+           : mv <= socOcvTable[i].mv
+             ? socOcvTable[i - 1].percent + (mv - socOcvTable[i - 1].mv) * (socOcvTable[i].percent - socOcvTable[i - 1].percent)
+                                            / (float) (socOcvTable[i].mv - socOcvTable[i - 1].mv)
+             : socFromOcv(mv, i + 1);
+}
+static_assert(socFromOcv(3750.0f) == 50.0f, "OCV插值错误");
+
+/* 估计器状态 */
+typedef struct {
+    float soc;              // 估计电量（%）
+    float variance;         // 估计方差（%²）
+    float ocvSoc;           // 最近一次OCV观测电量（%，用于上报与调试）
+    uint32_t lastMs;        // 上次更新时间
+    bool started;           // 是否已有首次观测
+} battery_soc_t;
+
+float socBatteryCurrentMa(float batteryMv, float ledPowerMw);
+void socInit(battery_soc_t *est);
+float socUpdate(battery_soc_t *est, float batteryMv, float loadMa, bool charging, uint32_t nowMs);
+
+#endif //LIGHTPROJECT_BATTERYSOC_H
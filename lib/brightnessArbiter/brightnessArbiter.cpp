@@ -0,0 +1,154 @@
+/**
+ * @file brightnessArbiter.cpp
+ * @brief 亮度来源仲裁模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现按优先级排列的亮度来源仲裁：
+ * - 紧急照明 > 远程设置 > 时间表 > 运动增亮 > 环境光基础亮度
+ * - 每个来源独立设置亮度与有效期，仲裁时从高到低找到第一个有效来源
+ * - 到期判断使用无符号减法，millis() 回绕后仍然正确
+ *
+ * @note
+ * 仲裁结果只决定目标亮度，来源切换时的平滑过渡由亮度控制模块的变化曲线完成
+ */
+
+#include "brightnessArbiter.h"
+
+/**
+ * 判断槽位是否已过期
+ */
+static bool slotExpired(const brightness_slot_t *slot, uint32_t nowMs) {
+    return slot->ttlMs != BRIGHTNESS_TTL_FOREVER && nowMs - slot->setTime >= slot->ttlMs;
+}
+
+/**
+ * 初始化仲裁器，所有来源均无效
+ */
+void arbiterInit(brightness_arbiter_t *arbiter) {
+    for (uint8_t i = 0; i < BRIGHTNESS_SRC_COUNT; i++) {
+        arbiter->slots[i].active = false;
+        arbiter->slots[i].level = 0;
+        arbiter->slots[i].setTime = 0;
+        arbiter->slots[i].ttlMs = BRIGHTNESS_TTL_FOREVER;
+    }
+}
+
+/**
+ * 设置（或刷新）一个来源
+ * 参数：source - 来源编号；level - 请求亮度；ttlMs - 有效期；nowMs - 当前时间
+ */
+void arbiterSet(brightness_arbiter_t *arbiter, uint8_t source, uint16_t level, uint32_t ttlMs, uint32_t nowMs) {
+    if (source >= BRIGHTNESS_SRC_COUNT) {
+        return;
+    }
+    brightness_slot_t *slot = &arbiter->slots[source];
+    slot->active = true;
+    slot->level = level;
+    slot->setTime = nowMs;
+    slot->ttlMs = ttlMs;
+}
+
+/**
+ * 清除一个来源
+ */
+void arbiterClear(brightness_arbiter_t *arbiter, uint8_t source) {
+    if (source < BRIGHTNESS_SRC_COUNT) {
+        arbiter->slots[source].active = false;
+    }
+}
+
+/**
+ * 查询来源是否有效（过期的来源会被顺便清除）
+ */
+bool arbiterIsActive(brightness_arbiter_t *arbiter, uint8_t source, uint32_t nowMs) {
+    if (source >= BRIGHTNESS_SRC_COUNT) {
+        return false;
+    }
+    brightness_slot_t *slot = &arbiter->slots[source];
+    if (slot->active && slotExpired(slot, nowMs)) {
+        slot->active = false;
+    }
+    return slot->active;
+}
+
+/**
+ * 仲裁：找出优先级最高的有效来源
+ * 参数：nowMs - 当前时间
+ *       ignoreMask - 本次忽略的来源位掩码（第 n 位对应来源 n），用于条件性来源（如白天不响应运动）
+ *       level - 输出：胜出来源的亮度，没有有效来源时为0
+ * 返回值：胜出的来源编号，没有有效来源时返回 BRIGHTNESS_SRC_COUNT
+ */
+uint8_t arbiterResolve(brightness_arbiter_t *arbiter, uint32_t nowMs, uint8_t ignoreMask, uint16_t *level) {
+    for (uint8_t i = 0; i < BRIGHTNESS_SRC_COUNT; i++) {
+        if ((ignoreMask & (1U << i)) == 0 && arbiterIsActive(arbiter, i, nowMs)) {
+            *level = arbiter->slots[i].level;
+            return i;
+        }
+    }
+    *level = 0;
+    return BRIGHTNESS_SRC_COUNT;
+}
+
+/**
+ * 计算距最近一个来源到期的时间
+ * 功能说明：灯控任务据此在来源到期时醒来重新仲裁，而不必定时轮询
+ * 返回值：剩余毫秒数，没有带有效期的来源时返回 BRIGHTNESS_NO_EXPIRY
+ */
+uint32_t arbiterNextExpiry(const brightness_arbiter_t *arbiter, uint32_t nowMs) {
+    uint32_t nearest = BRIGHTNESS_NO_EXPIRY;
+    for (uint8_t i = 0; i < BRIGHTNESS_SRC_COUNT; i++) {
+        const brightness_slot_t *slot = &arbiter->slots[i];
+        if (!slot->active || slot->ttlMs == BRIGHTNESS_TTL_FOREVER) {
+            continue;
+        }
+        uint32_t elapsed = nowMs - slot->setTime;
+        if (elapsed >= slot->ttlMs) {
+            continue;               // 已过期（尚未被仲裁清除），不再需要唤醒
+        }
+        uint32_t remaining = slot->ttlMs - elapsed;
+        if (remaining < nearest) {
+            nearest = remaining;
+        }
+    }
+    return nearest;
+}
+
+/**
+ * 对仲裁结果施加亮度上限
+ * 参数：source - 胜出的来源；level - 胜出来源的亮度；powerCap - 功率预算上限；scheduleCap - 时间表上限
+ * 返回值：限制后的亮度
+ * 说明：功率预算限制紧急照明以外的来源，时间表上限只限制自动来源（运动增亮与环境光）
+ */
+uint16_t arbiterApplyCaps(uint8_t source, uint16_t level, uint16_t powerCap, uint16_t scheduleCap) {
+    if (source != BRIGHTNESS_SRC_EMERGENCY && level > powerCap) {
+        level = powerCap;
+    }
+    if (source >= BRIGHTNESS_SRC_MOTION && level > scheduleCap) {
+        level = scheduleCap;
+    }
+    return level;
+}
+
+/**
+ * 来源名称（用于日志与上报）
+ */
+const char *arbiterSourceName(uint8_t source) {
+    switch (source) {
+        case BRIGHTNESS_SRC_EMERGENCY:
+            return "emergency";
+        case BRIGHTNESS_SRC_REMOTE:
+            return "remote";
+        case BRIGHTNESS_SRC_SCHEDULE:
+            return "schedule";
+        case BRIGHTNESS_SRC_MOTION:
+            return "motion";
+        case BRIGHTNESS_SRC_AMBIENT:
+            return "ambient";
+        default:
+            return "none";
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file brightnessArbiter.h
+ * @brief 亮度来源仲裁模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为亮度来源仲裁模块头文件，包含如下内容：
+ * - 亮度来源（按优先级排列）的枚举定义
+ * - 来源槽位与仲裁器结构体定义
+ * - 设置/清除来源、仲裁、到期查询与亮度上限的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 枚举值越小优先级越高，仲裁时取优先级最高的有效来源
+ * - 每个来源可设置有效期（TTL），到期后自动失效，BRIGHTNESS_TTL_FOREVER 表示长期有效
+ * - 所有操作均为 O(来源数)，不使用堆内存，时间由调用者传入，可在主机上直接编译测试
+ * - 仲裁器本身不加锁，只能在一个任务中使用
+ */
+
+#ifndef LIGHTPROJECT_BRIGHTNESSARBITER_H
+#define LIGHTPROJECT_BRIGHTNESSARBITER_H
+
+#include <cstdint>
+
+#define BRIGHTNESS_TTL_FOREVER 0            // 长期有效（直到被清除）
+#define BRIGHTNESS_NO_EXPIRY 0xFFFFFFFFUL   // 没有即将到期的来源
+
+/* 亮度来源（按优先级从高到低排列） */
+typedef enum {
+    BRIGHTNESS_SRC_EMERGENCY = 0,   // 紧急照明
+    BRIGHTNESS_SRC_REMOTE,          // 远程手动设置（带有效期）
+    BRIGHTNESS_SRC_SCHEDULE,        // 时间表
+    BRIGHTNESS_SRC_MOTION,          // 运动检测增亮
+    BRIGHTNESS_SRC_AMBIENT,         // 环境光基础亮度
+    BRIGHTNESS_SRC_COUNT            // 来源数量（也表示“无有效来源”）
+} brightness_source_t;
+
+/* 来源槽位 */
+typedef struct {
+    bool active;            // 是否有效
+    uint16_t level;         // 请求的亮度（16位感知亮度）
+    uint32_t setTime;       // 设置时间（毫秒）
+    uint32_t ttlMs;         // 有效期（毫秒），BRIGHTNESS_TTL_FOREVER 表示长期有效
+} brightness_slot_t;
+
+/* 仲裁器 */
+typedef struct {
+    brightness_slot_t slots[BRIGHTNESS_SRC_COUNT];  // 按来源编号索引
+} brightness_arbiter_t;
+
+void arbiterInit(brightness_arbiter_t *arbiter);
+void arbiterSet(brightness_arbiter_t *arbiter, uint8_t source, uint16_t level, uint32_t ttlMs, uint32_t nowMs);
+void arbiterClear(brightness_arbiter_t *arbiter, uint8_t source);
+bool arbiterIsActive(brightness_arbiter_t *arbiter, uint8_t source, uint32_t nowMs);
+uint8_t arbiterResolve(brightness_arbiter_t *arbiter, uint32_t nowMs, uint8_t ignoreMask, uint16_t *level);
+uint32_t arbiterNextExpiry(const brightness_arbiter_t *arbiter, uint32_t nowMs);
+uint16_t arbiterApplyCaps(uint8_t source, uint16_t level, uint16_t powerCap, uint16_t scheduleCap);
+const char *arbiterSourceName(uint8_t source);
+
+#endif //LIGHTPROJECT_BRIGHTNESSARBITER_H
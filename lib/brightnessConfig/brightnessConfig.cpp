@@ -10,185 +10,339 @@
  * 本模块实现智能LED亮度控制功能，包括：
  * - 基于环境光传感器的自适应亮度调节
  * - 运动检测触发的亮度增强
+ * - 多个亮度来源（紧急/远程/时间表/运动/环境光）按优先级仲裁
  * - 平滑的亮度变化曲线算法
- * - 支持手动调试按钮控制
+ * - 闭环日光补偿模式：PI控制器保持目标照度，自身光照模型由调试扫描拟合并保存在NVS
+ * - 功率预算限额：电量不足时限制除紧急照明以外所有来源的最高亮度
+ * - 支持手动调试按钮控制（输入事件由 motionInput 模块在灯控任务中转交）
  *
  * 主要特性：
  * - 三档环境光亮度控制（500/300/100 lux）
- * - 运动检测5秒超时机制
+ * - 运动检测保持时间按各时段的到达间隔自适应（默认5秒，样本不足时使用）
  * - 平滑的非线性亮度变化曲线
- * - 兼容立创开发板和自制核心板
+ * - 16位感知亮度（CIE L*）内部精度，输出端查表并时间抖动
+ * - 闭环模式下环境光来源的亮度由控制器给出，代替三档分档（传感器能看到灯光时分档会自激振荡）
  *
- * 硬件接口：
- * - motionPin: PIR运动检测传感器输入
- * - key1Pin: 手动触发运动检测按钮（内部上拉）
- * - key2Pin: 手动消除运动检测按钮（内部上拉）
+ * 本模块只依赖 millis()、Serial 与 Preferences，主机仿真（sim/）用虚拟时钟替换这些接口后直接编译本文件
+ *
+ * 线程模型：
+ * - 仲裁器与运动状态只由灯控任务读写（中断事件与远程命令都转交灯控任务处理），无需额外同步
  */
 
 #include "brightnessConfig.h"
-#include "taskCreate.h"
-#include <Adafruit_AHTX0.h>
-#include <BH1750.h>
-#include <FastLED.h>
+#include "perceptualDimming.h"
+#include "brightnessArbiter.h"
+#include "daylightController.h"
+#include "occupancyModel.h"
+#include <Preferences.h>
 
 /* ========== 全局变量定义区域 ========== */
 /* 这些变量用于存储系统的当前状态，在整个程序运行期间都会被使用 */
 
-volatile bool isMove = false;           // 运动检测标志（volatile表示这个变量可能被中断函数修改，告诉编译器不要优化它）
-uint8_t currentBrightness = 0;          // 当前实际亮度值（0-255，0是最暗，255是最亮）
-uint8_t targetBrightness = 0;           // 目标亮度值（系统想要达到的亮度）
-uint8_t baseBrightness = 0;             // 基础亮度值（根据环境光传感器计算出的基本亮度）
-
-/* ========== 硬件引脚配置区域 ========== */
-/* 根据不同的开发板型号，选择对应的引脚编号 */
-#ifdef isJLC
-/* 立创开发板的引脚定义 */
-int motionPin = JLC_MOTION_PIN;         // 运动检测传感器连接的引脚
-int key1Pin = JLC_KEY1_PIN;             // KEY1按钮连接的引脚（用于手动触发运动检测）
-int key2Pin = JLC_KEY2_PIN;             // KEY2按钮连接的引脚（用于手动取消运动检测）
-#else
-/* 自制核心板的引脚定义 */
-int motionPin = MOTION_PIN;             // 运动检测传感器连接的引脚
-int key1Pin = KEY1_PIN;                 // KEY1按钮连接的引脚
-int key2Pin = KEY2_PIN;                 // KEY2按钮连接的引脚
-#endif
+brightness_tuning_t brightnessTuning = {
+    LUX_THRESHOLD_HIGH, LUX_THRESHOLD_MID, LUX_THRESHOLD_LOW,
+    BRIGHTNESS_HIGH_LUX, BRIGHTNESS_MID_LUX, BRIGHTNESS_LOW_LUX, BRIGHTNESS_MAX,
+    BRIGHTNESS_UP_TIME_MS, BRIGHTNESS_DOWN_TIME_MS, MOTION_TIMEOUT_MS,
+    MOTION_HOLD_MIN_MS, MOTION_HOLD_MAX_MS, MOTION_RAMP_COST_MS, MOTION_ENERGY_CAP, true
+};
+
+uint8_t brightnessSource = BRIGHTNESS_SRC_COUNT;    // 当前胜出的亮度来源（只由灯控任务修改，其他任务仅读取用于显示与上报）
+uint16_t currentBrightness = 0;         // 当前实际亮度值（16位感知亮度，0是最暗，65535是最亮）
+uint16_t targetBrightness = 0;          // 目标亮度值（系统想要达到的亮度）
+uint16_t baseBrightness = 0;            // 基础亮度值（根据环境光传感器计算出的基本亮度）
+bool daylightMode = false;              // 是否处于闭环日光补偿模式
+float daylightTargetLux = DAYLIGHT_TARGET_LUX_DEFAULT;  // 闭环目标照度（lux）
+uint32_t motionHoldMs = MOTION_TIMEOUT_MS;  // 最近一次运动事件采用的保持时间（毫秒）
+float brightnessPowerLimit = 1.0f;      // 功率预算限额（线性输出比例）
+float brightnessVisibilityGain = 1.0f;  // 能见度补偿增益（线性输出倍数）
 
 /* ========== 私有变量定义区域 ========== */
 /* 这些变量只在本文件内部使用，用于控制亮度变化的细节 */
-static uint32_t lastMotionTime = 0;     // 上次检测到运动的时间（毫秒）
-static uint32_t motionTimeout = 5000;   // 运动检测超时时间(5秒，即5000毫秒)
-static int16_t brightnessStep = 0;      // 当前亮度变化已执行的步数（用于控制变化速度）
+static brightness_arbiter_t arbiter;    // 亮度来源仲裁器
+static uint32_t transitionStartTime = 0; // 当前亮度变化开始的时间（毫秒，用于计算变化进度）
 static bool isRising = false;           // 标记当前是否正在增加亮度
 static bool isFalling = false;          // 标记当前是否正在降低亮度
-static uint8_t startBrightness = 0;     // 记录亮度变化开始时的初始亮度值
+static uint16_t startBrightness = 0;    // 记录亮度变化开始时的初始亮度值
+static uint16_t powerLimitLevel = BRIGHTNESS_MAX;   // 功率预算限额对应的感知亮度上限
+static uint16_t scheduleCapLevel = BRIGHTNESS_MAX;  // 时间表亮度上限（只作用于运动增亮与环境光）
+
+/* 自适应运动保持时间相关 */
+static occupancy_model_t occupancy;     // 到达间隔统计
+static int8_t hourOfDay = -1;           // 当前小时（未对时为-1，使用公共桶）
+static uint32_t occupancySaveTime = 0;  // 上次保存到NVS的时间（毫秒）
+
+/* 闭环日光补偿相关 */
+static daylight_controller_t daylight;  // PI控制器状态
+static float daylightSelfGain = 0.0f;   // 调试扫描拟合的自身光照增益（lux），0 表示尚未调试
+static uint32_t daylightLastUpdate = 0; // 控制器上次更新时间（毫秒，用于计算 dt）
+static bool sweepActive = false;        // 是否正在进行调试扫描
+static uint8_t sweepStep = 0;           // 当前扫描阶跃序号
+static uint32_t sweepStepStart = 0;     // 当前阶跃开始时间（毫秒）
+static float sweepOutputs[DAYLIGHT_SWEEP_STEPS];    // 各阶跃的线性输出
+static float sweepLux[DAYLIGHT_SWEEP_STEPS];        // 各阶跃稳定后的照度
+
+/**
+ * 当前实际输出（线性占空比 0.0~1.0），用于自身光照补偿
+ */
+static float appliedLinearOutput() {
+    return (float) perceptualToLinear(currentBrightness) / (float) PERCEPTUAL_LEVEL_MAX;
+}
+
+/**
+ * 线性占空比转换为16位感知亮度
+ */
+static uint16_t outputToLevel(float output) {
+    return linearToPerceptual((uint16_t) (output * (float) PERCEPTUAL_LEVEL_MAX + 0.5f));
+}
+
+/**
+ * 更新闭环控制器的输出上限（功率预算与时间表上限中较小的一个），避免控制器在上限之上积分饱和
+ */
+static void updateDaylightMaxOutput() {
+    float scheduleLimit = (float) perceptualToLinear(scheduleCapLevel) / (float) PERCEPTUAL_LEVEL_MAX;
+    daylightSetMaxOutput(&daylight, scheduleLimit < brightnessPowerLimit ? scheduleLimit : brightnessPowerLimit);
+}
+
+/**
+ * 保存闭环参数到NVS（模式、目标照度、自身光照增益）
+ */
+static void saveDaylightPrefs() {
+    Preferences prefs;
+    if (!prefs.begin(DAYLIGHT_PREFS_NAMESPACE, false)) {
+        Serial.println("闭环参数保存失败");
+        return;
+    }
+    prefs.putBool("enable", daylightMode);
+    prefs.putFloat("target", daylightTargetLux);
+    prefs.putFloat("gain", daylightSelfGain);
+    prefs.end();
+}
+
+/**
+ * 从NVS读取闭环参数，未调试过（没有有效增益）时保持开环模式
+ */
+static void loadDaylightPrefs() {
+    Preferences prefs;
+    if (prefs.begin(DAYLIGHT_PREFS_NAMESPACE, true)) {     // 首次启动时命名空间不存在，使用默认值
+        daylightMode = prefs.getBool("enable", false);
+        daylightTargetLux = prefs.getFloat("target", DAYLIGHT_TARGET_LUX_DEFAULT);
+        daylightSelfGain = prefs.getFloat("gain", 0.0f);
+        prefs.end();
+    }
+    if (daylightSelfGain < DAYLIGHT_MIN_SELF_GAIN) {
+        daylightMode = false;
+    }
+    daylightInit(&daylight, daylightTargetLux, daylightSelfGain);
+}
+
+/**
+ * 从NVS读取到达间隔模型（数据缺失或版本不符时重新开始统计）
+ */
+static void loadOccupancy() {
+    Preferences prefs;
+    bool loaded = false;
+    if (prefs.begin(OCCUPANCY_PREFS_NAMESPACE, true)) {
+        loaded = prefs.getBytesLength("model") == sizeof(occupancy) &&
+                 prefs.getBytes("model", &occupancy, sizeof(occupancy)) == sizeof(occupancy) &&
+                 occupancyIsValid(&occupancy);
+        prefs.end();
+    }
+    if (!loaded) {
+        occupancyInit(&occupancy, MOTION_TIMEOUT_MS);
+    }
+    occupancy.hasLastEvent = false;     // 重启前的事件时间已无意义
+}
+
+/**
+ * 保存到达间隔模型到NVS
+ */
+static void saveOccupancy() {
+    Preferences prefs;
+    if (prefs.begin(OCCUPANCY_PREFS_NAMESPACE, false)) {
+        prefs.putBytes("model", &occupancy, sizeof(occupancy));
+        prefs.end();
+    }
+}
 
 /**
  * 初始化亮度控制模块
- * 功能说明：这个函数在系统启动时被调用，用于设置各种硬件接口和初始参数
+ * 功能说明：这个函数在系统启动时被调用，用于设置初始参数（引脚与中断见 motionInputInit()）
  */
 void brightnessInit() {
-    /* ===== 设置引脚工作模式 ===== */
-    pinMode(motionPin, INPUT_PULLDOWN);     // 设置运动检测引脚为输入模式，并启用内部下拉
-    pinMode(key1Pin, INPUT_PULLUP);         // KEY1按钮，内部上拉，用于手动触发运动检测
-    pinMode(key2Pin, INPUT_PULLUP);         // KEY2按钮，内部上拉，用于手动消除运动检测
-
-    /* ===== 配置中断处理 ===== */
-    /* 为运动检测引脚配置中断：当引脚电平从低变高时（RISING上升沿），调用motionISR函数 */
-    attachInterrupt(digitalPinToInterrupt(motionPin), motionISR, RISING);
-    /* 为KEY1按钮配置中断：当按钮被按下时（引脚电平从高变低，FALLING下降沿），调用key1ISR函数 */
-    attachInterrupt(digitalPinToInterrupt(key1Pin), key1ISR, FALLING);
-    /* 为KEY2按钮配置中断：当按钮被按下时，调用key2ISR函数 */
-    attachInterrupt(digitalPinToInterrupt(key2Pin), key2ISR, FALLING);
-
     /* ===== 初始化所有变量为默认值 ===== */
-    isMove = false;                     // 初始状态：没有检测到运动
+    arbiterInit(&arbiter);              // 初始状态：没有任何亮度来源
+    brightnessSource = BRIGHTNESS_SRC_COUNT;
     currentBrightness = 0;              // 初始亮度：0（灯是关闭的）
     targetBrightness = 0;               // 初始目标亮度：0
     baseBrightness = 0;                 // 初始基础亮度：0
-    brightnessStep = 0;                 // 初始变化步数：0
     isRising = false;                   // 初始状态：不在增加亮度
     isFalling = false;                  // 初始状态：不在降低亮度
 
+    perceptualDimmingInit();            // 生成感知亮度 -> PWM 查找表
+    loadDaylightPrefs();                // 读取闭环日光补偿参数
+    loadOccupancy();                    // 读取到达间隔统计
+    occupancySaveTime = millis();
+    motionHoldMs = brightnessTuning.motionTimeoutMs;
+    sweepActive = false;
+
     /* 向串口输出初始化完成的信息（用于调试） */
     Serial.println("亮度控制模块初始化完成");
-    Serial.println("IO15: 原有运动检测功能");
-    Serial.println("KEY1(IO1): 手动触发运动检测");
-    Serial.println("KEY2(IO2): 手动消除运动检测");
+    if (daylightMode) {
+        Serial.printf("闭环日光补偿已启用，目标照度: %.0f lux，自身光照增益: %.1f lux\n", daylightTargetLux, daylightSelfGain);
+    }
+}
+
+/**
+ * 初始化光照滤波器
+ * 参数：lux - 初始光照值
+ */
+void luxFilterInit(lux_filter_t *filter, float lux) {
+    filter->filtered = lux;
+    filter->notified = lux;
+}
+
+/**
+ * 光照滤波并判断是否需要唤醒灯控任务
+ * 功能说明：每次传感器采样（100ms）调用一次，一阶低通滤波抑制噪声，
+ * 滤波值相对上次通知变化超过 LUX_CHANGE_RATIO 且超过 LUX_CHANGE_MIN 时返回 true
+ */
+bool luxFilterUpdate(lux_filter_t *filter, float lux) {
+    filter->filtered += (lux - filter->filtered) * LUX_FILTER_ALPHA;
+    float delta = filter->filtered - filter->notified;
+    if (delta < 0.0f) {
+        delta = -delta;
+    }
+    if (delta > LUX_CHANGE_MIN && delta > filter->notified * LUX_CHANGE_RATIO) {    // 变化显著才唤醒灯控任务
+        filter->notified = filter->filtered;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * 记录一次运动检测
+ * 功能说明：由输入事件处理函数在灯控任务中调用（PIR或KEY1），以最高亮度刷新运动来源的有效期，
+ * 有效期（保持时间）由当前时段的到达间隔统计决定：繁忙时延长，避免反复熄灭与升亮；冷清时缩短，减少空耗
+ * 参数：timeMs - 事件发生时间（中断中记录的 millis）
+ */
+void brightnessMotionDetected(uint32_t timeMs) {
+    occupancyRecord(&occupancy, hourOfDay, timeMs);
+    if (brightnessTuning.motionAdaptive) {
+        motionHoldMs = occupancyHoldTime(&occupancy, hourOfDay, brightnessTuning.motionHoldMinMs,
+                                         brightnessTuning.motionHoldMaxMs, brightnessTuning.motionTimeoutMs,
+                                         brightnessTuning.motionRampCostMs, brightnessTuning.motionEnergyCap);
+    }
+    else {
+        motionHoldMs = brightnessTuning.motionTimeoutMs;
+    }
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_MOTION, brightnessTuning.levelMotion, motionHoldMs, timeMs);
+
+    if (timeMs - occupancySaveTime >= OCCUPANCY_SAVE_INTERVAL_MS) {    // 定期保存，重启后不必重新学习
+        occupancySaveTime = timeMs;
+        saveOccupancy();
+    }
+}
+
+/**
+ * 设置当前小时
+ * 参数：hour - 0~23，时间未知时为 -1（使用不分时段的统计）
+ */
+void brightnessSetHourOfDay(int8_t hour) {
+    hourOfDay = (hour >= 0 && hour < OCCUPANCY_HOURS) ? hour : -1;
+}
+
+/**
+ * 取消运动检测状态
+ * 功能说明：由输入事件处理函数在灯控任务中调用（KEY2），强制恢复基础亮度
+ */
+void brightnessMotionCleared() {
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_MOTION);
 }
 
 /**
- * 运动检测中断服务函数
- * 功能说明：当PIR运动检测传感器检测到运动时，这个函数会被自动调用
- * 注意：IRAM_ATTR表示这个函数存储在RAM中，可以更快地响应中断
+ * 设置一个亮度来源
+ * 功能说明：远程设置、紧急照明等来源通过灯控任务的命令队列转交到这里
+ * 参数：source - 来源编号（brightness_source_t）；level - 16位感知亮度；ttlMs - 有效期（0为长期有效）
  */
-IRAM_ATTR void motionISR() {
-    isMove = true;                      // 设置运动检测标志为真（检测到运动）
-    lastMotionTime = millis();          // 记录当前时间（millis()返回系统启动后的毫秒数）
+void brightnessSetSource(uint8_t source, uint16_t level, uint32_t ttlMs) {
+    arbiterSet(&arbiter, source, level, ttlMs, millis());
 }
 
 /**
- * KEY1中断服务函数 - 手动触发运动检测
- * 功能说明：当KEY1按钮被按下时，这个函数会被自动调用，模拟运动检测
+ * 清除一个亮度来源
  */
-IRAM_ATTR void key1ISR() {
-    isMove = true;                      // 设置运动检测标志为真（模拟检测到运动）
-    lastMotionTime = millis();          // 记录当前时间
-    Serial.println("KEY1按下 - 触发运动检测");  // 输出调试信息
+void brightnessClearSource(uint8_t source) {
+    arbiterClear(&arbiter, source);
 }
 
 /**
- * KEY2中断服务函数 - 手动消除运动检测
- * 功能说明：当KEY2按钮被按下时，这个函数会被自动调用，强制取消运动检测状态
+ * 当前是否处于自动控制（没有紧急照明或远程设置生效）
  */
-IRAM_ATTR void key2ISR() {
-    isMove = false;                     // 设置运动检测标志为假（取消运动检测状态）
-    Serial.println("KEY2按下 - 消除运动检测");  // 输出调试信息
+bool brightnessIsAuto() {
+    return brightnessSource > BRIGHTNESS_SRC_REMOTE;
 }
 
 /**
  * 根据环境光强度计算基础亮度
  * 功能说明：输入环境光照度值，输出对应的LED基础亮度值
  * 参数：lux - 环境光照度值（单位：勒克斯）
- * 返回值：LED亮度值（0-255）
+ * 返回值：LED亮度值（16位感知亮度，0-65535）
  *
  * 亮度分档规则：
  * - 500lux以上：环境光充足，关闭灯光（返回0）
- * - 300-500lux：中等光线，设置为50亮度
- * - 100-300lux：较暗环境，设置为80亮度
- * - 100lux以下：很暗环境，设置为110亮度
+ * - 300-500lux：中等光线，L* ≈ 51
+ * - 100-300lux：较暗环境，L* ≈ 63
+ * - 100lux以下：很暗环境，L* ≈ 72
  */
-uint8_t calculateBaseBrightness(float Lux) {
-    if (Lux >= LUX_THRESHOLD_HIGH) {    // 如果环境光照度 >= 500lux
+uint16_t calculateBaseBrightness(float Lux) {
+    if (Lux >= brightnessTuning.luxThresholdHigh) {     // 如果环境光照度 >= 500lux
         // 环境光充足，关闭灯光
         return 0;
     }
-    else if (Lux >= LUX_THRESHOLD_MID) { // 如果环境光照度在300-500lux之间
+    else if (Lux >= brightnessTuning.luxThresholdMid) { // 如果环境光照度在300-500lux之间
         // 500lux档位：中等亮度
-        return BRIGHTNESS_HIGH_LUX;     // 返回50
+        return brightnessTuning.levelHighLux;           // 返回 L* ≈ 51
     }
-    else if (Lux >= LUX_THRESHOLD_LOW) { // 如果环境光照度在100-300lux之间
+    else if (Lux >= brightnessTuning.luxThresholdLow) { // 如果环境光照度在100-300lux之间
         // 300lux档位：较高亮度
-        return BRIGHTNESS_MID_LUX;      // 返回80
+        return brightnessTuning.levelMidLux;            // 返回 L* ≈ 63
     }
     else {                              // 如果环境光照度 < 100lux
         // 100lux档位：最高基础亮度
-        return BRIGHTNESS_LOW_LUX;      // 返回110
+        return brightnessTuning.levelLowLux;            // 返回 L* ≈ 72
     }
 }
 
 /**
  * 更新亮度值，实现平滑变化曲线
- * 功能说明：这个函数每50毫秒被调用一次，负责：
- * 1. 检查运动检测是否超时
- * 2. 决定目标亮度
- * 3. 平滑地改变当前亮度，直到达到目标亮度
+ * 功能说明：这个函数在灯控任务被唤醒时调用（变化过程中每50毫秒一次），负责：
+ * 1. 仲裁各亮度来源（过期来源自动失效），决定目标亮度
+ * 2. 平滑地改变当前亮度，直到达到目标亮度（来源切换同样经过变化曲线）
  *
- * 返回值：当前的LED亮度值（0-255）
+ * 返回值：当前的LED亮度值（16位感知亮度）
  */
-uint8_t updateBrightness() {
+uint16_t updateBrightness() {
     uint32_t currentTime = millis();    // 获取当前系统时间（毫秒）
 
-    /* ===== 步骤1：检查运动检测超时 ===== */
-    // 如果检测到运动，但距离上次检测时间已经超过5秒，则取消运动检测状态
-    if (isMove && (currentTime - lastMotionTime > motionTimeout)) {
-        isMove = false;                 // 超时后自动取消运动检测状态
-    }
+    /* ===== 步骤1：仲裁确定目标亮度 ===== */
+    // 只有当环境亮度低于500lux（即baseBrightness > 0）时才响应运动增亮，白天忽略运动来源
+    uint8_t ignoreMask = (baseBrightness > 0) ? 0 : (1U << BRIGHTNESS_SRC_MOTION);
+    brightnessSource = arbiterResolve(&arbiter, currentTime, ignoreMask, &targetBrightness);
+    // 功率预算限制（紧急照明除外）与时间表上限（只限制自动来源）
+    targetBrightness = arbiterApplyCaps(brightnessSource, targetBrightness, powerLimitLevel, scheduleCapLevel);
 
-    /* ===== 步骤2：确定目标亮度 ===== */
-    if (baseBrightness > 0 && isMove) {     // 只有当环境亮度低于500lux（即baseBrightness > 0）且检测到运动时，才升至最高亮度
-        targetBrightness = BRIGHTNESS_MAX;  // 设置目标亮度为最大值255
-    }
-    else {      // 其他情况下使用基础亮度（根据环境光计算的亮度）
-        targetBrightness = baseBrightness;
+    /* ===== 步骤2：检查是否需要开始新的亮度变化过程 ===== */
+    uint16_t difference = (targetBrightness > currentBrightness) ? targetBrightness - currentBrightness
+                                                                 : currentBrightness - targetBrightness;
+    if (!isRising && !isFalling && difference <= BRIGHTNESS_TRACK_STEP) {
+        currentBrightness = targetBrightness;           // 微小变化（闭环输出的缓慢调节）直接跟随
     }
-
-    /* ===== 步骤3：检查是否需要开始新的亮度变化过程 ===== */
-    if (targetBrightness != currentBrightness) {        // 如果目标亮度与当前亮度不同
+    else if (targetBrightness != currentBrightness) {   // 如果目标亮度与当前亮度不同
         if (targetBrightness > currentBrightness) {     // 需要增加亮度
             if (!isRising || isFalling) {               // 如果当前不在上升状态，或者正在下降，则开始新的上升过程
                 isRising = true;                        // 设置为上升状态
                 isFalling = false;                      // 取消下降状态
-                brightnessStep = 0;                     // 重置步数计数器
+                transitionStartTime = currentTime;      // 记录变化开始时间
                 startBrightness = currentBrightness;    // 记录变化开始时的亮度值
             }
         }
@@ -196,37 +350,37 @@ uint8_t updateBrightness() {
             if (!isFalling || isRising) {               // 如果当前不在下降状态，或者正在上升，则开始新的下降过程
                 isFalling = true;                       // 设置为下降状态
                 isRising = false;                       // 取消上升状态
-                brightnessStep = 0;                     // 重置步数计数器
+                transitionStartTime = currentTime;      // 记录变化开始时间
                 startBrightness = currentBrightness;    // 记录变化开始时的亮度值
             }
         }
     }
 
-    /* ===== 步骤4：执行亮度变化（使用平滑曲线算法） ===== */
+    /* ===== 步骤3：执行亮度变化（使用平滑曲线算法） ===== */
     if (isRising && currentBrightness < targetBrightness) {     // 如果正在上升且还没达到目标
-        brightnessStep++;                                       // 增加步数计数器
-        if (brightnessStep <= BRIGHTNESS_UP_STEPS) {            // 如果还在上升过程中（40步内）
+        uint32_t elapsed = currentTime - transitionStartTime;   // 已经过的变化时间
+        if (elapsed < brightnessTuning.upTimeMs) {              // 如果还在上升过程中（2秒内）
             /* 使用平滑曲线算法：y = x^2，提供更自然的亮度变化，这种曲线的特点是：开始变化慢，后面变化快，符合人眼感觉 */
-            float progress = (float) brightnessStep / (float) BRIGHTNESS_UP_STEPS;      // 计算当前进度（0.0到1.0）
+            float progress = (float) elapsed / (float) brightnessTuning.upTimeMs;       // 计算当前进度（0.0到1.0）
             progress = progress * progress;                     // 应用平方曲线：progress^2，这样开始慢后面快
             /* 根据进度计算当前亮度值，公式：起始亮度 + (目标亮度 - 起始亮度) × 进度  */
-            currentBrightness = startBrightness + (uint8_t) ((float) (targetBrightness - startBrightness) * progress);
+            currentBrightness = startBrightness + (uint16_t) ((float) (targetBrightness - startBrightness) * progress);
         }
-        else {                                      // 如果已经完成所有上升步骤
+        else {                                      // 如果上升时间已到
             currentBrightness = targetBrightness;   // 直接设置为目标亮度
             isRising = false;                       // 结束上升状态
         }
     }
     else if (isFalling && currentBrightness > targetBrightness) {   // 如果正在下降且还没达到目标
-        brightnessStep++;                                           // 增加步数计数器
-        if (brightnessStep <= BRIGHTNESS_DOWN_STEPS) {              // 如果还在下降过程中（60步内）
+        uint32_t elapsed = currentTime - transitionStartTime;       // 已经过的变化时间
+        if (elapsed < brightnessTuning.downTimeMs) {                // 如果还在下降过程中（3秒内）
             /* 使用反向平滑曲线：y = 1 - (1-x)^2，提供更自然的亮度变化，这种曲线的特点是：开始变化快，后面变化慢，适合下降过程 */
-            float progress = (float) brightnessStep / (float) BRIGHTNESS_DOWN_STEPS;    // 计算当前进度（0.0到1.0）
+            float progress = (float) elapsed / (float) brightnessTuning.downTimeMs;     // 计算当前进度（0.0到1.0）
             progress = 1.0f - (1.0f - progress) * (1.0f - progress);        // 应用反向平方曲线：1 - (1-progress)^2，这样开始快后面慢
             /* 根据进度计算当前亮度值，公式：起始亮度 - (起始亮度 - 目标亮度) × 进度 */
-            currentBrightness = startBrightness - (uint8_t) ((float) (startBrightness - targetBrightness) * progress);
+            currentBrightness = startBrightness - (uint16_t) ((float) (startBrightness - targetBrightness) * progress);
         }
-        else {                                      // 如果已经完成所有下降步骤
+        else {                                      // 如果下降时间已到
             currentBrightness = targetBrightness;   // 直接设置为目标亮度
             isFalling = false;                      // 结束下降状态
         }
@@ -239,18 +393,216 @@ uint8_t updateBrightness() {
     return currentBrightness;   // 返回当前的亮度值
 }
 
+/**
+ * 结束调试扫描：拟合自身光照模型并保存
+ */
+static void finishCommissioning() {
+    float gain = 0.0f, offset = 0.0f;
+    if (daylightFitSelfGain(sweepOutputs, sweepLux, DAYLIGHT_SWEEP_STEPS, &gain, &offset)) {
+        daylightSelfGain = gain;
+        daylight.selfGain = gain;
+        saveDaylightPrefs();
+        Serial.printf("自身光照扫描完成：增益 %.1f lux，环境照度 %.1f lux\n", gain, offset);
+    }
+    else {
+        Serial.printf("自身光照扫描失败：增益 %.1f lux 过小（传感器几乎看不到灯光），保持原参数\n", gain);
+    }
+    if (daylightMode) {
+        daylightSetOutput(&daylight, (float) perceptualToLinear(baseBrightness) / (float) PERCEPTUAL_LEVEL_MAX);
+    }
+    daylightLastUpdate = millis();
+}
+
+/**
+ * 调试扫描的一次更新
+ * 功能说明：依次以 0、25%、50%、75%、100% 线性输出直接点亮（不经过仲裁与变化曲线），
+ * 每个阶跃保持 DAYLIGHT_SWEEP_SETTLE_MS 后记录滤波照度，全部完成后拟合 lux = gain * output + offset
+ * 扫描期间环境光应保持稳定（建议夜间进行），恒定的环境光会被拟合为 offset
+ */
+static uint16_t commissioningUpdate(float Lux, uint32_t now) {
+    if (now - sweepStepStart >= DAYLIGHT_SWEEP_SETTLE_MS) {
+        sweepOutputs[sweepStep] = (float) sweepStep / (float) (DAYLIGHT_SWEEP_STEPS - 1);
+        sweepLux[sweepStep] = Lux;
+        Serial.printf("扫描阶跃 %u：输出 %.2f，照度 %.1f lux\n", sweepStep, sweepOutputs[sweepStep], Lux);
+        sweepStep++;
+        sweepStepStart = now;
+        if (sweepStep >= DAYLIGHT_SWEEP_STEPS) {
+            sweepActive = false;
+            finishCommissioning();
+            return updateBrightness();  // 从满亮经变化曲线回到正常亮度
+        }
+    }
+    currentBrightness = outputToLevel((float) sweepStep / (float) (DAYLIGHT_SWEEP_STEPS - 1));
+    isRising = false;
+    isFalling = false;
+    return currentBrightness;
+}
+
+/**
+ * 开始自身光照调试扫描
+ * 功能说明：由远程命令经灯控任务调用，扫描约 DAYLIGHT_SWEEP_STEPS * DAYLIGHT_SWEEP_SETTLE_MS 毫秒
+ */
+void brightnessStartCommissioning() {
+    sweepActive = true;
+    sweepStep = 0;
+    sweepStepStart = millis();
+    Serial.println("开始自身光照阶跃扫描");
+}
+
+/**
+ * 切换闭环日光补偿模式
+ * 参数：enable - 是否启用；targetLux - 目标照度，<= 0 时保持原目标
+ * 返回值：false 表示尚未完成调试扫描，无法启用闭环
+ */
+bool brightnessSetDaylight(bool enable, float targetLux) {
+    if (enable && daylightSelfGain < DAYLIGHT_MIN_SELF_GAIN) {
+        Serial.println("尚未完成自身光照扫描，无法启用闭环日光补偿");
+        return false;
+    }
+    if (targetLux > 0.0f) {
+        daylightTargetLux = targetLux;
+        daylight.targetLux = targetLux * brightnessVisibilityGain;
+    }
+    if (enable && !daylightMode) {      // 从开环切换到闭环：以当前基础亮度为起点，无扰切换
+        daylightSetOutput(&daylight, (float) perceptualToLinear(baseBrightness) / (float) PERCEPTUAL_LEVEL_MAX);
+        daylightLastUpdate = millis();
+    }
+    daylight.settled = false;           // 目标变化后重新调节
+    daylightMode = enable;
+    saveDaylightPrefs();
+    Serial.printf("闭环日光补偿: %d，目标照度: %.0f lux\n", enable, daylightTargetLux);
+    return true;
+}
+
+/**
+ * 设置功率预算限额
+ * 功能说明：由电源预算经灯控任务调用，限额每次只变化很小的量，目标变化小时直接跟随，不会产生可见跳变；
+ * 闭环模式下同时限制控制器输出，避免控制器在限额之上积分饱和
+ * 参数：limit - 限额（线性输出比例 0.0~1.0）
+ */
+void brightnessSetPowerLimit(float limit) {
+    if (limit < 0.0f) {
+        limit = 0.0f;
+    }
+    if (limit > 1.0f) {
+        limit = 1.0f;
+    }
+    brightnessPowerLimit = limit;
+    powerLimitLevel = outputToLevel(limit);
+    updateDaylightMaxOutput();
+}
+
+/**
+ * 设置时间表亮度上限
+ * 功能说明：由灯控任务按当天计划查表后调用，只限制运动增亮与环境光（闭环）来源，
+ * 紧急照明与远程设置不受限制；闭环模式下同时限制控制器输出
+ * 参数：level - 上限（16位感知亮度，BRIGHTNESS_MAX 表示不限制）
+ */
+void brightnessSetScheduleCap(uint16_t level) {
+    if (level == scheduleCapLevel) {
+        return;
+    }
+    scheduleCapLevel = level;
+    updateDaylightMaxOutput();
+}
+
+/**
+ * 设置能见度补偿增益
+ * 功能说明：由能见度补偿经灯控任务调用，增益每次只变化很小的量；开环时放大基础亮度的线性输出，
+ * 闭环时放大目标照度（控制器自行调节到新目标）；白天基础亮度为0时不补偿
+ * 参数：gain - 增益（线性输出倍数，>= 1.0）
+ */
+void brightnessSetVisibilityGain(float gain) {
+    if (gain < 1.0f) {
+        gain = 1.0f;
+    }
+    if (gain == brightnessVisibilityGain) {
+        return;
+    }
+    brightnessVisibilityGain = gain;
+    daylight.targetLux = daylightTargetLux * gain;
+    daylight.settled = false;
+}
+
+/**
+ * 估计不含灯自身光照的环境照度
+ * 功能说明：完成自身光照扫描后按模型扣除灯光贡献（与是否启用闭环无关），供色温曲线等使用
+ * 参数：Lux - 滤波后的实测照度
+ */
+float brightnessAmbientLux(float Lux) {
+    if (daylightSelfGain < DAYLIGHT_MIN_SELF_GAIN) {
+        return Lux;
+    }
+    return daylightAmbientEstimate(&daylight, Lux, appliedLinearOutput());
+}
+
 /**
  * 根据环境光强度计算并更新当前亮度
  * 功能说明：这是主要的对外接口函数，整合了基础亮度计算和亮度平滑更新
  * 参数：lux - 环境光照度值
- * 返回值：当前应该设置的LED亮度值
+ * 返回值：当前应该设置的LED亮度值（16位感知亮度，由 perceptualToLinear() 转换为PWM）
  *
  * 调用流程：
- * 1. 根据环境光照度计算基础亮度
+ * 1. 根据环境光照度计算基础亮度（开环分档，或闭环模式下由PI控制器给出）
  * 2. 调用亮度更新函数，实现平滑变化
  * 3. 返回最终的亮度值给LED控制系统
  */
-uint8_t calculatePerceivedBrightness(float Lux) {
-    baseBrightness = calculateBaseBrightness(Lux);  // 第一步：根据环境光更新基础亮度
-    return updateBrightness();                      // 第二步：更新并返回当前亮度值
+uint16_t calculatePerceivedBrightness(float Lux) {
+    uint32_t now = millis();
+    if (sweepActive) {                              // 调试扫描期间直接驱动输出
+        return commissioningUpdate(Lux, now);
+    }
+    if (daylightMode) {                             // 闭环：实测照度包含灯光自身贡献，由控制器扣除
+        float dt = (float) (now - daylightLastUpdate) / 1000.0f;
+        daylightLastUpdate = now;
+        baseBrightness = outputToLevel(daylightUpdate(&daylight, Lux, appliedLinearOutput(), dt));
+    }
+    else {
+        baseBrightness = calculateBaseBrightness(Lux);  // 第一步：根据环境光更新基础亮度（最低优先级来源）
+        if (baseBrightness > 0 && brightnessVisibilityGain > 1.0f) {    // 能见度补偿：按线性输出放大基础亮度
+            float boosted = (float) perceptualToLinear(baseBrightness) * brightnessVisibilityGain + 0.5f;
+            baseBrightness = linearToPerceptual(boosted < (float) PERCEPTUAL_LEVEL_MAX ? (uint16_t) boosted
+                                                                                      : PERCEPTUAL_LEVEL_MAX);
+        }
+    }
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_AMBIENT, baseBrightness, BRIGHTNESS_TTL_FOREVER, now);
+    return updateBrightness();                      // 第二步：仲裁并更新当前亮度值
+}
+
+/**
+ * 计算距下一次必须刷新亮度的时间
+ * 功能说明：灯控任务据此决定阻塞多久，没有任何变化时可以一直睡眠直到被事件唤醒
+ * 返回值：
+ * - 调试扫描中：距当前阶跃结束的时间
+ * - 正在变化：BRIGHTNESS_FRAME_MS（按50ms刷新变化曲线）
+ * - 闭环模式：调节中 DAYLIGHT_UPDATE_MS，稳定后 DAYLIGHT_CHECK_MS
+ * - 有带有效期的来源：距最近一个来源到期的时间（到期后重新仲裁）
+ * - 其他情况：BRIGHTNESS_IDLE
+ */
+uint32_t brightnessNextUpdateDelay() {
+    uint32_t now = millis();
+    if (sweepActive) {                                  // 调试扫描，在阶跃结束时醒来记录照度
+        uint32_t elapsed = now - sweepStepStart;
+        return (elapsed >= DAYLIGHT_SWEEP_SETTLE_MS) ? 1 : DAYLIGHT_SWEEP_SETTLE_MS - elapsed + 1;
+    }
+    if (isRising || isFalling) {                        // 正在变化，按帧周期刷新
+        return BRIGHTNESS_FRAME_MS;
+    }
+    uint32_t delay = BRIGHTNESS_IDLE;                   // 稳定状态，只等待事件
+    if (daylightMode) {                                 // 闭环：调节中按帧周期更新，稳定后低频复查
+        delay = daylight.settled ? DAYLIGHT_CHECK_MS : DAYLIGHT_UPDATE_MS;
+    }
+    uint32_t expiry = arbiterNextExpiry(&arbiter, now);
+    if (expiry != BRIGHTNESS_NO_EXPIRY && expiry + 1 < delay) {   // 有来源即将到期，在到期时刻醒来
+        delay = expiry + 1;                             // +1 保证醒来时已经过期
+    }
+    return delay;
+}
+
+/**
+ * 亮度是否已稳定
+ * 返回值：true 表示当前不在上升或下降过程中，且闭环控制器（如启用）已稳定
+ */
+bool brightnessIsSettled() {
+    return !isRising && !isFalling && !sweepActive && !(daylightMode && !daylight.settled);
 }
@@ -8,61 +8,126 @@
  *
  * @attention
  * 本文件为亮度控制模块头文件，包含如下内容：
- * - 亮度阈值和对应亮度档位的宏定义
+ * - 亮度阈值和对应亮度档位的宏定义（16位感知亮度单位，见 perceptualDimming.h）
  * - 亮度变化曲线参数的宏定义
- * - 运动检测和手动触发引脚的宏定义
+ * - 亮度来源（仲裁）相关参数的宏定义
  * - 全局变量声明与函数声明
  *
  * @note
- * 具体引脚定义请根据实际硬件选择
- * 立创开发板：JLC_MOTION_PIN (GPIO16), JLC_KEY1_PIN (GPIO3), JLC_KEY2_PIN (GPIO4)
- * 自制核心板：MOTION_PIN (GPIO15), KEY1_PIN (GPIO1), KEY2_PIN (GPIO2)
+ * 运动检测和手动触发引脚的定义见 motionInput.h
  */
 
 #ifndef BRIGHTNESSCONFIG_H
 #define BRIGHTNESSCONFIG_H
 
 #include <Arduino.h>
+#include "brightnessArbiter.h"
+#include "daylightController.h"
+#include "occupancyModel.h"
 
 /* 亮度阈值定义 */
 #define LUX_THRESHOLD_HIGH 500      // 500lux阈值
 #define LUX_THRESHOLD_MID 300       // 300lux阈值
 #define LUX_THRESHOLD_LOW 100       // 100lux阈值
 
-/* 对应亮度档位 */
-#define BRIGHTNESS_HIGH_LUX 50      // 500lux时的亮度
-#define BRIGHTNESS_MID_LUX 80       // 300lux时的亮度
-#define BRIGHTNESS_LOW_LUX 110      // 100lux时的亮度
-#define BRIGHTNESS_MAX 255          // 运动检测时的最高亮度
+/* 对应亮度档位（16位感知亮度 L*，数值与原 PWM 50/80/110 的稳态输出等效） */
+#define BRIGHTNESS_HIGH_LUX 33679   // 500lux时的亮度（L* ≈ 51.4）
+#define BRIGHTNESS_MID_LUX 41170    // 300lux时的亮度（L* ≈ 62.8）
+#define BRIGHTNESS_LOW_LUX 46955    // 100lux时的亮度（L* ≈ 71.6）
+#define BRIGHTNESS_MAX 65535        // 运动检测时的最高亮度
 
-/* 变化曲线参数 (50ms周期) */
-#define BRIGHTNESS_UP_STEPS 40      // 2秒上升 (2000ms / 50ms = 40步)
-#define BRIGHTNESS_DOWN_STEPS 60    // 3秒下降 (3000ms / 50ms = 60步)
+/* 变化曲线参数（按经过时间计算进度，与唤醒次数无关） */
+#define BRIGHTNESS_UP_TIME_MS 2000      // 2秒上升
+#define BRIGHTNESS_DOWN_TIME_MS 3000    // 3秒下降
+#define BRIGHTNESS_FRAME_MS 50          // 变化过程中的刷新周期（50ms）
+#define BRIGHTNESS_TRACK_STEP 1024      // 目标变化不超过此值时直接跟随（闭环输出已限速，无需再走变化曲线）
+#define BRIGHTNESS_IDLE 0xFFFFFFFFUL    // 无需定时刷新（只等待事件唤醒）
 
-/* 运动检测引脚与手动触发引脚 */
-// 立创开发板引脚定义
-#define JLC_MOTION_PIN 16
-#define JLC_KEY1_PIN 3
-#define JLC_KEY2_PIN 4
-// 自制核心板引脚定义
-#define MOTION_PIN 15
-#define KEY1_PIN 1
-#define KEY2_PIN 2
+/* 亮度来源参数 */
+#define MOTION_TIMEOUT_MS 5000                  // 运动增亮保持时间（5秒，自适应模型样本不足或关闭时使用）
+#define MOTION_HOLD_MIN_MS MOTION_TIMEOUT_MS    // 自适应保持时间下限（不短于默认值，更短的保持几乎不省电，却让慢行者中途变暗）
+#define MOTION_HOLD_MAX_MS 30000                // 自适应保持时间上限（繁忙时段）
+#define MOTION_RAMP_COST_MS 10000               // 一次熄灭再升亮的代价，折算为满亮保持时间（按到达密度放大）
+// #define MOTION_RAMP_COMFORT                  // 可选：能耗上限取3倍，繁忙时段升亮次数再减半，能耗再增加约8%
+#ifdef MOTION_RAMP_COMFORT
+#define MOTION_ENERGY_CAP 3.0f                  // 运动增亮的期望满亮时间不超过固定保持时间的倍数（偏向减少升亮次数）
+#else
+#define MOTION_ENERGY_CAP 2.0f                  // 运动增亮的期望满亮时间不超过固定保持时间的倍数
+#endif
+#define OCCUPANCY_SAVE_INTERVAL_MS 3600000UL    // 到达间隔模型保存到NVS的最短间隔（1小时）
+#define OCCUPANCY_PREFS_NAMESPACE "occupancy"   // 到达间隔模型在NVS中的命名空间
+#define BRIGHTNESS_REMOTE_TTL_DEFAULT_S 3600    // 远程设置亮度的默认有效期（1小时），到期后恢复自动控制
 
+/* 闭环日光补偿参数（控制器参数见 daylightController.h） */
+#define DAYLIGHT_TARGET_LUX_DEFAULT 100.0f  // 默认目标照度（lux）
+#define DAYLIGHT_UPDATE_MS BRIGHTNESS_FRAME_MS  // 闭环未稳定时的更新周期（与变化曲线同帧周期，调节过程中持续时间抖动）
+#define DAYLIGHT_CHECK_MS 1000              // 闭环稳定后的复查周期，修正低于唤醒阈值的缓慢照度漂移
+#define DAYLIGHT_SWEEP_STEPS 5              // 调试扫描的阶跃数（线性输出 0、25%、50%、75%、100%）
+#define DAYLIGHT_SWEEP_SETTLE_MS 1500       // 每个阶跃的保持时间，光照滤波稳定后记录
+#define DAYLIGHT_PREFS_NAMESPACE "daylight" // 闭环参数在NVS中的命名空间
+
+/* 光照滤波与唤醒阈值（传感器任务与主机仿真共用） */
+#define LUX_FILTER_ALPHA 0.3f           // 光照一阶低通滤波系数（100ms采样，时间常数约0.3s）
+#define LUX_CHANGE_RATIO 0.1f           // 滤波后光照相对变化超过10%时唤醒灯控任务
+#define LUX_CHANGE_MIN 5.0f             // 滤波后光照绝对变化超过5lux时唤醒灯控任务（低照度时使用）
+
+/* 光照滤波器状态 */
+typedef struct {
+    float filtered;             // 滤波后的光照（lux）
+    float notified;             // 上次唤醒灯控任务时的滤波光照（lux）
+} lux_filter_t;
+
+/* 可调参数（默认值为上面的宏，主机仿真在运行时修改以做参数扫描） */
+typedef struct {
+    float luxThresholdHigh;     // 高于此照度关灯（lux）
+    float luxThresholdMid;      // 中档阈值（lux）
+    float luxThresholdLow;      // 低档阈值（lux）
+    uint16_t levelHighLux;      // 中等光线时的基础亮度
+    uint16_t levelMidLux;       // 较暗环境时的基础亮度
+    uint16_t levelLowLux;       // 很暗环境时的基础亮度
+    uint16_t levelMotion;       // 运动增亮亮度
+    uint32_t upTimeMs;          // 上升时间（毫秒）
+    uint32_t downTimeMs;        // 下降时间（毫秒）
+    uint32_t motionTimeoutMs;   // 运动增亮默认保持时间（毫秒）
+    uint32_t motionHoldMinMs;   // 自适应保持时间下限（毫秒）
+    uint32_t motionHoldMaxMs;   // 自适应保持时间上限（毫秒）
+    uint32_t motionRampCostMs;  // 一次熄灭再升亮的代价（毫秒），能耗与升亮次数之间的权衡
+    float motionEnergyCap;      // 自适应保持的期望满亮时间相对固定保持时间的上限倍数
+    bool motionAdaptive;        // 是否按到达间隔统计自适应保持时间
+} brightness_tuning_t;
 
 /* 全局变量声明 */
-extern volatile bool isMove;        // 运动检测标志
-extern uint8_t currentBrightness;   // 当前实际亮度值
-extern uint8_t targetBrightness;    // 目标亮度值
-extern uint8_t baseBrightness;      // 基础亮度值（根据环境光计算）
+extern brightness_tuning_t brightnessTuning;   // 可调参数
+extern uint8_t brightnessSource;    // 当前胜出的亮度来源（brightness_source_t）
+extern uint16_t currentBrightness;  // 当前实际亮度值（16位感知亮度）
+extern uint16_t targetBrightness;   // 目标亮度值（16位感知亮度）
+extern uint16_t baseBrightness;     // 基础亮度值（根据环境光计算，16位感知亮度）
+extern bool daylightMode;           // 是否处于闭环日光补偿模式（只由灯控任务修改）
+extern float daylightTargetLux;     // 闭环目标照度（lux）
+extern uint32_t motionHoldMs;       // 最近一次运动事件采用的保持时间（毫秒）
+extern float brightnessPowerLimit;  // 功率预算限额（线性输出比例 0.0~1.0，紧急照明不受限制）
+extern float brightnessVisibilityGain;  // 能见度补偿增益（线性输出倍数，1.0 表示不补偿）
 
 /* 函数声明 */
 void brightnessInit();              // 初始化亮度控制模块
-void motionISR();                   // 运动检测中断服务函数
-void key1ISR();                     // KEY1中断服务函数 - 手动触发运动检测
-void key2ISR();                     // KEY2中断服务函数 - 手动消除运动检测
-uint8_t calculateBaseBrightness(float Lux);  // 根据环境光计算基础亮度
-uint8_t updateBrightness();         // 更新亮度值，返回当前亮度
-uint8_t calculatePerceivedBrightness(float Lux); // 总体亮度计算函数
+void luxFilterInit(lux_filter_t *filter, float lux);    // 初始化光照滤波器
+bool luxFilterUpdate(lux_filter_t *filter, float lux);  // 输入一次采样，返回 true 表示需要唤醒灯控任务
+void brightnessMotionDetected(uint32_t timeMs);  // 记录一次运动检测（PIR或KEY1）
+void brightnessMotionCleared();     // 取消运动检测状态（KEY2）
+void brightnessSetHourOfDay(int8_t hour);   // 设置当前小时（0~23，未知为-1），用于分时段的到达间隔统计
+void brightnessSetSource(uint8_t source, uint16_t level, uint32_t ttlMs);  // 设置亮度来源（带有效期）
+void brightnessClearSource(uint8_t source);     // 清除亮度来源
+bool brightnessIsAuto();            // 是否处于自动控制（无紧急照明/远程设置）
+uint16_t calculateBaseBrightness(float Lux);  // 根据环境光计算基础亮度
+uint16_t updateBrightness();        // 更新亮度值，返回当前亮度
+uint16_t calculatePerceivedBrightness(float Lux); // 总体亮度计算函数
+uint32_t brightnessNextUpdateDelay();   // 距下一次必须刷新的时间（毫秒），空闲时返回 BRIGHTNESS_IDLE
+bool brightnessIsSettled();             // 亮度是否已稳定（不在变化过程中）
+bool brightnessSetDaylight(bool enable, float targetLux);   // 切换闭环日光补偿模式（targetLux <= 0 时保持原目标）
+void brightnessStartCommissioning();    // 开始自身光照阶跃扫描（调试）
+void brightnessSetPowerLimit(float limit);  // 设置功率预算限额（线性输出比例）
+void brightnessSetScheduleCap(uint16_t level);  // 设置时间表亮度上限（只限制运动增亮与环境光）
+void brightnessSetVisibilityGain(float gain);   // 设置能见度补偿增益（放大基础亮度或闭环目标照度）
+float brightnessAmbientLux(float Lux);      // 扣除灯自身光照后的环境照度（未完成自身光照扫描时返回实测值）
 
 #endif //BRIGHTNESSCONFIG_H
\ No newline at end of file
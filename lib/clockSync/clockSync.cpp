@@ -0,0 +1,132 @@
+/**
+ * @file clockSync.cpp
+ * @brief 时钟同步模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现系统时钟的获取与保持：
+ * - 启动时系统时间无效则从NVS恢复最近一次保存的时间
+ * - SNTP校时完成时在回调中更新时间来源并立即保存
+ * - 手动设置时间（MQTT命令）直接写入系统时间并保存
+ *
+ * @note
+ * 注意事项：
+ * - SNTP回调运行在lwIP任务中，只修改 clockSource，NVS写入留给传感器任务的 clockTick()
+ */
+
+#include "clockSync.h"
+#include <Preferences.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+#include <time.h>
+
+volatile uint8_t clockSource = CLOCK_SRC_NONE;  // 当前时间来源
+static volatile bool clockDirty = false;        // 时间来源改变，需要尽快保存
+static uint32_t clockSaveTime = 0;              // 上次保存的时间（毫秒）
+
+/**
+ * 写入系统时间
+ */
+static void setSystemTime(uint32_t epoch) {
+    struct timeval tv = {};
+    tv.tv_sec = (time_t) epoch;
+    settimeofday(&tv, nullptr);
+}
+
+/**
+ * SNTP校时完成回调
+ */
+static void onTimeSync(struct timeval *tv) {
+    (void) tv;
+    clockSource = CLOCK_SRC_SNTP;
+    clockDirty = true;
+}
+
+/**
+ * 初始化时钟
+ * 功能说明：系统时间无效时从NVS恢复，随后启动SNTP（联网后自动校时）
+ */
+void clockInit() {
+    if (time(nullptr) < (time_t) CLOCK_VALID_EPOCH) {
+        Preferences prefs;
+        if (prefs.begin(CLOCK_PREFS_NAMESPACE, true)) {
+            uint32_t saved = prefs.getUInt("epoch", 0);
+            prefs.end();
+            if (saved >= CLOCK_VALID_EPOCH) {
+                setSystemTime(saved);
+                clockSource = CLOCK_SRC_RESTORED;
+                Serial.printf("时间已从NVS恢复: %u\n", (unsigned) saved);
+            }
+        }
+    }
+    else {
+        clockSource = CLOCK_SRC_MANUAL;     // 软件复位后芯片时钟仍然有效
+    }
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    configTime(0, 0, CLOCK_NTP_SERVER_1, CLOCK_NTP_SERVER_2);    // 系统时间使用UTC
+    clockSaveTime = millis();
+}
+
+/**
+ * 当前UNIX时间（秒）
+ * 返回值：未对时返回0
+ */
+uint32_t clockNow() {
+    time_t now = time(nullptr);
+    return now < (time_t) CLOCK_VALID_EPOCH ? 0 : (uint32_t) now;
+}
+
+/**
+ * 手动设置时间（SNTP校时成功后会被覆盖）
+ */
+void clockSetEpoch(uint32_t epoch) {
+    if (epoch < CLOCK_VALID_EPOCH) {
+        return;
+    }
+    setSystemTime(epoch);
+    clockSource = CLOCK_SRC_MANUAL;
+    clockDirty = true;
+}
+
+/**
+ * 周期保存有效时间（来源改变时立即保存，否则每 CLOCK_SAVE_INTERVAL_MS 一次）
+ * 返回值：true 表示时间刚被校准或设置，调用者应通知依赖时间的模块（时间表）
+ */
+bool clockTick() {
+    uint32_t now = millis();
+    bool changed = clockDirty;
+    if (!changed && now - clockSaveTime < CLOCK_SAVE_INTERVAL_MS) {
+        return false;
+    }
+    clockSaveTime = now;
+    clockDirty = false;
+    uint32_t epoch = clockNow();
+    if (epoch == 0) {
+        return changed;
+    }
+    Preferences prefs;
+    if (prefs.begin(CLOCK_PREFS_NAMESPACE, false)) {
+        prefs.putUInt("epoch", epoch);
+        prefs.end();
+    }
+    return changed;
+}
+
+/**
+ * 时间来源名称
+ */
+const char *clockSourceName(uint8_t source) {
+    switch (source) {
+        case CLOCK_SRC_RESTORED:
+            return "restored";
+        case CLOCK_SRC_MANUAL:
+            return "manual";
+        case CLOCK_SRC_SNTP:
+            return "sntp";
+        default:
+            return "none";
+    }
+}
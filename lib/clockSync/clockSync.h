@@ -0,0 +1,50 @@
+/**
+ * @file clockSync.h
+ * @brief 时钟同步模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为时钟同步模块头文件，包含如下内容：
+ * - SNTP服务器、有效时间下限、NVS保存间隔等宏定义
+ * - 时间来源枚举与当前来源声明
+ * - 时钟初始化、读取、手动设置与周期保存的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 系统时间使用UTC，时区偏移由时间表配置给出，不设置C库的 TZ
+ * - 联网时由SNTP自动校时；也可以通过MQTT命令手动设置
+ * - 最近一次的有效时间定期保存到NVS，断电重启且无法联网时从保存值恢复（停电期间的时间无法补上），
+ *   之后由芯片时钟继续走时，时间表引擎可离线运行
+ */
+
+#ifndef LIGHTPROJECT_CLOCKSYNC_H
+#define LIGHTPROJECT_CLOCKSYNC_H
+
+#include <Arduino.h>
+
+#define CLOCK_NTP_SERVER_1 "ntp.aliyun.com"     // SNTP服务器
+#define CLOCK_NTP_SERVER_2 "pool.ntp.org"       // 备用SNTP服务器
+#define CLOCK_VALID_EPOCH 1704067200UL          // 早于此时间（2024-01-01）视为未对时
+#define CLOCK_SAVE_INTERVAL_MS 3600000UL        // 有效时间保存到NVS的间隔（1小时）
+#define CLOCK_PREFS_NAMESPACE "clock"           // 时间在NVS中的命名空间
+
+/* 时间来源 */
+typedef enum {
+    CLOCK_SRC_NONE = 0,         // 未对时
+    CLOCK_SRC_RESTORED,         // 从NVS恢复（断电期间的时间丢失，可能偏慢）
+    CLOCK_SRC_MANUAL,           // 手动设置
+    CLOCK_SRC_SNTP              // SNTP校时
+} clock_source_t;
+
+extern volatile uint8_t clockSource;    // 当前时间来源（clock_source_t）
+
+void clockInit();                       // 从NVS恢复时间并启动SNTP（需在WiFi初始化之后调用）
+uint32_t clockNow();                    // 当前UNIX时间（秒），未对时返回0
+void clockSetEpoch(uint32_t epoch);     // 手动设置时间并保存
+bool clockTick();                       // 周期保存有效时间（在传感器任务中调用），返回 true 表示时间刚改变
+const char *clockSourceName(uint8_t source);    // 时间来源名称（用于日志与上报）
+
+#endif //LIGHTPROJECT_CLOCKSYNC_H
@@ -0,0 +1,231 @@
+/**
+ * @file colorTemperature.cpp
+ * @brief 色温（可调白光）模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现色温到WS2812三通道输出的转换：
+ * - 查找表：按黑体辐射近似公式（Tanner Helland 拟合）求出各色温的sRGB白点，去伽马得到线性值，
+ *   乘以WS2812各通道的白平衡校正，再归一化使最大通道为 65535
+ * - 每帧：色温在相邻表项之间整数插值得到通道增益，线性亮度乘以增益后分别抖动为8位输出
+ * - 色温曲线：分段线性，按照度（黄昏偏冷、深夜偏暖）或按时间（跨越午夜循环）
+ * - 引擎：目标色温变化时按 CCT_SLEW_K_PER_S 平滑过渡，过渡期间灯控任务需要持续刷新
+ *
+ * @note
+ * 注意事项：
+ * - 按照度的曲线应使用扣除灯自身光照后的环境照度（见 brightnessAmbientLux()），否则夜间会被自身灯光推向冷白
+ * - 时间曲线在对时之前不可用，引擎自动退回按照度的曲线
+ */
+
+#include "colorTemperature.h"
+#include <cmath>
+
+static cct_gains_t cctLut[CCT_LUT_SIZE];    // 色温 -> 通道增益查找表
+
+/* 默认色温曲线：黄昏（照度较高）偏冷，夜深（照度很低）偏暖 */
+cct_curve_t cctLuxCurve = {
+    {{0.0f, 3000}, {5.0f, 3000}, {50.0f, 4000}, {200.0f, 5000}},
+    4, false, 0.0f
+};
+
+/* 默认时间曲线（一天中的分钟数）：傍晚 5000K，22点后逐渐转暖，凌晨 2700K，清晨回到冷白 */
+cct_curve_t cctTimeCurve = {
+    {{0.0f, 2700}, {300.0f, 2700}, {420.0f, 4500}, {1020.0f, 5000}, {1200.0f, 4500}, {1320.0f, 3500}},
+    6, true, 1440.0f
+};
+
+/**
+ * sRGB 编码值（0~255）转换为线性值（0.0~1.0）
+ */
+static float srgbToLinear(float value) {
+    float v = value / 255.0f;
+    if (v <= 0.04045f) {
+        return v / 12.92f;
+    }
+    return powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+/**
+ * 将数值限制在 0~255
+ */
+static float clampChannel(float value) {
+    if (value < 0.0f) {
+        return 0.0f;
+    }
+    if (value > 255.0f) {
+        return 255.0f;
+    }
+    return value;
+}
+
+/**
+ * 生成色温 -> 通道增益查找表
+ * 功能说明：启动时调用一次（使用浮点运算与 powf/logf），之后查询只做整数运算
+ * 黑体白点（sRGB，t = 色温 / 100）：
+ * - R：t <= 66 时为 255，否则 329.70 * (t - 60)^-0.1332
+ * - G：t <= 66 时为 99.47 * ln(t) - 161.12，否则 288.12 * (t - 60)^-0.0755
+ * - B：t >= 66 时为 255，t <= 19 时为 0，否则 138.52 * ln(t - 10) - 305.04
+ */
+void colorTemperatureInit() {
+    for (int i = 0; i < CCT_LUT_SIZE; i++) {
+        float t = (float) (CCT_MIN_K + i * CCT_LUT_STEP_K) / 100.0f;
+        float red, green, blue;
+        if (t <= 66.0f) {
+            red = 255.0f;
+            green = 99.4708025861f * logf(t) - 161.1195681661f;
+        }
+        else {
+            red = 329.698727446f * powf(t - 60.0f, -0.1332047592f);
+            green = 288.1221695283f * powf(t - 60.0f, -0.0755148492f);
+        }
+        if (t >= 66.0f) {
+            blue = 255.0f;
+        }
+        else if (t <= 19.0f) {
+            blue = 0.0f;
+        }
+        else {
+            blue = 138.5177312231f * logf(t - 10.0f) - 305.0447927307f;
+        }
+
+        /* 线性化并做白平衡校正（发光效率高的通道需要的占空比更低） */
+        float r = srgbToLinear(clampChannel(red)) * (float) CCT_BALANCE_R / 255.0f;
+        float g = srgbToLinear(clampChannel(green)) * (float) CCT_BALANCE_G / 255.0f;
+        float b = srgbToLinear(clampChannel(blue)) * (float) CCT_BALANCE_B / 255.0f;
+        float peak = r > g ? r : g;
+        peak = peak > b ? peak : b;
+        cctLut[i].r = (uint16_t) (r / peak * 65535.0f + 0.5f);
+        cctLut[i].g = (uint16_t) (g / peak * 65535.0f + 0.5f);
+        cctLut[i].b = (uint16_t) (b / peak * 65535.0f + 0.5f);
+    }
+}
+
+/**
+ * 查询色温对应的通道增益
+ * 参数：kelvin - 色温（K），超出范围时取边界值；gains - 输出：三通道增益（16位定点数）
+ */
+void cctGains(uint16_t kelvin, cct_gains_t *gains) {
+    if (kelvin <= CCT_MIN_K) {
+        *gains = cctLut[0];
+        return;
+    }
+    if (kelvin >= CCT_MAX_K) {
+        *gains = cctLut[CCT_LUT_SIZE - 1];
+        return;
+    }
+    uint16_t offset = kelvin - CCT_MIN_K;
+    uint16_t index = offset / CCT_LUT_STEP_K;
+    int32_t frac = offset % CCT_LUT_STEP_K;
+    const cct_gains_t *low = &cctLut[index];
+    const cct_gains_t *high = &cctLut[index + 1];
+    gains->r = (uint16_t) (low->r + ((int32_t) high->r - low->r) * frac / CCT_LUT_STEP_K);
+    gains->g = (uint16_t) (low->g + ((int32_t) high->g - low->g) * frac / CCT_LUT_STEP_K);
+    gains->b = (uint16_t) (low->b + ((int32_t) high->b - low->b) * frac / CCT_LUT_STEP_K);
+}
+
+/**
+ * 计算曲线上的色温
+ * 功能说明：分段线性插值，超出曲线两端时取端点值；循环曲线在最后一点与下一周期第一点之间插值
+ * 参数：x - 自变量（照度或分钟数）
+ * 返回值：色温（K），曲线为空时返回 CCT_DEFAULT_K
+ */
+uint16_t cctCurveEval(const cct_curve_t *curve, float x) {
+    if (curve->count == 0) {
+        return CCT_DEFAULT_K;
+    }
+    const cct_point_t *first = &curve->points[0];
+    const cct_point_t *last = &curve->points[curve->count - 1];
+    if (x < first->x || x >= last->x) {
+        if (!curve->wrap) {
+            return x < first->x ? first->kelvin : last->kelvin;
+        }
+        /* 循环曲线：在最后一点与下一周期的第一点之间插值 */
+        float span = first->x + curve->period - last->x;
+        float pos = (x >= last->x) ? x - last->x : x + curve->period - last->x;
+        if (span <= 0.0f) {
+            return last->kelvin;
+        }
+        return (uint16_t) ((float) last->kelvin + ((float) first->kelvin - (float) last->kelvin) * pos / span);
+    }
+    for (uint8_t i = 1; i < curve->count; i++) {
+        const cct_point_t *high = &curve->points[i];
+        if (x < high->x) {
+            const cct_point_t *low = &curve->points[i - 1];
+            float t = (x - low->x) / (high->x - low->x);
+            return (uint16_t) ((float) low->kelvin + ((float) high->kelvin - (float) low->kelvin) * t);
+        }
+    }
+    return last->kelvin;
+}
+
+/**
+ * 初始化色温引擎（自动模式，首次更新时直接跳到目标色温）
+ */
+void cctEngineInit(cct_engine_t *engine, uint32_t nowMs) {
+    engine->mode = CCT_MODE_AUTO;
+    engine->fixedKelvin = CCT_DEFAULT_K;
+    engine->minuteOfDay = -1;
+    engine->kelvin = 0.0f;
+    engine->targetKelvin = CCT_DEFAULT_K;
+    engine->lastMs = nowMs;
+    engine->settled = false;
+}
+
+/**
+ * 设置固定色温
+ * 参数：kelvin - 色温（K），0 表示恢复自动曲线
+ */
+void cctEngineSetFixed(cct_engine_t *engine, uint16_t kelvin) {
+    if (kelvin == 0) {
+        engine->mode = CCT_MODE_AUTO;
+    }
+    else {
+        engine->mode = CCT_MODE_FIXED;
+        engine->fixedKelvin = kelvin < CCT_MIN_K ? CCT_MIN_K : (kelvin > CCT_MAX_K ? CCT_MAX_K : kelvin);
+    }
+    engine->settled = false;
+}
+
+/**
+ * 更新色温引擎
+ * 功能说明：按模式计算目标色温，当前色温以 CCT_SLEW_K_PER_S 向目标靠近，每帧调用一次
+ * 参数：lux - 滤波后的环境照度；nowMs - 当前时间
+ * 返回值：当前色温（K）
+ */
+uint16_t cctEngineUpdate(cct_engine_t *engine, float lux, uint32_t nowMs) {
+    if (engine->mode == CCT_MODE_FIXED) {
+        engine->targetKelvin = engine->fixedKelvin;
+    }
+    else if (engine->minuteOfDay >= 0) {
+        engine->targetKelvin = cctCurveEval(&cctTimeCurve, (float) engine->minuteOfDay);
+    }
+    else {
+        engine->targetKelvin = cctCurveEval(&cctLuxCurve, lux);
+    }
+
+    float target = (float) engine->targetKelvin;
+    if (engine->kelvin <= 0.0f) {
+        engine->kelvin = target;                    // 首次更新，直接使用目标色温
+    }
+    else {
+        uint32_t elapsed = nowMs - engine->lastMs;
+        if (elapsed > CCT_MAX_DT_MS) {
+            elapsed = CCT_MAX_DT_MS;
+        }
+        float maxStep = CCT_SLEW_K_PER_S * (float) elapsed / 1000.0f;
+        float delta = target - engine->kelvin;
+        if (delta > maxStep) {
+            delta = maxStep;
+        }
+        else if (delta < -maxStep) {
+            delta = -maxStep;
+        }
+        engine->kelvin += delta;
+    }
+    engine->lastMs = nowMs;
+    engine->settled = (engine->kelvin == target);
+    return (uint16_t) (engine->kelvin + 0.5f);
+}
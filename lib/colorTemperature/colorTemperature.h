@@ -0,0 +1,96 @@
+/**
+ * @file colorTemperature.h
+ * @brief 色温（可调白光）模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为色温模块头文件，包含如下内容：
+ * - 色温范围与查找表尺寸的宏定义
+ * - 色温 -> RGB 通道增益查找表的生成与查询函数声明
+ * - 按照度或按时间的色温曲线，以及色温平滑过渡（引擎）的结构体与函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 通道增益为16位定点数（65535 = 1.0），已按WS2812各通道发光强度做白平衡，最大通道为 65535
+ * - 查找表在 colorTemperatureInit() 中用浮点生成一次，之后每帧只做整数插值与乘法
+ * - 各色温下最大通道满输出，暖色时蓝/绿通道较低，同一亮度下暖光略暗，夜间降低色温时同时减少能耗与眩光
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_COLORTEMPERATURE_H
+#define LIGHTPROJECT_COLORTEMPERATURE_H
+
+#include <cstdint>
+
+/* 色温范围与查找表 */
+#define CCT_MIN_K 1800                  // 最低色温（K）
+#define CCT_MAX_K 6500                  // 最高色温（K）
+#define CCT_LUT_STEP_K 100              // 查找表间隔（K），表项之间线性插值
+#define CCT_LUT_SIZE ((CCT_MAX_K - CCT_MIN_K) / CCT_LUT_STEP_K + 1)    // 48项
+#define CCT_DEFAULT_K 4000              // 没有曲线或曲线不可用时的色温
+
+/* WS2812 白平衡校正（各通道相对发光效率，同 FastLED TypicalLEDStrip） */
+#define CCT_BALANCE_R 255
+#define CCT_BALANCE_G 176
+#define CCT_BALANCE_B 240
+
+/* 色温过渡 */
+#define CCT_SLEW_K_PER_S 100            // 色温变化速率（K/s），2000K 的变化约20秒完成，不可察觉
+#define CCT_MAX_DT_MS 1000              // 单次更新允许的最大时间间隔，长时间休眠后醒来也只前进一步
+#define CCT_MAX_CURVE_POINTS 8          // 每条曲线的最大点数
+
+/* 线性亮度乘以通道增益（16位定点数，四舍五入） */
+#define CCT_SCALE(linear, gain) ((uint16_t) (((uint32_t) (linear) * (gain) + 32767U) / 65535U))
+
+/* 色温模式 */
+typedef enum {
+    CCT_MODE_AUTO = 0,      // 时间已知时按时间曲线，否则按照度曲线
+    CCT_MODE_FIXED          // 固定色温（远程设置）
+} cct_mode_t;
+
+/* 色温曲线点（自变量为照度 lux 或一天中的分钟数） */
+typedef struct {
+    float x;                // 自变量
+    uint16_t kelvin;        // 色温（K）
+} cct_point_t;
+
+/* 分段线性色温曲线（点按 x 升序排列） */
+typedef struct {
+    cct_point_t points[CCT_MAX_CURVE_POINTS];
+    uint8_t count;          // 点数
+    bool wrap;              // 自变量是否循环（按时间的曲线跨越午夜）
+    float period;           // 循环周期（wrap 为 true 时有效）
+} cct_curve_t;
+
+/* RGB 通道增益（16位定点数） */
+typedef struct {
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+} cct_gains_t;
+
+/* 色温引擎状态（只由灯控任务修改） */
+typedef struct {
+    uint8_t mode;           // cct_mode_t
+    uint16_t fixedKelvin;   // 固定色温（K）
+    int16_t minuteOfDay;    // 一天中的分钟数（0~1439），未知为-1
+    float kelvin;           // 当前色温（K，过渡中）
+    uint16_t targetKelvin;  // 目标色温（K）
+    uint32_t lastMs;        // 上次更新时间（毫秒）
+    bool settled;           // 当前色温已到达目标
+} cct_engine_t;
+
+extern cct_curve_t cctLuxCurve;     // 按照度的色温曲线（黄昏偏冷，深夜偏暖）
+extern cct_curve_t cctTimeCurve;    // 按时间的色温曲线（分钟数，跨越午夜）
+
+void colorTemperatureInit();                                // 生成色温 -> 通道增益查找表
+void cctGains(uint16_t kelvin, cct_gains_t *gains);         // 查询色温对应的通道增益（整数插值）
+uint16_t cctCurveEval(const cct_curve_t *curve, float x);   // 计算曲线上的色温
+void cctEngineInit(cct_engine_t *engine, uint32_t nowMs);
+void cctEngineSetFixed(cct_engine_t *engine, uint16_t kelvin);  // 固定色温，0 表示恢复自动
+uint16_t cctEngineUpdate(cct_engine_t *engine, float lux, uint32_t nowMs);   // 更新并返回当前色温
+
+#endif //LIGHTPROJECT_COLORTEMPERATURE_H
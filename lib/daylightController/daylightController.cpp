@@ -0,0 +1,157 @@
+/**
+ * @file daylightController.cpp
+ * @brief 闭环日光补偿控制器实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现保持目标照度的PI控制器：
+ * - 误差 e = (目标照度 - 实测照度) / selfGain，即“还差多少输出”，环路增益与安装位置无关
+ * - 输出 = Kp * e + 积分，限幅到 0~上限（功率预算）并限制变化速率
+ * - 抗积分饱和采用积分跟踪：输出被限幅或限速时，把积分回算为 输出 - Kp * e
+ * - 自身光照补偿：实际输出与控制器输出不同时（运动增亮、远程设置等），
+ *   按 selfGain * (实际输出 - 控制器输出) 从实测照度中扣除，控制器不会因灯自身变亮而误调
+ * - 开环分档控制在传感器能看到灯光时会自激振荡，闭环控制把灯光本身计入被控照度，从而避免振荡
+ *
+ * @note
+ * 注意事项：
+ * - 控制器只做浮点标量运算，每次传感器采样调用一次（约100ms）
+ * - selfGain 由调试时的阶跃扫描拟合得到，拟合失败（增益过小）时不应启用闭环
+ */
+
+#include "daylightController.h"
+
+/**
+ * 将数值限制在 [low, high] 范围内
+ */
+static float clampFloat(float value, float low, float high) {
+    if (value < low) {
+        return low;
+    }
+    if (value > high) {
+        return high;
+    }
+    return value;
+}
+
+/**
+ * 初始化控制器
+ * 参数：targetLux - 目标照度；selfGain - 自身光照增益（lux）
+ */
+void daylightInit(daylight_controller_t *ctrl, float targetLux, float selfGain) {
+    ctrl->targetLux = targetLux;
+    ctrl->selfGain = selfGain < DAYLIGHT_MIN_SELF_GAIN ? DAYLIGHT_MIN_SELF_GAIN : selfGain;
+    ctrl->integral = 0.0f;
+    ctrl->output = 0.0f;
+    ctrl->maxOutput = 1.0f;
+    ctrl->settled = false;
+}
+
+/**
+ * 无扰切换：从其他控制方式接管时，以当前实际输出作为起点
+ * 参数：output - 当前实际输出（线性占空比 0.0~1.0）
+ */
+void daylightSetOutput(daylight_controller_t *ctrl, float output) {
+    ctrl->output = clampFloat(output, 0.0f, ctrl->maxOutput);
+    ctrl->integral = ctrl->output;      // 误差为零时输出保持不变
+    ctrl->settled = false;
+}
+
+/**
+ * 设置输出上限
+ * 功能说明：上限降低时输出按限速逐渐降到上限以下，不会突变
+ * 参数：maxOutput - 输出上限（线性占空比 0.0~1.0）
+ */
+void daylightSetMaxOutput(daylight_controller_t *ctrl, float maxOutput) {
+    ctrl->maxOutput = clampFloat(maxOutput, 0.0f, 1.0f);
+    ctrl->settled = false;
+}
+
+/**
+ * 控制器更新
+ * 参数：measuredLux - 实测照度（含灯光自身贡献）
+ *       appliedOutput - 灯当前实际输出（线性占空比），可能被更高优先级的来源改变
+ *       dtS - 距上次更新的时间（秒）
+ * 返回值：新的输出（线性占空比 0.0~1.0）
+ */
+float daylightUpdate(daylight_controller_t *ctrl, float measuredLux, float appliedOutput, float dtS) {
+    dtS = clampFloat(dtS, 0.0f, DAYLIGHT_MAX_DT);
+
+    /* 自身光照补偿：换算成“灯按控制器输出点亮时”应测到的照度 */
+    float compensatedLux = measuredLux - ctrl->selfGain * (appliedOutput - ctrl->output);
+
+    /* 归一化误差，减去死区宽度（连续死区，进出死区时输出不跳变） */
+    float error = (ctrl->targetLux - compensatedLux) / ctrl->selfGain;
+    float deadband = ctrl->targetLux * DAYLIGHT_DEADBAND / ctrl->selfGain;
+    if (error > deadband) {
+        error -= deadband;
+    }
+    else if (error < -deadband) {
+        error += deadband;
+    }
+    else {
+        error = 0.0f;
+    }
+
+    /* PI计算：先积分，再求未限幅输出 */
+    float integral = ctrl->integral + DAYLIGHT_KI * error * dtS;
+    float command = DAYLIGHT_KP * error + integral;
+
+    /* 限幅与限速：相对速率限制使变化在感知上均匀，最小速率保证低输出时也能调节 */
+    float limited = clampFloat(command, 0.0f, ctrl->maxOutput);
+    float maxStep = ctrl->output * DAYLIGHT_MAX_REL_RATE * dtS;
+    if (maxStep < DAYLIGHT_MIN_RATE * dtS) {
+        maxStep = DAYLIGHT_MIN_RATE * dtS;
+    }
+    float output = clampFloat(limited, ctrl->output - maxStep, ctrl->output + maxStep);
+
+    /* 抗积分饱和：输出被限幅或限速时，积分跟踪实际输出 */
+    if (output != command) {
+        integral = output - DAYLIGHT_KP * error;
+    }
+
+    /* 稳定判断：没有被限速（仍在爬坡）且输出几乎不再变化 */
+    float change = output - ctrl->output;
+    ctrl->settled = (output == limited && change < DAYLIGHT_SETTLE_DELTA && change > -DAYLIGHT_SETTLE_DELTA);
+    ctrl->integral = integral;
+    ctrl->output = output;
+    return output;
+}
+
+/**
+ * 估计不含灯光自身贡献的环境照度
+ * 参数：measuredLux - 实测照度；appliedOutput - 灯当前实际输出（线性占空比）
+ * 返回值：环境照度估计值（lux）
+ */
+float daylightAmbientEstimate(const daylight_controller_t *ctrl, float measuredLux, float appliedOutput) {
+    float ambient = measuredLux - ctrl->selfGain * appliedOutput;
+    return ambient < 0.0f ? 0.0f : ambient;
+}
+
+/**
+ * 由阶跃扫描数据拟合自身光照模型 lux = gain * output + offset（最小二乘）
+ * 参数：outputs - 各阶跃的线性输出（0.0~1.0）；luxes - 各阶跃稳定后的照度；count - 数据点数
+ *       gain - 输出：自身光照增益（lux）；offset - 输出：扫描期间的环境照度（lux）
+ * 返回值：true 表示拟合成功且增益足够闭环使用
+ */
+bool daylightFitSelfGain(const float *outputs, const float *luxes, int count, float *gain, float *offset) {
+    if (count < 2) {
+        return false;
+    }
+    float sumX = 0.0f, sumY = 0.0f, sumXX = 0.0f, sumXY = 0.0f;
+    for (int i = 0; i < count; i++) {
+        sumX += outputs[i];
+        sumY += luxes[i];
+        sumXX += outputs[i] * outputs[i];
+        sumXY += outputs[i] * luxes[i];
+    }
+    float denominator = (float) count * sumXX - sumX * sumX;
+    if (denominator <= 0.0f) {
+        return false;               // 输出没有变化，无法拟合
+    }
+    *gain = ((float) count * sumXY - sumX * sumY) / denominator;
+    *offset = (sumY - *gain * sumX) / (float) count;
+    return *gain >= DAYLIGHT_MIN_SELF_GAIN;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file daylightController.h
+ * @brief 闭环日光补偿控制器头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为闭环日光补偿（daylight harvesting）控制器头文件，包含如下内容：
+ * - PI控制器参数宏定义与控制器结构体
+ * - 控制器更新、环境光估计函数声明
+ * - 自身光照模型（阶跃扫描）拟合函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 控制器输出为线性占空比（0.0~1.0），由调用者转换为感知亮度
+ * - 自身光照增益 selfGain 表示灯满亮时传感器额外测到的照度（lux），在调试时通过阶跃扫描拟合
+ * - 误差按 selfGain 归一化，使不同灯杆（传感器与灯的相对位置不同）的环路增益一致
+ * - 实际输出可能高于控制器输出（如运动增亮），更新时用自身光照模型扣除多出的灯光
+ * - 输出上限由功率预算给出，上限以内才参与积分，电量不足时不会积分饱和
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_DAYLIGHTCONTROLLER_H
+#define LIGHTPROJECT_DAYLIGHTCONTROLLER_H
+
+#include <cstdint>
+
+/* PI参数（按 selfGain 归一化后的无量纲增益） */
+#define DAYLIGHT_KP 0.3f                // 比例增益
+#define DAYLIGHT_KI 0.5f                // 积分增益（1/s）
+#define DAYLIGHT_DEADBAND 0.02f         // 误差死区（目标照度的2%），避免稳态下输出持续微调
+#define DAYLIGHT_MAX_REL_RATE 0.1f      // 输出最大相对变化速率（每秒10%），远低于人眼可察觉的变化
+#define DAYLIGHT_MIN_RATE 0.005f        // 输出最小变化速率（每秒0.5%满量程），保证从0附近也能起步
+#define DAYLIGHT_SETTLE_DELTA 0.0005f   // 单次更新输出变化小于此值视为稳定（灯控任务可停止定时更新）
+#define DAYLIGHT_MAX_DT 1.0f            // 单次更新允许的最大时间间隔（秒），防止长时间休眠后积分突变
+#define DAYLIGHT_MIN_SELF_GAIN 1.0f     // 最小可用自身光照增益（lux），传感器几乎看不到灯时无法闭环
+
+/* 控制器状态 */
+typedef struct {
+    float targetLux;        // 目标照度（lux）
+    float selfGain;         // 自身光照增益：灯满亮时传感器测到的额外照度（lux）
+    float integral;         // 积分项（输出单位）
+    float output;           // 当前输出（线性占空比 0.0~1.0）
+    float maxOutput;        // 输出上限（功率预算限额，默认1.0）
+    bool settled;           // 输出已稳定（未被限速且最近一次更新几乎没有变化）
+} daylight_controller_t;
+
+void daylightInit(daylight_controller_t *ctrl, float targetLux, float selfGain);
+void daylightSetOutput(daylight_controller_t *ctrl, float output);
+void daylightSetMaxOutput(daylight_controller_t *ctrl, float maxOutput);
+float daylightUpdate(daylight_controller_t *ctrl, float measuredLux, float appliedOutput, float dtS);
+float daylightAmbientEstimate(const daylight_controller_t *ctrl, float measuredLux, float appliedOutput);
+bool daylightFitSelfGain(const float *outputs, const float *luxes, int count, float *gain, float *offset);
+
+#endif //LIGHTPROJECT_DAYLIGHTCONTROLLER_H
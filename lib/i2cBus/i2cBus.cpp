@@ -0,0 +1,223 @@
+/**
+ * @file i2cBus.cpp
+ * @brief I2C总线管理模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现I2C总线任务与故障恢复：
+ * - 调用者把请求（事务函数、参数、入队时间与完成信号量）的指针放入对应优先级的队列，再给总线任务一个通知计数
+ * - 总线任务每取得一个计数，从高优先级队列开始取出一个请求执行，记录统计后释放完成信号量
+ * - 完成信号量为调用者栈上的静态信号量，不占用堆；总线任务释放信号量后不再访问请求
+ * - 总线恢复：卸载驱动，把SCL作为开漏输出逐个输出时钟，直到从机释放SDA（最多9个），再产生STOP，然后重新初始化 Wire
+ *
+ * @note
+ * 注意事项：
+ * - 统计由总线任务写入、MQTT任务读取，由 statsMux 保护
+ * - 事务函数应返回实际的访问结果，失败的事务才会触发总线检查
+ */
+
+#include "i2cBus.h"
+#include <Wire.h>
+#include <esp_timer.h>
+
+/* 事务请求（位于调用者栈上，调用者等待到执行完毕） */
+typedef struct {
+    uint8_t device;                         // 设备编号
+    i2c_job_t job;                          // 事务函数
+    void *context;                          // 事务参数
+    int64_t queuedUs;                       // 入队时间（微秒）
+    SemaphoreHandle_t done;                 // 完成信号量
+    bool result;                            // 执行结果
+} i2c_request_t;
+
+TaskHandle_t xI2cBusHandle = nullptr;       // 总线任务句柄
+static QueueHandle_t requestQueues[I2C_PRIORITIES] = {};    // 各优先级的请求队列（元素为请求指针）
+static i2c_device_stats_t deviceStats[I2C_DEVICES] = {};
+static i2c_bus_stats_t busStats = {};
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+static int busSda = -1;                     // SDA引脚
+static int busScl = -1;                     // SCL引脚
+static uint32_t busFrequency = I2C_BUS_FREQ_HZ;
+static uint8_t consecutiveErrors = 0;       // 连续失败的事务数（只由执行事务的上下文修改）
+
+static const char *const deviceNames[I2C_DEVICES] = {"bh1750", "aht20", "oled"};
+
+/**
+ * 初始化 Wire 与事务队列（在 setup 中、访问任何I2C设备前调用）
+ */
+void i2cBusInit(int sda, int scl, uint32_t frequency) {
+    busSda = sda;
+    busScl = scl;
+    busFrequency = frequency;
+    Wire.begin(sda, scl, frequency);
+    for (uint8_t i = 0; i < I2C_PRIORITIES; i++) {
+        requestQueues[i] = xQueueCreate(I2C_BUS_QUEUE_SIZE, sizeof(i2c_request_t *));
+        if (requestQueues[i] == nullptr) {
+            Serial.println("I2C事务队列创建失败");
+        }
+    }
+}
+
+/**
+ * SDA 或 SCL 是否被拉低（总线空闲时两条线都应为高电平）
+ */
+static bool busLineLow() {
+    return digitalRead(busSda) == LOW || digitalRead(busScl) == LOW;
+}
+
+/**
+ * 恢复总线：clockOut 为 true 时先输出SCL时钟与STOP释放被从机拉低的SDA，然后重新初始化驱动
+ */
+static void busRecover(bool clockOut) {
+    Wire.end();
+    if (clockOut) {
+        digitalWrite(busScl, HIGH);
+        pinMode(busScl, OUTPUT_OPEN_DRAIN);
+        pinMode(busSda, INPUT_PULLUP);
+        for (uint8_t i = 0; i < I2C_BUS_RECOVERY_CLOCKS && digitalRead(busSda) == LOW; i++) {
+            digitalWrite(busScl, LOW);          // 从机在每个时钟移出一位，直到释放SDA
+            delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+            digitalWrite(busScl, HIGH);
+            delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+        }
+        /* STOP：SCL为高时SDA由低变高，从机回到空闲状态 */
+        digitalWrite(busScl, LOW);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+        digitalWrite(busSda, LOW);
+        pinMode(busSda, OUTPUT_OPEN_DRAIN);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+        digitalWrite(busScl, HIGH);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+        digitalWrite(busSda, HIGH);
+        delayMicroseconds(I2C_BUS_RECOVERY_HALF_US);
+    }
+    Wire.begin(busSda, busScl, busFrequency);
+    bool stuck = busLineLow();
+    portENTER_CRITICAL(&statsMux);
+    busStats.recoveries++;
+    busStats.stuck = stuck;
+    portEXIT_CRITICAL(&statsMux);
+    Serial.printf("I2C总线已重新初始化%s\n", stuck ? "，总线仍被拉低" : "");
+}
+
+/**
+ * 执行一个事务并记录统计，失败时检查总线
+ */
+static bool execute(uint8_t device, i2c_job_t job, void *context, int64_t queuedUs) {
+    int64_t start = esp_timer_get_time();
+    bool ok = job(context);
+    int64_t end = esp_timer_get_time();
+    uint32_t busyUs = (uint32_t) (end - start);
+    uint32_t waitUs = (uint32_t) (start - queuedUs);
+
+    portENTER_CRITICAL(&statsMux);
+    i2c_device_stats_t *stats = &deviceStats[device];
+    stats->transactions++;
+    if (!ok) {
+        stats->errors++;
+    }
+    stats->lastUs = busyUs;
+    stats->totalUs += busyUs;
+    if (busyUs > stats->maxUs) {
+        stats->maxUs = busyUs;
+    }
+    if (waitUs > stats->maxWaitUs) {
+        stats->maxWaitUs = waitUs;
+    }
+    portEXIT_CRITICAL(&statsMux);
+
+    if (ok) {
+        consecutiveErrors = 0;
+        return true;
+    }
+    consecutiveErrors++;
+    bool low = busLineLow();
+    if (low) {
+        portENTER_CRITICAL(&statsMux);
+        busStats.stuckFaults++;
+        portEXIT_CRITICAL(&statsMux);
+    }
+    if (low || consecutiveErrors >= I2C_BUS_REINIT_ERRORS) {
+        busRecover(low);
+        consecutiveErrors = 0;
+    }
+    return false;
+}
+
+/**
+ * 提交事务并等待执行完毕
+ * 参数：device - 设备编号（统计用）；priority - I2C_PRIO_*；job、context - 事务函数与参数
+ * 返回值：事务函数的结果
+ */
+bool i2cBusRun(uint8_t device, uint8_t priority, i2c_job_t job, void *context) {
+    if (device >= I2C_DEVICES || priority >= I2C_PRIORITIES || job == nullptr) {
+        return false;
+    }
+    int64_t now = esp_timer_get_time();
+    if (xI2cBusHandle == nullptr || xTaskGetCurrentTaskHandle() == xI2cBusHandle
+        || requestQueues[priority] == nullptr) {        // 总线任务尚未创建或在总线任务中：直接执行
+        return execute(device, job, context, now);
+    }
+    StaticSemaphore_t doneBuffer;
+    i2c_request_t request = {device, job, context, now, xSemaphoreCreateBinaryStatic(&doneBuffer), false};
+    i2c_request_t *pointer = &request;
+    xQueueSend(requestQueues[priority], &pointer, portMAX_DELAY);
+    xTaskNotifyGive(xI2cBusHandle);                     // 每个请求一个通知计数
+    xSemaphoreTake(request.done, portMAX_DELAY);        // 事务都有超时，总线任务总会释放信号量
+    vSemaphoreDelete(request.done);
+    return request.result;
+}
+
+/*
+ * ———————— I2C总线任务 ————————
+ * 平时阻塞等待通知；每个通知计数对应一个请求，传感器队列中的请求先于屏幕刷新执行
+ */
+void i2cBusTask(void *pvParameters) {
+    (void) pvParameters;
+    while (true) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);       // 取走一个计数
+        i2c_request_t *request = nullptr;
+        for (uint8_t i = 0; i < I2C_PRIORITIES; i++) {
+            if (xQueueReceive(requestQueues[i], &request, 0) == pdPASS) {
+                break;
+            }
+        }
+        if (request == nullptr) {
+            continue;
+        }
+        request->result = execute(request->device, request->job, request->context, request->queuedUs);
+        xSemaphoreGive(request->done);                  // 此后不再访问请求（位于调用者栈上）
+    }
+}
+
+/**
+ * 设备统计（在MQTT任务中调用）
+ */
+void i2cBusGetStats(uint8_t device, i2c_device_stats_t *stats) {
+    if (device >= I2C_DEVICES) {
+        *stats = {};
+        return;
+    }
+    portENTER_CRITICAL(&statsMux);
+    *stats = deviceStats[device];
+    portEXIT_CRITICAL(&statsMux);
+}
+
+/**
+ * 总线统计（在MQTT任务中调用）
+ */
+void i2cBusGetBusStats(i2c_bus_stats_t *stats) {
+    portENTER_CRITICAL(&statsMux);
+    *stats = busStats;
+    portEXIT_CRITICAL(&statsMux);
+}
+
+/**
+ * 设备名称（用于上报）
+ */
+const char *i2cDeviceName(uint8_t device) {
+    return device < I2C_DEVICES ? deviceNames[device] : "unknown";
+}
@@ -0,0 +1,91 @@
+/**
+ * @file i2cBus.h
+ * @brief I2C总线管理模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为I2C总线管理模块头文件，包含如下内容：
+ * - I2C引脚、时钟与队列参数
+ * - 设备编号与事务优先级
+ * - 事务提交、总线任务与统计查询的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - I2C0 只由总线任务访问：BH1750、AHT20（经 Wire）与 OLED（经 ESP-IDF 命令链）的每次访问都包装为一个事务函数，
+ *   由调用者提交后阻塞等待，总线任务依次在自己的上下文中执行，不同任务的访问不会在总线上交错
+ * - 两个优先级队列：传感器读取先于屏幕刷新；屏幕刷新按页拆分为多个事务，传感器读取最多等待一页（约3ms）
+ * - 每个设备统计事务数、失败数、总线占用时间与排队时间
+ * - 事务失败后检查总线电平：SDA 或 SCL 被拉低时输出最多9个SCL时钟与STOP信号释放总线，然后重新初始化驱动；
+ *   连续失败达到门限时即使电平正常也重新初始化
+ * - 总线任务创建前（setup 中）事务直接在调用者中执行；总线任务中提交的事务也直接执行
+ * - 事务函数在总线任务中运行，调用者一直等待到执行完毕，因此可以使用调用者栈上的数据
+ */
+
+#ifndef LIGHTPROJECT_I2CBUS_H
+#define LIGHTPROJECT_I2CBUS_H
+
+#include <Arduino.h>
+#include <driver/i2c.h>
+
+/* 引脚与时钟 */
+#define JLC_I2C_SDA_PIN 1                   // 立创开发板
+#define JLC_I2C_SCL_PIN 2
+#define I2C_SDA_PIN 8                       // 自制核心板
+#define I2C_SCL_PIN 9
+#define I2C_BUS_PORT I2C_NUM_0              // Wire 使用的端口
+#define I2C_BUS_FREQ_HZ 400000              // 总线时钟（400kHz）
+
+/* 队列与故障处理 */
+#define I2C_BUS_QUEUE_SIZE 4                // 每个优先级队列的长度
+#define I2C_BUS_REINIT_ERRORS 3             // 连续失败达到此次数时重新初始化驱动
+#define I2C_BUS_RECOVERY_CLOCKS 9           // 释放总线时最多输出的SCL时钟数
+#define I2C_BUS_RECOVERY_HALF_US 5          // 释放总线时SCL半周期（微秒，约100kHz）
+
+/* 设备编号 */
+typedef enum {
+    I2C_DEV_BH1750 = 0,                     // 光照传感器
+    I2C_DEV_AHT20,                          // 温湿度传感器
+    I2C_DEV_OLED,                           // SSD1306 屏幕
+    I2C_DEVICES
+} i2c_device_t;
+
+/* 事务优先级（数字越小越先执行） */
+typedef enum {
+    I2C_PRIO_SENSOR = 0,                    // 传感器读取
+    I2C_PRIO_DISPLAY,                       // 屏幕刷新
+    I2C_PRIORITIES
+} i2c_priority_t;
+
+/* 事务函数：在总线任务中执行一次设备访问，返回是否成功 */
+typedef bool (*i2c_job_t)(void *context);
+
+/* 单个设备的统计 */
+typedef struct {
+    uint32_t transactions;                  // 执行的事务数
+    uint32_t errors;                        // 失败的事务数
+    uint32_t lastUs;                        // 最近一次总线占用时间（微秒）
+    uint32_t maxUs;                         // 最长总线占用时间（微秒）
+    uint64_t totalUs;                       // 总线占用时间合计（微秒，用于求平均）
+    uint32_t maxWaitUs;                     // 最长排队时间（微秒）
+} i2c_device_stats_t;
+
+/* 总线统计 */
+typedef struct {
+    uint32_t stuckFaults;                   // 检测到SDA或SCL被拉低的次数
+    uint32_t recoveries;                    // 重新初始化驱动的次数
+    bool stuck;                             // 最近一次恢复后总线仍被拉低
+} i2c_bus_stats_t;
+
+extern TaskHandle_t xI2cBusHandle;          // 总线任务句柄（创建任务时写入，之后事务经队列交给总线任务）
+
+void i2cBusInit(int sda, int scl, uint32_t frequency);     // 初始化 Wire 与事务队列（在访问任何I2C设备前调用）
+bool i2cBusRun(uint8_t device, uint8_t priority, i2c_job_t job, void *context);    // 提交事务并等待执行完毕
+void i2cBusTask(void *pvParameters);                        // 总线任务：按优先级执行事务
+void i2cBusGetStats(uint8_t device, i2c_device_stats_t *stats);
+void i2cBusGetBusStats(i2c_bus_stats_t *stats);
+const char *i2cDeviceName(uint8_t device);
+
+#endif //LIGHTPROJECT_I2CBUS_H
@@ -0,0 +1,426 @@
+/**
+ * @file ledOutput.cpp
+ * @brief LED输出模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现灯控任务的输出阶段：
+ * - 感知亮度经 CIE L* 查找表转为线性值，再按当前色温查表得到三通道线性值
+ * - 逐像素空间效果：运动波从PIR一侧扫向另一侧，配光增益决定各灯珠的相对亮度，高温时热点灯珠优先降额
+ * - 结果先渲染到帧缓冲区，与上一次发出的帧逐字节比较，相同则跳过刷新
+ * - 变化的帧复制到 FastLED 像素缓冲区后交给LED刷新任务发送，灯控任务不等待位流发送完毕
+ * - DDP像素流：像素流任务把收到的像素数据直接写入 FastLED 像素缓冲区，流模式期间灯控任务不再提交画面，
+ *   超时后恢复亮度引擎的输出
+ *
+ * @note
+ * 注意事项：
+ * - 空间效果配置由MQTT任务写入暂存区，灯控任务收到命令后在临界区内取走，避免渲染到一半的配置
+ * - 配光增益与热点权重以字节数组保存到NVS，灯珠数量改变后旧配置自动失效
+ * - 像素、渲染、空间效果与暂存缓冲区在启动时一次分配：总量小时放内部RAM，长灯带放PSRAM；
+ *   FastLED 的RMT驱动在 show() 中把像素复制到自己的内部缓冲区再发送，中断不会访问PSRAM
+ * - FastLED.show() 在RMT发送完成前不会返回（16颗约0.5ms，灯带加长后成比例增加），因此放在独立任务中调用；
+ *   灯控任务只在上一帧仍在发送时才等待（ledShowIdle 信号量），发送过程中不会改写 leds
+ * - 像素流的亮度仍受功率预算限制：发送前按限额设置 FastLED 全局亮度（由RMT驱动在复制时缩放），流结束后恢复
+ */
+
+#include "ledOutput.h"
+#include "perceptualDimming.h"
+#include "brightnessConfig.h"
+#include <Preferences.h>
+#include <esp_heap_caps.h>
+
+uint16_t ledCount = 0;          // LED灯珠数量
+uint8_t ledOutputs = 1;         // 实际使用的输出路数
+CRGB *leds = nullptr;           // FastLED 像素缓冲区
+cct_engine_t ledColor;          // 色温引擎
+spatial_layer_t ledSpatial;     // 空间效果层
+TaskHandle_t xLedShowHandle = nullptr;  // LED刷新任务句柄
+volatile uint32_t ledFramesSent = 0;    // 已发送的帧数
+volatile uint32_t ledFramesSkipped = 0; // 与上一帧相同而跳过的帧数
+static uint8_t *frame = nullptr;        // 渲染缓冲区（R、G、B），与 leds 比较后再提交
+static SemaphoreHandle_t ledShowIdle = nullptr; // 没有帧在发送时可获取（发送期间被灯控任务持有）
+pixel_stream_t ledStream = {-1};        // DDP像素流接收端
+volatile bool ledStreaming = false;     // 是否处于像素流模式
+static volatile uint32_t streamChannelSum = 0;  // 最近一帧像素流的通道输出之和（用于能耗计量）
+static_assert(sizeof(CRGB) == 3, "空间效果层按 R、G、B 连续字节写入像素缓冲区");
+
+/* 空间效果配置暂存区（MQTT任务写入，灯控任务取走；提交后到应用完成前暂存区归灯控任务所有，拒绝新的写入） */
+static portMUX_TYPE spatialMux = portMUX_INITIALIZER_UNLOCKED;
+static uint16_t *stagedGain = nullptr;      // 暂存的配光增益
+static uint16_t *stagedHotspot = nullptr;   // 暂存的热点权重
+static uint16_t stagedPirLed = LED_PIR_INDEX;   // 暂存的运动波起点
+static bool spatialStaged = false;          // 暂存区是否有已提交、尚未应用的配置
+
+/**
+ * 从NVS读取配光增益、热点权重与运动波起点（数据缺失或灯珠数量不符时使用默认值）
+ */
+static void loadSpatial() {
+    Preferences prefs;
+    if (!prefs.begin(LED_SPATIAL_PREFS_NAMESPACE, true)) {
+        return;
+    }
+    size_t size = ledCount * sizeof(uint16_t);
+    if (ledCount > 0 && prefs.getBytesLength("gain") == size && prefs.getBytesLength("hot") == size) {
+        prefs.getBytes("gain", ledSpatial.gain, size);      // 直接读入空间效果层，长灯带不占用栈空间
+        prefs.getBytes("hot", ledSpatial.hotspot, size);
+        ledSpatial.pirLed = prefs.getUShort("pir", LED_PIR_INDEX) % ledCount;
+        spatialUpdateGains(&ledSpatial);
+    }
+    prefs.end();
+}
+
+/**
+ * 从NVS读取灯珠数量与输出路数
+ * 功能说明：输出路数不足以让每路不超过 LED_MAX_PER_OUTPUT 颗时自动增加，保证刷新时间有上限
+ */
+static void loadLayout() {
+    uint16_t count = LED_COUNT;
+    uint8_t outputs = 1;
+    Preferences prefs;
+    if (prefs.begin(LED_LAYOUT_PREFS_NAMESPACE, true)) {
+        count = prefs.getUShort("count", LED_COUNT);
+        outputs = prefs.getUChar("outputs", 1);
+        prefs.end();
+    }
+    count = constrain(count, 1, LED_COUNT_MAX);
+    uint8_t minOutputs = (count + LED_MAX_PER_OUTPUT - 1) / LED_MAX_PER_OUTPUT;
+    ledOutputs = constrain(outputs, minOutputs, LED_MAX_OUTPUTS);
+    ledCount = count;
+}
+
+/**
+ * 分配缓冲区（总量超过 LED_PSRAM_THRESHOLD 且有PSRAM时放PSRAM，否则放内部RAM）
+ */
+static void *ledAlloc(size_t size, bool usePsram) {
+    void *p = nullptr;
+    if (usePsram) {
+        p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (p == nullptr) {
+        p = heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    return p;
+}
+
+/**
+ * 分配像素、渲染、空间效果与暂存缓冲区（只在启动时调用一次）
+ * 返回值：false 表示内存不足（此时灯珠数量为0，不输出）
+ */
+static bool allocBuffers(void **spatialStorage) {
+    size_t pixelBytes = (size_t) ledCount * 3;
+    size_t spatialBytes = spatialStorageSize(ledCount);
+    size_t stagedBytes = (size_t) ledCount * sizeof(uint16_t);
+    bool usePsram = psramFound() && 2 * pixelBytes + spatialBytes + 2 * stagedBytes > LED_PSRAM_THRESHOLD;
+    leds = static_cast<CRGB *>(ledAlloc(pixelBytes, usePsram));
+    frame = static_cast<uint8_t *>(ledAlloc(pixelBytes, usePsram));
+    *spatialStorage = ledAlloc(spatialBytes, usePsram);
+    stagedGain = static_cast<uint16_t *>(ledAlloc(stagedBytes, usePsram));
+    stagedHotspot = static_cast<uint16_t *>(ledAlloc(stagedBytes, usePsram));
+    if (leds == nullptr || frame == nullptr || *spatialStorage == nullptr
+        || stagedGain == nullptr || stagedHotspot == nullptr) {
+        Serial.println("LED缓冲区分配失败");
+        ledCount = 0;
+        *spatialStorage = nullptr;
+        return false;
+    }
+    memset(leds, 0, pixelBytes);
+    memset(frame, 0, pixelBytes);
+    Serial.printf("LED: %u颗，%u路输出，缓冲区位于%s\n", ledCount, ledOutputs, usePsram ? "PSRAM" : "内部RAM");
+    return true;
+}
+
+/**
+ * 注册一路输出（FastLED 的数据引脚是模板参数，按路号分别实例化）
+ */
+static void addOutput(uint8_t output, CRGB *data, uint16_t count) {
+    switch (output) {
+        case 0:
+            CFastLED::addLeds<WS2812, ledPin, GRB>(data, count);
+            break;
+        case 1:
+            CFastLED::addLeds<WS2812, LED_PIN_2, GRB>(data, count);
+            break;
+        case 2:
+            CFastLED::addLeds<WS2812, LED_PIN_3, GRB>(data, count);
+            break;
+        case 3:
+            CFastLED::addLeds<WS2812, LED_PIN_4, GRB>(data, count);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 保存空间效果配置到NVS
+ */
+static void saveSpatial() {
+    Preferences prefs;
+    if (!prefs.begin(LED_SPATIAL_PREFS_NAMESPACE, false)) {
+        Serial.println("空间效果配置保存失败");
+        return;
+    }
+    prefs.putBytes("gain", ledSpatial.gain, ledCount * sizeof(uint16_t));
+    prefs.putBytes("hot", ledSpatial.hotspot, ledCount * sizeof(uint16_t));
+    prefs.putUShort("pir", ledSpatial.pirLed);
+    prefs.end();
+}
+
+/**
+ * 初始化LED输出
+ * 功能说明：读取灯珠布局并分配缓冲区，按输出路数注册FastLED控制器并清屏，
+ *          生成色温查找表，初始化色温引擎与空间效果层
+ */
+void ledOutputInit() {
+    loadLayout();               // 灯珠数量与输出路数
+    void *spatialStorage = nullptr;
+    if (allocBuffers(&spatialStorage)) {
+        uint16_t perOutput = (ledCount + ledOutputs - 1) / ledOutputs;     // 各路均分，最后一路取余下的灯珠
+        for (uint8_t i = 0; i < ledOutputs; i++) {
+            uint16_t start = i * perOutput;
+            if (start < ledCount) {
+                uint16_t length = ledCount - start < perOutput ? ledCount - start : perOutput;
+                addOutput(i, leds + start, length);     // 初始化FastLED
+            }
+        }
+    }
+    FastLED.setDither(DISABLE_DITHER);  // 关闭FastLED自带抖动，由感知亮度模块做时间抖动
+    FastLED.show();             // 更新显示（缓冲区已清零，即设置亮度为0）
+    ledShowIdle = xSemaphoreCreateBinary();
+    xSemaphoreGive(ledShowIdle);    // 初始没有帧在发送
+
+    colorTemperatureInit();     // 生成色温 -> 通道增益查找表
+    cctEngineInit(&ledColor, millis());     // 色温引擎（默认自动曲线）
+    spatialInit(&ledSpatial, ledCount, LED_PIR_INDEX, spatialStorage);     // 均匀配光
+    loadSpatial();              // 读取保存的配光与热点
+}
+
+/**
+ * 提交 leds 中的新帧（调用前已获取 ledShowIdle，发送完成后释放）
+ */
+static void submitFrame() {
+    if (xLedShowHandle != nullptr) {
+        xTaskNotifyGive(xLedShowHandle);    // 交给LED刷新任务发送，发送完成后由其释放信号量
+    }
+    else {
+        FastLED.show();         // 刷新任务尚未创建时同步发送
+        ledFramesSent++;
+        xSemaphoreGive(ledShowIdle);
+    }
+}
+
+/**
+ * 渲染并输出一帧
+ * 参数：level - 16位感知亮度；floorLevel - 基础亮度（运动波未到达的灯珠保持此亮度）
+ *       settled - 亮度是否已稳定；ambientLux - 环境照度（用于按照度的色温曲线）
+ * 返回值：所有像素所有通道的8位输出之和（用于能耗计量）
+ */
+uint32_t ledOutputRender(uint16_t level, uint16_t floorLevel, bool settled, float ambientLux) {
+    uint32_t now = millis();
+    uint16_t kelvin = cctEngineUpdate(&ledColor, ambientLux, now);     // 色温（过渡中按帧靠近目标）
+    cct_gains_t gains;
+    cctGains(kelvin, &gains);                   // 色温 -> 白平衡后的通道增益（查表插值）
+
+    uint16_t linear = perceptualToLinear(level);        // 感知亮度 -> 线性值
+    uint16_t floorLinear = perceptualToLinear(floorLevel);
+    uint16_t channel[3] = {CCT_SCALE(linear, gains.r), CCT_SCALE(linear, gains.g), CCT_SCALE(linear, gains.b)};
+    uint16_t floor[3] = {CCT_SCALE(floorLinear, gains.r), CCT_SCALE(floorLinear, gains.g),
+                         CCT_SCALE(floorLinear, gains.b)};
+
+    uint32_t sum = spatialRender(&ledSpatial, channel, floor, settled && ledColor.settled, frame, now);
+    if (ledStreaming) {
+        return streamChannelSum;    // 像素流模式：画面由像素流决定
+    }
+    if (ledCount == 0) {
+        return sum;
+    }
+    uint8_t *pixels = reinterpret_cast<uint8_t *>(leds);    // CRGB 按 R、G、B 连续存放
+    if (memcmp(frame, pixels, ledCount * 3) == 0) {
+        ledFramesSkipped++;     // 与上一次发出的帧相同，不必刷新
+        return sum;
+    }
+    xSemaphoreTake(ledShowIdle, portMAX_DELAY);     // 上一帧仍在发送时等待（发送期间不能改写 leds）
+    if (ledStreaming) {
+        xSemaphoreGive(ledShowIdle);    // 等待期间进入了像素流模式
+        return streamChannelSum;
+    }
+    memcpy(pixels, frame, ledCount * 3);
+    submitFrame();
+    return sum;
+}
+
+/**
+ * LED刷新任务
+ * 功能说明：等待灯控任务提交新帧，调用 FastLED.show() 发送（阻塞到RMT发送完成），完成后释放 ledShowIdle
+ */
+void ledShowTask(void *pvParameters) {
+    (void) pvParameters;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);    // 等待新帧
+        FastLED.show();         // 刷新LED（等待RMT发送期间让出CPU）
+        ledFramesSent++;
+        xSemaphoreGive(ledShowIdle);
+    }
+}
+
+/**
+ * 打开DDP像素流接收端口
+ */
+bool ledOutputStreamOpen() {
+    return pixelStreamOpen(&ledStream, PIXEL_STREAM_PORT);
+}
+
+/**
+ * 接收像素流（在像素流任务中循环调用，没有数据时最多阻塞 PIXEL_STREAM_POLL_MS）
+ * 功能说明：像素数据直接从协议栈读入 leds，收到一帧的最后一包后按功率预算设置全局亮度并提交发送
+ * 返回值：true 表示像素流刚刚超时结束，调用者应唤醒灯控任务恢复亮度引擎的输出
+ */
+bool ledOutputStreamPoll() {
+    ddp_header_t header;
+    if (ledCount > 0 && pixelStreamPeek(&ledStream, &header)) {
+        xSemaphoreTake(ledShowIdle, portMAX_DELAY);     // 上一帧仍在发送时等待（发送期间不能改写 leds）
+        uint8_t *pixels = reinterpret_cast<uint8_t *>(leds);
+        pixel_stream_result_t result = pixelStreamRead(&ledStream, &header, pixels, ledCount * 3, millis());
+        ledStreaming = ledStream.active;
+        if (result == PIXEL_STREAM_FRAME) {
+            uint8_t scale = (uint8_t) (brightnessPowerLimit * 255.0f + 0.5f);
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < (uint32_t) ledCount * 3; i++) {
+                sum += pixels[i];
+            }
+            streamChannelSum = sum * scale / 255;
+            FastLED.setBrightness(scale);   // 功率预算限额（发送时由驱动缩放，不改写像素数据）
+            submitFrame();
+        }
+        else {
+            xSemaphoreGive(ledShowIdle);    // 帧未结束，等待后续数据包
+        }
+    }
+    if (!pixelStreamTimedOut(&ledStream, millis())) {
+        return false;
+    }
+    xSemaphoreTake(ledShowIdle, portMAX_DELAY);
+    FastLED.setBrightness(255);     // 恢复全局亮度（亮度引擎自行计算限额）
+    ledStreaming = false;
+    xSemaphoreGive(ledShowIdle);
+    return true;
+}
+
+/**
+ * 色温过渡与运动波是否均已结束（未结束时灯控任务需要按帧刷新）
+ */
+bool ledOutputIsSettled() {
+    return ledColor.settled && !ledSpatial.waveActive;
+}
+
+/**
+ * 开始运动波
+ */
+void ledOutputStartWave() {
+    spatialStartWave(&ledSpatial, millis());
+}
+
+/**
+ * 按温度更新热点降额（温度变化小于 LED_THERMAL_STEP_C 时忽略，避免频繁重算）
+ */
+void ledOutputSetTemperature(float temperatureC) {
+    static float appliedTemperature = -1000.0f;
+    float delta = temperatureC - appliedTemperature;
+    if (delta < LED_THERMAL_STEP_C && delta > -LED_THERMAL_STEP_C) {
+        return;
+    }
+    appliedTemperature = temperatureC;
+    spatialSetTemperature(&ledSpatial, temperatureC);
+}
+
+/**
+ * 暂存单颗灯珠的配光增益与热点权重（可在其他任务中调用，全部写完后调用 ledOutputCommitSpatial()）
+ * 功能说明：逐颗写入，长灯带也不需要在调用者栈上准备整条数组
+ * 返回值：false 表示序号超出灯珠数量，或上一次提交的配置尚未被灯控任务应用（此时不写入，避免新旧配置混合）
+ */
+bool ledOutputStageSpatial(uint16_t index, uint16_t gain, uint16_t hotspot) {
+    if (index >= ledCount) {
+        return false;
+    }
+    portENTER_CRITICAL(&spatialMux);
+    bool busy = spatialStaged;
+    if (!busy) {
+        stagedGain[index] = gain;
+        stagedHotspot[index] = hotspot;
+    }
+    portEXIT_CRITICAL(&spatialMux);
+    return !busy;
+}
+
+/**
+ * 结束暂存（随后投递 LIGHT_CMD_SPATIAL 让灯控任务应用）
+ * 参数：pirLed - 运动波起点，负数表示保持原值
+ * 返回值：false 表示参数无效，或上一次提交的配置尚未应用
+ */
+bool ledOutputCommitSpatial(int16_t pirLed) {
+    if (pirLed >= (int32_t) ledCount || ledCount == 0) {
+        return false;
+    }
+    portENTER_CRITICAL(&spatialMux);
+    bool busy = spatialStaged;
+    if (!busy) {
+        stagedPirLed = pirLed >= 0 ? (uint16_t) pirLed : ledSpatial.pirLed;
+        spatialStaged = true;
+    }
+    portEXIT_CRITICAL(&spatialMux);
+    return !busy;
+}
+
+/**
+ * 撤销已提交、尚未应用的配置（LIGHT_CMD_SPATIAL 投递失败时调用，否则暂存区一直被占用）
+ */
+void ledOutputCancelSpatial() {
+    portENTER_CRITICAL(&spatialMux);
+    spatialStaged = false;
+    portEXIT_CRITICAL(&spatialMux);
+}
+
+/**
+ * 应用暂存的空间效果配置并保存到NVS
+ * 说明：提交后暂存区不再被写入，逐颗复制（长灯带在PSRAM中）在临界区外进行，复制完成后才释放暂存区
+ */
+void ledOutputApplySpatial() {
+    portENTER_CRITICAL(&spatialMux);
+    bool staged = spatialStaged;
+    uint16_t pirLed = stagedPirLed;
+    portEXIT_CRITICAL(&spatialMux);
+    if (!staged) {
+        return;
+    }
+    for (uint16_t i = 0; i < ledCount; i++) {
+        spatialSetGain(&ledSpatial, i, stagedGain[i], stagedHotspot[i]);
+    }
+    ledSpatial.pirLed = pirLed;
+    portENTER_CRITICAL(&spatialMux);
+    spatialStaged = false;
+    portEXIT_CRITICAL(&spatialMux);
+    spatialUpdateGains(&ledSpatial);
+    saveSpatial();
+}
+
+/**
+ * 保存灯珠数量与输出路数（重启后生效，缓冲区只在启动时分配）
+ * 参数：count - 灯珠数量（1 ~ LED_COUNT_MAX）；outputs - 输出路数（1 ~ LED_MAX_OUTPUTS，不足时启动时自动增加）
+ * 返回值：false 表示参数无效或保存失败
+ */
+bool ledOutputSaveLayout(uint16_t count, uint8_t outputs) {
+    if (count == 0 || count > LED_COUNT_MAX || outputs == 0 || outputs > LED_MAX_OUTPUTS) {
+        return false;
+    }
+    Preferences prefs;
+    if (!prefs.begin(LED_LAYOUT_PREFS_NAMESPACE, false)) {
+        return false;
+    }
+    prefs.putUShort("count", count);
+    prefs.putUChar("outputs", outputs);
+    prefs.end();
+    return true;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file ledOutput.h
+ * @brief LED输出模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为LED输出模块头文件，包含如下内容：
+ * - LED数据引脚、灯珠数量上限、缓冲区分配等硬件宏定义
+ * - 像素缓冲区、色温引擎与空间效果层的全局变量声明
+ * - 输出初始化、逐帧渲染与空间效果配置的函数声明
+ * - LED刷新任务与帧计数器
+ * - DDP像素流接收（调试验收与活动灯光）
+ *
+ * @note
+ * 注意事项：
+ * - 渲染链路：16位感知亮度 -> 线性值 -> 色温通道增益 -> 逐像素空间效果（运动波、配光、热点降额）-> 8位输出
+ * - 渲染与色温、空间效果状态只在灯控任务中修改；其他任务通过灯控命令或暂存区（带临界区）提交配置
+ * - 与上一帧完全相同的帧不发送；变化的帧由LED刷新任务异步发送，灯控任务只在上一帧仍在发送时等待
+ * - 灯珠数量与输出路数保存在NVS中，启动时读取并一次性分配缓冲区（修改后重启生效），不同灯头无需重新编译
+ * - 灯带按输出路数均分到多个数据引脚，各路由独立RMT通道同时发送，刷新时间取决于最长一路的长度
+ */
+
+#ifndef LIGHTPROJECT_LEDOUTPUT_H
+#define LIGHTPROJECT_LEDOUTPUT_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "colorTemperature.h"
+#include "spatialEffects.h"
+#include "pixelStream.h"
+
+/* LED硬件参数 */
+#define JLC_LED_PIN 38          // 使用立创开发板时候的LED数据引脚
+#define LED_PIN 6               // LED数据引脚（第1路）
+#define LED_PIN_2 11            // 第2路LED数据引脚
+#define LED_PIN_3 12            // 第3路LED数据引脚
+#define LED_PIN_4 13            // 第4路LED数据引脚
+#define LED_MAX_OUTPUTS 4       // 最多输出路数（ESP32-S3 有4个RMT发送通道）
+#define LED_COUNT 16            // 默认LED灯珠数量（NVS中没有配置时使用）
+#define LED_MAX_PER_OUTPUT 512  // 每路最多灯珠数（WS2812 每颗30µs，512颗约15ms，小于帧周期）
+#define LED_COUNT_MAX (LED_MAX_OUTPUTS * LED_MAX_PER_OUTPUT)   // 最多灯珠数
+#define LED_PSRAM_THRESHOLD 4096    // 缓冲区总大小超过此字节数时分配在PSRAM
+#define LED_PIR_INDEX 0         // 离PIR最近的灯珠序号（运动波起点）
+#define LED_LAYOUT_PREFS_NAMESPACE "ledcfg"     // 灯珠数量与输出路数在NVS中的命名空间
+#ifdef isJLC
+constexpr uint8_t ledPin = JLC_LED_PIN;   // 立创开发板使用的LED数据引脚
+#else
+constexpr uint8_t ledPin = LED_PIN;       // LED数据引脚
+#endif
+
+/* 空间效果参数 */
+#define LED_THERMAL_STEP_C 0.5f                 // 温度变化超过此值时才更新热点降额
+#define LED_SPATIAL_PREFS_NAMESPACE "spatial"   // 配光增益与热点权重在NVS中的命名空间
+
+extern uint16_t ledCount;           // LED灯珠数量（启动时由NVS配置确定，缓冲区分配失败时为0）
+extern uint8_t ledOutputs;          // 实际使用的输出路数
+extern CRGB *leds;                  // FastLED 像素缓冲区（启动时分配）
+extern cct_engine_t ledColor;       // 色温引擎（只由灯控任务修改）
+extern spatial_layer_t ledSpatial;  // 空间效果层（只由灯控任务修改）
+extern TaskHandle_t xLedShowHandle; // LED刷新任务句柄
+extern volatile uint32_t ledFramesSent;     // 已发送的帧数
+extern volatile uint32_t ledFramesSkipped;  // 与上一帧相同而跳过的帧数
+extern pixel_stream_t ledStream;    // DDP像素流接收端（只由像素流任务修改）
+extern volatile bool ledStreaming;  // 是否处于像素流模式（流模式期间灯控任务不提交画面）
+
+void ledOutputInit();               // 初始化FastLED、色温查找表与空间效果层（读取NVS中的配光）
+uint32_t ledOutputRender(uint16_t level, uint16_t floorLevel, bool settled, float ambientLux);  // 渲染并输出一帧
+bool ledOutputIsSettled();          // 色温过渡与运动波均已结束
+void ledOutputStartWave();          // 开始运动波（运动增亮开始时调用）
+void ledOutputSetTemperature(float temperatureC);   // 按温度更新热点降额
+bool ledOutputStageSpatial(uint16_t index, uint16_t gain, uint16_t hotspot);  // 暂存单颗灯珠的配光增益与热点权重
+bool ledOutputCommitSpatial(int16_t pirLed);    // 结束暂存，随后投递 LIGHT_CMD_SPATIAL
+void ledOutputCancelSpatial();      // 撤销已提交的配置（LIGHT_CMD_SPATIAL 投递失败时调用）
+void ledOutputApplySpatial();       // 应用暂存的空间效果配置并保存到NVS（在灯控任务中调用）
+bool ledOutputSaveLayout(uint16_t count, uint8_t outputs);  // 保存灯珠数量与输出路数（重启后生效）
+void ledShowTask(void *pvParameters);   // LED刷新任务（发送灯控任务提交的帧）
+bool ledOutputStreamOpen();         // 打开DDP像素流接收端口
+bool ledOutputStreamPoll();         // 接收像素流，返回 true 表示像素流刚刚超时结束
+
+#endif //LIGHTPROJECT_LEDOUTPUT_H
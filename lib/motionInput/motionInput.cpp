@@ -0,0 +1,155 @@
+/**
+ * @file motionInput.cpp
+ * @brief 运动检测与按键输入模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现PIR运动检测与调试按键的输入处理：
+ * - 中断服务函数只把带时间戳的事件写入无锁环形队列，并通知灯控任务
+ * - 灯控任务被唤醒后调用 motionInputProcess()，完成消抖、日志输出和运动状态更新
+ * 这样中断中不再有串口输出，运动状态也只由灯控任务一个线程读写
+ *
+ * @note
+ * 注意事项：
+ * - 三个GPIO中断由同一个中断服务程序分发，不会互相嵌套，因此可以共用一个单生产者队列
+ * - 队列满时丢弃新事件并计数，下次处理时输出提示
+ */
+
+#include "motionInput.h"
+#include "spscRing.h"
+#include "taskCreate.h"
+#include "brightnessConfig.h"
+
+/* ========== 硬件引脚配置区域 ========== */
+/* 根据不同的开发板型号，选择对应的引脚编号 */
+#ifdef isJLC
+/* 立创开发板的引脚定义 */
+int motionPin = JLC_MOTION_PIN;         // 运动检测传感器连接的引脚
+int key1Pin = JLC_KEY1_PIN;             // KEY1按钮连接的引脚（用于手动触发运动检测）
+int key2Pin = JLC_KEY2_PIN;             // KEY2按钮连接的引脚（用于手动取消运动检测）
+#else
+/* 自制核心板的引脚定义 */
+int motionPin = MOTION_PIN;             // 运动检测传感器连接的引脚
+int key1Pin = KEY1_PIN;                 // KEY1按钮连接的引脚
+int key2Pin = KEY2_PIN;                 // KEY2按钮连接的引脚
+#endif
+
+/* ========== 私有变量定义区域 ========== */
+static SpscRing<input_event_t, INPUT_EVENT_QUEUE_SIZE> inputEvents;    // 中断 -> 灯控任务 事件队列
+static volatile uint32_t droppedEvents = 0;     // 队列满时丢弃的事件数（仅中断写入）
+static uint32_t reportedDropped = 0;            // 已输出提示的丢弃事件数
+static uint32_t lastKeyTime[2] = {0, 0};        // KEY1/KEY2 上次有效按下时间（用于消抖）
+static bool keyPressed[2] = {false, false};     // KEY1/KEY2 是否已有有效按下记录
+
+/**
+ * 初始化运动检测与按键输入
+ * 功能说明：设置引脚模式并挂载中断，中断在灯控任务创建前就可能触发，事件会在队列中等待
+ */
+void motionInputInit() {
+    /* ===== 设置引脚工作模式 ===== */
+    pinMode(motionPin, INPUT_PULLDOWN);     // 设置运动检测引脚为输入模式，并启用内部下拉
+    pinMode(key1Pin, INPUT_PULLUP);         // KEY1按钮，内部上拉，用于手动触发运动检测
+    pinMode(key2Pin, INPUT_PULLUP);         // KEY2按钮，内部上拉，用于手动消除运动检测
+
+    /* ===== 配置中断处理 ===== */
+    /* 为运动检测引脚配置中断：当引脚电平从低变高时（RISING上升沿），调用motionISR函数 */
+    attachInterrupt(digitalPinToInterrupt(motionPin), motionISR, RISING);
+    /* 为KEY1按钮配置中断：当按钮被按下时（引脚电平从高变低，FALLING下降沿），调用key1ISR函数 */
+    attachInterrupt(digitalPinToInterrupt(key1Pin), key1ISR, FALLING);
+    /* 为KEY2按钮配置中断：当按钮被按下时，调用key2ISR函数 */
+    attachInterrupt(digitalPinToInterrupt(key2Pin), key2ISR, FALLING);
+
+    /* 向串口输出初始化完成的信息（用于调试） */
+    Serial.printf("IO%d: 原有运动检测功能\n", motionPin);
+    Serial.printf("KEY1(IO%d): 手动触发运动检测\n", key1Pin);
+    Serial.printf("KEY2(IO%d): 手动消除运动检测\n", key2Pin);
+}
+
+/**
+ * 将事件写入队列并唤醒灯控任务（仅在中断中调用）
+ */
+static IRAM_ATTR void pushEventFromISR(uint8_t type) {
+    input_event_t event = {(uint32_t) millis(), type};
+    if (!inputEvents.push(event)) {
+        droppedEvents = droppedEvents + 1;  // 队列满，记录丢弃
+    }
+    lightTaskNotifyFromISR(LIGHT_EVENT_MOTION);
+}
+
+/**
+ * 运动检测中断服务函数
+ * 功能说明：PIR检测到运动时触发，只记录事件
+ * 注意：IRAM_ATTR表示这个函数存储在RAM中，可以更快地响应中断
+ */
+IRAM_ATTR void motionISR() {
+    pushEventFromISR(INPUT_EVENT_MOTION);
+}
+
+/**
+ * KEY1中断服务函数 - 手动触发运动检测
+ */
+IRAM_ATTR void key1ISR() {
+    pushEventFromISR(INPUT_EVENT_KEY1);
+}
+
+/**
+ * KEY2中断服务函数 - 手动消除运动检测
+ */
+IRAM_ATTR void key2ISR() {
+    pushEventFromISR(INPUT_EVENT_KEY2);
+}
+
+/**
+ * 按键消抖：同一按键在 KEY_DEBOUNCE_MS 内的重复边沿视为抖动
+ * 参数：index - 0为KEY1，1为KEY2；timeMs - 事件时间
+ * 返回值：true 表示本次按下有效
+ */
+static bool keyDebounce(uint8_t index, uint32_t timeMs) {
+    if (keyPressed[index] && timeMs - lastKeyTime[index] < KEY_DEBOUNCE_MS) {
+        return false;
+    }
+    keyPressed[index] = true;
+    lastKeyTime[index] = timeMs;
+    return true;
+}
+
+/**
+ * 处理队列中的全部输入事件
+ * 功能说明：在灯控任务中调用，按时间顺序把事件交给亮度控制模块
+ * - 运动：刷新运动保持时间（使用中断记录的时间戳）
+ * - KEY1：消抖后模拟一次运动检测
+ * - KEY2：消抖后立即取消运动状态
+ */
+void motionInputProcess() {
+    input_event_t event;
+    while (inputEvents.pop(event)) {
+        switch (event.type) {
+            case INPUT_EVENT_MOTION:
+                brightnessMotionDetected(event.timeMs);
+                break;
+            case INPUT_EVENT_KEY1:
+                if (keyDebounce(0, event.timeMs)) {
+                    brightnessMotionDetected(event.timeMs);
+                    Serial.println("KEY1按下 - 触发运动检测");
+                }
+                break;
+            case INPUT_EVENT_KEY2:
+                if (keyDebounce(1, event.timeMs)) {
+                    brightnessMotionCleared();
+                    Serial.println("KEY2按下 - 消除运动检测");
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    uint32_t dropped = droppedEvents;
+    if (dropped != reportedDropped) {       // 有新的丢弃事件，输出提示
+        Serial.printf("输入事件队列溢出，累计丢弃 %u 个事件\n", (unsigned) dropped);
+        reportedDropped = dropped;
+    }
+}
@@ -0,0 +1,61 @@
+/**
+ * @file motionInput.h
+ * @brief 运动检测与按键输入模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为运动检测与按键输入模块头文件，包含如下内容：
+ * - 运动检测和手动触发引脚的宏定义
+ * - 输入事件结构体与事件类型定义
+ * - 中断服务函数与事件处理函数声明
+ *
+ * @note
+ * 具体引脚定义请根据实际硬件选择
+ * 立创开发板：JLC_MOTION_PIN (GPIO16), JLC_KEY1_PIN (GPIO3), JLC_KEY2_PIN (GPIO4)
+ * 自制核心板：MOTION_PIN (GPIO15), KEY1_PIN (GPIO1), KEY2_PIN (GPIO2)
+ * 中断中只记录带时间戳的事件并唤醒灯控任务，消抖、日志与状态更新都在灯控任务中完成
+ */
+
+#ifndef LIGHTPROJECT_MOTIONINPUT_H
+#define LIGHTPROJECT_MOTIONINPUT_H
+
+#include <Arduino.h>
+
+/* 运动检测引脚与手动触发引脚 */
+// 立创开发板引脚定义
+#define JLC_MOTION_PIN 16
+#define JLC_KEY1_PIN 3
+#define JLC_KEY2_PIN 4
+// 自制核心板引脚定义
+#define MOTION_PIN 15
+#define KEY1_PIN 1
+#define KEY2_PIN 2
+
+/* 事件队列参数 */
+#define INPUT_EVENT_QUEUE_SIZE 16   // 事件队列容量（必须为2的幂）
+#define KEY_DEBOUNCE_MS 50          // 按键消抖时间（毫秒）
+
+/* 输入事件类型 */
+typedef enum {
+    INPUT_EVENT_MOTION = 0,         // PIR检测到运动
+    INPUT_EVENT_KEY1,               // KEY1按下（手动触发运动检测）
+    INPUT_EVENT_KEY2                // KEY2按下（手动消除运动检测）
+} input_event_type_t;
+
+/* 输入事件结构 */
+typedef struct {
+    uint32_t timeMs;                // 事件发生时间（millis）
+    uint8_t type;                   // 事件类型（input_event_type_t）
+} input_event_t;
+
+/* 函数声明 */
+void motionInputInit();             // 初始化引脚与中断
+void motionISR();                   // 运动检测中断服务函数
+void key1ISR();                     // KEY1中断服务函数 - 手动触发运动检测
+void key2ISR();                     // KEY2中断服务函数 - 手动消除运动检测
+void motionInputProcess();          // 处理队列中的输入事件（在灯控任务中调用）
+
+#endif //LIGHTPROJECT_MOTIONINPUT_H
@@ -0,0 +1,68 @@
+/**
+ * @file spscRing.h
+ * @brief 单生产者单消费者无锁环形队列
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件提供一个固定容量的无锁环形队列模板，用于中断与任务之间传递事件：
+ * - 生产者（中断）只写 head，消费者（任务）只写 tail，无需关中断或互斥锁
+ * - head/tail 为自由增长的32位计数，用差值判断满/空，容量必须为2的幂
+ *
+ * @note
+ * 注意事项：
+ * - 同一时刻只能有一个生产者和一个消费者，多个中断共用时必须保证它们不会互相嵌套
+ *   （ESP32 的GPIO中断由同一个中断服务程序分发，满足该条件）
+ * - push() 强制内联，以便随 IRAM_ATTR 中断函数一起放入 IRAM
+ * - 本文件不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_SPSCRING_H
+#define LIGHTPROJECT_SPSCRING_H
+
+#include <atomic>
+#include <cstdint>
+
+template<typename T, uint32_t N>
+class SpscRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing 容量必须为2的幂");
+
+public:
+    /* 生产者：写入一个元素，队列满时返回 false */
+    inline __attribute__((always_inline)) bool push(const T &item) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= N) {
+            return false;                                   // 队列已满，丢弃
+        }
+        buffer_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);   // 先写数据再发布 head
+        return true;
+    }
+
+    /* 消费者：取出一个元素，队列空时返回 false */
+    bool pop(T &item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;                                   // 队列为空
+        }
+        item = buffer_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);   // 读完数据再释放槽位
+        return true;
+    }
+
+    /* 当前元素个数（仅作统计参考，并发时可能立即过时） */
+    uint32_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    T buffer_[N];                           // 数据槽
+    std::atomic<uint32_t> head_{0};         // 下一个写入位置（仅生产者修改）
+    std::atomic<uint32_t> tail_{0};         // 下一个读取位置（仅消费者修改）
+};
+
+#endif //LIGHTPROJECT_SPSCRING_H
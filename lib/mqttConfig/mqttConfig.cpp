@@ -23,6 +23,9 @@
 #include "taskCreate.h"
 #include "brightnessConfig.h"
 #include "getPM2dot5.h"
+#include "clockSync.h"
+#include "i2cBus.h"
+#include "perceptualDimming.h"
 #include <FastLED.h>
 #include <BH1750.h>
 #include <Adafruit_AHTX0.h>
@@ -38,12 +41,22 @@ String mqttClientId = MQTT_CLIENT_ID;                       // 客户端ID
 const char *mqttTopicData = MQTT_TOPIC_DATA;                // 数据上报主题
 const char *mqttTopicHeartbeat = MQTT_TOPIC_HEARTBEAT;      // 心跳包主题
 const char *mqttTopicControl = MQTT_TOPIC_CONTROL;          // 控制命令订阅主题
+const char *mqttTopicSolar = MQTT_TOPIC_SOLAR;              // 太阳能每日摘要主题
 
 PubSubClient mqttClient;        // PubSubClient 实例，负责MQTT协议通信
 WiFiClient tcpClient;           // 底层TCP传输客户端，由WiFiClient实现
 
 static uint8_t retryCount = 0;                  // 重试计数器，用于限制连续失败次数
 static unsigned long lastConnectAttempt = 0;    // 上次尝试连接的时间戳（毫秒），用于控制重试间隔
+static uint32_t solarPublishedDay = 0;          // 最近一次发布每日摘要的日期（自1970-01-01起的天数）
+
+/**
+ * 命令有效期（秒）换算为毫秒
+ * 功能说明：超过 MQTT_DURATION_MAX_S 的值按上限处理（32位毫秒数约49.7天回绕，否则会变成很短的有效期），0 仍表示长期有效
+ */
+static uint32_t durationToMs(uint32_t seconds) {
+    return (seconds > MQTT_DURATION_MAX_S ? MQTT_DURATION_MAX_S : seconds) * 1000UL;
+}
 
 /*
  * MQTT消息回调函数 —— 当订阅的主题收到消息时被自动调用
@@ -70,18 +83,153 @@ void mqtt_callback(char *topic, byte *payload, unsigned int length) {
             return;
         }
         String command = doc["command"];            // 提取命令字段
-        if (command == "set_brightness") {          // 处理“设置亮度”命令
+        light_command_t lightCommand = {};          // 转交灯控任务执行的命令
+        if (command == "set_brightness") {          // 处理“设置亮度”命令（远程来源，到期后恢复自动控制）
             int newBrightness = doc["brightness"];  // 0~100百分比
+            uint32_t duration = doc["duration"] | BRIGHTNESS_REMOTE_TTL_DEFAULT_S;  // 有效期（秒），0为长期有效
             if (newBrightness >= 0 && newBrightness <= 100) {       // 百分比值 0~100
-                brightness = map(newBrightness, 0, 100, 0, 255);    // 映射到PWM范围 0~255
-                isAuto = false;                     // 手动模式
-                Serial.printf("设置亮度为: %d\n", newBrightness);
+                lightCommand.type = LIGHT_CMD_SET_SOURCE;
+                lightCommand.source = BRIGHTNESS_SRC_REMOTE;
+                lightCommand.level = LEVEL_8_TO_16(map(newBrightness, 0, 100, 0, 255));  // 映射到感知亮度
+                lightCommand.ttlMs = durationToMs(duration);
+                lightTaskPostCommand(&lightCommand);
+                Serial.printf("设置亮度为: %d，有效期: %us\n", newBrightness, (unsigned) duration);
             }
         }
         else if (command == "set_auto_mode") {      // 处理“设置自动模式”命令
             bool newAuto = doc["auto_mode"];        // true/false
-            isAuto = newAuto;
-            Serial.printf("设置自动模式: %d\n", isAuto);
+            lightCommand.type = newAuto ? LIGHT_CMD_CLEAR_SOURCE : LIGHT_CMD_SET_SOURCE;   // 自动：清除远程来源；手动：长期保持当前亮度
+            lightCommand.source = BRIGHTNESS_SRC_REMOTE;
+            lightCommand.level = currentBrightness;
+            lightCommand.ttlMs = BRIGHTNESS_TTL_FOREVER;
+            lightTaskPostCommand(&lightCommand);
+            Serial.printf("设置自动模式: %d\n", newAuto);
+        }
+        else if (command == "set_emergency") {      // 处理“紧急照明”命令（最高优先级）
+            bool enable = doc["enable"];            // true/false
+            int newBrightness = doc["brightness"] | 100;                // 0~100百分比，默认满亮
+            uint32_t duration = doc["duration"] | BRIGHTNESS_TTL_FOREVER;   // 有效期（秒），默认直到取消
+            lightCommand.type = enable ? LIGHT_CMD_SET_SOURCE : LIGHT_CMD_CLEAR_SOURCE;
+            lightCommand.source = BRIGHTNESS_SRC_EMERGENCY;
+            lightCommand.level = LEVEL_8_TO_16(map(constrain(newBrightness, 0, 100), 0, 100, 0, 255));
+            lightCommand.ttlMs = durationToMs(duration);
+            lightTaskPostCommand(&lightCommand);
+            Serial.printf("紧急照明: %d\n", enable);
+        }
+        else if (command == "set_daylight") {       // 处理“闭环日光补偿”命令（需先完成自身光照扫描）
+            lightCommand.type = LIGHT_CMD_DAYLIGHT;
+            lightCommand.enable = doc["enable"];    // true/false
+            lightCommand.value = doc["target_lux"] | 0.0f;  // 目标照度（lux），缺省时保持原目标
+            lightTaskPostCommand(&lightCommand);
+            Serial.printf("闭环日光补偿: %d\n", lightCommand.enable);
+        }
+        else if (command == "set_solar_forecast") {     // 处理“太阳能预报”命令（0 全阴 ~ 1 晴好，预报越差越早降额）
+            float factor = doc["factor"] | POWER_FORECAST_DEFAULT;
+            uint32_t duration = doc["duration"] | POWER_FORECAST_TTL_DEFAULT_S;    // 有效期（秒），0为长期有效
+            powerSetSolarForecast(factor, durationToMs(duration));
+            Serial.printf("太阳能预报系数: %.2f，有效期: %us\n", factor, (unsigned) duration);
+        }
+        else if (command == "set_cct") {            // 处理“色温”命令：kelvin 为固定色温，0或缺省时恢复自动曲线
+            lightCommand.type = LIGHT_CMD_CCT;
+            lightCommand.value = doc["kelvin"] | 0.0f;
+            lightTaskPostCommand(&lightCommand);
+            Serial.printf("色温: %.0fK\n", lightCommand.value);
+        }
+        else if (command == "set_spatial") {        // 处理“空间效果”命令：逐灯珠配光增益与热点权重（百分比），运动波起点
+            JsonArray gainArray = doc["gains"];     // 缺省为均匀配光
+            JsonArray hotArray = doc["hotspots"];   // 缺省为没有热点
+            bool staged = true;
+            for (uint16_t i = 0; i < ledCount && staged; i++) {     // 逐颗暂存，长灯带不占用回调栈空间
+                int gain = i < gainArray.size() ? gainArray[i].as<int>() : 100;
+                int hot = i < hotArray.size() ? hotArray[i].as<int>() : 0;
+                staged = ledOutputStageSpatial(i, (uint16_t) map(constrain(gain, 0, 100), 0, 100, 0, SPATIAL_GAIN_ONE),
+                                               (uint16_t) map(constrain(hot, 0, 100), 0, 100, 0, SPATIAL_GAIN_ONE));
+            }
+            int16_t pirLed = doc["pir_led"] | -1;   // 缺省保持原值
+            if (!staged) {                          // 上一次配置还在等待灯控任务应用，整条拒绝
+                Serial.println("空间效果配置被拒绝：上一次配置尚未应用，请稍后重试");
+            }
+            else if (ledOutputCommitSpatial(pirLed)) {
+                lightCommand.type = LIGHT_CMD_SPATIAL;
+                if (lightTaskPostCommand(&lightCommand)) {
+                    Serial.println("空间效果配置已更新");
+                }
+                else {                              // 命令队列已满：释放暂存区，否则之后的配置都会被拒绝
+                    ledOutputCancelSpatial();
+                    Serial.println("空间效果配置被拒绝：灯控命令队列已满，请稍后重试");
+                }
+            }
+        }
+        else if (command == "set_led_layout") {     // 处理“灯珠布局”命令：灯珠数量与输出路数，保存后重启生效
+            uint16_t count = doc["count"] | ledCount;
+            uint8_t outputs = doc["outputs"] | ledOutputs;
+            if (ledOutputSaveLayout(count, outputs)) {
+                Serial.printf("灯珠布局已保存: %u颗，%u路输出，重启后生效\n", count, outputs);
+            }
+        }
+        else if (command == "set_time") {           // 处理“设置时间”命令：epoch 为UNIX时间（秒），无法SNTP校时的现场使用
+            uint32_t epoch = doc["epoch"] | 0UL;
+            if (epoch >= CLOCK_VALID_EPOCH) {
+                clockSetEpoch(epoch);
+                lightTaskNotify(LIGHT_EVENT_CONTROL);   // 灯控任务按新时间重新查表
+                Serial.printf("时间已设置: %u\n", (unsigned) epoch);
+            }
+        }
+        else if (command == "set_schedule") {       // 处理“时间表”命令：缺省的字段保持原值，亮度均为百分比，时刻为一天中的分钟数
+            schedule_config_t config = scheduleConfig;
+            config.enabled = doc["enabled"] | config.enabled;
+            config.latitude = doc["latitude"] | config.latitude;
+            config.longitude = doc["longitude"] | config.longitude;
+            config.utcOffsetMin = doc["utc_offset"] | config.utcOffsetMin;
+            config.sunsetOffsetMin = doc["sunset_offset"] | config.sunsetOffsetMin;
+            config.sunriseOffsetMin = doc["sunrise_offset"] | config.sunriseOffsetMin;
+            if (!doc["day_level"].isNull()) {
+                config.dayLevel = LEVEL_8_TO_16(map(constrain(doc["day_level"].as<int>(), 0, 100), 0, 100, 0, 255));
+            }
+            JsonArray weekdayArray = doc["weekday_levels"];     // 7项，星期日在前
+            for (uint8_t i = 0; i < 7 && i < weekdayArray.size(); i++) {
+                config.weekdayLevel[i] = LEVEL_8_TO_16(map(constrain(weekdayArray[i].as<int>(), 0, 100), 0, 100, 0, 255));
+            }
+            config.curfewStartMin = (uint16_t) constrain(doc["curfew_start"] | (int) config.curfewStartMin, 0, 1439);
+            config.curfewEndMin = (uint16_t) constrain(doc["curfew_end"] | (int) config.curfewEndMin, 0, 1439);
+            if (!doc["curfew_level"].isNull()) {
+                config.curfewLevel = LEVEL_8_TO_16(map(constrain(doc["curfew_level"].as<int>(), 0, 100), 0, 100, 0, 255));
+            }
+            scheduleStage(&config);
+            Serial.printf("时间表已更新: %s\n", config.enabled ? "启用" : "停用");
+        }
+        else if (command == "commission_daylight") {    // 处理“自身光照扫描”命令（建议夜间、环境光稳定时执行）
+            lightCommand.type = LIGHT_CMD_COMMISSION;
+            lightTaskPostCommand(&lightCommand);
+            Serial.println("开始自身光照扫描");
+        }
+        else if (command == "calibrate_adc") {      // 处理“ADC两点校正”命令：point 为0或1，actual_mv 为此刻测得的实际电压
+            String channelName = doc["channel"] | "battery";    // battery / solar
+            uint8_t channel = channelName == "solar" ? ADC_CH_SOLAR : ADC_CH_BATTERY;
+            if (doc["clear"] | false) {
+                adcCalibrationClear(channel);
+                Serial.printf("ADC校正已清除: %s\n", channelName.c_str());
+            }
+            else {
+                int point = doc["point"] | -1;
+                long actualMv = doc["actual_mv"] | 0L;
+                if ((point != 0 && point != 1) || actualMv <= 0 || actualMv > 65535) {
+                    Serial.println("ADC校正参数无效：point 应为0或1，actual_mv 应为正的毫伏数");
+                }
+                else if (adcCalibrationCapture(channel, (uint8_t) point, (uint16_t) actualMv)) {
+                    Serial.printf("ADC两点校正已保存: %s\n", channelName.c_str());
+                }
+            }
+        }
+        else if (command == "set_solar_expectation") {  // 处理“发电量期望”命令：expected_wh 为晴好天气的每日太阳能输入，0 清除
+            solar_expectation_t expectation = {};
+            expectation.version = SOLAR_EXPECT_VERSION;
+            expectation.expectedWh = (uint16_t) constrain(doc["expected_wh"] | 0, 0, 65535);
+            expectation.minRatioPercent = (uint8_t) constrain(doc["min_ratio"] | SOLAR_EXPECT_RATIO_DEFAULT, 0, 100);
+            expectation.days = (uint8_t) constrain(doc["days"] | SOLAR_EXPECT_DAYS_DEFAULT, 0, SOLAR_HISTORY_DAYS);
+            solarExpectationSet(&expectation);      // 参数无效时清除
+            Serial.printf("发电量期望: %uWh，门限%u%%，连续%u天\n", expectation.expectedWh,
+                          expectation.minRatioPercent, expectation.days);
         }
         esp_task_wdt_reset();                       // 处理完命令后再次喂狗
     }
@@ -166,24 +314,140 @@ void mqttSendData() {
     if (mqttClient.connected()) {       // 仅在已连接状态下发送
         JsonDocument doc;               // 创建JSON文档对象
         doc["ambient_light"] = lux;     // 环境亮度
-        uint8_t currentBrightness = isAuto ? brightnessAuto : brightness;   // 当前灯光亮度（0-255），根据模式选择
-        uint8_t brightness100 = map(currentBrightness, 0, 255, 0, 100);     // 转换为百分比
+        uint8_t brightness100 = map(LEVEL_16_TO_8(currentBrightness), 0, 255, 0, 100);  // 当前灯光亮度转换为百分比
         doc["light_brightness"] = brightness100;        // 灯光亮度百分比
         doc["temperature"] = temp.temperature;          // 环境温度
         doc["humidity"] = humidity.relative_humidity;   // 环境湿度
-        doc["pm25"] = pm25_concentration;               // PM2.5传感器数值
+        air_quality_report_t air;                       // 颗粒物滚动统计（上报统计值而不是单个读数）
+        pm25_get_air_quality(&air);
+        static const char *const pm25Keys[AQ_WINDOWS] = {"pm25", "pm25_15m", "pm25_1h", "pm25_24h"};
+        static const char *const pm10Keys[AQ_WINDOWS] = {"pm10", "pm10_15m", "pm10_1h", "pm10_24h"};
+        for (uint8_t i = 0; i < AQ_WINDOWS; i++) {      // 1分钟平均沿用 pm25/pm10 键名；窗口内没有数据时不上报
+            if (air.pm25Mean[i] >= 0.0f) {
+                doc[pm25Keys[i]] = air.pm25Mean[i];
+            }
+            if (air.pm10Mean[i] >= 0.0f) {
+                doc[pm10Keys[i]] = air.pm10Mean[i];
+            }
+        }
+        if (air.pm25NowCast >= 0.0f) {
+            doc["pm25_nowcast"] = air.pm25NowCast;      // PM2.5 NowCast（最近12小时加权）
+        }
+        doc["aqi"] = air.aqi;                           // 当前AQI（NowCast，-1 表示数据不足）
+        doc["aqi_24h"] = air.aqi24h;                    // 24小时AQI
+        pm25_sample_t pm = pm25_get_sample();           // 最近样本（各字段来自同一帧）
+        if (!pm.stale && pm.pm1 >= 0.0f) {
+            doc["pm1"] = pm.pm1;                        // PM1.0最近读数（仅PMS5003提供）
+        }
+        doc["pm_stale"] = pm.stale;                     // 颗粒物传感器是否已停止发送（或尚未收到有效帧）
+        doc["pm_protocol"] = particleProtocolName(pm.protocol);     // 识别出的颗粒物传感器协议
+        const particle_stats_t *pmStats = particleParserStats(&particle_parser);   // 识别阶段为空
+        doc["pm25_frames"] = pmStats ? pmStats->goodFrames : 0;             // 有效帧数
+        doc["pm25_bad_checksum"] = pmStats ? pmStats->badChecksums : 0;     // 长度或校验失败的候选帧数
+        doc["pm25_resyncs"] = pmStats ? pmStats->resyncs : 0;               // 丢弃字节后重新同步的次数
+        doc["pm25_discarded"] = pmStats ? pmStats->bytesDiscarded : 0;      // 丢弃的字节数
         doc["battery_level"] = battery_percentage;      // 电池电量百分比
-        doc["solar_voltage"] = solar_mV / 1000.0;       // 太阳能电压
-        doc["auto_mode"] = isAuto;                      // 当前模式
+        doc["battery_voltage"] = battery_mV / 1000.0;   // 电池电压
+        solar_report_t solar;                           // 太阳能收益摘要（上报能量统计而不是电压读数）
+        solarHarvestGetReport(&solar);
+        doc["solar_today_wh"] = solar.today.solarMWh / 1000.0;          // 当天估算的太阳能输入
+        doc["solar_today_charge_wh"] = solar.today.chargeMWh / 1000.0;  // 当天电池充入能量
+        doc["solar_charge_minutes"] = solar.today.chargeMinutes;        // 当天充电时长（分钟）
+        if (solar.yesterday.day != 0) {                 // 最近完整日（完整记录另见每日摘要主题）
+            doc["solar_yesterday_wh"] = solar.yesterday.solarMWh / 1000.0;
+            doc["solar_peak_hour"] = solar.peakHour;    // 收益最高的小时
+        }
+        doc["solar_low_days"] = solar.lowDays;          // 连续欠发天数
+        doc["solar_underperforming"] = solar.underperforming;  // 是否欠发（面板脏污、遮挡或故障）
+        doc["adc_cal"] = adcCalibrationSource();        // ADC芯片特性参数来源（efuse / default）
+        doc["adc_cal_battery"] = adcCalibrationIsCorrected(ADC_CH_BATTERY);    // 电池通道是否有两点校正
+        doc["adc_cal_solar"] = adcCalibrationIsCorrected(ADC_CH_SOLAR);        // 太阳能通道是否有两点校正
+        doc["auto_mode"] = brightnessIsAuto();          // 当前模式（无紧急照明/远程设置即为自动）
+        doc["brightness_source"] = arbiterSourceName(brightnessSource);    // 当前胜出的亮度来源
+        doc["daylight_mode"] = daylightMode;            // 是否处于闭环日光补偿模式
+        doc["daylight_target"] = daylightTargetLux;     // 闭环目标照度
+        doc["motion_hold_ms"] = motionHoldMs;           // 当前运动增亮保持时间（按到达间隔自适应）
+        doc["led_power_w"] = ledPower.powerMw / 1000.0;                         // LED当前功率
+        doc["led_energy_wh"] = powerMeterEnergyMWh(&ledPower, millis()) / 1000.0;   // 本次启动以来的LED能耗
+        doc["led_energy_total_wh"] = powerLedTotalMWh() / 1000.0;                // LED累计能耗（含历次启动）
+        doc["power_limit"] = (int) (brightnessPowerLimit * 100.0f + 0.5f);       // 功率预算限额（线性输出百分比）
+        doc["solar_forecast"] = solarForecast;          // 太阳能预报系数
+        doc["visibility_gain"] = (int) (brightnessVisibilityGain * 100.0f + 0.5f);   // 能见度补偿增益（百分比，100为不补偿）
+        doc["color_temp"] = (int) (ledColor.kelvin + 0.5f);     // 当前色温（K）
+        doc["cct_mode"] = ledColor.mode == CCT_MODE_FIXED ? "fixed" : "auto";   // 色温模式
+        doc["led_count"] = ledCount;                    // 灯珠数量
+        doc["clock_source"] = clockSourceName(clockSource);     // 时间来源
+        doc["schedule_cap"] = scheduleCap == SCHEDULE_LEVEL_NONE ? 100 : map(LEVEL_16_TO_8(scheduleCap), 0, 255, 0, 100);   // 时间表亮度上限（百分比）
+        doc["sunrise"] = schedulePlan.sunriseMin;       // 当天本地日出时刻（分钟，极昼/极夜或未对时为-1）
+        doc["sunset"] = schedulePlan.sunsetMin;         // 当天本地日落时刻（分钟）
+        doc["pixel_stream"] = (bool) ledStreaming;      // 是否处于DDP像素流模式
+        doc["stream_frames"] = ledStream.frames;        // 已接收的像素流帧数
+        doc["stream_dropped"] = ledStream.late + ledStream.invalid;    // 迟到、重复或格式错误而丢弃的数据包数
+        doc["led_frames_sent"] = (uint32_t) ledFramesSent;   // 已发送的LED帧数
+        doc["led_frames_skipped"] = (uint32_t) ledFramesSkipped;   // 与上一帧相同而跳过的帧数
+        JsonObject i2c = doc["i2c"].to<JsonObject>();   // I2C总线统计（逐设备事务数、失败数与延迟）
+        for (uint8_t i = 0; i < I2C_DEVICES; i++) {
+            i2c_device_stats_t stats;
+            i2cBusGetStats(i, &stats);
+            JsonObject device = i2c[i2cDeviceName(i)].to<JsonObject>();
+            device["ops"] = stats.transactions;         // 事务数
+            device["errors"] = stats.errors;            // 失败数
+            device["avg_us"] = stats.transactions ? (uint32_t) (stats.totalUs / stats.transactions) : 0;  // 平均总线占用时间
+            device["max_us"] = stats.maxUs;             // 最长总线占用时间
+            device["max_wait_us"] = stats.maxWaitUs;    // 最长排队时间
+        }
+        i2c_bus_stats_t bus;
+        i2cBusGetBusStats(&bus);
+        i2c["stuck_faults"] = bus.stuckFaults;          // SDA/SCL被拉低的次数
+        i2c["recoveries"] = bus.recoveries;             // 总线恢复（重新初始化）次数
+        i2c["stuck"] = bus.stuck;                       // 恢复后总线仍被拉低
         String payload;                                 // 序列化JSON为字符串
         serializeJson(doc, payload);             // 序列化JSON为字符串以便发布
         mqttClient.publish(mqttTopicData, payload.c_str());     // 发布到数据主题
+        if (solar.yesterday.day != 0 && solar.yesterday.day != solarPublishedDay
+            && mqttSendSolarSummary(&solar)) {          // 新的完整日：发布每日摘要（失败时下次重试）
+            solarPublishedDay = solar.yesterday.day;
+        }
     }
     mqttClient.loop();                  // 处理MQTT事务
     esp_task_wdt_reset();               // 喂看门狗，防止信息发送过程超时
     Serial.println("发送传感器数据成功");
 }
 
+/*
+ * 发布太阳能每日摘要（最近完整日的能量统计与24小时收益曲线）
+ * 返回值：发布成功时返回 true
+ */
+bool mqttSendSolarSummary(const solar_report_t *solar) {
+    const solar_day_t *day = &solar->yesterday;
+    JsonDocument doc;
+    doc["device_id"] = DEVICE_ID;                   // 设备唯一标识
+    time_t dayStart = (time_t) day->day * 86400;
+    struct tm date;
+    gmtime_r(&dayStart, &date);                     // 日期序号已按本地时区计算
+    char dateText[11];
+    strftime(dateText, sizeof(dateText), "%Y-%m-%d", &date);
+    doc["date"] = dateText;                         // 本地日期
+    doc["solar_wh"] = day->solarMWh / 1000.0;       // 估算的太阳能输入
+    doc["charge_wh"] = day->chargeMWh / 1000.0;     // 电池充入能量
+    doc["charge_minutes"] = day->chargeMinutes;     // 充电时长（分钟）
+    doc["covered_minutes"] = day->coveredMinutes;   // 有记录的分钟数
+    doc["peak_hour"] = solar->peakHour;             // 收益最高的小时
+    doc["peak_wh"] = day->hourly[solar->peakHour] * SOLAR_HOUR_UNIT_MWH / 1000.0;  // 该小时的收益（即平均功率W）
+    JsonArray hourly = doc["hourly_wh"].to<JsonArray>();    // 24小时收益曲线
+    for (uint8_t i = 0; i < 24; i++) {
+        hourly.add(day->hourly[i] * SOLAR_HOUR_UNIT_MWH / 1000.0);
+    }
+    doc["forecast"] = day->forecastPercent / 100.0; // 当天的太阳能预报系数
+    doc["saturated"] = (day->flags & SOLAR_DAY_FLAG_SATURATED) != 0;    // 电池曾充满（不参与欠发判断）
+    doc["partial"] = (day->flags & SOLAR_DAY_FLAG_PARTIAL) != 0;        // 记录不完整（不参与欠发判断）
+    doc["low_days"] = solar->lowDays;               // 连续欠发天数
+    doc["underperforming"] = solar->underperforming;    // 是否欠发
+    String payload;
+    serializeJson(doc, payload);
+    return mqttClient.publish(mqttTopicSolar, payload.c_str());
+}
+
 /*
  * 发送心跳包（维持连接活跃、上报设备在线状态）
  */
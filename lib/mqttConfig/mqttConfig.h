@@ -26,6 +26,7 @@
 #include <WiFi.h>
 #include <PubSubClient.h>
 #include "esp_task_wdt.h"
+#include "solarHarvest.h"
 
 
 #define MQTT_BROKER_ADDR "192.168.43.20"    // 服务器地址
@@ -36,12 +37,14 @@
 #define MQTT_CLIENT_ID "esp32_client"       // 客户端ID
 #define MQTT_CONNECT_TIMEOUT 5000           // MQTT连接超时时间(毫秒)
 #define MQTT_MAX_RETRY_COUNT 3              // 最大重试次数
+#define MQTT_DURATION_MAX_S 2592000UL       // 命令有效期上限（30天，秒），更长的有效期按此值处理，换算为毫秒时不溢出
 #define DEVICE_PREFIX "LIGHT_"                  // 设备ID前缀
 #define DEVICE_NUMBER "1"                       // 设备编号（根据实际设备修改）
 #define DEVICE_ID DEVICE_PREFIX DEVICE_NUMBER   // 设备ID（唯一标识符）
 #define MQTT_TOPIC_DATA "device/" DEVICE_ID "/data"             // 数据上报主题
 #define MQTT_TOPIC_HEARTBEAT "device/" DEVICE_ID "/heartbeat"   // 心跳包主题
 #define MQTT_TOPIC_CONTROL "device/" DEVICE_ID "/control"       // 控制命令订阅主题
+#define MQTT_TOPIC_SOLAR "device/" DEVICE_ID "/solar"           // 太阳能每日摘要主题（每天一次）
 
 
 extern WiFiClient tcpClient;        // PubSubClient 实例，负责MQTT协议通信
@@ -52,5 +55,6 @@ void mqttConfig();
 void mqttConnect();
 void mqttSendData();
 void mqttSendHeartbeat();
+bool mqttSendSolarSummary(const solar_report_t *solar);
 
 #endif //PLANTFORM_CLIONTEST_MQTTCONFIG_H
\ No newline at end of file
@@ -0,0 +1,181 @@
+/**
+ * @file occupancyModel.cpp
+ * @brief 运动到达间隔统计与自适应保持时间模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现按小时分桶的到达间隔分位数估计：
+ * - 同一次经过中PIR的连续触发（间隔小于 OCCUPANCY_MIN_GAP_MS）只刷新时间，不计入统计，
+ *   因此统计的是“上一位离开到下一位到达”的空闲间隔，正是保持时间需要跨越的长度
+ * - 每个事件同时更新所在小时桶和公共桶，小时桶样本不足时用公共桶
+ * - 保持时间：把5个分位数看作离散分布（每个分位数代表一段概率质量），候选值为下限、上限、默认值与各分位数 × 余量，
+ *   取期望代价最小者。代价 = Σ 质量 × (间隔 <= 保持 ? 间隔 : 保持 + 升亮代价)
+ * - 升亮代价 × (1 + OCCUPANCY_RAMP_WITNESS_MS / 间隔中位数)：到达间隔服从指数分布时，只有升亮代价大于平均间隔才值得延长保持，
+ *   固定的代价要么在所有时段都不延长，要么在所有时段都延长到上限，按密度放大后只有繁忙时段延长
+ * - 期望满亮时间 Σ 质量 × min(间隔, 保持) 超过默认保持时间的 energyCap 倍的候选值被排除
+ */
+
+#include "occupancyModel.h"
+#include <cmath>
+
+/* 各分位数的概率与代表的概率质量（相邻分位数中点之间） */
+static const float quantileP[OCCUPANCY_QUANTILES] = {0.10f, 0.25f, 0.50f, 0.75f, 0.90f};
+static const float quantileMass[OCCUPANCY_QUANTILES] = {0.175f, 0.20f, 0.25f, 0.20f, 0.175f};
+
+/**
+ * 初始化模型，所有分位数从默认保持时间开始
+ */
+void occupancyInit(occupancy_model_t *model, uint32_t defaultHoldMs) {
+    float initial = logf((float) defaultHoldMs);
+    model->version = OCCUPANCY_VERSION;
+    for (occupancy_bucket_t &bucket : model->buckets) {
+        for (float &quantile : bucket.logQuantiles) {
+            quantile = initial;
+        }
+        bucket.samples = 0;
+    }
+    model->lastEventMs = 0;
+    model->hasLastEvent = false;
+}
+
+/**
+ * 检查模型数据是否有效（从NVS读取后调用）
+ */
+bool occupancyIsValid(const occupancy_model_t *model) {
+    if (model->version != OCCUPANCY_VERSION) {
+        return false;
+    }
+    for (const occupancy_bucket_t &bucket : model->buckets) {
+        for (float quantile : bucket.logQuantiles) {
+            if (!std::isfinite(quantile)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * 随机逼近更新一个分位数：q += η·(p - [x <= q])
+ */
+static float updateQuantile(float quantile, float sample, float p, float rate) {
+    return quantile + rate * (p - (sample <= quantile ? 1.0f : 0.0f));
+}
+
+/**
+ * 把一个间隔样本计入桶
+ */
+static void updateBucket(occupancy_bucket_t *bucket, float logGap) {
+    float rate = OCCUPANCY_LEARN_RATE_INIT / (1.0f + (float) bucket->samples / OCCUPANCY_MIN_SAMPLES);
+    if (rate < OCCUPANCY_LEARN_RATE) {
+        rate = OCCUPANCY_LEARN_RATE;
+    }
+    for (uint8_t i = 0; i < OCCUPANCY_QUANTILES; i++) {
+        if (bucket->samples == 0) {     // 第一个样本直接作为初值
+            bucket->logQuantiles[i] = logGap;
+        }
+        else {
+            bucket->logQuantiles[i] = updateQuantile(bucket->logQuantiles[i], logGap, quantileP[i], rate);
+        }
+    }
+    if (bucket->samples < UINT16_MAX) {
+        bucket->samples++;
+    }
+}
+
+/**
+ * 记录一次运动事件
+ * 参数：hour - 当前小时（0~23），未知时为负数；timeMs - 事件时间（毫秒）
+ */
+void occupancyRecord(occupancy_model_t *model, int8_t hour, uint32_t timeMs) {
+    uint32_t gap = timeMs - model->lastEventMs;
+    bool counted = model->hasLastEvent && gap >= OCCUPANCY_MIN_GAP_MS;
+    model->lastEventMs = timeMs;
+    model->hasLastEvent = true;
+    if (!counted) {
+        return;                         // 第一个事件或同一次经过的连续触发
+    }
+    if (gap > OCCUPANCY_MAX_GAP_MS) {
+        gap = OCCUPANCY_MAX_GAP_MS;
+    }
+    float logGap = logf((float) gap);
+    if (hour >= 0 && hour < OCCUPANCY_HOURS) {
+        updateBucket(&model->buckets[hour], logGap);
+    }
+    updateBucket(&model->buckets[OCCUPANCY_HOUR_ANY], logGap);
+}
+
+/**
+ * 选择用于决策的桶：小时桶样本足够时用小时桶，否则用公共桶，都不足时返回空
+ */
+static const occupancy_bucket_t *selectBucket(const occupancy_model_t *model, int8_t hour) {
+    if (hour >= 0 && hour < OCCUPANCY_HOURS && model->buckets[hour].samples >= OCCUPANCY_MIN_SAMPLES) {
+        return &model->buckets[hour];
+    }
+    if (model->buckets[OCCUPANCY_HOUR_ANY].samples >= OCCUPANCY_MIN_SAMPLES) {
+        return &model->buckets[OCCUPANCY_HOUR_ANY];
+    }
+    return nullptr;
+}
+
+/**
+ * 计算运动增亮保持时间
+ * 参数：hour - 当前小时（未知时为负数）；minMs/maxMs - 保持时间上下限；defaultMs - 样本不足时的保持时间
+ *       rampCostMs - 一次熄灭再升亮的代价（折算为满亮保持时间），越大越倾向于延长保持
+ *       energyCap - 期望满亮时间相对默认保持时间的上限倍数
+ * 返回值：保持时间（毫秒）
+ */
+uint32_t occupancyHoldTime(const occupancy_model_t *model, int8_t hour, uint32_t minMs, uint32_t maxMs,
+                           uint32_t defaultMs, uint32_t rampCostMs, float energyCap) {
+    const occupancy_bucket_t *bucket = selectBucket(model, hour);
+    if (bucket == nullptr) {
+        return defaultMs;
+    }
+    float gaps[OCCUPANCY_QUANTILES];
+    float candidates[OCCUPANCY_QUANTILES + 3] = {(float) minMs, (float) maxMs, (float) defaultMs};
+    for (uint8_t i = 0; i < OCCUPANCY_QUANTILES; i++) {
+        gaps[i] = expf(bucket->logQuantiles[i]);
+        float candidate = gaps[i] * OCCUPANCY_HOLD_MARGIN;
+        candidates[i + 3] = candidate < (float) minMs ? (float) minMs : (candidate > (float) maxMs ? (float) maxMs : candidate);
+    }
+
+    /* 升亮代价按到达密度放大：繁忙时段一次熄灭再升亮会被更多行人看到 */
+    float rampCost = (float) rampCostMs * (1.0f + OCCUPANCY_RAMP_WITNESS_MS / gaps[2]);
+    /* 能耗上限：每次运动的期望满亮时间不超过默认保持时间的 energyCap 倍 */
+    float onLimit = 0.0f;
+    for (uint8_t i = 0; i < OCCUPANCY_QUANTILES; i++) {
+        onLimit += quantileMass[i] * (gaps[i] <= (float) defaultMs ? gaps[i] : (float) defaultMs);
+    }
+    onLimit *= energyCap;
+
+    float bestHold = (float) minMs;
+    float bestCost = INFINITY;
+    for (float hold : candidates) {
+        float cost = 0.0f;
+        float onTime = 0.0f;
+        for (uint8_t i = 0; i < OCCUPANCY_QUANTILES; i++) {
+            float on = gaps[i] <= hold ? gaps[i] : hold;
+            onTime += quantileMass[i] * on;
+            cost += quantileMass[i] * (gaps[i] <= hold ? on : on + rampCost);
+        }
+        if (onTime > onLimit && hold > (float) minMs) {
+            continue;                   // 超出能耗上限（下限总是允许）
+        }
+        if (cost < bestCost || (cost == bestCost && hold < bestHold)) {    // 代价相同时取较短的保持时间
+            bestCost = cost;
+            bestHold = hold;
+        }
+    }
+    return (uint32_t) bestHold;
+}
+
+/**
+ * 到达间隔中位数（用于上报），样本不足时返回0
+ */
+uint32_t occupancyMedianGap(const occupancy_model_t *model, int8_t hour) {
+    const occupancy_bucket_t *bucket = selectBucket(model, hour);
+    return bucket == nullptr ? 0 : (uint32_t) expf(bucket->logQuantiles[2]);
+}
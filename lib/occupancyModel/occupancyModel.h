@@ -0,0 +1,64 @@
+/**
+ * @file occupancyModel.h
+ * @brief 运动到达间隔统计与自适应保持时间模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为自适应运动保持时间模块头文件，包含如下内容：
+ * - 按小时分桶的到达间隔流式分位数估计
+ * - 根据分位数计算运动增亮保持时间的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 到达间隔在对数域中用随机逼近法估计5个分位数：q += η·(p - [x <= q])，每个分位数只需一个浮点数
+ * - 保持时间在候选值中按期望代价选择：代价 = 保持期间的满亮时间 + 未等到下一位行人时的一次升亮代价
+ *   （升亮代价由调用者给出，折算为满亮保持时间，并按到达密度放大：越繁忙，一次熄灭再升亮被看到的越多），
+ *   繁忙时段下一位行人大概率很快到达，延长保持避免反复熄灭与升亮；冷清时段缩短到下限，减少空耗
+ * - 期望满亮时间不超过默认保持时间的 energyCap 倍，限制繁忙时段延长保持增加的能耗
+ * - 小时未知（尚未对时）时使用不分时段的公共桶 OCCUPANCY_HOUR_ANY
+ * - 结构体为纯数据，可直接整体保存到NVS；本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_OCCUPANCYMODEL_H
+#define LIGHTPROJECT_OCCUPANCYMODEL_H
+
+#include <cstdint>
+
+#define OCCUPANCY_HOURS 24                  // 按小时分桶
+#define OCCUPANCY_HOUR_ANY OCCUPANCY_HOURS  // 小时未知时使用的公共桶
+#define OCCUPANCY_VERSION 1                 // 结构体版本（NVS中保存的数据版本不符时丢弃）
+
+#define OCCUPANCY_MIN_GAP_MS 1500           // 小于此间隔视为同一次经过（PIR持续触发），不计入统计
+#define OCCUPANCY_MAX_GAP_MS 600000         // 间隔上限（10分钟），更长的间隔按此值计入
+#define OCCUPANCY_QUANTILES 5               // 分位数个数（10%、25%、50%、75%、90%）
+#define OCCUPANCY_HOLD_MARGIN 1.2f          // 候选保持时间的余量（覆盖下一次触发前的走动时间）
+#define OCCUPANCY_MIN_SAMPLES 8             // 分桶样本数达到此值后才启用自适应
+#define OCCUPANCY_LEARN_RATE_INIT 1.0f      // 分位数初始学习率（对数域），随样本数递减
+#define OCCUPANCY_LEARN_RATE 0.05f          // 分位数学习率下限（对数域，约5%），保证能跟上季节变化
+#define OCCUPANCY_RAMP_WITNESS_MS 10000.0f  // 升亮代价按 (1 + 此值 / 间隔中位数) 放大，到达越密集一次升亮越显眼
+
+/* 单个时段的统计 */
+typedef struct {
+    float logQuantiles[OCCUPANCY_QUANTILES];    // 到达间隔分位数（ln 毫秒，按概率从小到大）
+    uint16_t samples;                           // 已计入的样本数（饱和）
+} occupancy_bucket_t;
+
+/* 模型 */
+typedef struct {
+    uint8_t version;                                    // 结构体版本
+    occupancy_bucket_t buckets[OCCUPANCY_HOURS + 1];    // 24个小时桶 + 公共桶
+    uint32_t lastEventMs;                               // 上一次运动事件时间
+    bool hasLastEvent;                                  // 是否有上一次运动事件
+} occupancy_model_t;
+
+void occupancyInit(occupancy_model_t *model, uint32_t defaultHoldMs);
+bool occupancyIsValid(const occupancy_model_t *model);
+void occupancyRecord(occupancy_model_t *model, int8_t hour, uint32_t timeMs);
+uint32_t occupancyHoldTime(const occupancy_model_t *model, int8_t hour, uint32_t minMs, uint32_t maxMs,
+                           uint32_t defaultMs, uint32_t rampCostMs, float energyCap);
+uint32_t occupancyMedianGap(const occupancy_model_t *model, int8_t hour);
+
+#endif //LIGHTPROJECT_OCCUPANCYMODEL_H
@@ -20,6 +20,7 @@
  *
  * @note
  * 为保证中文显示正常 请将编译器的字符集设置为UTF-8
+ * 底层发送经I2C总线任务（i2cBus）执行，刷新屏幕时每页一个事务，优先级低于传感器读取
  *
  */
 #include <Arduino.h>
@@ -27,9 +28,9 @@
 #include <cstdlib>
 #include "oled.h"
 
-#include <driver/i2c.h>
+#include "i2cBus.h"
 
-#define I2C_NUM     I2C_NUM_0
+#define I2C_NUM     I2C_BUS_PORT
 
 // OLED器件地址
 #define OLED_ADDRESS 0x3C
@@ -45,13 +46,13 @@ uint8_t OLED_GRAM[OLED_PAGE][OLED_COLUMN];
 // ========================== 底层通信函数 ==========================
 
 /**
- * @brief 向OLED发送数据的函数
+ * @brief 向OLED写入一次数据（在I2C总线任务中执行）
  * @param data 要发送的数据
  * @param len 要发送的数据长度
- * @return None
+ * @return 是否收到全部应答
  * @note 此函数是移植本驱动时的重要函数 将本驱动库移植到其他平台时应根据实际情况修改此函数
  */
-void OLED_Send(const uint8_t *data, uint8_t len) {
+static bool OLED_Write(const uint8_t *data, uint8_t len) {
     i2c_cmd_handle_t cmd = i2c_cmd_link_create();               // 创建I2C命令链句柄，用于构建I2C传输命令序列
     i2c_master_start(cmd);                                      // 添加I2C起始信号到命令链
     /* 添加设备地址写入命令到命令链， (OLED_ADDRESS << 1) | I2C_MASTER_WRITE 构成7位地址+1位读写位的8位地址 */
@@ -59,8 +60,31 @@ void OLED_Send(const uint8_t *data, uint8_t len) {
     /* 添加数据写入命令到命令链，data: 要发送的数据缓冲区指针，len: 数据长度，true表示需要等待每个字节的ACK应答信号 */
     i2c_master_write(cmd, data, len, true);
     i2c_master_stop(cmd);                                       // 添加I2C停止信号到命令链
-    i2c_master_cmd_begin(I2C_NUM, cmd, pdMS_TO_TICKS(10));      // 执行命令链中的所有I2C操作
+    esp_err_t err = i2c_master_cmd_begin(I2C_NUM, cmd, pdMS_TO_TICKS(10));     // 执行命令链中的所有I2C操作
     i2c_cmd_link_delete(cmd);                                   // 删除命令链，释放内存资源
+    return err == ESP_OK;
+}
+
+/* 一次写入的参数（位于调用者栈上） */
+typedef struct {
+    const uint8_t *data;
+    uint8_t len;
+} OLED_SendArgs;
+
+static bool OLED_SendJob(void *context) {
+    const OLED_SendArgs *args = (const OLED_SendArgs *) context;
+    return OLED_Write(args->data, args->len);
+}
+
+/**
+ * @brief 向OLED发送数据的函数
+ * @param data 要发送的数据
+ * @param len 要发送的数据长度
+ * @note 经I2C总线任务以屏幕刷新优先级执行，与传感器读取不会在总线上交错
+ */
+void OLED_Send(const uint8_t *data, uint8_t len) {
+    OLED_SendArgs args = {data, len};
+    i2cBusRun(I2C_DEV_OLED, I2C_PRIO_DISPLAY, OLED_SendJob, &args);
 }
 
 /**
@@ -170,19 +194,28 @@ void OLED_NewFrame() {
     memset(OLED_GRAM, 0, sizeof(OLED_GRAM));
 }
 
+/**
+ * @brief 发送一页显存（在I2C总线任务中执行）
+ * @param context 页号
+ * @note 先以连续指令流设置页地址与列地址，再一次写入整页数据
+ */
+static bool OLED_SendPageJob(void *context) {
+    uint8_t page = *(const uint8_t *) context;
+    const uint8_t address[] = {0x00, (uint8_t) (0xB0 + page), 0x00, 0x10};    // 页地址、列地址低4位、列地址高4位
+    static uint8_t sendBuffer[OLED_COLUMN + 1];
+    sendBuffer[0] = 0x40;
+    memcpy(sendBuffer + 1, OLED_GRAM[page], OLED_COLUMN);
+    return OLED_Write(address, sizeof(address)) && OLED_Write(sendBuffer, OLED_COLUMN + 1);
+}
+
 /**
  * @brief 将当前显存显示到屏幕上
  * @note 此函数是移植本驱动时的重要函数 将本驱动库移植到其他驱动芯片时应根据实际情况修改此函数
+ * @note 每页作为一个事务提交，页与页之间总线任务可以先执行等待中的传感器读取；调用者等待每页发送完毕，期间不会修改显存
  */
 void OLED_ShowFrame() {
-    static uint8_t sendBuffer[OLED_COLUMN + 1];
-    sendBuffer[0] = 0x40;
     for (uint8_t i = 0; i < OLED_PAGE; i++) {
-        OLED_SendCmd(0xB0 + i); // 设置页地址
-        OLED_SendCmd(0x00); // 设置列地址低4位
-        OLED_SendCmd(0x10); // 设置列地址高4位
-        memcpy(sendBuffer + 1, OLED_GRAM[i], OLED_COLUMN);
-        OLED_Send(sendBuffer, OLED_COLUMN + 1);
+        i2cBusRun(I2C_DEV_OLED, I2C_PRIO_DISPLAY, OLED_SendPageJob, &i);
     }
 }
 
@@ -0,0 +1,277 @@
+/**
+ * @file particleParser.cpp
+ * @brief 颗粒物传感器多协议流式解析模块实现
+ * @author cepvor
+ * @version 1.1
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现各协议的格式检查、校验和与字段解码，以及协议自动识别：
+ * - 识别阶段每段输入依次交给所有协议的解析器，各自维护窗口与统计
+ * - 某一协议连续（中间没有丢弃字节）解析出 PARTICLE_DETECT_FRAMES 个有效帧即锁定；
+ *   其他协议偶然通过校验的帧几乎不可能连续出现，不会误锁
+ * - 开始接收超过 PARTICLE_DETECT_WINDOW_MS 仍未锁定时（线路噪声较大），锁定有效帧最多的协议
+ * - 锁定后只运行选中的解析器，其他解析器不再占用CPU
+ *
+ * @note
+ * 注意事项：
+ * - 多字节字段按字节拼接，不依赖主机字节序，也不要求帧在内存中对齐
+ * - 识别阶段返回0帧，样本从锁定时刻起发布（锁定时发布选中协议最近一帧）
+ */
+
+#include "particleParser.h"
+
+/* 帧头存储（C++11 下 constexpr 静态数组成员被 memcmp 引用时需要类外定义） */
+constexpr uint8_t A5Protocol::HEADER[];
+constexpr uint8_t Pms5003Protocol::HEADER[];
+constexpr uint8_t Sds011Protocol::HEADER[];
+
+/**
+ * 读取大端16位字段
+ */
+static inline uint16_t readBe16(const uint8_t *p) {
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+/**
+ * 读取小端16位字段
+ */
+static inline uint16_t readLe16(const uint8_t *p) {
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+/**
+ * 清空样本中该协议不提供的字段
+ */
+static void clearSample(particle_sample_t *sample) {
+    sample->pm1 = -1.0f;
+    sample->pm10 = -1.0f;
+    sample->hasCounts = false;
+    memset(sample->counts, 0, sizeof(sample->counts));
+}
+
+/* ==================== A5 协议 ==================== */
+
+bool A5Protocol::checksum(const uint8_t *frame) {
+    return ((frame[0] + frame[1] + frame[2]) & 0x7F) == frame[3];
+}
+
+void A5Protocol::decode(const uint8_t *frame, particle_sample_t *sample) {
+    clearSample(sample);
+    sample->pm25 = (float) (frame[1] * 128 + frame[2]);
+}
+
+/* ==================== PMS5003 协议 ==================== */
+
+bool Pms5003Protocol::framing(const uint8_t *frame) {
+    return readBe16(frame + 2) == FRAME_SIZE - 4;       // 长度字段 = 数据 + 校验和 = 28
+}
+
+bool Pms5003Protocol::checksum(const uint8_t *frame) {
+    uint16_t sum = 0;
+    for (size_t i = 0; i < FRAME_SIZE - 2; i++) {
+        sum = (uint16_t) (sum + frame[i]);
+    }
+    return sum == readBe16(frame + FRAME_SIZE - 2);
+}
+
+void Pms5003Protocol::decode(const uint8_t *frame, particle_sample_t *sample) {
+    /* 第4~9字节为标准颗粒物（CF=1）浓度，室外使用第10~15字节的大气环境浓度 */
+    sample->pm1 = (float) readBe16(frame + 10);
+    sample->pm25 = (float) readBe16(frame + 12);
+    sample->pm10 = (float) readBe16(frame + 14);
+    for (size_t i = 0; i < PARTICLE_COUNT_BINS; i++) {
+        sample->counts[i] = readBe16(frame + 16 + 2 * i);
+    }
+    sample->hasCounts = true;
+}
+
+/* ==================== SDS011 协议 ==================== */
+
+bool Sds011Protocol::framing(const uint8_t *frame) {
+    return frame[FRAME_SIZE - 1] == 0xAB;               // 帧尾
+}
+
+bool Sds011Protocol::checksum(const uint8_t *frame) {
+    uint8_t sum = 0;
+    for (size_t i = 2; i < 8; i++) {
+        sum = (uint8_t) (sum + frame[i]);
+    }
+    return sum == frame[8];
+}
+
+void Sds011Protocol::decode(const uint8_t *frame, particle_sample_t *sample) {
+    clearSample(sample);
+    sample->pm25 = (float) readLe16(frame + 2) / 10.0f;    // 单位 0.1μg/m³
+    sample->pm10 = (float) readLe16(frame + 4) / 10.0f;
+}
+
+/* ==================== 多协议解析器 ==================== */
+
+/**
+ * 锁定协议，并发布选中协议在识别阶段解析出的最近一帧
+ */
+static void lockProtocol(particle_parser_t *parser, uint8_t protocol) {
+    parser->protocol = protocol;
+    switch (protocol) {
+        case PARTICLE_PROTOCOL_A5:
+            parser->sample = parser->a5.sample;
+            break;
+        case PARTICLE_PROTOCOL_PMS5003:
+            parser->sample = parser->pms5003.sample;
+            break;
+        case PARTICLE_PROTOCOL_SDS011:
+            parser->sample = parser->sds011.sample;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 识别阶段：所有解析器并行运行，满足条件时锁定
+ * 返回值：锁定时返回1（发布了一个样本），否则返回0
+ */
+static size_t detectFeed(particle_parser_t *parser, const uint8_t *data, size_t length, uint32_t nowMs) {
+    if (!parser->started) {
+        parser->started = true;
+        parser->startMs = nowMs;
+    }
+    parser->a5.feed(data, length);
+    parser->pms5003.feed(data, length);
+    parser->sds011.feed(data, length);
+
+    uint8_t protocol = PARTICLE_PROTOCOL_NONE;
+    if (parser->pms5003.streak >= PARTICLE_DETECT_FRAMES) {             // 长帧优先：偶然通过校验的可能最小
+        protocol = PARTICLE_PROTOCOL_PMS5003;
+    }
+    else if (parser->sds011.streak >= PARTICLE_DETECT_FRAMES) {
+        protocol = PARTICLE_PROTOCOL_SDS011;
+    }
+    else if (parser->a5.streak >= PARTICLE_DETECT_FRAMES) {
+        protocol = PARTICLE_PROTOCOL_A5;
+    }
+    else if (nowMs - parser->startMs >= PARTICLE_DETECT_WINDOW_MS) {   // 超时：按有效帧覆盖的字节数选择
+        uint32_t best = 0;
+        uint32_t covered = parser->pms5003.stats.goodFrames * (uint32_t) Pms5003Protocol::FRAME_SIZE;
+        if (covered > best) {
+            best = covered;
+            protocol = PARTICLE_PROTOCOL_PMS5003;
+        }
+        covered = parser->sds011.stats.goodFrames * (uint32_t) Sds011Protocol::FRAME_SIZE;
+        if (covered > best) {
+            best = covered;
+            protocol = PARTICLE_PROTOCOL_SDS011;
+        }
+        covered = parser->a5.stats.goodFrames * (uint32_t) A5Protocol::FRAME_SIZE;
+        if (covered > best) {
+            protocol = PARTICLE_PROTOCOL_A5;
+        }
+    }
+    if (protocol == PARTICLE_PROTOCOL_NONE) {
+        return 0;
+    }
+    lockProtocol(parser, protocol);
+    return 1;
+}
+
+/**
+ * 初始化解析器（清空窗口与统计，重新开始协议识别）
+ */
+void particleParserInit(particle_parser_t *parser) {
+    memset(parser, 0, sizeof(*parser));     // 各协议解析器均为平凡类型，清零即完成初始化
+    parser->sample.pm25 = -1.0f;
+    parser->sample.pm1 = -1.0f;
+    parser->sample.pm10 = -1.0f;
+}
+
+/**
+ * 丢弃窗口中的不完整帧（输入数据不连续时调用，如串口溢出后），统计与已锁定的协议保持不变
+ */
+void particleParserReset(particle_parser_t *parser) {
+    parser->a5.reset();
+    parser->pms5003.reset();
+    parser->sds011.reset();
+}
+
+/**
+ * 输入一段数据
+ * 参数：data - 接收到的字节；length - 字节数；nowMs - 当前时间（毫秒，用于识别超时）
+ * 返回值：本次发布的样本数（最近一个样本在 parser->sample 中）
+ */
+size_t particleParserFeed(particle_parser_t *parser, const uint8_t *data, size_t length, uint32_t nowMs) {
+    size_t frames = 0;
+    switch (parser->protocol) {
+        case PARTICLE_PROTOCOL_A5:
+            frames = parser->a5.feed(data, length);
+            if (frames > 0) {
+                parser->sample = parser->a5.sample;
+            }
+            break;
+        case PARTICLE_PROTOCOL_PMS5003:
+            frames = parser->pms5003.feed(data, length);
+            if (frames > 0) {
+                parser->sample = parser->pms5003.sample;
+            }
+            break;
+        case PARTICLE_PROTOCOL_SDS011:
+            frames = parser->sds011.feed(data, length);
+            if (frames > 0) {
+                parser->sample = parser->sds011.sample;
+            }
+            break;
+        default:
+            if (length > 0) {
+                frames = detectFeed(parser, data, length, nowMs);
+            }
+            break;
+    }
+    return frames;
+}
+
+/**
+ * 获取已锁定协议的解析统计，识别阶段返回 nullptr
+ */
+const particle_stats_t *particleParserStats(const particle_parser_t *parser) {
+    switch (parser->protocol) {
+        case PARTICLE_PROTOCOL_A5:
+            return &parser->a5.stats;
+        case PARTICLE_PROTOCOL_PMS5003:
+            return &parser->pms5003.stats;
+        case PARTICLE_PROTOCOL_SDS011:
+            return &parser->sds011.stats;
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * 获取已锁定协议的帧长度，识别阶段返回最短的帧长度
+ */
+size_t particleParserFrameSize(const particle_parser_t *parser) {
+    switch (parser->protocol) {
+        case PARTICLE_PROTOCOL_PMS5003:
+            return Pms5003Protocol::FRAME_SIZE;
+        case PARTICLE_PROTOCOL_SDS011:
+            return Sds011Protocol::FRAME_SIZE;
+        default:
+            return A5Protocol::FRAME_SIZE;
+    }
+}
+
+/**
+ * 协议名称（用于上报）
+ */
+const char *particleProtocolName(uint8_t protocol) {
+    switch (protocol) {
+        case PARTICLE_PROTOCOL_A5:
+            return "a5";
+        case PARTICLE_PROTOCOL_PMS5003:
+            return "pms5003";
+        case PARTICLE_PROTOCOL_SDS011:
+            return "sds011";
+        default:
+            return "none";
+    }
+}
@@ -0,0 +1,250 @@
+/**
+ * @file particleParser.h
+ * @brief 颗粒物传感器多协议流式解析模块头文件
+ * @author cepvor
+ * @version 1.1
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为颗粒物传感器多协议流式解析模块头文件，包含如下内容：
+ * - 统一的颗粒物样本结构体（PM1/PM2.5/PM10、粒子计数），所有协议都解码到该结构体
+ * - 协议描述（帧头、帧长、长度/帧尾检查、校验和策略、字段解码），每个协议一个描述结构体
+ * - 帧解析器模板 FrameParser<协议>：滑动窗口重新同步与错误统计，与协议无关
+ * - 自动识别：开始接收后所有协议的解析器并行运行，某一协议连续解析出若干有效帧即锁定
+ *
+ * @note
+ * 支持的协议（均为9600波特率、8N1，因此识别只需观察字节流，不必切换波特率）：
+ * - A5：[0xA5][DATAH][DATAL][SUM]，SUM 为前3字节累加和的低7位，PM2.5 = DATAH × 128 + DATAL
+ * - PMS5003：[0x42][0x4D][长度=28，大端][13个大端16位数据][16位累加和，大端]，共32字节，
+ *   取大气环境下的 PM1/PM2.5/PM10 与6档粒子计数
+ * - SDS011：[0xAA][0xC0][PM2.5 低/高][PM10 低/高][ID×2][SUM][0xAB]，共10字节，
+ *   SUM 为第2~7字节累加和的低8位，浓度单位为 0.1μg/m³
+ *
+ * 注意事项：
+ * - 输入可以在任意位置切分（每次一个字节或一大段），结果与整段输入相同
+ * - 完整落在输入数据中的帧原地校验、原地解码，只有跨越两次输入的不完整帧才复制到窗口
+ * - 统计字段只增不减；particleParserReset() 只清空窗口，不清零统计
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_PARTICLEPARSER_H
+#define LIGHTPROJECT_PARTICLEPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* 协议编号 */
+#define PARTICLE_PROTOCOL_NONE 0        // 尚未识别
+#define PARTICLE_PROTOCOL_A5 1          // 4字节 0xA5 协议（早期灯杆）
+#define PARTICLE_PROTOCOL_PMS5003 2     // Plantower PMS5003
+#define PARTICLE_PROTOCOL_SDS011 3      // Nova SDS011
+
+#define PARTICLE_COUNT_BINS 6           // 粒子计数档数（>0.3、>0.5、>1.0、>2.5、>5.0、>10μm）
+
+/* 自动识别参数 */
+#define PARTICLE_DETECT_FRAMES 3        // 连续（中间没有丢弃字节）解析出的有效帧数达到该值即锁定协议
+#define PARTICLE_DETECT_WINDOW_MS 5000  // 开始接收后超过该时间仍未锁定时，锁定有效帧最多的协议
+
+/* 颗粒物样本（各协议统一发布） */
+typedef struct {
+    uint8_t protocol;                       // 来源协议
+    float pm1;                              // PM1.0（μg/m³），负数表示该协议不提供
+    float pm25;                             // PM2.5（μg/m³）
+    float pm10;                             // PM10（μg/m³），负数表示该协议不提供
+    bool hasCounts;                         // counts 是否有效
+    uint16_t counts[PARTICLE_COUNT_BINS];   // 每0.1L空气中直径大于0.3/0.5/1.0/2.5/5.0/10μm的粒子数
+} particle_sample_t;
+
+/* 帧解析统计 */
+typedef struct {
+    uint32_t goodFrames;                // 有效帧数
+    uint32_t badChecksums;              // 帧头正确但长度或校验失败的候选帧数
+    uint32_t resyncs;                   // 丢弃字节后重新找到有效帧的次数
+    uint32_t bytesDiscarded;            // 不属于任何有效帧而丢弃的字节数
+} particle_stats_t;
+
+/*
+ * 协议描述：每个协议提供以下静态成员，供 FrameParser 使用
+ *   PROTOCOL        协议编号
+ *   FRAME_SIZE      帧长度（字节）
+ *   HEADER_SIZE     帧头字节数，HEADER[] 为帧头（HEADER[0] 用于快速查找候选帧）
+ *   framing(frame)  帧头之外的格式检查（长度字段、帧尾）
+ *   checksum(frame) 校验和策略
+ *   decode(frame, sample) 字段解码
+ */
+struct A5Protocol {
+    static constexpr uint8_t PROTOCOL = PARTICLE_PROTOCOL_A5;
+    static constexpr size_t FRAME_SIZE = 4;
+    static constexpr size_t HEADER_SIZE = 1;
+    static constexpr uint8_t HEADER[HEADER_SIZE] = {0xA5};
+    static bool framing(const uint8_t *frame) { (void) frame; return true; }
+    static bool checksum(const uint8_t *frame);
+    static void decode(const uint8_t *frame, particle_sample_t *sample);
+};
+
+struct Pms5003Protocol {
+    static constexpr uint8_t PROTOCOL = PARTICLE_PROTOCOL_PMS5003;
+    static constexpr size_t FRAME_SIZE = 32;
+    static constexpr size_t HEADER_SIZE = 2;
+    static constexpr uint8_t HEADER[HEADER_SIZE] = {0x42, 0x4D};
+    static bool framing(const uint8_t *frame);
+    static bool checksum(const uint8_t *frame);
+    static void decode(const uint8_t *frame, particle_sample_t *sample);
+};
+
+struct Sds011Protocol {
+    static constexpr uint8_t PROTOCOL = PARTICLE_PROTOCOL_SDS011;
+    static constexpr size_t FRAME_SIZE = 10;
+    static constexpr size_t HEADER_SIZE = 2;
+    static constexpr uint8_t HEADER[HEADER_SIZE] = {0xAA, 0xC0};
+    static bool framing(const uint8_t *frame);
+    static bool checksum(const uint8_t *frame);
+    static void decode(const uint8_t *frame, particle_sample_t *sample);
+};
+
+/*
+ * 单协议帧解析器（滑动窗口）：
+ * - 快速路径：窗口为空时直接在输入数据中用 memchr 找帧头首字节，剩余数据够一帧时原地校验、原地解码
+ * - 不足一帧的尾部存入窗口，下一次输入先补满窗口再校验
+ * - 校验失败时只丢弃候选帧头这一个字节，从下一个偏移继续寻找（窗口中的剩余字节同样参与搜索）
+ * 成员均为平凡类型，可随所在结构体一起 memset 清零（等同于 init()）
+ */
+template<typename Protocol>
+class FrameParser {
+    static_assert(Protocol::FRAME_SIZE <= 255, "帧长度超出窗口计数范围");
+
+public:
+    particle_sample_t sample;           // 最近一个有效帧的解码结果
+    particle_stats_t stats;             // 统计
+    uint8_t streak;                     // 连续（中间没有丢弃字节）解析出的有效帧数
+
+    /* 清空窗口与统计 */
+    void init() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    /* 丢弃窗口中的不完整帧（输入数据不连续时调用），统计保持不变 */
+    void reset() {
+        discard(count_);
+        count_ = 0;
+    }
+
+    /* 窗口中等待补齐的字节数（有效帧字节 + 丢弃字节 + 该值 = 输入字节总数） */
+    size_t pending() const {
+        return count_;
+    }
+
+    /* 输入一段数据，返回本次解析出的有效帧数（最近一帧在 sample 中） */
+    size_t feed(const uint8_t *data, size_t length) {
+        size_t frames = 0;
+        size_t index = 0;
+        while (index < length) {
+            if (count_ == 0) {              // 快速路径：直接在输入数据中寻找并校验
+                const uint8_t *header = (const uint8_t *) memchr(data + index, Protocol::HEADER[0], length - index);
+                if (header == nullptr) {
+                    discard(length - index);
+                    break;
+                }
+                size_t skip = (size_t) (header - (data + index));
+                discard(skip);
+                index += skip;
+                if (length - index < Protocol::FRAME_SIZE) {    // 不足一帧，存入窗口等待下一次输入
+                    count_ = (uint8_t) (length - index);
+                    memcpy(window_, data + index, count_);
+                    break;
+                }
+                if (valid(data + index)) {
+                    accept(data + index);
+                    frames++;
+                    index += Protocol::FRAME_SIZE;
+                }
+                else {
+                    stats.badChecksums++;
+                    discard(1);             // 只丢弃候选帧头，从下一个偏移重新寻找
+                    index++;
+                }
+                continue;
+            }
+
+            /* 窗口中有上次剩余的不完整帧：先补满窗口 */
+            size_t fill = Protocol::FRAME_SIZE - count_;
+            if (fill > length - index) {
+                fill = length - index;
+            }
+            memcpy(window_ + count_, data + index, fill);
+            count_ = (uint8_t) (count_ + fill);
+            index += fill;
+            if (count_ < Protocol::FRAME_SIZE) {
+                break;
+            }
+            if (valid(window_)) {
+                accept(window_);
+                frames++;
+                count_ = 0;
+                continue;
+            }
+            stats.badChecksums++;
+            uint8_t next = 1;               // 在窗口剩余字节中寻找下一个候选帧头
+            while (next < count_ && window_[next] != Protocol::HEADER[0]) {
+                next++;
+            }
+            discard(next);
+            count_ = (uint8_t) (count_ - next);
+            memmove(window_, window_ + next, count_);
+        }
+        return frames;
+    }
+
+private:
+    uint8_t window_[Protocol::FRAME_SIZE];  // 跨越两次输入的不完整帧（以帧头首字节开始）
+    uint8_t count_;                         // 窗口中的字节数
+    bool lost_;                             // 上一个有效帧之后是否丢弃过字节
+
+    static bool valid(const uint8_t *frame) {
+        return memcmp(frame, Protocol::HEADER, Protocol::HEADER_SIZE) == 0
+               && Protocol::framing(frame) && Protocol::checksum(frame);
+    }
+
+    void accept(const uint8_t *frame) {
+        Protocol::decode(frame, &sample);
+        sample.protocol = Protocol::PROTOCOL;
+        stats.goodFrames++;
+        if (lost_) {
+            stats.resyncs++;
+            lost_ = false;
+            streak = 0;
+        }
+        if (streak < 255) {
+            streak++;
+        }
+    }
+
+    void discard(size_t count) {
+        if (count > 0) {
+            stats.bytesDiscarded += (uint32_t) count;
+            lost_ = true;
+        }
+    }
+};
+
+/* 多协议解析器：识别阶段并行运行所有协议，锁定后只运行选中的协议 */
+typedef struct {
+    uint8_t protocol;                   // 已锁定的协议，PARTICLE_PROTOCOL_NONE 表示仍在识别
+    bool started;                       // 是否已收到过数据（识别计时从第一次输入开始）
+    uint32_t startMs;                   // 第一次输入的时间
+    particle_sample_t sample;           // 最近一个有效帧（仅在锁定后更新）
+    FrameParser<A5Protocol> a5;
+    FrameParser<Pms5003Protocol> pms5003;
+    FrameParser<Sds011Protocol> sds011;
+} particle_parser_t;
+
+void particleParserInit(particle_parser_t *parser);
+void particleParserReset(particle_parser_t *parser);
+size_t particleParserFeed(particle_parser_t *parser, const uint8_t *data, size_t length, uint32_t nowMs);
+const particle_stats_t *particleParserStats(const particle_parser_t *parser);
+size_t particleParserFrameSize(const particle_parser_t *parser);
+const char *particleProtocolName(uint8_t protocol);
+
+#endif //LIGHTPROJECT_PARTICLEPARSER_H
@@ -0,0 +1,107 @@
+/**
+ * @file perceptualDimming.cpp
+ * @brief 感知亮度（CIE L*）调光模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现感知亮度到PWM的映射与时间抖动：
+ * - 启动时按 CIE 1976 L* 公式生成 257 项查找表，运行时只做查表与整数插值
+ * - 8位输出无法表示的余量累加到下一帧（一阶 Σ-Δ），多帧平均后等于16位精度
+ *
+ * @note
+ * 注意事项：
+ * - 浮点运算只出现在 perceptualDimmingInit() 中，50ms 循环内全部为整数运算
+ * - 每一路输出通道需要各自独立的 residual 变量
+ * - 抖动需要持续刷新才有意义，亮度稳定后灯控任务会休眠，此时应改用 perceptualQuantize()
+ */
+
+#include "perceptualDimming.h"
+
+static uint16_t lightnessLut[PERCEPTUAL_LUT_SIZE];    // 感知亮度 -> 线性PWM 查找表
+
+/**
+ * 生成 CIE L* -> 线性PWM 查找表
+ * 功能说明：L* = 100 * i / 256，按 CIE 1976 逆公式换算成相对亮度 Y（0~1），再放大到 0~65535
+ * - L* > 8 时：Y = ((L* + 16) / 116)^3
+ * - L* <= 8 时：Y = L* / 903.3（低亮度线性段）
+ */
+void perceptualDimmingInit() {
+    for (int i = 0; i < PERCEPTUAL_LUT_SIZE; i++) {
+        float lightness = 100.0f * (float) i / (float) (PERCEPTUAL_LUT_SIZE - 1);   // 当前表项对应的 L*
+        float luminance;
+        if (lightness > 8.0f) {
+            float t = (lightness + 16.0f) / 116.0f;
+            luminance = t * t * t;
+        }
+        else {
+            luminance = lightness / 903.3f;
+        }
+        lightnessLut[i] = (uint16_t) (luminance * 65535.0f + 0.5f);     // 四舍五入到16位
+    }
+}
+
+/**
+ * 16位感知亮度转换为16位线性PWM值
+ * 参数：level - 感知亮度（0~65535）
+ * 返回值：线性PWM值（0~65535），相邻表项之间线性插值
+ */
+uint16_t perceptualToLinear(uint16_t level) {
+    uint16_t index = level >> PERCEPTUAL_LUT_SHIFT;                             // 表项索引
+    uint32_t frac = level & ((1U << PERCEPTUAL_LUT_SHIFT) - 1);                 // 表项之间的小数部分
+    uint32_t lower = lightnessLut[index];
+    uint32_t upper = lightnessLut[index + 1];
+    return (uint16_t) (lower + (((upper - lower) * frac) >> PERCEPTUAL_LUT_SHIFT));  // 查找表单调递增，差值非负
+}
+
+/**
+ * 16位线性PWM值转换为16位感知亮度
+ * 功能说明：在单调递增的查找表中二分查找所在区间，再在区间内线性插值，用于把线性域的控制量（如照度闭环输出）换算回感知亮度
+ * 参数：linear - 线性PWM值（0~65535）
+ * 返回值：感知亮度（0~65535）
+ */
+uint16_t linearToPerceptual(uint16_t linear) {
+    uint16_t low = 0, high = PERCEPTUAL_LUT_SIZE - 1;     // 不变式：lut[low] <= linear，且 high 为最后一项或 lut[high] > linear
+    if (linear >= lightnessLut[high]) {
+        return PERCEPTUAL_LEVEL_MAX;
+    }
+    while (high - low > 1) {
+        uint16_t mid = (low + high) / 2;
+        if (lightnessLut[mid] <= linear) {
+            low = mid;
+        }
+        else {
+            high = mid;
+        }
+    }
+    uint32_t span = lightnessLut[high] - lightnessLut[low];
+    uint32_t frac = span == 0 ? 0 : (((uint32_t) (linear - lightnessLut[low])) << PERCEPTUAL_LUT_SHIFT) / span;
+    return (uint16_t) (((uint32_t) low << PERCEPTUAL_LUT_SHIFT) + frac);
+}
+
+/**
+ * 将16位线性PWM值抖动为8位输出
+ * 功能说明：每帧输出 floor((linear + residual) / 257)，余数留到下一帧，
+ *          连续多帧的平均值精确等于 linear / 257，从而在不提高刷新率的前提下获得亚LSB精度
+ * 参数：linear - 线性PWM值（0~65535）
+ *       residual - 该通道的累计余量（0~256），由调用者保存
+ * 返回值：本帧的8位PWM值（0~255）
+ */
+uint8_t perceptualDither(uint16_t linear, uint16_t *residual) {
+    uint32_t sum = (uint32_t) linear + *residual;     // 最大 65535 + 256，除以257后仍不超过255
+    uint8_t output = (uint8_t) (sum / 257U);
+    *residual = (uint16_t) (sum - output * 257U);
+    return output;
+}
+
+/**
+ * 将16位线性PWM值四舍五入为8位输出
+ * 功能说明：亮度稳定、不再连续刷新时使用，避免停在抖动序列的某一帧上
+ * 参数：linear - 线性PWM值（0~65535）
+ * 返回值：8位PWM值（0~255）
+ */
+uint8_t perceptualQuantize(uint16_t linear) {
+    return (uint8_t) (((uint32_t) linear + 128U) / 257U);
+}
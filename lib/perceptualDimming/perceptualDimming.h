@@ -0,0 +1,42 @@
+/**
+ * @file perceptualDimming.h
+ * @brief 感知亮度（CIE L*）调光模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为感知亮度调光模块头文件，包含如下内容：
+ * - 16位感知亮度单位与查找表尺寸的宏定义
+ * - 感知亮度 -> 线性PWM 的转换函数声明
+ * - 时间抖动（temporal dithering）函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 亮度链路内部统一使用16位感知亮度（0~65535 对应 L* 0~100）
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ * - 使用前必须调用 perceptualDimmingInit() 生成查找表
+ */
+
+#ifndef LIGHTPROJECT_PERCEPTUALDIMMING_H
+#define LIGHTPROJECT_PERCEPTUALDIMMING_H
+
+#include <cstdint>
+
+/* 查找表参数 */
+#define PERCEPTUAL_LUT_SHIFT 8                                  // 每个表项覆盖 2^8 个感知亮度单位
+#define PERCEPTUAL_LUT_SIZE ((65536 >> PERCEPTUAL_LUT_SHIFT) + 1)  // 257项，最后一项用于插值
+#define PERCEPTUAL_LEVEL_MAX 65535                              // 16位感知亮度最大值
+
+/* 8位亮度与16位感知亮度互转（x * 257 使 255 精确对应 65535） */
+#define LEVEL_8_TO_16(x) ((uint16_t) ((x) * 257U))
+#define LEVEL_16_TO_8(x) ((uint8_t) ((x) >> 8))
+
+void perceptualDimmingInit();                               // 生成 CIE L* -> PWM 查找表
+uint16_t perceptualToLinear(uint16_t level);                // 16位感知亮度 -> 16位线性PWM
+uint16_t linearToPerceptual(uint16_t linear);               // 16位线性PWM -> 16位感知亮度（查找表逆运算）
+uint8_t perceptualDither(uint16_t linear, uint16_t *residual);  // 16位线性PWM -> 8位输出（时间抖动）
+uint8_t perceptualQuantize(uint16_t linear);                // 16位线性PWM -> 8位输出（四舍五入，稳态使用）
+
+#endif //LIGHTPROJECT_PERCEPTUALDIMMING_H
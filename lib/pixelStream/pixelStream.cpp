@@ -0,0 +1,184 @@
+/**
+ * @file pixelStream.cpp
+ * @brief UDP像素流接收模块实现（DDP协议）
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现DDP像素流的接收：
+ * - 包头校验：版本1、目标为默认输出设备、数据类型为RGB 8位（或未定义），不支持查询/应答/存储包
+ * - 序号：与上一个已接受的序号比较（4位模运算），落后或重复的包丢弃，超时后重新开始
+ * - 数据：用 recvmsg() 分散读，包头读入栈上的小缓冲区，像素数据直接读入像素缓冲区的偏移处，
+ *   超出缓冲区的部分由协议栈截断丢弃
+ *
+ * @note
+ * 注意事项：
+ * - 套接字设置了接收超时（PIXEL_STREAM_POLL_MS），pixelStreamPeek() 不会无限阻塞
+ * - 不处理的数据报也要读出（丢弃），否则会一直停在接收队列头部
+ */
+
+#include "pixelStream.h"
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/**
+ * 解析DDP包头
+ * 参数：data - 数据报开头；size - 可用字节数
+ * 返回值：false 表示不是本设备可以显示的像素数据包
+ */
+bool ddpParseHeader(const uint8_t *data, size_t size, ddp_header_t *header) {
+    if (size < DDP_HEADER_LEN) {
+        return false;
+    }
+    header->flags = data[0];
+    header->sequence = data[1] & DDP_SEQUENCE_MASK;
+    header->dataType = data[2];
+    header->id = data[3];
+    header->offset = ((uint32_t) data[4] << 24) | ((uint32_t) data[5] << 16) | ((uint32_t) data[6] << 8) | data[7];
+    header->length = (uint16_t) ((data[8] << 8) | data[9]);
+    header->headerLen = (header->flags & DDP_FLAGS_TIMECODE) ? DDP_HEADER_LEN_TIMECODE : DDP_HEADER_LEN;
+    if ((header->flags & DDP_FLAGS_VER_MASK) != DDP_FLAGS_VER1) {
+        return false;       // 版本不符
+    }
+    if (header->flags & (DDP_FLAGS_STORAGE | DDP_FLAGS_REPLY | DDP_FLAGS_QUERY)) {
+        return false;       // 查询、应答与配置存储包不处理
+    }
+    if (header->id != DDP_ID_DISPLAY) {
+        return false;
+    }
+    return header->dataType == DDP_TYPE_UNDEFINED || header->dataType == DDP_TYPE_RGB8
+           || header->dataType == DDP_TYPE_RGB8_LEGACY;
+}
+
+/**
+ * 判断序号是否迟到
+ * 功能说明：序号在 1~15 之间循环，按模15比较，与上一个相同或落后 1~7 个序号视为重复或迟到；
+ *          任一方为0（发送端不使用序号，或尚未收到过包）时不判断
+ */
+bool ddpSequenceIsLate(uint8_t lastSequence, uint8_t sequence) {
+    if (lastSequence == 0 || sequence == 0) {
+        return false;
+    }
+    uint8_t ahead = (uint8_t) ((sequence + DDP_SEQUENCE_MASK - lastSequence) % DDP_SEQUENCE_MASK);  // 领先的步数
+    return ahead == 0 || ahead > DDP_SEQUENCE_MASK / 2;
+}
+
+/**
+ * 打开UDP接收套接字
+ * 参数：port - 监听端口（通常为 PIXEL_STREAM_PORT）
+ * 返回值：false 表示套接字创建或绑定失败
+ */
+bool pixelStreamOpen(pixel_stream_t *stream, uint16_t port) {
+    memset(stream, 0, sizeof(*stream));
+    stream->fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (stream->fd < 0) {
+        return false;
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    struct timeval timeout = {};
+    timeout.tv_sec = PIXEL_STREAM_POLL_MS / 1000;
+    timeout.tv_usec = (PIXEL_STREAM_POLL_MS % 1000) * 1000;
+    if (bind(stream->fd, (struct sockaddr *) &addr, sizeof(addr)) != 0
+        || setsockopt(stream->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+        pixelStreamClose(stream);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 关闭接收套接字
+ */
+void pixelStreamClose(pixel_stream_t *stream) {
+    if (stream->fd >= 0) {
+        close(stream->fd);
+    }
+    stream->fd = -1;
+    stream->active = false;
+}
+
+/**
+ * 等待并查看下一个数据报的包头（不取走数据报）
+ * 功能说明：最多等待 PIXEL_STREAM_POLL_MS；格式错误、不支持或迟到的数据报直接读出丢弃
+ * 返回值：true 表示队列头部是一个可显示的像素数据包，调用者随后调用 pixelStreamRead()
+ */
+bool pixelStreamPeek(pixel_stream_t *stream, ddp_header_t *header) {
+    uint8_t head[DDP_HEADER_LEN_TIMECODE];
+    ssize_t received = recv(stream->fd, head, sizeof(head), MSG_PEEK);
+    if (received < 0) {
+        return false;       // 超时（或套接字错误）
+    }
+    bool valid = ddpParseHeader(head, (size_t) received, header) && (size_t) received >= header->headerLen;
+    bool late = valid && ddpSequenceIsLate(stream->lastSequence, header->sequence);
+    if (valid && !late) {
+        return true;
+    }
+    recv(stream->fd, head, sizeof(head), 0);    // 读出并丢弃
+    if (late) {
+        stream->late++;
+    }
+    else {
+        stream->invalid++;
+    }
+    return false;
+}
+
+/**
+ * 读取 pixelStreamPeek() 确认过的数据报，像素数据直接写入像素缓冲区
+ * 参数：header - pixelStreamPeek() 得到的包头；pixels - 像素缓冲区（R、G、B 连续排列）；size - 缓冲区字节数
+ *       nowMs - 当前时间（用于超时判断）
+ * 返回值：PIXEL_STREAM_FRAME 表示一帧结束需要刷新，PIXEL_STREAM_DATA 表示帧未结束
+ */
+pixel_stream_result_t pixelStreamRead(pixel_stream_t *stream, const ddp_header_t *header, uint8_t *pixels,
+                                      size_t size, uint32_t nowMs) {
+    uint8_t head[DDP_HEADER_LEN_TIMECODE];
+    size_t length = 0;      // 写入像素缓冲区的字节数（超出缓冲区的部分丢弃）
+    if (header->offset < size) {
+        length = size - header->offset < header->length ? size - header->offset : header->length;
+    }
+    struct iovec iov[2];
+    iov[0].iov_base = head;
+    iov[0].iov_len = header->headerLen;
+    iov[1].iov_base = pixels + (length > 0 ? header->offset : 0);
+    iov[1].iov_len = length;
+    struct msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = length > 0 ? 2 : 1;
+    ssize_t received = recvmsg(stream->fd, &msg, 0);
+    if (received < (ssize_t) header->headerLen) {
+        stream->invalid++;
+        return PIXEL_STREAM_NONE;
+    }
+    if (header->sequence != 0) {
+        stream->lastSequence = header->sequence;
+    }
+    stream->active = true;
+    stream->lastPacketMs = nowMs;
+    stream->packets++;
+    if (header->flags & DDP_FLAGS_PUSH) {
+        stream->frames++;
+        return PIXEL_STREAM_FRAME;
+    }
+    return PIXEL_STREAM_DATA;
+}
+
+/**
+ * 检查流模式是否超时
+ * 返回值：true 表示刚刚超时（只返回一次），调用者应恢复亮度引擎的输出
+ */
+bool pixelStreamTimedOut(pixel_stream_t *stream, uint32_t nowMs) {
+    if (!stream->active || nowMs - stream->lastPacketMs < PIXEL_STREAM_TIMEOUT_MS) {
+        return false;
+    }
+    stream->active = false;
+    stream->lastSequence = 0;   // 发送端重新开始时序号可能从任意值开始
+    return true;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file pixelStream.h
+ * @brief UDP像素流接收模块头文件（DDP协议）
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为UDP像素流接收模块头文件，包含如下内容：
+ * - DDP（Distributed Display Protocol）包头字段与标志位宏定义
+ * - 接收端状态结构体（套接字、序号、超时、统计）
+ * - 包头解析、序号判断、收包与超时检测的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 用于调试验收与活动灯光：PC上的 xLights、WLED 等DDP发送端直接驱动灯带，超时后由调用者恢复亮度引擎
+ * - 收包分两步：先 pixelStreamPeek() 只读包头（不取走数据报），调用者确认像素缓冲区可写后，
+ *   再 pixelStreamRead() 用分散读把像素数据直接从协议栈读入缓冲区的对应偏移处，中间没有额外拷贝
+ * - DDP序号为4位（1~15循环，0表示发送端不使用序号）；落后于上一个已接受序号的包视为迟到包，直接丢弃
+ * - 只使用BSD套接字接口（ESP32上由lwIP提供），不依赖Arduino，可在主机上用本地回环地址测试
+ */
+
+#ifndef LIGHTPROJECT_PIXELSTREAM_H
+#define LIGHTPROJECT_PIXELSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define PIXEL_STREAM_PORT 4048              // DDP标准端口
+#define PIXEL_STREAM_TIMEOUT_MS 2500        // 超过此时间没有收到像素数据即退出流模式，恢复亮度引擎
+#define PIXEL_STREAM_POLL_MS 500            // 等待数据报的最长时间（毫秒），到时返回以便检查超时
+
+/* DDP包头 */
+#define DDP_HEADER_LEN 10                   // 包头长度
+#define DDP_HEADER_LEN_TIMECODE 14          // 带时间码的包头长度
+#define DDP_FLAGS_VER_MASK 0xC0             // 版本位
+#define DDP_FLAGS_VER1 0x40                 // 版本1
+#define DDP_FLAGS_TIMECODE 0x10             // 包头后附4字节时间码
+#define DDP_FLAGS_STORAGE 0x08              // 存储/读取配置（不支持）
+#define DDP_FLAGS_REPLY 0x04                // 应答包（不支持）
+#define DDP_FLAGS_QUERY 0x02                // 查询包（不支持）
+#define DDP_FLAGS_PUSH 0x01                 // 本包是一帧的最后一包，收到后显示
+#define DDP_SEQUENCE_MASK 0x0F              // 序号位（4位）
+#define DDP_TYPE_UNDEFINED 0x00             // 未定义数据类型（按RGB处理）
+#define DDP_TYPE_RGB8 0x0B                  // 规范编码：类型RGB（TTT=001），每通道8位（SSS=011）
+#define DDP_TYPE_RGB8_LEGACY 0x01           // 部分发送端使用的简化编码（只填类型位），同样按RGB 8位处理
+#define DDP_ID_DISPLAY 1                    // 默认输出设备
+
+/* 收包结果 */
+typedef enum {
+    PIXEL_STREAM_NONE = 0,      // 没有收到数据
+    PIXEL_STREAM_DATA,          // 收到像素数据（帧未结束）
+    PIXEL_STREAM_FRAME          // 收到一帧的最后一包（需要刷新）
+} pixel_stream_result_t;
+
+/* DDP包头 */
+typedef struct {
+    uint8_t flags;              // 标志位
+    uint8_t sequence;           // 序号（0 表示不使用）
+    uint8_t dataType;           // 数据类型
+    uint8_t id;                 // 目标设备
+    uint32_t offset;            // 数据在像素缓冲区中的字节偏移
+    uint16_t length;            // 数据长度（字节）
+    uint8_t headerLen;          // 包头长度（含时间码）
+} ddp_header_t;
+
+/* 接收端状态 */
+typedef struct {
+    int fd;                     // UDP套接字（-1 表示未打开）
+    uint8_t lastSequence;       // 上一个已接受的序号（0 表示没有）
+    bool active;                // 是否处于流模式（超时前收到过像素数据）
+    uint32_t lastPacketMs;      // 最近一次收到像素数据的时间
+    uint32_t packets;           // 已接受的数据包数
+    uint32_t frames;            // 已接受的帧数（带PUSH标志的包）
+    uint32_t late;              // 因迟到或重复丢弃的包数
+    uint32_t invalid;           // 格式错误或不支持而丢弃的包数
+} pixel_stream_t;
+
+bool ddpParseHeader(const uint8_t *data, size_t size, ddp_header_t *header);
+bool ddpSequenceIsLate(uint8_t lastSequence, uint8_t sequence);
+bool pixelStreamOpen(pixel_stream_t *stream, uint16_t port);
+void pixelStreamClose(pixel_stream_t *stream);
+bool pixelStreamPeek(pixel_stream_t *stream, ddp_header_t *header);
+pixel_stream_result_t pixelStreamRead(pixel_stream_t *stream, const ddp_header_t *header, uint8_t *pixels,
+                                      size_t size, uint32_t nowMs);
+bool pixelStreamTimedOut(pixel_stream_t *stream, uint32_t nowMs);
+
+#endif //LIGHTPROJECT_PIXELSTREAM_H
@@ -3,140 +3,150 @@
 // 文件名: getPM2dot5.cpp
 // 创建者: cepvor
 // 创建时间: 2025/9/28
-// 功能说明: 通过串口2接收PM2.5传感器数据，解析数据包并计算浓度值
+// 功能说明: 通过串口2接收颗粒物传感器数据，自动识别协议，解析数据包并发布颗粒物样本
 // 硬件配置:
 //   - TX引脚: IO17 (ESP32发送，实际上本项目中不需要发送)
 //   - RX引脚: IO18 (ESP32接收PM2.5传感器数据)
 //   - 串口: UART2
 //   - 波特率: 9600
 //   - 数据格式: 8位数据位，无校验位，1位停止位
-// 数据协议:
-//   - 帧格式: [0xA5][DATAH][DATAL][SUM]
-//   - 0xA5: 帧头标识
-//   - DATAH: PM2.5浓度高7位
-//   - DATAL: PM2.5浓度低7位
-//   - SUM: 校验字节(前3字节累加和的低7位)
-//   - 浓度计算公式: PM2.5 = DATAH × 128 + DATAL
+// 数据协议（帧格式详见 particleParser.h）:
+//   - A5: [0xA5][DATAH][DATAL][SUM]，4字节，仅PM2.5（早期灯杆）
+//   - PMS5003: 0x42 0x4D 开头的32字节帧，PM1/PM2.5/PM10与粒子计数
+//   - SDS011: 0xAA 0xC0 开头、0xAB 结尾的10字节帧，PM2.5/PM10
+//   - 三种传感器都是9600波特率，上电后前几秒的数据并行交给各协议解析器，连续解析出有效帧的协议被锁定
+// 接收方式:
+//   - 使用ESP-IDF UART驱动：中断服务程序把硬件FIFO搬入驱动的环形缓冲区，并向事件队列投递 UART_DATA 事件
+//   - FIFO达到一帧长度或接收空闲超时时才产生中断，处理任务阻塞在事件队列上，没有轮询唤醒
+//   - 每个事件一次读出全部数据，交给流式解析器（particleParser）原地解析，只有不完整帧才复制到解析器窗口
+//   - 协议锁定后把FIFO中断阈值改为该协议的帧长度，每帧只中断一次
+//   - 每个有效帧通过顺序锁（seqLock.h）发布为样本，其他任务无锁读取，读到的各字段总是来自同一帧
+//   - 每个有效帧计入滚动统计（airQuality：1分钟、15分钟、1小时、24小时平均值、NowCast与AQI），上报统计值而不是单个读数
+//   - 校验失败时解析器逐个偏移重新寻找帧头，并统计有效帧、校验失败、重新同步与丢弃字节数
 //
 
 #include "getPM2dot5.h"
 
 // ==================== 全局变量定义 ====================
-uint16_t pm25_concentration = 0;     // PM2.5浓度值，单位：μg/m³，供其他模块使用
-bool pm25_data_ready = false;        // 数据就绪标志，表示是否有新的有效数据
+particle_parser_t particle_parser;   // 多协议流式解析器（含最近样本与错误统计，只由PM2.5任务修改）
 
 // ==================== 静态变量定义 ====================
-static uint8_t rx_buffer[PM25_PACKET_SIZE];    // 串口接收缓冲区，存储一个完整数据包
-static int buffer_index = 0;                   // 缓冲区索引，指示当前接收位置
-static bool header_found = false;              // 帧头发现标志，用于状态机控制
+static QueueHandle_t uart_queue = nullptr;     // UART事件队列（由驱动创建）
+static air_quality_t air_quality;              // 滚动统计（PM2.5任务写入，MQTT任务查询，由 air_quality_mux 保护）
+static portMUX_TYPE air_quality_mux = portMUX_INITIALIZER_UNLOCKED;
+static SeqLock<pm25_sample_t> sample_lock;      // 最近样本（PM2.5任务写入，其他任务无锁读取）
+static uint32_t sample_sequence = 0;           // 已发布的样本数（只由PM2.5任务修改）
+static uint8_t span[PM25_SPAN_SIZE];           // 一次读出的连续数据
 
 /**
  * @brief 初始化PM2.5传感器串口通信
- * @details 配置串口2参数，设置TX/RX引脚，初始化相关变量
+ * @details 安装UART2驱动（带事件队列），设置TX/RX引脚与中断阈值，初始化相关变量
  *          串口配置：9600波特率，8位数据位，无校验位，1位停止位
  *          引脚配置：RX=IO18，TX=IO17
  */
 void pm25_init() {
-    /* 初始化串口2，配置波特率和引脚，SERIAL_8N1: 8位数据位，无校验位，1位停止位 */
-    Serial2.begin(PM25_BAUD_RATE, SERIAL_8N1, PM25_RX_PIN, PM25_TX_PIN);
+    uart_config_t config = {};
+    config.baud_rate = PM25_BAUD_RATE;
+    config.data_bits = UART_DATA_8_BITS;        // 8位数据位
+    config.parity = UART_PARITY_DISABLE;        // 无校验位
+    config.stop_bits = UART_STOP_BITS_1;        // 1位停止位
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;          // APB时钟（IDF 4.4）
+    if (uart_driver_install(PM25_UART_NUM, PM25_UART_RX_BUFFER, 0, PM25_UART_QUEUE_SIZE, &uart_queue, 0) != ESP_OK
+        || uart_param_config(PM25_UART_NUM, &config) != ESP_OK
+        || uart_set_pin(PM25_UART_NUM, PM25_TX_PIN, PM25_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) != ESP_OK) {
+        Serial.println("PM2.5串口驱动安装失败");
+        uart_queue = nullptr;
+        return;
+    }
+    uart_set_rx_full_threshold(PM25_UART_NUM, PM25_UART_RX_FULL_THRESH);   // 识别阶段按最短帧长度中断
+    uart_set_rx_timeout(PM25_UART_NUM, PM25_UART_RX_TIMEOUT);              // 不足一帧时空闲超时中断
     /* 初始化状态变量，确保系统处于干净状态 */
-    buffer_index = 0;                           // 重置缓冲区索引
-    header_found = false;                       // 重置帧头搜索状态
-    pm25_data_ready = false;                    // 重置数据就绪标志
-    pm25_concentration = 0;                     // 重置浓度值
-}
-
-/**
- * @brief 校验接收到的数据包
- * @details 根据协议要求，计算前三个字节(header+dataH+dataL)的累加和的低7位
- *          与接收到的校验字节进行比较，验证数据包完整性
- * @param packet 指向数据包结构体的指针
- * @return true 校验通过，数据包有效
- * @return false 校验失败，数据包损坏
- */
-static bool validate_packet(pm25_packet_t *packet) {
-    /* 计算校验和：前三个字节累加和的低7位(& 0x7F 相当于 % 128) */
-    uint8_t calculated_sum = (packet->header + packet->dataH + packet->dataL) & 0x7F;
-    return (calculated_sum == packet->checksum);    // 将计算结果与接收到的校验字节比较
-}
-
-/**
- * @brief 根据高低字节计算PM2.5浓度值
- * @details 按照传感器协议，浓度值 = 高字节 × 128 + 低字节
- *          例：DATAH=0x01, DATAL=0x2C 时，浓度 = 1×128+44 = 172 μg/m³
- * @param dataH PM2.5浓度值高7位
- * @param dataL PM2.5浓度值低7位
- * @return uint16_t 计算得到的PM2.5浓度值，单位μg/m³
- */
-static uint16_t calculate_concentration(uint8_t dataH, uint8_t dataL) {
-    // 应用协议规定的计算公式
-    return (uint16_t) (dataH * 128 + dataL);
+    particleParserInit(&particle_parser);       // 清空解析器窗口与统计，重新识别协议
+    airQualityInit(&air_quality);               // 清空滚动统计
 }
 
 /**
- * @brief 处理接收到的完整数据包
- * @details 对完整数据包进行校验，如果校验通过则计算浓度值并更新全局变量
- *          同时输出调试信息到串口监视器
+ * @brief 等待并处理一个UART事件（在PM2.5任务中循环调用）
+ * @details 阻塞在UART事件队列上，收到数据事件时一次读出全部数据并解析；
+ *          硬件FIFO或驱动缓冲区溢出时清空输入与事件队列，丢弃不完整帧后重新同步
+ * @param wait 最长等待时间（系统节拍），portMAX_DELAY 表示一直等待
  */
-static void process_packet() {
-    pm25_packet_t *packet = (pm25_packet_t *) rx_buffer;    // 将接收缓冲区强制转换为数据包结构体指针，便于访问各字段
-    if (validate_packet(packet)) {  // 验证数据包完整性
-        pm25_concentration = calculate_concentration(packet->dataH, packet->dataL); // 校验通过，计算并更新浓度值
-        pm25_data_ready = true;     // 设置数据就绪标志
+void pm25_update(TickType_t wait) {
+    uart_event_t event;
+    if (uart_queue == nullptr) {
+        vTaskDelay(wait == portMAX_DELAY ? pdMS_TO_TICKS(1000) : wait);   // 驱动未安装，避免调用者空转
+        return;
     }
-}
-
-/**
- * @brief 更新PM2.5数据（主循环调用）
- * @details 实现状态机逻辑处理串口数据接收：
- *          状态1：搜索帧头(0xA5)
- *          状态2：接收数据字节直到完整数据包
- *          使用状态机可以正确处理数据流中的任意位置开始接收
- * @note 此函数需要在主循环中频繁调用以确保及时处理串口数据
- */
-void pm25_update() {
-    while (Serial2.available()) {       // 处理串口缓冲区中的所有可用字节
-        uint8_t byte = Serial2.read();  // 读取一个字节
-        if (!header_found) {            // 状态1：搜索帧头阶段
-            if (byte == PM25_HEADER) {  // 找到帧头0xA5
-                rx_buffer[0] = byte;    // 保存帧头到缓冲区
-                buffer_index = 1;       // 设置下一个字节的存储位置
-                header_found = true;    // 切换到数据接收状态
-            }
-            /* 如果不是帧头，继续搜索（忽略当前字节） */
-        }
-        else {                                  // 状态2：数据接收阶段
-            rx_buffer[buffer_index] = byte;     // 存储数据字节
-            buffer_index++;                     // 移动到下一个位置
-            if (buffer_index >= PM25_PACKET_SIZE) { // 检查是否接收到完整数据包(4字节)
-                process_packet();                   // 处理完整数据包
-                buffer_index = 0;                   // 重置状态机，准备接收下一个数据包
-                header_found = false;
+    if (xQueueReceive(uart_queue, &event, wait) != pdTRUE) {
+        return;
+    }
+    switch (event.type) {
+        case UART_DATA: {
+            size_t length = 0;
+            uart_get_buffered_data_len(PM25_UART_NUM, &length);   // 事件之间可能已有更多数据到达，一并读出
+            while (length > 0) {
+                int received = uart_read_bytes(PM25_UART_NUM, span, length < PM25_SPAN_SIZE ? length : PM25_SPAN_SIZE, 0);
+                if (received <= 0) {
+                    break;
+                }
+                length -= (size_t) received;
+                bool detecting = particle_parser.protocol == PARTICLE_PROTOCOL_NONE;
+                if (particleParserFeed(&particle_parser, span, (size_t) received, millis()) > 0) {
+                    pm25_sample_t sample = {};
+                    sample.pm25 = particle_parser.sample.pm25;
+                    sample.pm10 = particle_parser.sample.pm10;
+                    sample.pm1 = particle_parser.sample.pm1;
+                    sample.protocol = particle_parser.sample.protocol;
+                    sample.timestampMs = millis();
+                    sample.sequence = ++sample_sequence;
+                    sample.valid = true;
+                    /* 临界区防止同一核心上优先级更高的读者（如传感器任务）在写入中途抢占后一直重试 */
+                    portENTER_CRITICAL(&air_quality_mux);
+                    sample_lock.write(sample);
+                    airQualityAdd(&air_quality, sample.pm25, sample.pm10, sample.timestampMs);
+                    portEXIT_CRITICAL(&air_quality_mux);
+                }
+                if (detecting && particle_parser.protocol != PARTICLE_PROTOCOL_NONE) {  // 刚刚锁定协议
+                    uart_set_rx_full_threshold(PM25_UART_NUM, (int) particleParserFrameSize(&particle_parser));
+                    Serial.print("颗粒物传感器协议: ");
+                    Serial.println(particleProtocolName(particle_parser.protocol));
+                }
             }
+            break;
         }
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            uart_flush_input(PM25_UART_NUM);
+            xQueueReset(uart_queue);
+            particleParserReset(&particle_parser);  // 数据不再连续，丢弃不完整帧
+            break;
+        default:                                // 帧错误、校验错误等：数据中的坏字节由帧头与校验和过滤
+            break;
     }
 }
 
 /**
- * @brief 获取当前PM2.5浓度值
- * @details 返回最近一次成功解析的PM2.5浓度值
- *          此函数可被其他模块调用以获取PM2.5数据
- * @return uint16_t 当前PM2.5浓度值，单位μg/m³
+ * @brief 获取最近的PM2.5样本
+ * @details 通过顺序锁无锁读取，各字段总是来自同一个有效帧；可被多个任务同时调用，不会互相影响
+ *          （取代读取即清除的数据就绪标志：调用者保存上次的 sequence，序号变化即为新样本）
+ * @return pm25_sample_t 最近样本；尚未收到有效帧时 valid 为 false，超过 PM25_SAMPLE_STALE_MS 未更新时 stale 为 true
  */
-uint16_t pm25_get_value() {
-    return pm25_concentration;
+pm25_sample_t pm25_get_sample() {
+    pm25_sample_t sample = sample_lock.read();
+    sample.stale = !sample.valid || millis() - sample.timestampMs > PM25_SAMPLE_STALE_MS;
+    return sample;
 }
 
 /**
- * @brief 检查是否有新的PM2.5数据
- * @details 检查数据就绪标志，用于判断是否有新的有效数据
- *          读取后会自动清除标志，避免重复处理同一数据
- * @return true 有新数据可用
- * @return false 没有新数据
- * @note 此函数采用"读取即清除"机制，每次调用后标志位会被清零
+ * @brief 获取颗粒物滚动统计报告
+ * @details 先把各窗口前进到当前时间（传感器停止发送后旧数据逐步离开窗口），再计算各窗口平均值、NowCast与AQI；
+ *          更新与查询都是常数时间，可在其他任务中调用
+ * @param report 输出的统计报告（浓度为负数表示窗口内没有数据）
  */
-bool pm25_is_data_ready() {
-    bool ready = pm25_data_ready;
-    pm25_data_ready = false;  // 读取后清除标志，避免重复处理
-    return ready;
+void pm25_get_air_quality(air_quality_report_t *report) {
+    portENTER_CRITICAL(&air_quality_mux);
+    airQualityAdvance(&air_quality, millis());
+    airQualityReport(&air_quality, report);
+    portEXIT_CRITICAL(&air_quality_mux);
 }
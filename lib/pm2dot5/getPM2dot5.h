@@ -6,30 +6,44 @@
 #define LIGHTPROJECT_GETPM2DOT5_H
 
 #include <Arduino.h>
+#include <driver/uart.h>
+#include "particleParser.h"
+#include "airQuality.h"
+#include "seqLock.h"
 
-/* PM2.5数据包格式定义 */
-#define PM25_HEADER 0xA5
-#define PM25_PACKET_SIZE 4
+/* 颗粒物传感器串口定义（各协议帧格式见 particleParser.h） */
 #define PM25_TX_PIN 17
 #define PM25_RX_PIN 18
 #define PM25_BAUD_RATE 9600
 
-/* PM2.5数据结构 */
+/* UART驱动参数（ESP-IDF UART事件队列，任务只在收到数据或超时时唤醒） */
+#define PM25_UART_NUM UART_NUM_2
+#define PM25_UART_RX_BUFFER 256         // 驱动接收环形缓冲区（字节，须大于128字节的硬件FIFO）
+#define PM25_UART_QUEUE_SIZE 8          // UART事件队列长度
+#define PM25_UART_RX_FULL_THRESH A5Protocol::FRAME_SIZE  // 识别阶段FIFO中达到最短帧长度即产生中断（锁定后改为该协议帧长度）
+#define PM25_UART_RX_TIMEOUT 3          // 接收空闲超过3个字符时间（约3ms）产生超时中断，交出不足一帧的数据
+#define PM25_SPAN_SIZE 128              // 一次读出的最大字节数（不完整帧保存在解析器中）
+#define PM25_SAMPLE_STALE_MS 10000      // 超过此时间没有新帧，样本标记为过期（传感器约1秒一帧）
+
+/* PM2.5样本（通过 pm25_get_sample() 读取，各字段来自同一个有效帧） */
 typedef struct {
-    uint8_t header;     // 0xA5
-    uint8_t dataH;      // 浓度值高7位
-    uint8_t dataL;      // 浓度值低7位
-    uint8_t checksum;   // 校验字节
-} pm25_packet_t;
+    float pm25;             // PM2.5（μg/m³）
+    float pm10;             // PM10（μg/m³），负数表示传感器不提供
+    float pm1;              // PM1.0（μg/m³），负数表示传感器不提供
+    uint8_t protocol;       // 来源协议（PARTICLE_PROTOCOL_*）
+    uint32_t timestampMs;   // 帧到达时间（millis）
+    uint32_t sequence;      // 样本序号（每个有效帧加1，0 表示尚未收到有效帧；比较序号即可判断是否有新样本）
+    bool valid;             // 是否收到过有效帧
+    bool stale;             // 读取时距帧到达已超过 PM25_SAMPLE_STALE_MS
+} pm25_sample_t;
 
 /* 全局变量声明 */
-extern uint16_t pm25_concentration;  // PM2.5浓度值，供其他代码使用
-extern bool pm25_data_ready;         // 数据就绪标志
+extern particle_parser_t particle_parser;    // 多协议流式解析器（最近样本、协议、有效帧与错误统计）
 
 /* 函数声明 */
 void pm25_init();
-void pm25_update();
-uint16_t pm25_get_value();
-bool pm25_is_data_ready();
+void pm25_update(TickType_t wait);   // 等待并处理一个UART事件（wait 为最长等待时间）
+pm25_sample_t pm25_get_sample();     // 最近样本（无锁读取，可在其他任务与核心中调用）
+void pm25_get_air_quality(air_quality_report_t *report);   // 滚动平均值、NowCast与AQI（可在其他任务中调用）
 
 #endif //LIGHTPROJECT_GETPM2DOT5_H
\ No newline at end of file
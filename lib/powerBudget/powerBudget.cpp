@@ -0,0 +1,124 @@
+/**
+ * @file powerBudget.cpp
+ * @brief LED能耗计量与功率预算模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现LED能耗计量与功率预算：
+ * - 计量：由各通道输出估算功率，按经过时间积分为 mWh（64位中间量，长时间休眠后也不会溢出）
+ * - 预算：电量高于降额点时不限制；降额点到最低电量之间按 smoothstep 曲线平滑降到最低限额
+ * - 太阳能预报越差，降额点越高（在 POWER_SOC_KNEE 与 POWER_SOC_KNEE_CLOUDY 之间插值），
+ *   连续阴天时提前省电，而不是等电池快耗尽才突然变暗
+ *
+ * @note
+ * 注意事项：
+ * - 电池电压在LED负载下会跌落，电量读数偏低，因此预算使用慢速滤波后的电量，并限制限额变化速率
+ * - 电量未知（没有电池或未接分压电路）时不限制亮度
+ */
+
+#include "powerBudget.h"
+
+/**
+ * 将数值限制在 [low, high] 范围内
+ */
+static float clampFloat(float value, float low, float high) {
+    if (value < low) {
+        return low;
+    }
+    if (value > high) {
+        return high;
+    }
+    return value;
+}
+
+/**
+ * 估算LED功率
+ * 参数：channelSum - 所有灯珠所有通道的8位输出之和；ledCount - 灯珠数量
+ * 返回值：功率（mW）
+ */
+uint32_t powerLedPowerMw(uint32_t channelSum, uint16_t ledCount) {
+    uint64_t currentUa = (uint64_t) channelSum * POWER_LED_CHANNEL_MA * 1000ULL / 255ULL
+                         + (uint64_t) ledCount * POWER_LED_IDLE_MA * 1000ULL;
+    return (uint32_t) (currentUa * POWER_LED_SUPPLY_MV / 1000000ULL);
+}
+
+/**
+ * 初始化能耗计量器（累计能量清零）
+ */
+void powerMeterInit(power_meter_t *meter, uint32_t nowMs) {
+    meter->energyMWh = 0;
+    meter->residual = 0;
+    meter->powerMw = 0;
+    meter->lastMs = nowMs;
+}
+
+/**
+ * 更新能耗计量器
+ * 功能说明：把上次更新以来按原功率消耗的能量计入累计值，再切换到新功率，每次输出变化时调用
+ * 参数：powerMw - 从现在起的功率（mW）；nowMs - 当前时间
+ */
+void powerMeterUpdate(power_meter_t *meter, uint32_t powerMw, uint32_t nowMs) {
+    uint64_t consumed = (uint64_t) meter->powerMw * (uint32_t) (nowMs - meter->lastMs) + meter->residual;
+    meter->energyMWh += (uint32_t) (consumed / POWER_MW_MS_PER_MWH);
+    meter->residual = (uint32_t) (consumed % POWER_MW_MS_PER_MWH);
+    meter->powerMw = powerMw;
+    meter->lastMs = nowMs;
+}
+
+/**
+ * 读取累计能量（含上次更新以来尚未计入的部分）
+ * 功能说明：供其他任务读取；与更新并发时结果可能短暂偏差一个更新间隔的能量，不会累积
+ * 返回值：累计能量（mWh）
+ */
+uint32_t powerMeterEnergyMWh(const power_meter_t *meter, uint32_t nowMs) {
+    uint64_t pending = (uint64_t) meter->powerMw * (uint32_t) (nowMs - meter->lastMs) + meter->residual;
+    return meter->energyMWh + (uint32_t) (pending / POWER_MW_MS_PER_MWH);
+}
+
+/**
+ * 计算目标限额
+ * 参数：socPercent - 电池电量（%），负数表示电量未知；forecast - 太阳能预报系数（0 全阴 ~ 1 晴好）
+ * 返回值：亮度上限（线性输出比例 POWER_LIMIT_MIN~1.0）
+ */
+float powerBudgetTarget(float socPercent, float forecast) {
+    if (socPercent < 0.0f) {
+        return 1.0f;
+    }
+    forecast = clampFloat(forecast, 0.0f, 1.0f);
+    float knee = POWER_SOC_KNEE + (1.0f - forecast) * (POWER_SOC_KNEE_CLOUDY - POWER_SOC_KNEE);
+    float x = clampFloat((socPercent - POWER_SOC_FLOOR) / (knee - POWER_SOC_FLOOR), 0.0f, 1.0f);
+    float smooth = x * x * (3.0f - 2.0f * x);      // smoothstep，两端斜率为0，进出降额区不会突变
+    return POWER_LIMIT_MIN + (1.0f - POWER_LIMIT_MIN) * smooth;
+}
+
+/**
+ * 初始化功率预算（电量未知，不限制）
+ */
+void powerBudgetInit(power_budget_t *budget) {
+    budget->socFiltered = -1.0f;
+    budget->limit = 1.0f;
+}
+
+/**
+ * 功率预算更新
+ * 功能说明：周期调用（约10秒一次），滤波电量后计算目标限额，并限制限额每次的变化量
+ * 参数：socPercent - 电池电量（%），负数表示电量未知；forecast - 太阳能预报系数（0~1）
+ * 返回值：新的限额（线性输出比例）
+ */
+float powerBudgetUpdate(power_budget_t *budget, float socPercent, float forecast) {
+    if (socPercent < 0.0f) {
+        budget->socFiltered = -1.0f;
+    }
+    else if (budget->socFiltered < 0.0f) {
+        budget->socFiltered = socPercent;          // 首次读到电量，直接作为初值
+    }
+    else {
+        budget->socFiltered += (socPercent - budget->socFiltered) * POWER_SOC_FILTER_ALPHA;
+    }
+    float target = powerBudgetTarget(budget->socFiltered, forecast);
+    budget->limit = clampFloat(target, budget->limit - POWER_LIMIT_MAX_STEP, budget->limit + POWER_LIMIT_MAX_STEP);
+    return budget->limit;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file powerBudget.h
+ * @brief LED能耗计量与功率预算模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为LED能耗计量与功率预算模块头文件，包含如下内容：
+ * - LED电流模型参数（每通道满占空比电流、静态电流、供电电压）
+ * - 能耗计量器结构体与累计函数声明
+ * - 按电池电量与太阳能预报计算亮度上限的预算函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 功率按 各通道8位输出之和 × 每通道电流 / 255 + 灯珠数 × 静态电流 估算，供电电压视为恒定
+ * - 能量以整数 mWh 累计，不足 1mWh 的部分保存在余量中，长期运行不会因浮点精度丢失
+ * - 功率在两次更新之间视为恒定（灯控任务稳定后休眠，输出确实不变），读取时补上最后一段
+ * - 预算上限为线性输出比例（0.0~1.0），由调用者转换为感知亮度上限
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_POWERBUDGET_H
+#define LIGHTPROJECT_POWERBUDGET_H
+
+#include <cstdint>
+
+/* LED电流模型（WS2812，5V供电） */
+#define POWER_LED_CHANNEL_MA 16         // 单个通道满占空比（255）时的电流（mA）
+#define POWER_LED_IDLE_MA 1             // 每颗灯珠的静态电流（mA，全灭时驱动芯片仍在耗电）
+#define POWER_LED_SUPPLY_MV 5000        // 灯带供电电压（mV）
+#define POWER_MW_MS_PER_MWH 3600000UL   // 1mWh = 3600000 mW·ms
+
+/* 功率预算参数（电量为百分比 0~100） */
+#define POWER_SOC_KNEE 40.0f            // 预报晴好时开始降额的电量
+#define POWER_SOC_KNEE_CLOUDY 80.0f     // 预报全阴时开始降额的电量（提前降额，撑过连续阴天）
+#define POWER_SOC_FLOOR 10.0f           // 低于此电量时只保留最低限额
+#define POWER_LIMIT_MIN 0.15f           // 最低限额（线性输出比例），保证电量耗尽前仍有基本照明
+#define POWER_SOC_FILTER_ALPHA 0.05f    // 电量一阶低通滤波系数（每次预算更新），滤除负载引起的电压跌落
+#define POWER_LIMIT_MAX_STEP 0.01f      // 每次预算更新限额最多变化1%，亮度上限的变化不可察觉
+#define POWER_FORECAST_DEFAULT 1.0f     // 没有预报时的太阳能预报系数（不额外降额）
+
+/* 能耗计量器（只由一个任务更新，其他任务只读） */
+typedef struct {
+    uint32_t energyMWh;     // 累计能量（mWh）
+    uint32_t residual;      // 不足 1mWh 的余量（mW·ms）
+    uint32_t powerMw;       // 当前功率（mW）
+    uint32_t lastMs;        // 上次更新时间（毫秒）
+} power_meter_t;
+
+/* 功率预算状态 */
+typedef struct {
+    float socFiltered;      // 滤波后的电池电量（%），负数表示没有电池（外部供电）
+    float limit;            // 当前限额（线性输出比例 0.0~1.0）
+} power_budget_t;
+
+uint32_t powerLedPowerMw(uint32_t channelSum, uint16_t ledCount);
+void powerMeterInit(power_meter_t *meter, uint32_t nowMs);
+void powerMeterUpdate(power_meter_t *meter, uint32_t powerMw, uint32_t nowMs);
+uint32_t powerMeterEnergyMWh(const power_meter_t *meter, uint32_t nowMs);
+float powerBudgetTarget(float socPercent, float forecast);
+void powerBudgetInit(power_budget_t *budget);
+float powerBudgetUpdate(power_budget_t *budget, float socPercent, float forecast);
+
+#endif //LIGHTPROJECT_POWERBUDGET_H
@@ -0,0 +1,225 @@
+/**
+ * @file scheduleEngine.cpp
+ * @brief 时间表引擎实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现时间表的编译与查表：
+ * - 本地零点、星期与公历日期由UNIX时间加时区偏移换算（不依赖C库的时区设置）
+ * - 日出日落按NOAA简化公式计算：分数年 γ → 时差方程与太阳赤纬 → 天顶角90.833°时的时角
+ * - 编译：收集当天的转换时刻（0点、关灯、开灯、宵禁开始、宵禁结束），排序去重后逐段求亮度上限，
+ *   相邻相同的段合并，得到不超过 SCHEDULE_MAX_ENTRIES 项的转换表
+ * - 查表：按分钟找到所在段，同时给出下一次转换的时刻，调用者据此安排唤醒
+ *
+ * @note
+ * 注意事项：
+ * - 时刻均按一天中的分钟数处理，跨零点的时段（如宵禁 23:00~05:00、时区导致日出晚于日落）按环形区间判断
+ */
+
+#include "scheduleEngine.h"
+#include <cmath>
+
+#define SCHEDULE_PI 3.14159265358979f
+#define SCHEDULE_DEG_TO_RAD (SCHEDULE_PI / 180.0f)
+#define SCHEDULE_SUN_ZENITH_DEG 90.833f     // 日出日落时的太阳天顶角（含大气折射与太阳视半径）
+
+/**
+ * 默认配置（不启用亮度上限）
+ */
+void scheduleConfigDefault(schedule_config_t *config) {
+    config->version = SCHEDULE_CONFIG_VERSION;
+    config->enabled = false;
+    config->latitude = SCHEDULE_DEFAULT_LATITUDE;
+    config->longitude = SCHEDULE_DEFAULT_LONGITUDE;
+    config->utcOffsetMin = SCHEDULE_DEFAULT_UTC_OFFSET;
+    config->sunsetOffsetMin = SCHEDULE_SUNSET_OFFSET_MIN;
+    config->sunriseOffsetMin = SCHEDULE_SUNRISE_OFFSET_MIN;
+    config->dayLevel = SCHEDULE_DAY_LEVEL;
+    for (uint8_t i = 0; i < 7; i++) {
+        config->weekdayLevel[i] = SCHEDULE_LEVEL_NONE;
+    }
+    config->curfewStartMin = SCHEDULE_CURFEW_START_MIN;
+    config->curfewEndMin = SCHEDULE_CURFEW_END_MIN;
+    config->curfewLevel = SCHEDULE_CURFEW_LEVEL;
+}
+
+/**
+ * 由1970-01-01起的天数换算公历日期
+ */
+void scheduleCivilFromDays(int32_t days, int16_t *year, uint8_t *month, uint8_t *day) {
+    days += 719468;                                 // 以0000-03-01为起点，闰日位于每个400年周期的末尾
+    int32_t era = (days >= 0 ? days : days - 146096) / 146097;
+    uint32_t dayOfEra = (uint32_t) (days - era * 146097);
+    uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    uint32_t mp = (5 * dayOfYear + 2) / 153;        // 从3月起的月序号
+    *day = (uint8_t) (dayOfYear - (153 * mp + 2) / 5 + 1);
+    *month = (uint8_t) (mp < 10 ? mp + 3 : mp - 9);
+    *year = (int16_t) (yearOfEra + era * 400 + (*month <= 2 ? 1 : 0));
+}
+
+/**
+ * 一年中的第几天（1月1日为1）
+ */
+static uint16_t dayOfYear(int16_t year, uint8_t month, uint8_t day) {
+    static const uint16_t cumulative[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return cumulative[month - 1] + day + ((leap && month > 2) ? 1 : 0);
+}
+
+/**
+ * 计算日出日落（UTC，一天中的分钟数，可能小于0或大于1440）
+ * 参数：year/month/day - 日期；latitude/longitude - 纬度、经度（度）
+ * 返回值：SCHEDULE_SUN_NORMAL / SCHEDULE_SUN_ALWAYS_UP（极昼）/ SCHEDULE_SUN_ALWAYS_DOWN（极夜）
+ */
+int scheduleSunTimes(int16_t year, uint8_t month, uint8_t day, float latitude, float longitude,
+                     float *sunriseMinUtc, float *sunsetMinUtc) {
+    float gamma = 2.0f * SCHEDULE_PI / 365.0f * (float) (dayOfYear(year, month, day) - 1);     // 分数年（按正午）
+    float eqTime = 229.18f * (0.000075f + 0.001868f * cosf(gamma) - 0.032077f * sinf(gamma)
+                              - 0.014615f * cosf(2.0f * gamma) - 0.040849f * sinf(2.0f * gamma));   // 时差（分钟）
+    float decl = 0.006918f - 0.399912f * cosf(gamma) + 0.070257f * sinf(gamma)
+                 - 0.006758f * cosf(2.0f * gamma) + 0.000907f * sinf(2.0f * gamma)
+                 - 0.002697f * cosf(3.0f * gamma) + 0.00148f * sinf(3.0f * gamma);                 // 太阳赤纬（弧度）
+    float lat = latitude * SCHEDULE_DEG_TO_RAD;
+    float cosHourAngle = cosf(SCHEDULE_SUN_ZENITH_DEG * SCHEDULE_DEG_TO_RAD) / (cosf(lat) * cosf(decl))
+                         - tanf(lat) * tanf(decl);
+    if (cosHourAngle > 1.0f) {
+        return SCHEDULE_SUN_ALWAYS_DOWN;
+    }
+    if (cosHourAngle < -1.0f) {
+        return SCHEDULE_SUN_ALWAYS_UP;
+    }
+    float hourAngle = acosf(cosHourAngle) / SCHEDULE_DEG_TO_RAD;    // 时角（度）
+    *sunriseMinUtc = 720.0f - 4.0f * (longitude + hourAngle) - eqTime;
+    *sunsetMinUtc = 720.0f - 4.0f * (longitude - hourAngle) - eqTime;
+    return SCHEDULE_SUN_NORMAL;
+}
+
+/**
+ * 分钟数归一化到 0~1439
+ */
+static uint16_t wrapMinute(int32_t minute) {
+    minute %= SCHEDULE_MINUTES_PER_DAY;
+    return (uint16_t) (minute < 0 ? minute + SCHEDULE_MINUTES_PER_DAY : minute);
+}
+
+/**
+ * 判断分钟是否在环形区间 [start, end) 内（start == end 表示空区间）
+ */
+static bool inWindow(uint16_t minute, uint16_t start, uint16_t end) {
+    if (start < end) {
+        return minute >= start && minute < end;
+    }
+    if (start > end) {
+        return minute >= start || minute < end;
+    }
+    return false;
+}
+
+/**
+ * 编译当天计划
+ * 参数：config - 时间表配置；epoch - 当前UNIX时间（秒）；plan - 输出的当天计划
+ */
+void scheduleCompile(const schedule_config_t *config, uint32_t epoch, schedule_plan_t *plan) {
+    int64_t local = (int64_t) epoch + (int64_t) config->utcOffsetMin * 60;
+    int32_t days = (int32_t) (local >= 0 ? local / 86400 : (local - 86399) / 86400);   // 本地日期（1970-01-01起的天数）
+    plan->dayStart = (uint32_t) ((int64_t) days * 86400 - (int64_t) config->utcOffsetMin * 60);
+    plan->utcOffsetMin = config->utcOffsetMin;
+    plan->weekday = (uint8_t) (((days % 7) + 11) % 7);     // 1970-01-01 是星期四
+    int16_t year;
+    uint8_t month, day;
+    scheduleCivilFromDays(days, &year, &month, &day);
+
+    float riseUtc = 0.0f, setUtc = 0.0f;
+    int sun = scheduleSunTimes(year, month, day, config->latitude, config->longitude, &riseUtc, &setUtc);
+    uint16_t offMinute = 0, onMinute = 0;   // 关灯（白天开始）与开灯（夜间开始）时刻
+    if (sun == SCHEDULE_SUN_NORMAL) {
+        plan->sunriseMin = (int16_t) wrapMinute((int32_t) lroundf(riseUtc) + config->utcOffsetMin);
+        plan->sunsetMin = (int16_t) wrapMinute((int32_t) lroundf(setUtc) + config->utcOffsetMin);
+        offMinute = wrapMinute(plan->sunriseMin + config->sunriseOffsetMin);
+        onMinute = wrapMinute(plan->sunsetMin + config->sunsetOffsetMin);
+    }
+    else {
+        plan->sunriseMin = -1;
+        plan->sunsetMin = -1;
+    }
+
+    /* 收集转换时刻并排序去重 */
+    uint16_t points[SCHEDULE_MAX_ENTRIES];
+    uint8_t count = 0;
+    points[count++] = 0;
+    if (config->enabled && sun == SCHEDULE_SUN_NORMAL) {
+        points[count++] = offMinute;
+        points[count++] = onMinute;
+    }
+    bool curfew = config->enabled && config->curfewStartMin != config->curfewEndMin;
+    if (curfew) {
+        points[count++] = wrapMinute(config->curfewStartMin);
+        points[count++] = wrapMinute(config->curfewEndMin);
+    }
+    for (uint8_t i = 1; i < count; i++) {          // 插入排序（最多5项）
+        uint16_t value = points[i];
+        uint8_t j = i;
+        while (j > 0 && points[j - 1] > value) {
+            points[j] = points[j - 1];
+            j--;
+        }
+        points[j] = value;
+    }
+
+    /* 逐段求亮度上限，相邻相同的段合并 */
+    plan->count = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t minute = points[i];
+        uint16_t level = SCHEDULE_LEVEL_NONE;
+        if (config->enabled) {
+            bool daytime = (sun == SCHEDULE_SUN_ALWAYS_UP)
+                           || (sun == SCHEDULE_SUN_NORMAL && inWindow(minute, offMinute, onMinute));
+            if (daytime) {
+                level = config->dayLevel;
+            }
+            else {
+                level = config->weekdayLevel[plan->weekday];
+                if (curfew && inWindow(minute, config->curfewStartMin, config->curfewEndMin)
+                    && config->curfewLevel < level) {
+                    level = config->curfewLevel;
+                }
+            }
+        }
+        if (plan->count > 0 && (plan->entries[plan->count - 1].minute == minute
+                                || plan->entries[plan->count - 1].level == level)) {
+            continue;       // 与上一段时刻相同（重复的转换点）或上限相同（无需转换）
+        }
+        plan->entries[plan->count].minute = minute;
+        plan->entries[plan->count].level = level;
+        plan->count++;
+    }
+}
+
+/**
+ * 计划是否覆盖给定时刻（即给定时刻与编译时处于同一本地日期）
+ */
+bool schedulePlanCovers(const schedule_plan_t *plan, uint32_t epoch) {
+    return plan->count > 0 && epoch - plan->dayStart < SCHEDULE_SECONDS_PER_DAY;
+}
+
+/**
+ * 查表
+ * 参数：minute - 一天中的分钟数；nextMinute - 输出下一次转换的时刻（没有时为 SCHEDULE_MINUTES_PER_DAY，即次日零点）
+ * 返回值：当前亮度上限（没有计划时为 SCHEDULE_LEVEL_NONE）
+ */
+uint16_t schedulePlanLevel(const schedule_plan_t *plan, uint16_t minute, uint16_t *nextMinute) {
+    uint16_t level = SCHEDULE_LEVEL_NONE;
+    *nextMinute = SCHEDULE_MINUTES_PER_DAY;
+    for (uint8_t i = 0; i < plan->count; i++) {
+        if (plan->entries[i].minute > minute) {
+            *nextMinute = plan->entries[i].minute;
+            break;
+        }
+        level = plan->entries[i].level;
+    }
+    return level;
+}
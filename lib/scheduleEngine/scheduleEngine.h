@@ -0,0 +1,94 @@
+/**
+ * @file scheduleEngine.h
+ * @brief 时间表引擎头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为时间表引擎头文件，包含如下内容：
+ * - 时间表配置（灯杆经纬度、时区、日出日落偏移、按星期的亮度上限、宵禁时段与亮度）
+ * - 当天计划（紧凑的转换表：从某分钟起的亮度上限）
+ * - 日出日落计算、公历换算、计划编译与查表的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 每天只编译一次计划（或配置、时间改变时），灯控任务每次唤醒只查表，不再逐条判断规则
+ * - 亮度上限作用于自动来源（运动增亮与环境光），紧急照明与远程设置不受限制
+ * - 白天（日出+偏移 ~ 日落+偏移）使用白天上限（默认0，即按天文时钟关灯；光照传感器仍然有效，两者取暗）
+ * - 夜间按日历日的星期取上限，宵禁时段再取宵禁亮度与星期上限中较小的一个
+ * - 日出日落按NOAA简化公式计算（太阳天顶角90.833°，误差约1~2分钟），极昼/极夜时整天为白天/夜间
+ * - 时区为固定偏移（分钟），不处理夏令时
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_SCHEDULEENGINE_H
+#define LIGHTPROJECT_SCHEDULEENGINE_H
+
+#include <cstdint>
+
+#define SCHEDULE_MINUTES_PER_DAY 1440
+#define SCHEDULE_SECONDS_PER_DAY 86400UL
+#define SCHEDULE_MAX_ENTRIES 6              // 转换表最多项数（0点、日出、日落、宵禁开始、宵禁结束）
+#define SCHEDULE_LEVEL_NONE 65535           // 不限制亮度
+#define SCHEDULE_CONFIG_VERSION 1           // 配置结构体版本（NVS中保存的数据版本不符时丢弃）
+
+/* 日出日落计算结果 */
+#define SCHEDULE_SUN_NORMAL 0               // 有日出日落
+#define SCHEDULE_SUN_ALWAYS_UP 1            // 极昼
+#define SCHEDULE_SUN_ALWAYS_DOWN (-1)       // 极夜
+
+/* 默认配置 */
+#define SCHEDULE_DEFAULT_LATITUDE 39.90f    // 默认纬度（北纬为正）
+#define SCHEDULE_DEFAULT_LONGITUDE 116.40f  // 默认经度（东经为正）
+#define SCHEDULE_DEFAULT_UTC_OFFSET 480     // 默认时区（UTC+8，分钟）
+#define SCHEDULE_SUNSET_OFFSET_MIN (-15)    // 开灯时刻相对日落的偏移（分钟，负数为日落前）
+#define SCHEDULE_SUNRISE_OFFSET_MIN 15      // 关灯时刻相对日出的偏移（分钟，正数为日出后）
+#define SCHEDULE_DAY_LEVEL 0                // 白天的亮度上限（0 = 关灯）
+#define SCHEDULE_CURFEW_START_MIN 60        // 宵禁开始（01:00）
+#define SCHEDULE_CURFEW_END_MIN 300         // 宵禁结束（05:00）
+#define SCHEDULE_CURFEW_LEVEL 55705         // 宵禁亮度上限（L* ≈ 85，仍高于基础亮度，运动增亮可见）
+
+/* 时间表配置（整体保存到NVS） */
+typedef struct {
+    uint8_t version;                // 结构体版本
+    bool enabled;                   // 是否启用亮度上限（未启用时只提供时刻，用于分时段统计与色温曲线）
+    float latitude;                 // 纬度（度，北纬为正）
+    float longitude;                // 经度（度，东经为正）
+    int16_t utcOffsetMin;           // 时区（相对UTC的分钟数）
+    int16_t sunsetOffsetMin;        // 开灯时刻 = 日落 + 偏移（分钟）
+    int16_t sunriseOffsetMin;       // 关灯时刻 = 日出 + 偏移（分钟）
+    uint16_t dayLevel;              // 白天的亮度上限（16位感知亮度）
+    uint16_t weekdayLevel[7];       // 夜间按星期的亮度上限（0 = 星期日）
+    uint16_t curfewStartMin;        // 宵禁开始（一天中的分钟数），与结束相同表示不宵禁
+    uint16_t curfewEndMin;          // 宵禁结束（一天中的分钟数）
+    uint16_t curfewLevel;           // 宵禁亮度上限（16位感知亮度）
+} schedule_config_t;
+
+/* 转换表项：从 minute 起使用 level，直到下一项 */
+typedef struct {
+    uint16_t minute;                // 一天中的分钟数
+    uint16_t level;                 // 亮度上限（16位感知亮度）
+} schedule_entry_t;
+
+/* 当天计划 */
+typedef struct {
+    uint32_t dayStart;              // 本地零点对应的UNIX时间（秒）
+    int16_t utcOffsetMin;           // 编译时使用的时区
+    int16_t sunriseMin;             // 本地日出时刻（分钟），极昼/极夜时为 -1
+    int16_t sunsetMin;              // 本地日落时刻（分钟），极昼/极夜时为 -1
+    uint8_t weekday;                // 星期（0 = 星期日）
+    uint8_t count;                  // 转换表项数（0 表示没有计划）
+    schedule_entry_t entries[SCHEDULE_MAX_ENTRIES];
+} schedule_plan_t;
+
+void scheduleConfigDefault(schedule_config_t *config);
+void scheduleCivilFromDays(int32_t days, int16_t *year, uint8_t *month, uint8_t *day);
+int scheduleSunTimes(int16_t year, uint8_t month, uint8_t day, float latitude, float longitude,
+                     float *sunriseMinUtc, float *sunsetMinUtc);
+void scheduleCompile(const schedule_config_t *config, uint32_t epoch, schedule_plan_t *plan);
+bool schedulePlanCovers(const schedule_plan_t *plan, uint32_t epoch);
+uint16_t schedulePlanLevel(const schedule_plan_t *plan, uint16_t minute, uint16_t *nextMinute);
+
+#endif //LIGHTPROJECT_SCHEDULEENGINE_H
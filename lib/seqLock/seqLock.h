@@ -0,0 +1,58 @@
+/**
+ * @file seqLock.h
+ * @brief 单写者顺序锁（seqlock）
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件提供一个顺序锁模板，用于一个任务发布、多个任务（可在另一核心上）读取的小型数据：
+ * - 写入前把序号加1（变为奇数），写完再加1（变为偶数）
+ * - 读者不加锁，先后两次读取序号，序号为奇数或前后不一致说明读到一半被改写，重新读取
+ *
+ * @note
+ * 注意事项：
+ * - 只能有一个写者；写者不能在写入中途被同一核心上的读者抢占，否则读者会一直重试
+ *   （写入很短，调用者应在临界区内调用 write()）
+ * - T 必须是可平凡复制的类型
+ * - 本文件不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_SEQLOCK_H
+#define LIGHTPROJECT_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+template<typename T>
+class SeqLock {
+public:
+    /* 写者：发布新值 */
+    void write(const T &value) {
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);         // 奇数：写入中
+        std::atomic_thread_fence(std::memory_order_release);    // 序号先于数据可见
+        data_ = value;
+        seq_.store(seq + 2, std::memory_order_release);         // 偶数：数据先于序号可见
+    }
+
+    /* 读者：读取一致的副本（不加锁，被改写时重试） */
+    T read() const {
+        T copy;
+        uint32_t before, after;
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            copy = data_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+        return copy;
+    }
+
+private:
+    T data_{};                          // 数据
+    std::atomic<uint32_t> seq_{0};      // 序号（偶数表示数据完整）
+};
+
+#endif //LIGHTPROJECT_SEQLOCK_H
@@ -0,0 +1,232 @@
+/**
+ * @file solarHarvest.cpp
+ * @brief 太阳能收益统计模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现收益积分与每日记录：
+ * - 每次更新先把本次间隔计入当前小时（电量净增量与充电期间负载能量），再处理跨小时、跨日
+ * - 小时结束时电量净增量为负（充电不足以覆盖负载）按0计，太阳能输入按模型折算后并入当天总量与收益曲线
+ * - 欠发判断从最近的完整日往前数：有效日低于门限计数加1，遇到达标的有效日停止，无效日跳过
+ *
+ * @note
+ * 注意事项：
+ * - 估计电量由卡尔曼滤波给出，变化平滑，小时内的净增量不会因观测噪声累积偏差
+ * - 预报系数为0（全阴）的日子期望为0，不参与欠发判断
+ */
+
+#include "solarHarvest.h"
+#include "batterySoc.h"
+
+static constexpr float SOLAR_MWH_PER_PERCENT = SOC_CAPACITY_MAH * SOLAR_BATTERY_NOMINAL_MV / 1000.0f / 100.0f;  // 1%电量对应的能量（mWh）
+
+/**
+ * 开始新的一天
+ */
+static void dayStart(solar_day_t *day, uint32_t index, uint8_t flags) {
+    *day = {};
+    day->day = index;
+    day->flags = flags;
+}
+
+/**
+ * 当前小时的充入能量与太阳能输入（mWh）
+ */
+static void hourEnergy(const solar_harvest_t *h, float *charge, float *solar) {
+    *charge = h->hourChargeMWh > 0.0f ? h->hourChargeMWh : 0.0f;
+    *solar = (*charge + h->hourLoadMWh) / SOLAR_CHARGER_EFFICIENCY;
+}
+
+/**
+ * 把当前小时并入一天的记录（不修改统计状态，上报时用于合并进行中的小时）
+ */
+static void hourMerge(const solar_harvest_t *h, solar_day_t *day) {
+    float charge, solar;
+    hourEnergy(h, &charge, &solar);
+    day->chargeMWh += (uint32_t) (charge + 0.5f);
+    day->solarMWh += (uint32_t) (solar + 0.5f);
+    if (h->hour >= 0) {
+        uint32_t units = day->hourly[h->hour] + (uint32_t) (solar / SOLAR_HOUR_UNIT_MWH + 0.5f);
+        day->hourly[h->hour] = (uint16_t) (units > 0xFFFF ? 0xFFFF : units);
+    }
+}
+
+/**
+ * 结束当前小时
+ */
+static void hourClose(solar_harvest_t *h) {
+    hourMerge(h, &h->today);
+    h->hourChargeMWh = 0.0f;
+    h->hourLoadMWh = 0.0f;
+}
+
+/**
+ * 把当天记录写入环形缓冲区
+ */
+static void dayClose(solar_harvest_t *h, float forecast) {
+    float percent = forecast * 100.0f + 0.5f;
+    h->today.forecastPercent = (uint8_t) (percent < 0.0f ? 0.0f : (percent > 100.0f ? 100.0f : percent));
+    h->history[h->head] = h->today;
+    h->head = (uint8_t) ((h->head + 1) % SOLAR_HISTORY_DAYS);
+    if (h->count < SOLAR_HISTORY_DAYS) {
+        h->count++;
+    }
+}
+
+/**
+ * 毫秒累加到分钟计数（分钟数饱和）
+ */
+static void addMinutes(uint32_t *ms, uint16_t *minutes, uint32_t dt) {
+    *ms += dt;
+    while (*ms >= 60000) {
+        *ms -= 60000;
+        if (*minutes < 0xFFFF) {
+            (*minutes)++;
+        }
+    }
+}
+
+/**
+ * 初始化统计状态（不含历史记录，历史记录由调用者从NVS恢复）
+ */
+void solarHarvestInit(solar_harvest_t *h) {
+    *h = {};
+    h->hour = -1;
+}
+
+/**
+ * 更新收益统计（每个电池电压值一次）
+ * 参数：localSeconds - 本地时间（UNIX时间 + 时区，秒），未对时为0；soc - 估计电量（%）；
+ *       batteryMv - 电池电压；loadMa - 电池侧负载电流；charging - 是否正在充电；forecast - 太阳能预报系数
+ * 返回值：有一天刚结束并写入环形缓冲区时返回 true
+ */
+bool solarHarvestUpdate(solar_harvest_t *h, uint32_t nowMs, uint32_t localSeconds, float soc,
+                        float batteryMv, float loadMa, bool charging, float forecast) {
+    uint32_t day = localSeconds / 86400;
+    int8_t hour = localSeconds == 0 ? (int8_t) -1 : (int8_t) ((localSeconds % 86400) / 3600);
+    if (!h->started) {                              // 启动时当天已经过去一部分
+        h->started = true;
+        h->lastMs = nowMs;
+        h->lastSoc = soc;
+        h->hour = hour;
+        dayStart(&h->today, day, SOLAR_DAY_FLAG_PARTIAL);
+        return false;
+    }
+
+    /* 本次间隔计入当前小时 */
+    uint32_t dt = nowMs - h->lastMs;
+    h->lastMs = nowMs;
+    if (dt > SOLAR_MAX_STEP_MS) {
+        dt = SOLAR_MAX_STEP_MS;
+    }
+    addMinutes(&h->coveredMs, &h->today.coveredMinutes, dt);
+    if (charging) {
+        addMinutes(&h->chargeMs, &h->today.chargeMinutes, dt);
+        h->hourChargeMWh += (soc - h->lastSoc) * SOLAR_MWH_PER_PERCENT;
+        h->hourLoadMWh += loadMa * batteryMv / 1000.0f * ((float) dt / 3600000.0f);
+        if (soc >= SOLAR_FULL_SOC) {
+            h->today.flags |= SOLAR_DAY_FLAG_SATURATED;
+        }
+    }
+    h->lastSoc = soc;
+
+    /* 跨小时、跨日 */
+    if (day == h->today.day && hour == h->hour) {
+        return false;
+    }
+    hourClose(h);
+    bool closed = false;
+    if (day == 0 || h->today.day == 0) {            // 时间丢失或刚对时：继续当天记录
+        h->today.day = day;
+        h->today.flags |= SOLAR_DAY_FLAG_PARTIAL;
+    }
+    else if (day != h->today.day) {
+        bool consecutive = day == h->today.day + 1;     // 正常跨过零点；时间被修改时新的一天不完整
+        dayClose(h, forecast);
+        dayStart(&h->today, day, consecutive ? 0 : SOLAR_DAY_FLAG_PARTIAL);
+        h->coveredMs = 0;
+        h->chargeMs = 0;
+        closed = true;
+    }
+    h->hour = hour;
+    return closed;
+}
+
+/**
+ * 最近的完整日（age 为0表示最近一天），不存在时返回 nullptr
+ */
+const solar_day_t *solarHarvestDay(const solar_harvest_t *h, uint8_t age) {
+    if (age >= h->count) {
+        return nullptr;
+    }
+    return &h->history[(h->head + SOLAR_HISTORY_DAYS - 1 - age) % SOLAR_HISTORY_DAYS];
+}
+
+/**
+ * 收益最高的小时（没有收益时返回0）
+ */
+uint8_t solarDayPeakHour(const solar_day_t *day) {
+    uint8_t peak = 0;
+    for (uint8_t i = 1; i < 24; i++) {
+        if (day->hourly[i] > day->hourly[peak]) {
+            peak = i;
+        }
+    }
+    return peak;
+}
+
+/**
+ * 期望是否已设置且参数有效
+ */
+bool solarExpectationValid(const solar_expectation_t *expectation) {
+    return expectation != nullptr && expectation->version == SOLAR_EXPECT_VERSION && expectation->expectedWh > 0
+           && expectation->days > 0 && expectation->minRatioPercent > 0 && expectation->minRatioPercent <= 100;
+}
+
+/**
+ * 连续欠发天数（从最近的完整日往前数，不完整、电池充满或预报全阴的日子跳过）
+ */
+uint8_t solarHarvestLowDays(const solar_harvest_t *h, const solar_expectation_t *expectation) {
+    if (!solarExpectationValid(expectation)) {
+        return 0;
+    }
+    uint8_t low = 0;
+    for (uint8_t age = 0; age < h->count; age++) {
+        const solar_day_t *day = solarHarvestDay(h, age);
+        if (day->day == 0 || (day->flags & (SOLAR_DAY_FLAG_PARTIAL | SOLAR_DAY_FLAG_SATURATED)) != 0
+            || day->coveredMinutes < SOLAR_VALID_MINUTES) {
+            continue;
+        }
+        /* 期望（mWh）× 预报系数（%）× 欠发门限（%） */
+        uint64_t threshold = (uint64_t) expectation->expectedWh * 1000U * day->forecastPercent * expectation->minRatioPercent / 10000U;
+        if (threshold == 0) {
+            continue;
+        }
+        if (day->solarMWh >= threshold) {
+            break;
+        }
+        low++;
+    }
+    return low;
+}
+
+/**
+ * 生成上报摘要
+ */
+void solarHarvestReport(const solar_harvest_t *h, const solar_expectation_t *expectation, solar_report_t *report) {
+    report->today = h->today;
+    hourMerge(h, &report->today);
+    const solar_day_t *yesterday = solarHarvestDay(h, 0);
+    if (yesterday != nullptr) {
+        report->yesterday = *yesterday;
+    }
+    else {
+        report->yesterday = {};
+    }
+    report->peakHour = solarDayPeakHour(&report->yesterday);
+    report->lowDays = solarHarvestLowDays(h, expectation);
+    report->underperforming = solarExpectationValid(expectation) && report->lowDays >= expectation->days;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file solarHarvest.h
+ * @brief 太阳能收益统计模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为太阳能收益统计模块头文件，包含如下内容：
+ * - 充电与收益模型参数
+ * - 每日记录（太阳能输入、电池充入、充电时长、24小时收益曲线）与最近7天环形缓冲区
+ * - 发电量期望（由平台按灯杆下发，保存在NVS）与欠发判断
+ *
+ * @note
+ * 注意事项：
+ * - 没有电流采样，收益由模型估算：充电期间电池充入能量 = 估计电量的净增量 × 容量 × 标称电压，
+ *   负载在充电期间由充电芯片直接供电；太阳能输入 = (充入能量 + 充电期间负载能量) / 充电效率
+ * - 太阳能输入由充入能量按固定效率折算，充入能量 / 太阳能输入 最多为 SOLAR_CHARGER_EFFICIENCY，是模型的产物而不是测量值，
+ *   不能用来判断面板状态；面板状态只由太阳能输入与期望比较（欠发判断）
+ * - 能量先累计在当前小时，跨小时时并入当天记录与收益曲线；跨本地零点时当天记录进入环形缓冲区
+ * - 未对时期间只累计当天总量，不计入曲线；对时后当天记录标记为不完整
+ * - 不完整（覆盖不足20小时）或电池曾充满（收益受负载限制而不是面板限制）的日子不参与欠发判断
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_SOLARHARVEST_H
+#define LIGHTPROJECT_SOLARHARVEST_H
+
+#include <cstdint>
+
+/* 收益模型 */
+#define SOLAR_BATTERY_NOMINAL_MV 3700       // 电池标称电压（电量增量折算能量）
+#define SOLAR_CHARGER_EFFICIENCY 0.80f      // 充电芯片效率（太阳能输入 = 输出 / 效率）
+#define SOLAR_FULL_SOC 99.0f                // 充电时电量达到此值视为充满
+#define SOLAR_MAX_STEP_MS 10000             // 两次更新间隔上限（超过按此值计算）
+
+/* 每日记录与环形缓冲区 */
+#define SOLAR_HISTORY_DAYS 7                // 保存的完整日数
+#define SOLAR_HOUR_UNIT_MWH 10              // 收益曲线单位（10mWh，uint16 最大约655Wh/小时）
+#define SOLAR_VALID_MINUTES 1200            // 覆盖不少于20小时的日子才参与欠发判断
+#define SOLAR_DAY_FLAG_SATURATED 0x01       // 当天电池曾充满
+#define SOLAR_DAY_FLAG_PARTIAL 0x02         // 当天曾未对时或重启（记录不完整）
+
+/* 发电量期望 */
+#define SOLAR_EXPECT_VERSION 1              // 期望结构体版本（NVS中保存的数据版本不符时丢弃）
+#define SOLAR_EXPECT_RATIO_DEFAULT 60       // 默认欠发门限（期望的60%）
+#define SOLAR_EXPECT_DAYS_DEFAULT 3         // 默认连续欠发天数
+
+/* 每日记录 */
+typedef struct {
+    uint32_t day;                           // 本地日期（自1970-01-01起的天数），0 表示未对时
+    uint32_t solarMWh;                      // 估算的太阳能输入（mWh）
+    uint32_t chargeMWh;                     // 电池充入能量（mWh）
+    uint16_t chargeMinutes;                 // 太阳能电压高于充电门限的分钟数
+    uint16_t coveredMinutes;                // 有记录的分钟数
+    uint16_t hourly[24];                    // 每小时太阳能输入（SOLAR_HOUR_UNIT_MWH）
+    uint8_t forecastPercent;                // 当天结束时的太阳能预报系数（百分比）
+    uint8_t flags;                          // SOLAR_DAY_FLAG_*
+} solar_day_t;
+
+/* 发电量期望（晴好天气下每天的太阳能输入） */
+typedef struct {
+    uint8_t version;                        // 结构体版本，0 表示未设置（不做欠发判断）
+    uint8_t minRatioPercent;                // 低于 期望 × 预报系数 × 此比例 视为欠发
+    uint8_t days;                           // 连续欠发天数达到此值时标记
+    uint16_t expectedWh;                    // 期望的每日太阳能输入（Wh）
+} solar_expectation_t;
+
+/* 统计状态 */
+typedef struct {
+    solar_day_t today;                      // 当天记录（进行中）
+    solar_day_t history[SOLAR_HISTORY_DAYS];    // 最近的完整日（环形缓冲区）
+    uint8_t head;                           // 下一次写入的位置
+    uint8_t count;                          // 已保存的日数
+    int8_t hour;                            // 当前小时（-1 表示未对时）
+    float hourChargeMWh;                    // 当前小时电池电量净增量折算的能量（可为负）
+    float hourLoadMWh;                      // 当前小时充电期间的负载能量
+    uint32_t chargeMs;                      // 不足一分钟的充电时长
+    uint32_t coveredMs;                     // 不足一分钟的记录时长
+    float lastSoc;                          // 上次更新时的电量
+    uint32_t lastMs;                        // 上次更新时间
+    bool started;                           // 是否已有首次更新
+} solar_harvest_t;
+
+/* 上报用的摘要 */
+typedef struct {
+    solar_day_t today;                      // 当天进行中的记录（已并入当前小时）
+    solar_day_t yesterday;                  // 最近一个完整日（day 为0表示还没有）
+    uint8_t peakHour;                       // 最近完整日收益最高的小时
+    uint8_t lowDays;                        // 连续欠发天数
+    bool underperforming;                   // 是否欠发
+} solar_report_t;
+
+void solarHarvestInit(solar_harvest_t *h);
+bool solarHarvestUpdate(solar_harvest_t *h, uint32_t nowMs, uint32_t localSeconds, float soc,
+                        float batteryMv, float loadMa, bool charging, float forecast);
+const solar_day_t *solarHarvestDay(const solar_harvest_t *h, uint8_t age);
+uint8_t solarHarvestLowDays(const solar_harvest_t *h, const solar_expectation_t *expectation);
+void solarHarvestReport(const solar_harvest_t *h, const solar_expectation_t *expectation, solar_report_t *report);
+uint8_t solarDayPeakHour(const solar_day_t *day);
+bool solarExpectationValid(const solar_expectation_t *expectation);
+
+#endif //LIGHTPROJECT_SOLARHARVEST_H
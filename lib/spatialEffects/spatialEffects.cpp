@@ -0,0 +1,179 @@
+/**
+ * @file spatialEffects.cpp
+ * @brief 逐像素空间效果模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现逐像素的定点渲染流水线，每帧对每颗灯珠：
+ * 1. 运动波（进行中时）：按灯珠到PIR的距离计算波前遮罩，增亮部分乘以遮罩，波前未到的灯珠停在基础亮度
+ * 2. 乘以合并增益（配光 × 热点降额）
+ * 3. 16位线性值时间抖动（或稳定时四舍五入）为8位输出
+ * 波前位置以 1/256 颗灯珠为单位，遮罩、增益与抖动全部是整数运算
+ *
+ * @note
+ * 注意事项：
+ * - 时间抖动余量按像素保存，各像素增益不同时也能各自保持16位精度
+ * - 运动波进行中需要持续刷新，调用者通过 waveActive 判断
+ * - 运动波扫过整条灯带的时间固定，长灯带的波前按比例变快、变宽，不会拖长增亮过程
+ */
+
+#include "spatialEffects.h"
+#include "perceptualDimming.h"
+
+/**
+ * 空间效果层所需存储的字节数（配光增益、热点权重、合并增益与三通道抖动余量）
+ */
+size_t spatialStorageSize(uint16_t count) {
+    return (size_t) count * 6 * sizeof(uint16_t);
+}
+
+/**
+ * 初始化空间效果层（均匀配光、无热点、无降额）
+ * 参数：count - 灯珠数量；pirLed - 离PIR最近的灯珠序号
+ *       storage - 至少 spatialStorageSize(count) 字节、2字节对齐的存储（nullptr 时灯珠数量视为0）
+ */
+void spatialInit(spatial_layer_t *layer, uint16_t count, uint16_t pirLed, void *storage) {
+    uint16_t *words = static_cast<uint16_t *>(storage);
+    layer->count = words != nullptr ? count : 0;
+    layer->pirLed = pirLed < layer->count ? pirLed : 0;
+    layer->gain = words;
+    layer->hotspot = words + layer->count;
+    layer->combined = words + 2 * layer->count;
+    layer->residual = reinterpret_cast<uint16_t (*)[3]>(words + 3 * layer->count);
+    for (uint16_t i = 0; i < layer->count; i++) {
+        layer->gain[i] = SPATIAL_GAIN_ONE;
+        layer->hotspot[i] = 0;
+        layer->residual[i][0] = 0;
+        layer->residual[i][1] = 0;
+        layer->residual[i][2] = 0;
+    }
+    layer->thermal = SPATIAL_GAIN_ONE;
+    layer->waveStart = 0;
+    layer->waveActive = false;
+    spatialUpdateGains(layer);
+}
+
+/**
+ * 设置单颗灯珠的配光增益与热点权重（设置完成后调用 spatialUpdateGains() 生效）
+ */
+void spatialSetGain(spatial_layer_t *layer, uint16_t index, uint16_t gain, uint16_t hotspot) {
+    if (index < layer->count) {
+        layer->gain[index] = gain;
+        layer->hotspot[index] = hotspot;
+    }
+}
+
+/**
+ * 合并配光增益与热点降额
+ * 功能说明：降额 = 1 - 热点权重 × (1 - 温度降额系数)，合并增益 = 配光增益 × 降额
+ */
+void spatialUpdateGains(spatial_layer_t *layer) {
+    uint32_t loss = SPATIAL_GAIN_ONE - layer->thermal;     // 热点权重为1的灯珠损失的增益
+    for (uint16_t i = 0; i < layer->count; i++) {
+        uint16_t derate = (uint16_t) (SPATIAL_GAIN_ONE - SPATIAL_SCALE(loss, layer->hotspot[i]));
+        layer->combined[i] = SPATIAL_SCALE(layer->gain[i], derate);
+    }
+}
+
+/**
+ * 按温度更新热点降额
+ * 功能说明：低于 SPATIAL_DERATE_START_C 不降额，到 SPATIAL_DERATE_END_C 线性降到 SPATIAL_DERATE_MIN
+ * 参数：temperatureC - 灯体附近温度（℃）
+ */
+void spatialSetTemperature(spatial_layer_t *layer, float temperatureC) {
+    float x = (temperatureC - SPATIAL_DERATE_START_C) / (SPATIAL_DERATE_END_C - SPATIAL_DERATE_START_C);
+    if (x < 0.0f) {
+        x = 0.0f;
+    }
+    if (x > 1.0f) {
+        x = 1.0f;
+    }
+    uint16_t thermal = (uint16_t) ((float) SPATIAL_GAIN_ONE - x * (float) (SPATIAL_GAIN_ONE - SPATIAL_DERATE_MIN));
+    if (thermal != layer->thermal) {
+        layer->thermal = thermal;
+        spatialUpdateGains(layer);
+    }
+}
+
+/**
+ * 开始运动波（运动增亮开始时调用）
+ */
+void spatialStartWave(spatial_layer_t *layer, uint32_t nowMs) {
+    layer->waveStart = nowMs;
+    layer->waveActive = true;
+}
+
+/**
+ * 计算运动波遮罩
+ * 参数：front - 波前位置（1/256 颗灯珠）；width - 波前过渡宽度（1/256 颗灯珠）；index - 灯珠序号
+ * 返回值：遮罩（0 ~ SPATIAL_GAIN_ONE）
+ */
+static uint16_t waveMask(const spatial_layer_t *layer, uint32_t front, uint32_t width, uint16_t index) {
+    uint32_t distance = (uint32_t) (index > layer->pirLed ? index - layer->pirLed : layer->pirLed - index) << 8;
+    if (front <= distance) {
+        return 0;
+    }
+    uint32_t x = front - distance;
+    if (x >= width) {
+        return SPATIAL_GAIN_ONE;
+    }
+    return (uint16_t) ((uint64_t) x * SPATIAL_GAIN_ONE / width);
+}
+
+/**
+ * 逐像素渲染
+ * 参数：channel - 三通道16位线性值（已按色温缩放）；floor - 基础亮度对应的三通道线性值（运动波不低于此值）
+ *       settled - 亮度与色温已稳定（且运动波已结束）时四舍五入并清零余量，否则时间抖动
+ *       pixels - 输出：count × 3 字节（R、G、B）；nowMs - 当前时间
+ * 返回值：所有像素所有通道的8位输出之和（用于能耗计量）
+ */
+uint32_t spatialRender(spatial_layer_t *layer, const uint16_t channel[3], const uint16_t floor[3], bool settled,
+                       uint8_t *pixels, uint32_t nowMs) {
+    if (layer->count == 0) {
+        return 0;
+    }
+    uint32_t front = 0;
+    uint32_t width = 0;
+    if (layer->waveActive) {
+        uint16_t farthest = layer->pirLed > layer->count - 1 - layer->pirLed ? layer->pirLed
+                                                                             : layer->count - 1 - layer->pirLed;
+        uint32_t widthLeds = farthest / SPATIAL_WAVE_WIDTH_DIV;
+        width = (widthLeds > SPATIAL_WAVE_WIDTH_LEDS ? widthLeds : SPATIAL_WAVE_WIDTH_LEDS) << 8;
+        uint32_t span = (farthest > 0 ? (uint32_t) farthest : 1U) << 8;    // 扫过的距离（1/256 颗灯珠）
+        uint32_t elapsed = nowMs - layer->waveStart;
+        if (elapsed > SPATIAL_WAVE_SWEEP_MS * 8) {
+            elapsed = SPATIAL_WAVE_SWEEP_MS * 8;    // 任务长时间未运行时避免溢出（此时波前早已扫过）
+        }
+        front = (uint32_t) ((uint64_t) elapsed * span / SPATIAL_WAVE_SWEEP_MS);
+        if (front >= ((uint32_t) farthest << 8) + width) {
+            layer->waveActive = false;      // 波前已扫过整条灯带
+        }
+    }
+
+    bool dither = !settled || layer->waveActive;     // 稳定后调用者将休眠，抖动无法继续
+    uint32_t sum = 0;
+    for (uint16_t i = 0; i < layer->count; i++) {
+        uint16_t mask = layer->waveActive ? waveMask(layer, front, width, i) : SPATIAL_GAIN_ONE;
+        for (uint8_t c = 0; c < 3; c++) {
+            uint16_t value = channel[c];
+            if (mask != SPATIAL_GAIN_ONE && value > floor[c]) {    // 波前未到：增亮部分按遮罩缩小
+                value = (uint16_t) (floor[c] + SPATIAL_SCALE(value - floor[c], mask));
+            }
+            value = SPATIAL_SCALE(value, layer->combined[i]);
+            uint8_t out;
+            if (dither) {
+                out = perceptualDither(value, &layer->residual[i][c]);
+            }
+            else {
+                out = perceptualQuantize(value);
+                layer->residual[i][c] = 0;
+            }
+            pixels[i * 3 + c] = out;
+            sum += out;
+        }
+    }
+    return sum;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file spatialEffects.h
+ * @brief 逐像素空间效果模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为逐像素空间效果模块头文件，包含如下内容：
+ * - 逐像素增益图（配光方向）、热点降额权重与运动波的参数宏定义
+ * - 空间效果层结构体
+ * - 增益设置、温度降额、运动波与逐像素渲染的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 增益与权重均为16位定点数（65535 = 1.0），像素流水线只有整数乘法与移位，灯珠数增加时没有额外浮点运算
+ * - 配光增益与热点降额在设置或温度变化时合并为一张增益表，每帧每像素每通道只乘一次
+ * - 运动波只作用于基础亮度之上的增亮部分：离PIR近的一侧先亮，波前扫过整条灯带后与普通运动增亮一致
+ * - 输出写入按 R、G、B 顺序排列的字节数组（与 FastLED 的 CRGB 内存布局相同），线序由输出驱动处理
+ * - 灯珠数量在运行时确定，各数组由调用者分配（大小见 spatialStorageSize()），本模块不分配内存
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_SPATIALEFFECTS_H
+#define LIGHTPROJECT_SPATIALEFFECTS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define SPATIAL_GAIN_ONE 65535          // 定点数 1.0
+
+/* 运动波参数 */
+#define SPATIAL_WAVE_SWEEP_MS 600       // 波前从PIR扫到最远灯珠的时间（毫秒），与灯珠数量无关，短于2秒的上升时间
+#define SPATIAL_WAVE_WIDTH_LEDS 4       // 波前过渡的最小宽度（灯珠数），波前内逐渐增亮，避免硬边
+#define SPATIAL_WAVE_WIDTH_DIV 4        // 长灯带的波前宽度为最远距离的 1/4
+
+/* 热点温度降额参数（温度取自AHT20） */
+#define SPATIAL_DERATE_START_C 50.0f    // 开始降额的温度（℃）
+#define SPATIAL_DERATE_END_C 70.0f      // 降额到最低系数的温度（℃）
+#define SPATIAL_DERATE_MIN 32768        // 最高温度下热点权重为1的灯珠的增益（0.5）
+
+/* 逐像素定点乘法：value × gain / 65536，gain 为 65535 时原样输出 */
+#define SPATIAL_SCALE(value, gain) ((uint16_t) (((uint32_t) (value) * ((uint32_t) (gain) + 1U)) >> 16))
+
+/* 空间效果层（只由灯控任务修改） */
+typedef struct {
+    uint16_t count;                         // 灯珠数量
+    uint16_t pirLed;                        // 离PIR最近的灯珠序号（运动波起点）
+    uint16_t *gain;                         // 配光增益（定向照明，例如路面一侧更亮）
+    uint16_t *hotspot;                      // 热点权重（散热差的灯珠为1，温度升高时优先降额）
+    uint16_t *combined;                     // 合并后的增益（配光 × 降额）
+    uint16_t (*residual)[3];                // 各像素各通道的时间抖动余量
+    uint16_t thermal;                       // 当前温度对应的降额系数（热点权重为1时的增益）
+    uint32_t waveStart;                     // 运动波开始时间（毫秒）
+    bool waveActive;                        // 运动波是否进行中
+} spatial_layer_t;
+
+size_t spatialStorageSize(uint16_t count);
+void spatialInit(spatial_layer_t *layer, uint16_t count, uint16_t pirLed, void *storage);
+void spatialSetGain(spatial_layer_t *layer, uint16_t index, uint16_t gain, uint16_t hotspot);
+void spatialUpdateGains(spatial_layer_t *layer);
+void spatialSetTemperature(spatial_layer_t *layer, float temperatureC);
+void spatialStartWave(spatial_layer_t *layer, uint32_t nowMs);
+uint32_t spatialRender(spatial_layer_t *layer, const uint16_t channel[3], const uint16_t floor[3], bool settled,
+                       uint8_t *pixels, uint32_t nowMs);
+
+#endif //LIGHTPROJECT_SPATIALEFFECTS_H
@@ -28,6 +28,12 @@
 #include "oled.h"
 #include "brightnessConfig.h"   // 添加亮度配置模块头文件
 #include "getPM2dot5.h"         // 添加PM2.5模块头文件
+#include "perceptualDimming.h"  // 添加感知亮度调光模块头文件
+#include "motionInput.h"        // 添加运动检测与按键输入模块头文件
+#include "powerBudget.h"        // 添加能耗计量与功率预算模块头文件
+#include "clockSync.h"          // 添加时钟同步模块头文件
+#include "i2cBus.h"             // 添加I2C总线管理模块头文件
+#include <Preferences.h>
 
 /* ==================== 任务创建函数（Core 0） ==================== */
 /*
@@ -35,6 +41,12 @@
  * Core 0 通常用于处理 WiFi、MQTT、HTTP 等网络协议栈
  */
 void taskCreateCore0() {
+    /* 创建灯控命令队列（MQTT回调会向其投递命令，必须先于MQTT任务创建） */
+    xLightCommandQueue = xQueueCreate(LIGHT_COMMAND_QUEUE_SIZE, sizeof(light_command_t));
+    if (xLightCommandQueue == nullptr) {
+        Serial.println("灯控命令队列创建失败");
+    }
+
     /* 创建 MQTT 数据上报任务 */
     BaseType_t resultMqttData = xTaskCreatePinnedToCore(
         mqttDataTask,           // 任务函数
@@ -56,6 +68,17 @@ void taskCreateCore0() {
         0                       // 核心编号：0表示Core 0
     );
 
+    /* 创建 DDP像素流接收任务 */
+    BaseType_t resultPixelStream = xTaskCreatePinnedToCore(
+        pixelStreamTask,        // 任务函数
+        "pixelStream_Task",     // 任务名称（字符串）
+        4096,                   // 栈大小（字节）
+        nullptr,                // 传递给任务的参数，如果不需要可以设为nullptr
+        2,                      // 任务优先级（1-25，数字越大优先级越高）
+        nullptr,                // 任务句柄，如果不需要可以设为nullptr
+        0                       // 核心编号：0表示Core 0
+    );
+
     /* 错误检查 */
     if (resultMqttData != pdPASS) {
         Serial.println("mqttDataTask 创建失败");
@@ -63,6 +86,9 @@ void taskCreateCore0() {
     if (resultMqttHeart != pdPASS) {
         Serial.println("mqttHeartbeatTask 创建失败");
     }
+    if (resultPixelStream != pdPASS) {
+        Serial.println("pixelStreamTask 创建失败");
+    }
 }
 
 /* ==================== 任务创建函数（Core 1） ==================== */
@@ -71,6 +97,16 @@ void taskCreateCore0() {
  * Core 1 用于处理实时性要求较高的本地控制与传感器读取
  */
 void taskCreateCore1() {
+    /* 创建I2C总线任务（必须先于所有访问I2C设备的任务创建，优先级与传感器任务相同，执行事务时大部分时间在等待驱动） */
+    BaseType_t resultI2CBus = xTaskCreatePinnedToCore(
+        i2cBusTask,             // 任务函数
+        "i2cBus_Task",          // 任务名称（字符串）
+        4096,                   // 栈大小（字节），传感器库在此任务中运行
+        nullptr,                // 传递给任务的参数，如果不需要可以设为nullptr
+        4,                      // 任务优先级（1-25，数字越大优先级越高）
+        &xI2cBusHandle,         // 任务句柄，提交事务时通知
+        1                       // 核心编号：1表示Core 1
+    );
     /* 创建传感器采集任务 */
     BaseType_t resultI2C = xTaskCreatePinnedToCore(
         getI2CTask,             // 任务函数
@@ -81,6 +117,16 @@ void taskCreateCore1() {
         nullptr,                // 任务句柄，如果不需要可以设为nullptr
         1                       // 核心编号：1表示Core 1
     );
+    /* 创建LED刷新任务（优先级高于灯控任务，收到新帧后立即启动发送，等待RMT完成期间让出CPU） */
+    BaseType_t resultLedShow = xTaskCreatePinnedToCore(
+        ledShowTask,            // 任务函数
+        "ledShow_Task",         // 任务名称（字符串）
+        2048,                   // 栈大小（字节）
+        nullptr,                // 传递给任务的参数，如果不需要可以设为nullptr
+        6,                      // 任务优先级（1-25，数字越大优先级越高）
+        &xLedShowHandle,        // 任务句柄，灯控任务提交新帧时通知
+        1                       // 核心编号：1表示Core 1
+    );
     /* 创建灯光控制任务 */
     BaseType_t resultLight = xTaskCreatePinnedToCore(
         lightSetTask,           // 任务函数
@@ -88,7 +134,7 @@ void taskCreateCore1() {
         4096,                   // 栈大小（字节）
         nullptr,                // 传递给任务的参数，如果不需要可以设为nullptr
         5,                      // 任务优先级（1-25，数字越大优先级越高）
-        nullptr,                // 任务句柄，如果不需要可以设为nullptr
+        &xLightSetHandle,       // 任务句柄，供中断与其他任务发送唤醒通知
         1                       // 核心编号：1表示Core 1
     );
     /* 创建串口打印任务用于调试，每秒输出传感器数据 */
@@ -102,6 +148,17 @@ void taskCreateCore1() {
         1                       // 核心编号：1表示Core 1
     );
 
+    /* 创建ADC采样任务（连续转换在后台进行，任务只在DMA交出一批结果时唤醒） */
+    BaseType_t resultAdc = xTaskCreatePinnedToCore(
+        adcSampleTask,          // 任务函数
+        "adcSample_Task",       // 任务名称（字符串）
+        4096,                   // 栈大小（字节），电量估计、收益统计与日结时的NVS写入在此任务中运行
+        nullptr,                // 传递给任务的参数，如果不需要可以设为nullptr
+        3,                      // 任务优先级（1-25，数字越大优先级越高）
+        nullptr,                // 任务句柄，如果不需要可以设为nullptr
+        1                       // 核心编号：1表示Core 1
+    );
+
     /* 创建PM2.5数据处理任务 */
     BaseType_t resultPM25 = xTaskCreatePinnedToCore(
         pm25DataTask,           // 任务函数
@@ -126,15 +183,24 @@ void taskCreateCore1() {
     );
 #endif
     /* 错误检查 */
+    if (resultI2CBus != pdPASS) {
+        Serial.println("i2cBusTask创建失败");
+    }
     if (resultI2C != pdPASS) {
         Serial.println("I2CTask创建失败");
     }
+    if (resultLedShow != pdPASS) {
+        Serial.println("ledShowTask创建失败");
+    }
     if (resultLight != pdPASS) {
         Serial.println("lightSetTask创建失败");
     }
     if (resultSP != pdPASS) {
         Serial.println("SerialPrintTask 创建失败");
     }
+    if (resultAdc != pdPASS) {
+        Serial.println("adcSampleTask 创建失败");
+    }
     if (resultPM25 != pdPASS) {
         Serial.println("PM25DataTask 创建失败");
     }
@@ -147,22 +213,268 @@ void taskCreateCore1() {
 
 /* ==================== 任务函数实现 ==================== */
 
+/*
+ * ———————— 电源预算 ————————
+ * 灯控任务每次输出时按各通道输出计量LED能耗；传感器任务每10秒按电池电量与太阳能预报计算亮度限额，
+ * 限额变化时通过命令队列交给灯控任务；累计能耗每小时保存一次到NVS
+ */
+power_meter_t ledPower;                 // LED能耗计量器（本次启动以来）
+power_budget_t powerBudget;             // 功率预算状态
+float solarForecast = POWER_FORECAST_DEFAULT;   // 太阳能预报系数
+static uint32_t solarForecastTime = 0;  // 预报设置时间（毫秒）
+static uint32_t solarForecastTtlMs = 0; // 预报有效期（毫秒），0 表示长期有效
+static uint32_t ledEnergyBaseMWh = 0;   // 本次启动前的累计能耗（mWh）
+static uint32_t energySaveTime = 0;     // 上次保存累计能耗的时间（毫秒）
+static uint32_t powerBudgetTime = 0;    // 上次更新功率预算的时间（毫秒）
+static float postedLimit = 1.0f;        // 最近一次交给灯控任务的限额
+
+/* 读取累计能耗并初始化计量器与预算 */
+void powerInit() {
+    Preferences prefs;
+    if (prefs.begin(POWER_PREFS_NAMESPACE, true)) {    // 首次启动时命名空间不存在，从0开始
+        ledEnergyBaseMWh = prefs.getUInt("led_mwh", 0);
+        prefs.end();
+    }
+    powerMeterInit(&ledPower, millis());
+    powerBudgetInit(&powerBudget);
+    energySaveTime = millis();
+}
+
+/* LED累计能耗（含历次启动） */
+uint32_t powerLedTotalMWh() {
+    return ledEnergyBaseMWh + powerMeterEnergyMWh(&ledPower, millis());
+}
+
+/* 设置太阳能预报系数（0~1），ttlMs 为有效期（0为长期有效），到期后恢复默认系数 */
+void powerSetSolarForecast(float factor, uint32_t ttlMs) {
+    solarForecast = constrain(factor, 0.0f, 1.0f);
+    solarForecastTime = millis();
+    solarForecastTtlMs = ttlMs;
+}
+
+/* 功率预算周期更新（在传感器任务中调用，电压由ADC采样任务在后台更新） */
+static void powerBudgetTick() {
+    uint32_t now = millis();
+    if (now - powerBudgetTime < POWER_BUDGET_UPDATE_MS) {
+        return;
+    }
+    powerBudgetTime = now;
+    if (solarForecastTtlMs != 0 && now - solarForecastTime >= solarForecastTtlMs) {    // 预报过期
+        solarForecast = POWER_FORECAST_DEFAULT;
+        solarForecastTtlMs = 0;
+    }
+    float soc = (battery_mV < POWER_BATTERY_PRESENT_MV) ? -1.0f : (float) battery_percentage;
+    float limit = powerBudgetUpdate(&powerBudget, soc, solarForecast);
+    if (limit != postedLimit) {         // 限额变化才通知灯控任务（队列满时下次重试）
+        light_command_t command = {};
+        command.type = LIGHT_CMD_POWER_LIMIT;
+        command.value = limit;
+        if (lightTaskPostCommand(&command)) {
+            postedLimit = limit;
+        }
+    }
+    if (now - energySaveTime >= POWER_ENERGY_SAVE_MS) {    // 定期保存累计能耗，控制NVS写入次数
+        energySaveTime = now;
+        Preferences prefs;
+        if (prefs.begin(POWER_PREFS_NAMESPACE, false)) {
+            prefs.putUInt("led_mwh", powerLedTotalMWh());
+            prefs.end();
+        }
+    }
+}
+
+/*
+ * ———————— 能见度补偿 ————————
+ * 传感器任务每10秒把湿度与PM2.5交给能见度补偿（滤波、确认、限速），增益变化时通过命令队列交给灯控任务
+ */
+visibility_boost_t visibility;          // 能见度补偿状态
+static uint32_t visibilityTime = 0;     // 上次更新能见度补偿的时间（毫秒）
+static float postedVisibilityGain = 1.0f;   // 最近一次交给灯控任务的增益
+static uint32_t visibilityPmSequence = 0;   // 最近一次计入的PM2.5样本序号
+
+/* 能见度补偿周期更新（在传感器任务中调用，读取温湿度之后） */
+static void visibilityTick() {
+    uint32_t now = millis();
+    if (now - visibilityTime < VISIBILITY_UPDATE_MS) {
+        return;
+    }
+    visibilityTime = now;
+    pm25_sample_t pm = pm25_get_sample();
+    float pm25 = -1.0f;                     // 没有新的PM2.5样本时只更新湿度
+    if (!pm.stale && pm.sequence != visibilityPmSequence) {
+        visibilityPmSequence = pm.sequence;
+        pm25 = pm.pm25;
+    }
+    float gain = visibilityBoostUpdate(&visibility, humidity.relative_humidity, pm25);
+    if (gain != postedVisibilityGain) {     // 增益变化才通知灯控任务（队列满时下次重试）
+        light_command_t command = {};
+        command.type = LIGHT_CMD_VISIBILITY;
+        command.value = gain;
+        if (lightTaskPostCommand(&command)) {
+            postedVisibilityGain = gain;
+        }
+    }
+}
+
+/*
+ * ———————— 时间表 ————————
+ * 配置整体保存在NVS；MQTT回调暂存新配置后投递 LIGHT_CMD_SCHEDULE，由灯控任务应用、保存并重新编译当天计划。
+ * 计划每天编译一次（跨过本地零点、配置或时间改变时），灯控任务每次唤醒只查表
+ */
+schedule_config_t scheduleConfig;       // 当前时间表配置
+schedule_plan_t schedulePlan = {};      // 当天计划（count 为0表示需要重新编译）
+uint16_t scheduleCap = SCHEDULE_LEVEL_NONE;     // 当前亮度上限
+static portMUX_TYPE scheduleMux = portMUX_INITIALIZER_UNLOCKED;
+static schedule_config_t stagedSchedule;        // 暂存的配置
+static bool scheduleStaged = false;             // 暂存区是否有新配置
+
+/* 从NVS读取时间表配置，版本不符或不存在时使用默认配置 */
+void scheduleInit() {
+    scheduleConfigDefault(&scheduleConfig);
+    Preferences prefs;
+    if (prefs.begin(SCHEDULE_PREFS_NAMESPACE, true)) {
+        schedule_config_t saved;
+        if (prefs.getBytes("config", &saved, sizeof(saved)) == sizeof(saved)
+            && saved.version == SCHEDULE_CONFIG_VERSION) {
+            scheduleConfig = saved;
+        }
+        prefs.end();
+    }
+}
+
+/* 暂存新配置（在MQTT回调中调用），灯控任务随后应用 */
+void scheduleStage(const schedule_config_t *config) {
+    portENTER_CRITICAL(&scheduleMux);
+    stagedSchedule = *config;
+    scheduleStaged = true;
+    portEXIT_CRITICAL(&scheduleMux);
+    light_command_t command = {};
+    command.type = LIGHT_CMD_SCHEDULE;
+    lightTaskPostCommand(&command);
+}
+
+/* 应用暂存的配置并保存（在灯控任务中调用），随后重新编译计划 */
+static void scheduleApply() {
+    if (scheduleStaged) {
+        portENTER_CRITICAL(&scheduleMux);
+        scheduleConfig = stagedSchedule;
+        scheduleStaged = false;
+        portEXIT_CRITICAL(&scheduleMux);
+        Preferences prefs;
+        if (prefs.begin(SCHEDULE_PREFS_NAMESPACE, false)) {
+            prefs.putBytes("config", &scheduleConfig, sizeof(scheduleConfig));
+            prefs.end();
+        }
+    }
+    schedulePlan.count = 0;
+}
+
+/*
+ * 按当天计划更新亮度上限、分时段统计的小时与色温曲线的时刻（在灯控任务中调用）
+ * 返回值：距下一次转换的时间（毫秒），时间未知时返回 BRIGHTNESS_IDLE
+ */
+static uint32_t scheduleUpdate() {
+    uint32_t epoch = clockNow();
+    if (epoch == 0) {                   // 未对时：不限制亮度，不使用分时段统计与时间曲线
+        scheduleCap = SCHEDULE_LEVEL_NONE;
+        brightnessSetScheduleCap(BRIGHTNESS_MAX);
+        brightnessSetHourOfDay(-1);
+        ledColor.minuteOfDay = -1;
+        return BRIGHTNESS_IDLE;
+    }
+    if (!schedulePlanCovers(&schedulePlan, epoch)) {
+        scheduleCompile(&scheduleConfig, epoch, &schedulePlan);
+        Serial.printf("时间表已编译: 星期%u，日出 %d，日落 %d，%u段\n", schedulePlan.weekday,
+                      schedulePlan.sunriseMin, schedulePlan.sunsetMin, schedulePlan.count);
+    }
+    uint32_t secondOfDay = epoch - schedulePlan.dayStart;
+    uint16_t minute = (uint16_t) (secondOfDay / 60);
+    uint16_t nextMinute;
+    scheduleCap = schedulePlanLevel(&schedulePlan, minute, &nextMinute);
+    brightnessSetScheduleCap(scheduleCap);
+    brightnessSetHourOfDay((int8_t) (minute / 60));
+    ledColor.minuteOfDay = (int16_t) minute;
+    return ((uint32_t) nextMinute * 60 - secondOfDay) * 1000UL;
+}
+
 /*
  * ———————— 传感器采集任务 ————————
- * 周期性读取 AHT20 温湿度传感器与 BH1750 光照传感器
+ * 周期性读取 AHT20 温湿度传感器与 BH1750 光照传感器（读取以事务形式交给I2C总线任务执行，失败时保留上一次的值）
  * 数据存入全局变量供其他任务使用
+ * 滤波后的光照变化显著时唤醒灯控任务，温度变化时更新热点降额，并周期更新功率预算
  */
 sensors_event_t humidity, temp; // 温湿度事件结构体（来自Adafruit_Sensor）
 Adafruit_AHTX0 aht;             // AHT20 温湿度传感器对象
 BH1750 lightMeter;              // BH1750 光照强度传感器对象
 float lux = 500.0;              // 环境光照强度（单位：lux），默认初始值
+float luxFiltered = 500.0;      // 滤波后的环境光照强度（单位：lux）
+
+/* 传感器事务（在I2C总线任务中执行） */
+static bool bh1750BeginJob(void *context) {
+    (void) context;
+    return lightMeter.begin();
+}
+
+static bool ahtBeginJob(void *context) {
+    (void) context;
+    return aht.begin();
+}
+
+static bool bh1750ReadJob(void *context) {
+    float level = lightMeter.readLightLevel();     // 读取失败时返回负值
+    *(float *) context = level;
+    return level >= 0.0f;
+}
+
+static bool ahtReadJob(void *context) {
+    sensors_event_t *events = (sensors_event_t *) context;     // [0] 湿度，[1] 温度
+    return aht.getEvent(&events[0], &events[1]);
+}
+
+/* 初始化I2C传感器（在 setup 中、i2cBusInit() 之后调用） */
+void i2cSensorsInit() {
+    if (!i2cBusRun(I2C_DEV_BH1750, I2C_PRIO_SENSOR, bh1750BeginJob, nullptr)) {
+        Serial.println("BH1750初始化失败");
+    }
+    if (!i2cBusRun(I2C_DEV_AHT20, I2C_PRIO_SENSOR, ahtBeginJob, nullptr)) {
+        Serial.println("AHT20初始化失败");
+    }
+}
 
 void getI2CTask(void *pvParameters) {
     (void) pvParameters;         // 不进行传参则固定使用此代码
+    lux_filter_t luxFilter;
+    luxFilterInit(&luxFilter, luxFiltered);
+    visibilityBoostInit(&visibility);
+    float postedTemperature = -1000.0f;     // 最近一次交给灯控任务的温度（热点降额）
     while (true) {
-        aht.getEvent(&humidity, &temp);     // 读取温湿度
-        lux = lightMeter.readLightLevel();  // 读取光照强度（lux）
-        getVoltage();                       // 读取电池与太阳能电压
+        sensors_event_t events[2];
+        if (i2cBusRun(I2C_DEV_AHT20, I2C_PRIO_SENSOR, ahtReadJob, events)) {    // 读取温湿度
+            humidity = events[0];
+            temp = events[1];
+        }
+        if (fabsf(temp.temperature - postedTemperature) >= LED_THERMAL_STEP_C) {   // 温度变化才更新热点降额
+            light_command_t command = {};
+            command.type = LIGHT_CMD_THERMAL;
+            command.value = temp.temperature;
+            if (lightTaskPostCommand(&command)) {
+                postedTemperature = temp.temperature;
+            }
+        }
+        float level;
+        if (i2cBusRun(I2C_DEV_BH1750, I2C_PRIO_SENSOR, bh1750ReadJob, &level)) {
+            lux = level;                    // 读取光照强度（lux）
+            bool changed = luxFilterUpdate(&luxFilter, lux);   // 一阶低通滤波，抑制噪声
+            luxFiltered = luxFilter.filtered;
+            if (changed) {                  // 变化显著才唤醒灯控任务
+                lightTaskNotify(LIGHT_EVENT_LUX);
+            }
+        }
+        powerBudgetTick();                  // 按电量与太阳能预报更新亮度限额
+        visibilityTick();                   // 按湿度与PM2.5更新能见度补偿
+        if (clockTick()) {                  // 时间刚校准或设置：唤醒灯控任务重新编译时间表
+            lightTaskNotify(LIGHT_EVENT_CONTROL);
+        }
         vTaskDelay(DELAY_100MS);            // 任务运行周期（100ms）
     }
 }
@@ -213,29 +525,135 @@ void mqttHeartbeatTask(void *pvParameters) {
     }
 }
 
+/*
+ * ———————— DDP像素流接收任务 ————————
+ * 接收PC发送的DDP像素流并直接写入LED像素缓冲区（调试验收与活动灯光）
+ * 没有数据时每 PIXEL_STREAM_POLL_MS 返回一次检查超时，超时后唤醒灯控任务恢复亮度引擎的输出
+ * 没有灯珠（布局为0或缓冲区分配失败，重启前不会改变）时任务直接退出：接收循环中唯一的阻塞调用是读取数据包，
+ * 不读取时会在核心0上空转，饿死空闲任务并触发任务看门狗
+ */
+void pixelStreamTask(void *pvParameters) {
+    (void) pvParameters;
+    if (ledCount == 0) {
+        Serial.println("没有灯珠，像素流接收任务退出");
+        vTaskDelete(nullptr);
+    }
+    while (!ledOutputStreamOpen()) {
+        Serial.println("像素流端口打开失败");
+        vTaskDelay(DELAY_10S);
+    }
+    while (true) {
+        if (ledOutputStreamPoll()) {
+            Serial.println("像素流超时，恢复自动亮度");
+            lightTaskNotify(LIGHT_EVENT_CONTROL);   // 重新提交亮度引擎的画面
+        }
+    }
+}
 
 /*
  * ———————— 灯光控制任务 ————————
  * 使用新的亮度控制模块，支持运动检测和平滑变化曲线
- * 每50ms刷新一次，保证灯光无闪烁并匹配变化曲线
+ * 亮度以16位感知亮度计算，输出阶段（ledOutput）按色温与逐像素空间效果渲染，变化过程中时间抖动为8位输出
+ * 事件驱动：阻塞等待任务通知（运动/按键中断、环境光显著变化、控制命令），
+ * 只有在亮度变化过程中才每50ms自行唤醒，有带有效期的亮度来源时在到期时刻唤醒一次，稳定后一直休眠
+ * 亮度来源（紧急/远程/时间表/运动/环境光）在亮度控制模块中按优先级仲裁，这里不再区分手动/自动模式
  */
-uint8_t ledCount = LED_COUNT;   // LED灯珠数量
-CRGB leds[LED_COUNT];           // FastLED 像素缓冲区
-bool isAuto = true;             // 是否启用自动亮度模式
-uint8_t brightnessAuto = 0, brightness = 0; // 各模式亮度值
+TaskHandle_t xLightSetHandle = nullptr;     // 灯控任务句柄
+QueueHandle_t xLightCommandQueue = nullptr; // 灯控命令队列
+
+/* 在任务中唤醒灯控任务，events 为 LIGHT_EVENT_xxx 的组合 */
+void lightTaskNotify(uint32_t events) {
+    if (xLightSetHandle != nullptr) {
+        xTaskNotify(xLightSetHandle, events, eSetBits);
+    }
+}
+
+/* 投递灯控命令，队列满时返回 false */
+bool lightTaskPostCommand(const light_command_t *command) {
+    if (xLightCommandQueue == nullptr || xQueueSend(xLightCommandQueue, command, 0) != pdPASS) {
+        return false;
+    }
+    lightTaskNotify(LIGHT_EVENT_CONTROL);
+    return true;
+}
+
+/* 在中断中唤醒灯控任务（中断在任务创建前就已挂载，需判断句柄） */
+IRAM_ATTR void lightTaskNotifyFromISR(uint32_t events) {
+    if (xLightSetHandle != nullptr) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        xTaskNotifyFromISR(xLightSetHandle, events, eSetBits, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
 
 void lightSetTask(void *pvParameters) {
     (void) pvParameters;
+    TickType_t waitTicks = 0;   // 首次立即刷新
+    uint8_t lastSource = BRIGHTNESS_SRC_COUNT;  // 上一帧胜出的亮度来源（用于检测运动增亮开始）
     while (true) {
-        if (isAuto == true) {   // 自动模式：使用新的亮度控制算法
-            brightnessAuto = calculatePerceivedBrightness(lux);
-            fill_solid(leds, ledCount, CRGB(brightnessAuto, brightnessAuto, brightnessAuto));   // 设置所有LED为同一灰度值（白光）
+        uint32_t events = 0;    // 本次唤醒的事件位（仅用于清除通知，处理逻辑与唤醒原因无关）
+        xTaskNotifyWait(0, UINT32_MAX, &events, waitTicks);    // 等待事件或定时唤醒
+        motionInputProcess();   // 处理中断记录的运动/按键事件（消抖、日志、状态更新）
+        light_command_t command;
+        while (xQueueReceive(xLightCommandQueue, &command, 0) == pdTRUE) {     // 执行其他任务投递的灯控命令
+            switch (command.type) {
+                case LIGHT_CMD_SET_SOURCE:
+                    brightnessSetSource(command.source, command.level, command.ttlMs);
+                    break;
+                case LIGHT_CMD_CLEAR_SOURCE:
+                    brightnessClearSource(command.source);
+                    break;
+                case LIGHT_CMD_DAYLIGHT:
+                    brightnessSetDaylight(command.enable, command.value);
+                    break;
+                case LIGHT_CMD_COMMISSION:
+                    brightnessStartCommissioning();
+                    break;
+                case LIGHT_CMD_POWER_LIMIT:
+                    brightnessSetPowerLimit(command.value);
+                    break;
+                case LIGHT_CMD_CCT:
+                    cctEngineSetFixed(&ledColor, (uint16_t) command.value);
+                    break;
+                case LIGHT_CMD_SPATIAL:
+                    ledOutputApplySpatial();
+                    break;
+                case LIGHT_CMD_THERMAL:
+                    ledOutputSetTemperature(command.value);
+                    break;
+                case LIGHT_CMD_SCHEDULE:
+                    scheduleApply();
+                    break;
+                case LIGHT_CMD_VISIBILITY:
+                    brightnessSetVisibilityGain(command.value);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        uint32_t scheduleDelay = scheduleUpdate();                      // 查表更新时间表亮度上限
+        uint16_t level = calculatePerceivedBrightness(luxFiltered);    // 仲裁并计算本帧16位感知亮度
+        uint32_t nextDelay = brightnessNextUpdateDelay();               // 距下一次必须刷新的时间（毫秒）
+        if (scheduleDelay != BRIGHTNESS_IDLE) {
+            scheduleDelay = scheduleDelay < SCHEDULE_MAX_SLEEP_MS ? scheduleDelay : SCHEDULE_MAX_SLEEP_MS;
+            nextDelay = scheduleDelay < nextDelay ? scheduleDelay : nextDelay;     // 到下一次转换时唤醒
+        }
+
+        if (brightnessSource == BRIGHTNESS_SRC_MOTION && lastSource != BRIGHTNESS_SRC_MOTION) {
+            ledOutputStartWave();                   // 运动增亮开始：从PIR一侧开始扫过灯带
         }
-        else {      // 手动模式：使用设定值
-            fill_solid(leds, ledCount, CRGB(brightness, brightness, brightness));
+        lastSource = brightnessSource;
+
+        /* 色温与逐像素空间效果，稳定后四舍五入输出，变化过程中时间抖动 */
+        uint32_t channelSum = ledOutputRender(level, baseBrightness, brightnessIsSettled(),
+                                              brightnessAmbientLux(luxFiltered));
+        powerMeterUpdate(&ledPower, powerLedPowerMw(channelSum, ledCount), millis());   // 按本帧输出计量能耗
+        if (!ledOutputIsSettled() && nextDelay > BRIGHTNESS_FRAME_MS) {
+            nextDelay = BRIGHTNESS_FRAME_MS;        // 色温过渡或运动波进行中，按帧周期刷新
         }
-        FastLED.show();         // 刷新LED
-        vTaskDelay(DELAY_50MS); // 任务运行周期改为50ms，匹配亮度变化曲线
+
+        waitTicks = (nextDelay == BRIGHTNESS_IDLE) ? portMAX_DELAY : pdMS_TO_TICKS(nextDelay);
     }
 }
 
@@ -249,14 +667,12 @@ void serialPrintTask(void *pvParameters) {
         Serial.print("Light: ");
         Serial.print(lux);
         Serial.print("lx ");
-        Serial.print(", brightnessAuto: ");
-        Serial.print(brightnessAuto);
         Serial.print(", brightness: ");
-        Serial.print(brightness);
-        Serial.print(", isMove: ");
-        Serial.print(isMove ? "YES" : "NO");
+        Serial.print(LEVEL_16_TO_8(currentBrightness));
+        Serial.print(", source: ");
+        Serial.print(arbiterSourceName(brightnessSource));
         Serial.print(", baseBrightness: ");
-        Serial.println(baseBrightness);
+        Serial.println(LEVEL_16_TO_8(baseBrightness));
         Serial.print("Temperature: ");
         Serial.print(temp.temperature);
         Serial.print(" ℃");
@@ -264,22 +680,27 @@ void serialPrintTask(void *pvParameters) {
         Serial.print(humidity.relative_humidity);
         Serial.print("% rH");
         Serial.print("， PM2.5: ");
-        Serial.print(pm25_concentration);
-        Serial.println(" µg/m³");
+        pm25_sample_t pm = pm25_get_sample();
+        if (pm.stale) {
+            Serial.println("--");           // 尚未收到有效帧或传感器已停止发送
+        }
+        else {
+            Serial.print(pm.pm25);
+            Serial.println(" µg/m³");
+        }
         vTaskDelay(DELAY_1S);   // 任务运行周期（1s）
     }
 }
 
 /*
  * ———————— PM2.5数据处理任务 ————————
- * 高频处理串口接收的PM2.5数据，每10ms检查一次
- * 确保不丢失任何数据包
+ * 阻塞在UART事件队列上，收到完整帧（或接收空闲超时）时才唤醒解析
+ * 数据由驱动的中断服务程序搬入环形缓冲区，任务唤醒延迟不会丢失数据
  */
 void pm25DataTask(void *pvParameters) {
     (void) pvParameters;
     while (true) {
-        pm25_update();  // 处理串口接收的数据
-        vTaskDelay(DELAY_100MS);  // 每10ms检查一次，确保不丢失数据
+        pm25_update(portMAX_DELAY);     // 等待并处理串口事件
     }
 }
 
@@ -306,7 +727,7 @@ void oledPrintTask(void *pvParameters) {
 
         sprintf(msg, "Lux:%.1f", lux);
         OLED_PrintString(2, 28, msg, &font12x12, OLED_COLOR_NORMAL);
-        sprintf(msg, "Light:%d", isAuto ? brightnessAuto : brightness);
+        sprintf(msg, "Light:%d", LEVEL_16_TO_8(currentBrightness));
         OLED_PrintString(70, 28, msg, &font12x12, OLED_COLOR_NORMAL);
 
         OLED_DrawImage(2,39,&temperatureImg,OLED_COLOR_NORMAL);
@@ -316,7 +737,13 @@ void oledPrintTask(void *pvParameters) {
         sprintf(msg, "%.1f", humidity.relative_humidity);
         OLED_PrintString(57, 40, msg, &font12x12, OLED_COLOR_NORMAL);
         OLED_DrawImage(85,39,&PM2dot5Img,OLED_COLOR_NORMAL);
-        sprintf(msg, "%d", pm25_concentration);
+        pm25_sample_t pm = pm25_get_sample();
+        if (pm.stale) {
+            sprintf(msg, "--");
+        }
+        else {
+            sprintf(msg, "%.0f", pm.pm25);
+        }
         OLED_PrintString(99, 40, msg, &font12x12, OLED_COLOR_NORMAL);
 
         OLED_DrawImage(3,51,&batteryImg,OLED_COLOR_NORMAL);
@@ -28,6 +28,10 @@
 #include <BH1750.h>
 #include <FastLED.h>
 #include "brightnessConfig.h"
+#include "powerBudget.h"
+#include "ledOutput.h"
+#include "scheduleEngine.h"
+#include "visibilityBoost.h"
 
 /* 任务执行周期 */
 #define DELAY_10S    pdMS_TO_TICKS(10000)
@@ -53,7 +57,9 @@ extern sensors_event_t humidity, temp;  // 温湿度事件结构体（来自Adaf
 extern Adafruit_AHTX0 aht;              // AHT20 温湿度传感器对象
 extern BH1750 lightMeter;               // BH1750 光照强度传感器对象
 extern float lux;                       // 环境光照强度（单位：lux），默认初始值
+extern float luxFiltered;               // 滤波后的环境光照强度（单位：lux），用于亮度控制（滤波参数见 brightnessConfig.h）
 
+void i2cSensorsInit();                   // 初始化BH1750与AHT20（经I2C总线管理模块）
 void getI2CTask(void* pvParameters);
 
 /* WiFi任务相关 */
@@ -66,22 +72,68 @@ void mqttDataTask(void* pvParameters);
 
 void mqttHeartbeatTask(void* pvParameters);
 
+/* 像素流任务相关 */
+void pixelStreamTask(void* pvParameters);
+
 /* 灯控任务相关 */
-#define JLC_LED_PIN 38          // 使用立创开发板时候的LED数据引脚
-#define LED_PIN 6               // LED数据引脚
-#define LED_COUNT 16            // LED灯珠数量
-extern uint8_t ledCount;        // LED灯珠数量
-#ifdef isJLC
-constexpr uint8_t ledPin = JLC_LED_PIN;   // 立创开发板使用的LED数据引脚
-#else
-constexpr uint8_t ledPin = LED_PIN;       // LED数据引脚
-#endif
-extern CRGB leds[LED_COUNT];    // FastLED 像素缓冲区
-extern uint8_t brightness;      // 手动模式亮度值
-extern uint8_t brightnessAuto;  // 自动模式亮度值
-extern bool isAuto;             // 是否启用自动亮度模式
+extern TaskHandle_t xLightSetHandle;    // 灯控任务句柄
+extern QueueHandle_t xLightCommandQueue;    // 灯控命令队列（远程设置、紧急照明等）
+/* 灯控任务唤醒事件（任务通知位），任务在没有事件且不在变化过程中时一直休眠 */
+#define LIGHT_EVENT_MOTION  (1UL << 0)  // 运动检测或按键
+#define LIGHT_EVENT_LUX     (1UL << 1)  // 环境光显著变化
+#define LIGHT_EVENT_CONTROL (1UL << 2)  // 远程控制命令
+void lightTaskNotify(uint32_t events);          // 在任务中唤醒灯控任务
+void lightTaskNotifyFromISR(uint32_t events);   // 在中断中唤醒灯控任务
+/* 灯控命令：由其他任务投递、灯控任务执行，保证仲裁器与闭环控制器只在一个任务中修改 */
+#define LIGHT_COMMAND_QUEUE_SIZE 8
+typedef enum {
+    LIGHT_CMD_SET_SOURCE = 0,   // 设置亮度来源（source/level/ttlMs）
+    LIGHT_CMD_CLEAR_SOURCE,     // 清除亮度来源（source）
+    LIGHT_CMD_DAYLIGHT,         // 切换闭环日光补偿（enable/value 为目标照度）
+    LIGHT_CMD_COMMISSION,       // 开始自身光照阶跃扫描
+    LIGHT_CMD_POWER_LIMIT,      // 设置功率预算限额（value 为线性输出比例）
+    LIGHT_CMD_CCT,              // 设置固定色温（value 为色温K，0 表示恢复自动曲线）
+    LIGHT_CMD_SPATIAL,          // 应用暂存的空间效果配置（见 ledOutputStageSpatial()）
+    LIGHT_CMD_THERMAL,          // 更新热点降额（value 为温度℃）
+    LIGHT_CMD_SCHEDULE,         // 应用暂存的时间表配置（见 scheduleStage()），时间改变时也用于重新编译计划
+    LIGHT_CMD_VISIBILITY        // 设置能见度补偿增益（value 为线性输出倍数）
+} light_command_type_t;
+typedef struct {
+    uint8_t type;               // 命令类型（light_command_type_t）
+    uint8_t source;             // 亮度来源（brightness_source_t）
+    bool enable;                // 开关类命令的参数
+    uint16_t level;             // 16位感知亮度
+    uint32_t ttlMs;             // 有效期（毫秒），0 表示长期有效
+    float value;                // 数值参数（目标照度等）
+} light_command_t;
+bool lightTaskPostCommand(const light_command_t *command);  // 投递灯控命令并唤醒灯控任务
 void lightSetTask(void* pvParameters);
 
+/* 电源预算相关（能耗由灯控任务计量，预算由传感器任务按电池电量周期计算） */
+#define POWER_BUDGET_UPDATE_MS 10000            // 功率预算更新周期（10秒）
+#define POWER_ENERGY_SAVE_MS 3600000UL          // 累计能耗保存到NVS的间隔（1小时）
+#define POWER_BATTERY_PRESENT_MV 2500           // 电池电压低于此值视为未接电池（外部供电，不限制亮度）
+#define POWER_FORECAST_TTL_DEFAULT_S 86400      // 太阳能预报默认有效期（24小时），过期后恢复默认系数
+#define POWER_PREFS_NAMESPACE "power"           // 累计能耗在NVS中的命名空间
+extern power_meter_t ledPower;          // LED能耗计量器（本次启动以来，只由灯控任务更新）
+extern power_budget_t powerBudget;      // 功率预算状态（只由传感器任务更新）
+extern float solarForecast;             // 太阳能预报系数（0 全阴 ~ 1 晴好）
+void powerInit();                       // 读取累计能耗并初始化计量器（在任务创建前调用）
+uint32_t powerLedTotalMWh();            // LED累计能耗（含历次启动，mWh）
+void powerSetSolarForecast(float factor, uint32_t ttlMs);   // 设置太阳能预报系数及有效期
+
+/* 能见度补偿相关（由传感器任务按湿度与PM2.5周期更新，增益变化时交给灯控任务） */
+extern visibility_boost_t visibility;   // 能见度补偿状态（只由传感器任务更新）
+
+/* 时间表相关（配置由MQTT暂存、灯控任务应用；当天计划由灯控任务编译与查表） */
+#define SCHEDULE_PREFS_NAMESPACE "schedule"     // 时间表配置在NVS中的命名空间
+#define SCHEDULE_MAX_SLEEP_MS 60000             // 时间有效时灯控任务最长休眠时间（色温时间曲线按分钟更新）
+extern schedule_config_t scheduleConfig;        // 当前时间表配置（只由灯控任务修改）
+extern schedule_plan_t schedulePlan;            // 当天计划（只由灯控任务修改，其他任务仅读取用于上报）
+extern uint16_t scheduleCap;                    // 当前亮度上限（16位感知亮度，SCHEDULE_LEVEL_NONE 表示不限制）
+void scheduleInit();                            // 从NVS读取时间表配置（在任务创建前调用）
+void scheduleStage(const schedule_config_t *config);    // 暂存新配置并通知灯控任务应用
+
 /* 串口打印任务相关 */
 void serialPrintTask(void* pvParameters);
 
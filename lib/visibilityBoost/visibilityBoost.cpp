@@ -0,0 +1,129 @@
+/**
+ * @file visibilityBoost.cpp
+ * @brief 能见度补偿模块实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 此文件实现由湿度与PM2.5推断能见度下降并给出亮度增益：
+ * - 严重程度：湿度与PM2.5分别在起始值到满额值之间线性映射到 0~1，取两者中较大的一个
+ * - 目标增益 = 1 + 严重程度 × (VISIBILITY_GAIN_MAX - 1)，与已确认档位相差超过3/4档并在同一方向上
+ *   持续 VISIBILITY_HOLD_UPDATES 次更新后，按最近的档位确认新目标
+ * - 实际增益每次更新最多变化 VISIBILITY_GAIN_MAX_STEP
+ *
+ * @note
+ * 注意事项：
+ * - 只有持续的高湿或高PM2.5才会引起补偿：短时的喷雾、车辆尾气经低通滤波与确认时间两级消除
+ * - 方向改变或回到当前档位附近时确认计数清零，在阈值附近抖动的输入不会让目标来回切换
+ */
+
+#include "visibilityBoost.h"
+#include <cmath>
+
+/**
+ * 将数值限制在 [low, high] 范围内
+ */
+static float clampFloat(float value, float low, float high) {
+    if (value < low) {
+        return low;
+    }
+    if (value > high) {
+        return high;
+    }
+    return value;
+}
+
+/**
+ * 输入值是否有效（负数或NaN表示没有数据）
+ */
+static bool hasData(float value) {
+    return std::isfinite(value) && value >= 0.0f;
+}
+
+/**
+ * 输入一次采样到一阶低通滤波器（首个有效采样直接作为初值）
+ * 参数：filtered - 滤波值，负数表示尚未初始化；missing - 连续没有数据的更新次数；sample - 采样值
+ * 说明：连续 VISIBILITY_STALE_UPDATES 次没有数据时丢弃滤波值，之后的首个有效采样重新作为初值
+ */
+static void filterSample(float *filtered, uint16_t *missing, float sample) {
+    if (!hasData(sample)) {
+        if (*missing < VISIBILITY_STALE_UPDATES) {
+            (*missing)++;
+        }
+        if (*missing >= VISIBILITY_STALE_UPDATES) {
+            *filtered = -1.0f;
+        }
+        return;
+    }
+    *missing = 0;
+    if (*filtered < 0.0f) {
+        *filtered = sample;
+    }
+    else {
+        *filtered += (sample - *filtered) * VISIBILITY_FILTER_ALPHA;
+    }
+}
+
+/**
+ * 计算能见度下降的严重程度
+ * 参数：rhPercent - 相对湿度（%）；pm25 - PM2.5浓度（μg/m³），负数或NaN表示没有数据
+ * 返回值：0（正常）~ 1（满额补偿）
+ */
+float visibilitySeverity(float rhPercent, float pm25) {
+    float rh = !hasData(rhPercent) ? 0.0f
+                                : clampFloat((rhPercent - VISIBILITY_RH_START) / (VISIBILITY_RH_FULL - VISIBILITY_RH_START),
+                                             0.0f, 1.0f);
+    float pm = !hasData(pm25) ? 0.0f
+                           : clampFloat((pm25 - VISIBILITY_PM_START) / (VISIBILITY_PM_FULL - VISIBILITY_PM_START),
+                                        0.0f, 1.0f);
+    return rh > pm ? rh : pm;
+}
+
+/**
+ * 初始化能见度补偿状态（增益为1，不补偿）
+ */
+void visibilityBoostInit(visibility_boost_t *boost) {
+    boost->rhFiltered = -1.0f;
+    boost->pmFiltered = -1.0f;
+    boost->rhMissing = 0;
+    boost->pmMissing = 0;
+    boost->target = 1.0f;
+    boost->gain = 1.0f;
+    boost->pendingDir = 0;
+    boost->pendingCount = 0;
+}
+
+/**
+ * 周期更新（每 VISIBILITY_UPDATE_MS 调用一次）
+ * 参数：rhPercent - 相对湿度（%）；pm25 - PM2.5浓度（μg/m³）；两者负数或NaN表示没有数据
+ * 返回值：当前亮度增益（线性输出倍数，1.0 ~ VISIBILITY_GAIN_MAX）
+ */
+float visibilityBoostUpdate(visibility_boost_t *boost, float rhPercent, float pm25) {
+    filterSample(&boost->rhFiltered, &boost->rhMissing, rhPercent);
+    filterSample(&boost->pmFiltered, &boost->pmMissing, pm25);
+    float desired = 1.0f + visibilitySeverity(boost->rhFiltered, boost->pmFiltered) * (VISIBILITY_GAIN_MAX - 1.0f);
+
+    int8_t direction = 0;       // 期望增益相对已确认档位的方向（含3/4档回差）
+    if (desired >= boost->target + VISIBILITY_GAIN_QUANTUM * 0.75f) {
+        direction = 1;
+    }
+    else if (desired <= boost->target - VISIBILITY_GAIN_QUANTUM * 0.75f) {
+        direction = -1;
+    }
+    if (direction == 0 || direction != boost->pendingDir) {
+        boost->pendingDir = direction;
+        boost->pendingCount = direction != 0 ? 1 : 0;
+    }
+    else if (++boost->pendingCount >= VISIBILITY_HOLD_UPDATES) {    // 持续偏离，确认新档位
+        float steps = (desired - 1.0f) / VISIBILITY_GAIN_QUANTUM + 0.5f;
+        boost->target = clampFloat(1.0f + (float) (int) steps * VISIBILITY_GAIN_QUANTUM, 1.0f, VISIBILITY_GAIN_MAX);
+        boost->pendingDir = 0;
+        boost->pendingCount = 0;
+    }
+
+    boost->gain = clampFloat(boost->target, boost->gain - VISIBILITY_GAIN_MAX_STEP,
+                             boost->gain + VISIBILITY_GAIN_MAX_STEP);
+    return boost->gain;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file visibilityBoost.h
+ * @brief 能见度补偿模块头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为能见度补偿模块头文件，包含如下内容：
+ * - 湿度与PM2.5的起始/满额阈值、滤波系数、确认时间与限速参数
+ * - 能见度补偿状态结构体
+ * - 严重程度计算与周期更新的函数声明
+ *
+ * @note
+ * 注意事项：
+ * - 持续高湿（雾、雨）或高PM2.5（霾）时输出大于1的亮度增益（线性输出倍数），乘到基础亮度上
+ * - 输入先经过慢速低通滤波，目标增益按 VISIBILITY_GAIN_QUANTUM 分档，偏离当前档位超过回差并持续
+ *   VISIBILITY_HOLD_UPDATES 次更新后才切换，实际增益再按 VISIBILITY_GAIN_MAX_STEP 限速逼近，传感器噪声不会引起闪烁
+ * - 按固定周期（VISIBILITY_UPDATE_MS）调用，滤波与限速都按更新次数计算
+ * - 负数或NaN输入表示没有数据；某一输入持续 VISIBILITY_STALE_UPDATES 次没有数据时按没有该传感器处理，
+ *   传感器失效时补偿不会停留在失效前的值
+ * - 本模块不依赖Arduino，可在主机上直接编译
+ */
+
+#ifndef LIGHTPROJECT_VISIBILITYBOOST_H
+#define LIGHTPROJECT_VISIBILITYBOOST_H
+
+#include <cstdint>
+
+#define VISIBILITY_UPDATE_MS 10000          // 更新周期（10秒）
+#define VISIBILITY_FILTER_ALPHA 0.02f       // 湿度与PM2.5一阶低通滤波系数（每次更新，时间常数约8分钟）
+#define VISIBILITY_RH_START 90.0f           // 相对湿度高于此值开始补偿（%）
+#define VISIBILITY_RH_FULL 98.0f            // 相对湿度达到此值时满额补偿（%，接近饱和即起雾或降雨）
+#define VISIBILITY_PM_START 75.0f           // PM2.5高于此值开始补偿（μg/m³，轻度污染）
+#define VISIBILITY_PM_FULL 250.0f           // PM2.5达到此值时满额补偿（μg/m³，严重污染）
+#define VISIBILITY_GAIN_MAX 1.5f            // 满额补偿时的亮度增益（线性输出倍数）
+#define VISIBILITY_GAIN_QUANTUM 0.05f       // 目标增益的分档（线性输出5%）
+#define VISIBILITY_HOLD_UPDATES 60          // 偏离当前档位需持续的更新次数（10分钟）
+#define VISIBILITY_GAIN_MAX_STEP 0.005f     // 每次更新增益最多变化0.5%（从1.0到1.5约17分钟）
+#define VISIBILITY_STALE_UPDATES 180        // 某一输入连续这么多次更新（30分钟）没有数据时丢弃其滤波值
+
+/* 能见度补偿状态 */
+typedef struct {
+    float rhFiltered;       // 滤波后的相对湿度（%），负数表示尚未收到数据
+    float pmFiltered;       // 滤波后的PM2.5（μg/m³），负数表示尚未收到数据
+    uint16_t rhMissing;     // 湿度连续没有数据的更新次数
+    uint16_t pmMissing;     // PM2.5连续没有数据的更新次数
+    float target;           // 已确认的目标增益（分档）
+    float gain;             // 当前增益（限速逼近目标）
+    int8_t pendingDir;      // 正在确认的方向（1 升高，-1 降低，0 无）
+    uint16_t pendingCount;  // 同一方向已持续的更新次数
+} visibility_boost_t;
+
+float visibilitySeverity(float rhPercent, float pm25);
+void visibilityBoostInit(visibility_boost_t *boost);
+float visibilityBoostUpdate(visibility_boost_t *boost, float rhPercent, float pm25);
+
+#endif //LIGHTPROJECT_VISIBILITYBOOST_H
@@ -0,0 +1,552 @@
+/**
+ * @file brightnessSim.cpp
+ * @brief 亮度控制模块主机仿真器
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 把 brightnessConfig 及其依赖（仲裁、感知调光、闭环控制器）直接编译到 Linux 主机上，
+ * 用虚拟时钟回放光照、运动与控制事件轨迹，输出亮度-时间轨迹与统计指标：
+ * - 事件驱动：按“轨迹事件 / 灯控任务唤醒 / 光照采样”三者中最早的时刻推进虚拟时钟，
+ *   灯控任务的唤醒规则与固件 lightSetTask 相同（事件唤醒 + brightnessNextUpdateDelay）
+ * - 光照采样按固件的100ms周期经 luxFilterUpdate 滤波，输入不变且滤波已收敛时跳过采样
+ * - --plant-gain 模拟传感器看到灯自身的光（实测照度 = 环境照度 + 增益 × 输出），用于闭环稳定性验证
+ * - --sweep 对可调参数做扫描，每个取值完整回放一次轨迹并输出一行指标
+ * - --learn-nights 先回放若干次让到达间隔模型学习（NVS中的学习结果跨次保留），再统计指标
+ * - 轨迹中有湿度/PM2.5事件时，按固件的10秒周期运行能见度补偿，增益变化时唤醒灯控任务
+ * - --jobs 把 --repeat / --sweep 分给多个进程（固件模块是全局状态，多进程互不干扰）；
+ *   单核吞吐量取决于灯控任务的帧数：变化过程中每50ms一帧，繁忙街道12小时约8万帧，
+ *   约400次/秒，稀疏夜晚约3000次/秒（轨迹只解析一次，时间几乎全部花在固件代码上）
+ *
+ * @note
+ * 编译与运行（PlatformIO）：
+ *   pio run -e native_sim
+ *   .pio/build/native_sim/program sim/traces/night.csv --out brightness.csv
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "brightnessConfig.h"
+#include "perceptualDimming.h"
+#include "visibilityBoost.h"
+#include "simTrace.h"
+#include "simMetrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#define SIM_NEVER UINT64_MAX            // 不再发生
+#define SIM_SENSOR_PERIOD_MS 100        // 光照采样周期（与 getI2CTask 一致）
+#define SIM_SENSOR_EPSILON 0.01f        // 滤波值与输入之差小于此值视为已收敛，停止采样
+
+/* 仿真配置 */
+typedef struct {
+    float plantGain;            // 灯满亮时传感器额外看到的照度（lux），0 表示传感器看不到灯
+    float selfGain;             // 预置的调试扫描结果（lux），<= 0 时与 plantGain 相同
+    float daylightTarget;       // > 0 时启用闭环日光补偿并设置目标照度
+    float ledWatts;             // 灯满亮功率（W）
+    float flickerWindowMs;      // 闪烁判定窗口（毫秒）
+    float startHour;            // 轨迹开始时刻（小时，用于分时段统计），负数表示时间未知
+    FILE *traceOut;             // 亮度轨迹输出（可为空）
+} sim_config_t;
+
+/* 能见度补偿统计（最后一次回放） */
+typedef struct {
+    float maxGain;              // 最大增益
+    uint32_t boostedMs;         // 增益大于1的累计时间（毫秒）
+    uint32_t steps;             // 增益变化次数（交给灯控任务的次数）
+} sim_visibility_t;
+
+static sim_visibility_t visibilityStats;
+
+/* NVS快照（数值与二进制块） */
+typedef struct {
+    std::map<std::string, double> values;
+    std::map<std::string, std::string> blobs;
+} sim_prefs_t;
+
+/* 可调参数表项 */
+typedef struct {
+    const char *name;
+    float *f32;
+    uint16_t *u16;
+    uint32_t *u32;
+    bool *flag;
+} sim_param_t;
+
+static sim_config_t config = {0.0f, 0.0f, 0.0f, SIM_LED_WATTS, (float) SIM_FLICKER_WINDOW_MS, 18.0f, nullptr};
+
+static const sim_param_t params[] = {
+    {"lux_high", &brightnessTuning.luxThresholdHigh, nullptr, nullptr, nullptr},
+    {"lux_mid", &brightnessTuning.luxThresholdMid, nullptr, nullptr, nullptr},
+    {"lux_low", &brightnessTuning.luxThresholdLow, nullptr, nullptr, nullptr},
+    {"level_high", nullptr, &brightnessTuning.levelHighLux, nullptr, nullptr},
+    {"level_mid", nullptr, &brightnessTuning.levelMidLux, nullptr, nullptr},
+    {"level_low", nullptr, &brightnessTuning.levelLowLux, nullptr, nullptr},
+    {"level_motion", nullptr, &brightnessTuning.levelMotion, nullptr, nullptr},
+    {"up_ms", nullptr, nullptr, &brightnessTuning.upTimeMs, nullptr},
+    {"down_ms", nullptr, nullptr, &brightnessTuning.downTimeMs, nullptr},
+    {"motion_timeout_ms", nullptr, nullptr, &brightnessTuning.motionTimeoutMs, nullptr},
+    {"hold_min_ms", nullptr, nullptr, &brightnessTuning.motionHoldMinMs, nullptr},
+    {"hold_max_ms", nullptr, nullptr, &brightnessTuning.motionHoldMaxMs, nullptr},
+    {"ramp_cost_ms", nullptr, nullptr, &brightnessTuning.motionRampCostMs, nullptr},
+    {"energy_cap", &brightnessTuning.motionEnergyCap, nullptr, nullptr, nullptr},
+    {"motion_adaptive", nullptr, nullptr, nullptr, &brightnessTuning.motionAdaptive},
+    {"plant_gain", &config.plantGain, nullptr, nullptr, nullptr},
+    {"self_gain", &config.selfGain, nullptr, nullptr, nullptr},
+    {"daylight_target", &config.daylightTarget, nullptr, nullptr, nullptr},
+    {"led_watts", &config.ledWatts, nullptr, nullptr, nullptr},
+    {"flicker_window_ms", &config.flickerWindowMs, nullptr, nullptr, nullptr},
+    {"start_hour", &config.startHour, nullptr, nullptr, nullptr},
+};
+
+/**
+ * 设置一个可调参数，未知参数返回 false
+ */
+static bool setParam(const char *name, double value) {
+    for (const sim_param_t &param : params) {
+        if (strcmp(param.name, name) == 0) {
+            if (param.f32 != nullptr) {
+                *param.f32 = (float) value;
+            }
+            else if (param.u16 != nullptr) {
+                *param.u16 = (uint16_t) value;
+            }
+            else if (param.flag != nullptr) {
+                *param.flag = value != 0.0;
+            }
+            else {
+                *param.u32 = (uint32_t) value;
+            }
+            return true;
+        }
+    }
+    fprintf(stderr, "未知参数 %s，可用参数：", name);
+    for (const sim_param_t &param : params) {
+        fprintf(stderr, " %s", param.name);
+    }
+    fputc('\n', stderr);
+    return false;
+}
+
+static uint64_t minTime(uint64_t a, uint64_t b) {
+    return a < b ? a : b;
+}
+
+/**
+ * 轨迹时间对应的小时（0~23），开始时刻未知时为 -1
+ */
+static int8_t hourAt(uint32_t timeMs) {
+    if (config.startHour < 0.0f) {
+        return -1;
+    }
+    return (int8_t) ((uint32_t) (config.startHour * 3600000.0f + (float) timeMs) / 3600000UL % 24);
+}
+
+/**
+ * 完整回放一次轨迹
+ * 参数：events - 轨迹；prefs - 运行前恢复的 NVS 快照；metrics - 输出统计
+ */
+static void runTrace(const std::vector<sim_event_t> &events, const sim_prefs_t &prefs, sim_metrics_t *metrics) {
+    uint32_t endMs = simTraceDuration(events);
+    float ambient = 0.0f;                       // 当前环境照度（不含灯自身光照）
+    for (const sim_event_t &event : events) {   // 以第一个光照事件作为初始照度，避免开机瞬间的虚假变化
+        if (event.type == SIM_EVENT_LUX) {
+            ambient = event.value;
+            break;
+        }
+    }
+
+    simClockMs = 0;
+    simPrefsStore() = prefs.values;
+    simPrefsBlobs() = prefs.blobs;
+    float selfGain = config.selfGain > 0.0f ? config.selfGain : config.plantGain;
+    if (selfGain > 0.0f) {
+        simPrefsStore()[std::string(DAYLIGHT_PREFS_NAMESPACE) + "/gain"] = selfGain;
+    }
+    brightnessInit();
+    brightnessSetVisibilityGain(1.0f);
+    if (config.daylightTarget > 0.0f) {
+        brightnessSetDaylight(true, config.daylightTarget);
+    }
+
+    lux_filter_t filter;
+    luxFilterInit(&filter, ambient);
+    simMetricsInit(metrics, config.ledWatts, (uint32_t) config.flickerWindowMs);
+
+    uint64_t nextWake = 0;                      // 灯控任务启动后立即刷新一次
+    uint64_t nextSensor = SIM_NEVER;
+    uint64_t nextVisibility = SIM_NEVER;        // 能见度补偿更新（收到第一个湿度事件后开始）
+    visibility_boost_t visibility;
+    visibilityBoostInit(&visibility);
+    float humidity = -1.0f, pm25 = -1.0f;
+    visibilityStats = {1.0f, 0, 0};
+    size_t index = 0;
+    uint16_t ditherResidual = 0;
+    uint8_t pwm = 0;
+
+    while (true) {
+        uint64_t nextEvent = index < events.size() ? events[index].timeMs : SIM_NEVER;
+        uint64_t now = minTime(minTime(minTime(nextEvent, nextWake), nextSensor), nextVisibility);
+        if (now == SIM_NEVER || now > endMs) {
+            break;
+        }
+        simClockMs = (uint32_t) now;
+
+        if (now == nextSensor) {                // 光照采样（灯自身光照按实际输出叠加）
+            float sample = ambient + config.plantGain * (float) pwm / 255.0f;
+            if (luxFilterUpdate(&filter, sample)) {
+                nextWake = now;
+            }
+            nextSensor = fabsf(sample - filter.filtered) > SIM_SENSOR_EPSILON ? now + SIM_SENSOR_PERIOD_MS : SIM_NEVER;
+        }
+        else if (now == nextVisibility) {       // 能见度补偿（与 getI2CTask 中的 visibilityTick 相同）
+            float lastGain = visibility.gain;
+            float gain = visibilityBoostUpdate(&visibility, humidity, pm25);
+            if (lastGain > 1.0f) {
+                visibilityStats.boostedMs += VISIBILITY_UPDATE_MS;
+            }
+            if (gain != lastGain) {
+                brightnessSetVisibilityGain(gain);
+                visibilityStats.steps++;
+                visibilityStats.maxGain = gain > visibilityStats.maxGain ? gain : visibilityStats.maxGain;
+                nextWake = now;
+            }
+            nextVisibility = now + VISIBILITY_UPDATE_MS;
+        }
+        else if (now == nextEvent) {            // 轨迹事件，等同于中断或远程命令唤醒灯控任务
+            const sim_event_t &event = events[index++];
+            brightnessSetHourOfDay(hourAt(simClockMs));
+            switch (event.type) {
+                case SIM_EVENT_LUX:
+                    ambient = event.value;
+                    if (nextSensor == SIM_NEVER) {
+                        nextSensor = (now / SIM_SENSOR_PERIOD_MS + 1) * SIM_SENSOR_PERIOD_MS;
+                    }
+                    break;
+                case SIM_EVENT_MOTION:
+                    simMetricsMotion(metrics, simClockMs, brightnessTuning.levelMotion);
+                    brightnessMotionDetected(simClockMs);
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_MOTION_CLEAR:
+                    brightnessMotionCleared();
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_SET_SOURCE:
+                    brightnessSetSource(event.source, event.level, event.ttlMs);
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_CLEAR_SOURCE:
+                    brightnessClearSource(event.source);
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_DAYLIGHT:
+                    brightnessSetDaylight(event.source != 0, event.value);
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_COMMISSION:
+                    brightnessStartCommissioning();
+                    nextWake = now;
+                    break;
+                case SIM_EVENT_WEATHER:
+                    humidity = event.value;
+                    if (event.source != 0) {
+                        pm25 = (float) event.level;
+                    }
+                    if (nextVisibility == SIM_NEVER) {
+                        nextVisibility = now + VISIBILITY_UPDATE_MS;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        else {                                  // 灯控任务一次刷新（与 lightSetTask 相同）
+            uint16_t level = calculatePerceivedBrightness(filter.filtered);
+            uint32_t nextDelay = brightnessNextUpdateDelay();
+            bool settled = brightnessIsSettled();
+            uint16_t linear = perceptualToLinear(level);
+            uint8_t lastPwm = pwm;
+            if (settled) {
+                pwm = perceptualQuantize(linear);
+                ditherResidual = 0;
+            }
+            else {
+                pwm = perceptualDither(linear, &ditherResidual);
+            }
+            simMetricsFrame(metrics, simClockMs, level, pwm, settled, brightnessTuning.levelMotion);
+            if (config.traceOut != nullptr) {
+                fprintf(config.traceOut, "%u,%.1f,%.1f,%u,%u,%s,%.3f\n", simClockMs, ambient, filter.filtered, level, pwm,
+                        arbiterSourceName(brightnessSource), brightnessVisibilityGain);
+            }
+            nextWake = (nextDelay == BRIGHTNESS_IDLE) ? SIM_NEVER : now + nextDelay;
+            if (config.plantGain > 0.0f && pwm != lastPwm && nextSensor == SIM_NEVER) {    // 灯光变化，传感器输入随之变化
+                nextSensor = (now / SIM_SENSOR_PERIOD_MS + 1) * SIM_SENSOR_PERIOD_MS;
+            }
+        }
+    }
+    simMetricsFinish(metrics, endMs);
+}
+
+/**
+ * 派生工作进程
+ * 功能说明：每个工作进程的标准输出重定向到一个管道，由调用者按顺序收集；工作进程结束时用 _exit 退出
+ * 参数：jobs - 工作进程数；readFds - 输出各工作进程管道的读端
+ * 返回值：工作进程中返回其编号（0 ~ jobs-1），父进程中返回 -1；派生失败时返回 -2
+ */
+static long forkWorkers(long jobs, std::vector<int> &readFds) {
+    fflush(stdout);
+    for (long worker = 0; worker < jobs; worker++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return -2;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            return -2;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            for (int fd : readFds) {
+                close(fd);
+            }
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[1]);
+            return worker;
+        }
+        close(fds[1]);
+        readFds.push_back(fds[0]);
+    }
+    return -1;
+}
+
+/**
+ * 读取所有工作进程的输出并等待其退出
+ * 参数：readFds - 管道读端；lines - 输出的各行（含换行符）
+ * 返回值：所有工作进程都正常退出时返回 true
+ */
+static bool collectWorkers(const std::vector<int> &readFds, std::vector<std::string> &lines) {
+    char line[512];
+    for (int fd : readFds) {                    // 顺序读取即可：其他进程写满管道后只是等待
+        FILE *in = fdopen(fd, "r");
+        while (fgets(line, sizeof(line), in) != nullptr) {
+            lines.emplace_back(line);
+        }
+        fclose(in);
+    }
+    bool ok = true;
+    int status = 0;
+    while (wait(&status) > 0) {
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok;
+}
+
+static void printUsage(const char *program) {
+    fprintf(stderr,
+            "用法: %s [选项] 轨迹文件(.csv|.bin)\n"
+            "  --out FILE              输出亮度轨迹 CSV（time_ms,lux,lux_filtered,level,pwm,source,visibility_gain）\n"
+            "  --repeat N              重复回放 N 次（吞吐量测试）\n"
+            "  --jobs N                用 N 个进程并行执行 --repeat / --sweep（默认1）\n"
+            "  --set NAME=VALUE        设置参数\n"
+            "  --sweep NAME=A:B:STEP   参数扫描，每个取值输出一行指标\n"
+            "  --plant-gain LUX        传感器看到的灯自身光照（满亮时，lux）\n"
+            "  --self-gain LUX         预置调试扫描得到的自身光照增益（默认与 plant-gain 相同）\n"
+            "  --daylight LUX          启用闭环日光补偿并设置目标照度\n"
+            "  --learn-nights N        先回放 N 次学习到达间隔（保留NVS），再统计指标\n"
+            "  --to-binary FILE        把轨迹转换为二进制格式后退出\n"
+            "  --echo                  把固件串口输出转发到 stderr\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    const char *tracePath = nullptr;
+    const char *outPath = nullptr;
+    const char *binaryPath = nullptr;
+    const char *sweep = nullptr;
+    long repeat = 1;
+    long learnNights = 0;
+    long jobs = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        }
+        else if (strcmp(arg, "--repeat") == 0 && hasValue) {
+            repeat = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(arg, "--jobs") == 0 && hasValue) {
+            jobs = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(arg, "--set") == 0 && hasValue) {
+            char *assignment = argv[++i];
+            char *equals = strchr(assignment, '=');
+            if (equals == nullptr) {
+                printUsage(argv[0]);
+                return 2;
+            }
+            *equals = '\0';
+            if (!setParam(assignment, strtod(equals + 1, nullptr))) {
+                return 2;
+            }
+        }
+        else if (strcmp(arg, "--learn-nights") == 0 && hasValue) {
+            learnNights = strtol(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(arg, "--sweep") == 0 && hasValue) {
+            sweep = argv[++i];
+        }
+        else if (strcmp(arg, "--plant-gain") == 0 && hasValue) {
+            config.plantGain = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(arg, "--self-gain") == 0 && hasValue) {
+            config.selfGain = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(arg, "--daylight") == 0 && hasValue) {
+            config.daylightTarget = strtof(argv[++i], nullptr);
+        }
+        else if (strcmp(arg, "--to-binary") == 0 && hasValue) {
+            binaryPath = argv[++i];
+        }
+        else if (strcmp(arg, "--echo") == 0) {
+            Serial.echo = true;
+        }
+        else if (arg[0] != '-' && tracePath == nullptr) {
+            tracePath = arg;
+        }
+        else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (tracePath == nullptr || repeat < 1 || jobs < 1) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    std::vector<sim_event_t> events;
+    if (!simTraceLoad(tracePath, events)) {
+        return 1;
+    }
+    if (binaryPath != nullptr) {
+        return simTraceSaveBinary(binaryPath, events) ? 0 : 1;
+    }
+
+    sim_prefs_t prefs = {simPrefsStore(), simPrefsBlobs()};    // 每次运行前恢复的 NVS 快照
+    sim_metrics_t metrics;
+    for (long i = 0; i < learnNights; i++) {   // 学习阶段：每次回放后保留NVS中的学习结果
+        runTrace(events, prefs, &metrics);
+        prefs.values = simPrefsStore();
+        prefs.blobs = simPrefsBlobs();
+    }
+
+    if (sweep != nullptr) {                     // 参数扫描：NAME=A:B:STEP
+        char name[64] = {};
+        double start = 0.0, stop = 0.0, step = 0.0;
+        if (sscanf(sweep, "%63[^=]=%lf:%lf:%lf", name, &start, &stop, &step) != 4 || step <= 0.0) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        std::vector<double> values;
+        for (double value = start; value <= stop + step * 1e-6; value += step) {
+            values.push_back(value);
+        }
+        printf("%s,", name);
+        simMetricsPrintRowHeader(stdout);
+        if (jobs == 1) {
+            for (double value : values) {
+                if (!setParam(name, value)) {
+                    return 2;
+                }
+                runTrace(events, prefs, &metrics);
+                printf("%g,", value);
+                simMetricsPrintRow(&metrics, stdout);
+            }
+            return 0;
+        }
+
+        /* 并行扫描：工作进程 w 负责第 w、w+jobs、... 个取值，每行前加取值序号，由父进程排序后输出 */
+        std::vector<int> readFds;
+        long worker = forkWorkers(std::min(jobs, (long) values.size()), readFds);
+        if (worker >= 0) {
+            for (size_t i = worker; i < values.size(); i += jobs) {
+                if (!setParam(name, values[i])) {
+                    _exit(2);
+                }
+                runTrace(events, prefs, &metrics);
+                printf("%zu %g,", i, values[i]);
+                simMetricsPrintRow(&metrics, stdout);
+            }
+            fflush(stdout);
+            _exit(0);
+        }
+        std::vector<std::string> lines;
+        bool ok = worker == -1 && collectWorkers(readFds, lines);
+        std::sort(lines.begin(), lines.end(), [](const std::string &a, const std::string &b) {
+            return strtoul(a.c_str(), nullptr, 10) < strtoul(b.c_str(), nullptr, 10);
+        });
+        for (const std::string &line : lines) {
+            fputs(line.c_str() + line.find(' ') + 1, stdout);
+        }
+        return ok && lines.size() == values.size() ? 0 : 1;
+    }
+
+    if (outPath != nullptr) {
+        config.traceOut = fopen(outPath, "w");
+        if (config.traceOut == nullptr) {
+            fprintf(stderr, "无法写入 %s\n", outPath);
+            return 1;
+        }
+        fprintf(config.traceOut, "time_ms,lux,lux_filtered,level,pwm,source,visibility_gain\n");
+    }
+
+    /* 多进程重复回放：父进程回放自己的份额（含亮度轨迹与统计输出），工作进程回放其余份额 */
+    jobs = std::min(jobs, repeat);
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<int> readFds;
+    long worker = jobs > 1 ? forkWorkers(jobs - 1, readFds) : -1;
+    if (worker < -1) {
+        fprintf(stderr, "无法创建工作进程\n");
+        return 1;
+    }
+    long share = repeat / jobs + (worker + 1 < repeat % jobs ? 1 : 0);
+    if (worker >= 0) {
+        config.traceOut = nullptr;              // 亮度轨迹只由父进程记录
+    }
+    for (long i = 0; i < share; i++) {
+        runTrace(events, prefs, &metrics);
+        if (config.traceOut != nullptr) {       // 亮度轨迹只记录第一次回放
+            fclose(config.traceOut);
+            config.traceOut = nullptr;
+        }
+    }
+    if (worker >= 0) {
+        _exit(0);
+    }
+    std::vector<std::string> lines;
+    if (!collectWorkers(readFds, lines)) {
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("trace:           %s (%zu events, %.2f h)\n", tracePath, events.size(),
+           simTraceDuration(events) / 3600000.0);
+    simMetricsPrint(&metrics, stdout);
+    if (visibilityStats.steps > 0) {
+        printf("visibility:      max gain %.2f, boosted %.2f h, %u steps\n", visibilityStats.maxGain,
+               visibilityStats.boostedMs / 3600000.0, visibilityStats.steps);
+    }
+    printf("throughput:      %ld runs in %.3f s (%.0f runs/s, %ld jobs)\n", repeat, seconds,
+           seconds > 0.0 ? repeat / seconds : 0.0, jobs);
+    return 0;
+}
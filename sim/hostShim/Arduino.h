@@ -0,0 +1,67 @@
+/**
+ * @file Arduino.h
+ * @brief 主机仿真用 Arduino 接口替身
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件只提供被仿真模块实际用到的 Arduino 接口：
+ * - millis() 返回仿真器维护的虚拟时钟，仿真器直接推进时间，不做任何等待
+ * - Serial 默认丢弃输出（仿真速度优先），需要查看固件日志时打开 echo 转发到 stderr
+ *
+ * @note
+ * 注意事项：
+ * - 仅在 native_sim 环境中通过 -I sim/hostShim 生效，固件编译使用真正的 Arduino.h
+ * - 被仿真模块用到新的 Arduino 接口时在这里补充
+ */
+
+#ifndef LIGHTPROJECT_SIM_ARDUINO_H
+#define LIGHTPROJECT_SIM_ARDUINO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <cmath>
+
+extern uint32_t simClockMs;     // 虚拟时钟（毫秒），由仿真器推进
+
+inline uint32_t millis() {
+    return simClockMs;
+}
+
+/* 串口替身 */
+class HostSerial {
+public:
+    bool echo = false;          // true 时把输出转发到 stderr
+
+    int printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+        if (!echo) {
+            return 0;
+        }
+        va_list args;
+        va_start(args, format);
+        int written = vfprintf(stderr, format, args);
+        va_end(args);
+        return written;
+    }
+
+    void print(const char *text) {
+        if (echo) {
+            fputs(text, stderr);
+        }
+    }
+
+    void println(const char *text) {
+        if (echo) {
+            fputs(text, stderr);
+            fputc('\n', stderr);
+        }
+    }
+};
+
+extern HostSerial Serial;
+
+#endif //LIGHTPROJECT_SIM_ARDUINO_H
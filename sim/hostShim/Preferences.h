@@ -0,0 +1,82 @@
+/**
+ * @file Preferences.h
+ * @brief 主机仿真用 NVS（Preferences）替身
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 键值保存在进程内存中（按“命名空间/键”索引），仿真器可在运行前预置参数（如调试得到的自身光照增益），
+ * 每次仿真运行前恢复快照，保证重复运行的结果一致
+ *
+ * @note
+ * 只实现被仿真模块用到的类型（bool、float、二进制块），需要时再补充
+ */
+
+#ifndef LIGHTPROJECT_SIM_PREFERENCES_H
+#define LIGHTPROJECT_SIM_PREFERENCES_H
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <string>
+
+std::map<std::string, double> &simPrefsStore();     // 数值键值（命名空间/键 -> 数值）
+std::map<std::string, std::string> &simPrefsBlobs(); // 二进制块（命名空间/键 -> 字节）
+
+class Preferences {
+public:
+    bool begin(const char *name, bool readOnly = false) {
+        space = name;
+        (void) readOnly;
+        return true;
+    }
+
+    void end() {
+    }
+
+    size_t putBool(const char *key, bool value) {
+        simPrefsStore()[space + "/" + key] = value ? 1.0 : 0.0;
+        return 1;
+    }
+
+    size_t putFloat(const char *key, float value) {
+        simPrefsStore()[space + "/" + key] = value;
+        return sizeof(float);
+    }
+
+    size_t putBytes(const char *key, const void *value, size_t length) {
+        simPrefsBlobs()[space + "/" + key].assign((const char *) value, length);
+        return length;
+    }
+
+    size_t getBytesLength(const char *key) {
+        auto it = simPrefsBlobs().find(space + "/" + key);
+        return it == simPrefsBlobs().end() ? 0 : it->second.size();
+    }
+
+    size_t getBytes(const char *key, void *buffer, size_t length) {
+        auto it = simPrefsBlobs().find(space + "/" + key);
+        if (it == simPrefsBlobs().end() || it->second.size() > length) {
+            return 0;
+        }
+        memcpy(buffer, it->second.data(), it->second.size());
+        return it->second.size();
+    }
+
+    bool getBool(const char *key, bool defaultValue = false) {
+        auto it = simPrefsStore().find(space + "/" + key);
+        return it == simPrefsStore().end() ? defaultValue : it->second != 0.0;
+    }
+
+    float getFloat(const char *key, float defaultValue = 0.0f) {
+        auto it = simPrefsStore().find(space + "/" + key);
+        return it == simPrefsStore().end() ? defaultValue : (float) it->second;
+    }
+
+private:
+    std::string space;
+};
+
+#endif //LIGHTPROJECT_SIM_PREFERENCES_H
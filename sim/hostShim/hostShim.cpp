@@ -0,0 +1,24 @@
+/**
+ * @file hostShim.cpp
+ * @brief 主机仿真用 Arduino 接口替身的全局对象
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ */
+
+#include "Arduino.h"
+#include "Preferences.h"
+
+uint32_t simClockMs = 0;        // 虚拟时钟（毫秒）
+HostSerial Serial;              // 串口替身
+
+std::map<std::string, double> &simPrefsStore() {
+    static std::map<std::string, double> store;
+    return store;
+}
+
+std::map<std::string, std::string> &simPrefsBlobs() {
+    static std::map<std::string, std::string> blobs;
+    return blobs;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file simMetrics.cpp
+ * @brief 主机仿真统计指标实现
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ */
+
+#include "simMetrics.h"
+#include <cstring>
+
+/**
+ * 初始化统计（灯从关闭状态开始）
+ */
+void simMetricsInit(sim_metrics_t *metrics, float ledWatts, uint32_t flickerWindowMs) {
+    memset(metrics, 0, sizeof(*metrics));
+    metrics->ledWatts = ledWatts;
+    metrics->flickerWindowMs = flickerWindowMs;
+}
+
+/**
+ * 记录一次运动事件，开始计算满亮时间（已经满亮或已有等待中的事件时不重复计时）
+ */
+void simMetricsMotion(sim_metrics_t *metrics, uint32_t timeMs, uint16_t fullLevel) {
+    if (!metrics->fullPending && metrics->lastLevel < fullLevel) {
+        metrics->fullPending = true;
+        metrics->fullStart = timeMs;
+    }
+}
+
+/**
+ * 累计能耗到指定时间（上一帧输出保持到该时间）
+ */
+static void accumulateEnergy(sim_metrics_t *metrics, uint32_t timeMs) {
+    double hours = (double) (timeMs - metrics->lastTime) / 3600000.0;
+    metrics->energyWh += (double) metrics->lastPwm / 255.0 * metrics->ledWatts * hours;
+    metrics->lastTime = timeMs;
+}
+
+/**
+ * 记录一帧输出
+ * 参数：level - 感知亮度（抖动前）；pwm - 实际8位输出；settled - 本帧后亮度是否稳定；fullLevel - 运动增亮亮度
+ */
+void simMetricsFrame(sim_metrics_t *metrics, uint32_t timeMs, uint16_t level, uint8_t pwm, bool settled,
+                     uint16_t fullLevel) {
+    accumulateEnergy(metrics, timeMs);
+    metrics->frames++;
+
+    /* 方向反转与闪烁：相对上一个极值反向超过 SIM_FLICKER_MIN_DELTA 才算反转（滞回，忽略闭环的微小调节） */
+    int8_t direction = 0;
+    if (level > metrics->extreme + SIM_FLICKER_MIN_DELTA) {
+        direction = 1;
+    }
+    else if (level + SIM_FLICKER_MIN_DELTA < metrics->extreme) {
+        direction = -1;
+    }
+    if (direction != 0 && direction != metrics->direction) {
+        if (metrics->direction != 0) {
+            metrics->reversals++;
+            if (metrics->hasReversal && !metrics->heldSinceReversal &&
+                timeMs - metrics->lastReversal < metrics->flickerWindowMs) {
+                metrics->flickers++;    // 两次反转之间没有稳定停留，属于来回调节
+            }
+            metrics->hasReversal = true;
+            metrics->heldSinceReversal = false;
+            metrics->lastReversal = timeMs;
+        }
+        metrics->direction = direction;
+        metrics->extreme = level;
+    }
+    else if (metrics->direction > 0 ? level > metrics->extreme : level < metrics->extreme) {
+        metrics->extreme = level;       // 同方向的新极值
+    }
+
+    if (settled) {
+        metrics->heldSinceReversal = true;
+    }
+
+    /* 满亮时间 */
+    if (metrics->fullPending) {
+        if (level >= fullLevel) {
+            uint32_t elapsed = timeMs - metrics->fullStart;
+            metrics->fullCount++;
+            metrics->fullTotalMs += elapsed;
+            if (elapsed > metrics->fullMaxMs) {
+                metrics->fullMaxMs = elapsed;
+            }
+            metrics->fullPending = false;
+        }
+        else if (settled) {
+            metrics->fullMissed++;
+            metrics->fullPending = false;
+        }
+    }
+
+    /* 变化过程与过冲 */
+    if (!settled && !metrics->inTransition) {
+        metrics->inTransition = true;
+        metrics->transStart = metrics->lastLevel;
+        metrics->transMin = level < metrics->lastLevel ? level : metrics->lastLevel;
+        metrics->transMax = level > metrics->lastLevel ? level : metrics->lastLevel;
+    }
+    if (metrics->inTransition) {
+        if (level < metrics->transMin) {
+            metrics->transMin = level;
+        }
+        if (level > metrics->transMax) {
+            metrics->transMax = level;
+        }
+        if (settled) {
+            uint16_t overshoot = level >= metrics->transStart ? metrics->transMax - level : level - metrics->transMin;
+            if (overshoot > metrics->maxOvershoot) {
+                metrics->maxOvershoot = overshoot;
+            }
+            metrics->transitions++;
+            metrics->inTransition = false;
+        }
+    }
+
+    metrics->lastLevel = level;
+    metrics->lastPwm = pwm;
+}
+
+/**
+ * 结束统计，累计最后一帧到仿真结束的能耗
+ */
+void simMetricsFinish(sim_metrics_t *metrics, uint32_t endMs) {
+    if (endMs > metrics->lastTime) {
+        accumulateEnergy(metrics, endMs);
+    }
+}
+
+/**
+ * 输出完整统计结果
+ */
+void simMetricsPrint(const sim_metrics_t *metrics, FILE *out) {
+    fprintf(out, "frames:          %u\n", metrics->frames);
+    fprintf(out, "energy:          %.3f Wh\n", metrics->energyWh);
+    fprintf(out, "time_to_full:    mean %.0f ms, max %u ms (%u reached, %u missed)\n",
+            metrics->fullCount ? (double) metrics->fullTotalMs / metrics->fullCount : 0.0,
+            metrics->fullMaxMs, metrics->fullCount, metrics->fullMissed);
+    fprintf(out, "flicker:         %u (%u reversals, window %u ms)\n",
+            metrics->flickers, metrics->reversals, metrics->flickerWindowMs);
+    fprintf(out, "overshoot:       %u (%.2f%% of full scale) over %u transitions\n",
+            metrics->maxOvershoot, metrics->maxOvershoot * 100.0 / 65535.0, metrics->transitions);
+}
+
+/**
+ * 参数扫描表头（与 simMetricsPrintRow 对应）
+ */
+void simMetricsPrintRowHeader(FILE *out) {
+    fprintf(out, "energy_wh,ttf_mean_ms,ttf_max_ms,ttf_missed,flicker,reversals,overshoot,transitions,frames\n");
+}
+
+/**
+ * 参数扫描的一行结果（CSV）
+ */
+void simMetricsPrintRow(const sim_metrics_t *metrics, FILE *out) {
+    fprintf(out, "%.4f,%.0f,%u,%u,%u,%u,%u,%u,%u\n", metrics->energyWh,
+            metrics->fullCount ? (double) metrics->fullTotalMs / metrics->fullCount : 0.0,
+            metrics->fullMaxMs, metrics->fullMissed, metrics->flickers, metrics->reversals,
+            metrics->maxOvershoot, metrics->transitions, metrics->frames);
+}
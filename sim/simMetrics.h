@@ -0,0 +1,73 @@
+/**
+ * @file simMetrics.h
+ * @brief 主机仿真统计指标头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为仿真统计指标头文件，按灯控任务输出的每一帧累计以下指标：
+ * - 满亮时间（time-to-full）：运动事件到亮度达到运动增亮亮度的时间
+ * - 闪烁次数：感知亮度变化方向反转，距上次反转不足 flickerWindowMs 且期间没有稳定停留（振荡、来回调节）
+ * - 能耗：按8位输出占空比与灯满亮功率积分（Wh）
+ * - 过冲：一次变化过程中亮度越过最终值的最大幅度（感知亮度单位）
+ *
+ * @note
+ * 指标只依赖帧序列，与被仿真模块的实现无关
+ */
+
+#ifndef LIGHTPROJECT_SIMMETRICS_H
+#define LIGHTPROJECT_SIMMETRICS_H
+
+#include <cstdint>
+#include <cstdio>
+
+#define SIM_FLICKER_WINDOW_MS 10000     // 默认闪烁判定窗口（10秒内再次反转视为闪烁）
+#define SIM_FLICKER_MIN_DELTA 655       // 方向反转的最小幅度（感知亮度单位，约 L* 1%）
+#define SIM_LED_WATTS 4.8f              // 默认灯满亮功率（16颗WS2812，每颗 5V × 60mA）
+
+typedef struct {
+    /* 参数 */
+    float ledWatts;             // 灯满亮功率（W）
+    uint32_t flickerWindowMs;   // 闪烁判定窗口（毫秒）
+
+    /* 逐帧状态 */
+    uint32_t lastTime;          // 上一帧时间
+    uint16_t lastLevel;         // 上一帧感知亮度
+    uint8_t lastPwm;            // 上一帧8位输出
+    int8_t direction;           // 最近一次变化方向（1 上升，-1 下降，0 未知）
+    uint16_t extreme;           // 当前方向上的极值（上升时为最高，下降时为最低）
+    bool hasReversal;           // 是否出现过方向反转
+    uint32_t lastReversal;      // 上次方向反转时间
+    bool heldSinceReversal;     // 上次反转后亮度是否稳定停留过
+    bool fullPending;           // 是否有等待满亮的运动事件
+    uint32_t fullStart;         // 等待满亮的运动事件时间
+    bool inTransition;          // 是否处于变化过程中
+    uint16_t transStart;        // 变化开始时的亮度
+    uint16_t transMin;          // 变化过程中的最低亮度
+    uint16_t transMax;          // 变化过程中的最高亮度
+
+    /* 结果 */
+    uint32_t frames;            // 输出帧数（灯控任务唤醒次数）
+    double energyWh;            // 能耗（Wh）
+    uint32_t reversals;         // 方向反转次数
+    uint32_t flickers;          // 闪烁次数
+    uint32_t fullCount;         // 达到满亮的运动事件数
+    uint32_t fullMissed;        // 未达到满亮（白天被忽略或被更高优先级来源覆盖）的运动事件数
+    uint64_t fullTotalMs;       // 满亮时间累计
+    uint32_t fullMaxMs;         // 最长满亮时间
+    uint32_t transitions;       // 完成的变化过程数
+    uint16_t maxOvershoot;      // 最大过冲（感知亮度单位）
+} sim_metrics_t;
+
+void simMetricsInit(sim_metrics_t *metrics, float ledWatts, uint32_t flickerWindowMs);
+void simMetricsMotion(sim_metrics_t *metrics, uint32_t timeMs, uint16_t fullLevel);
+void simMetricsFrame(sim_metrics_t *metrics, uint32_t timeMs, uint16_t level, uint8_t pwm, bool settled,
+                     uint16_t fullLevel);
+void simMetricsFinish(sim_metrics_t *metrics, uint32_t endMs);
+void simMetricsPrint(const sim_metrics_t *metrics, FILE *out);
+void simMetricsPrintRowHeader(FILE *out);
+void simMetricsPrintRow(const sim_metrics_t *metrics, FILE *out);
+
+#endif //LIGHTPROJECT_SIMMETRICS_H
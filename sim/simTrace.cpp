@@ -0,0 +1,205 @@
+/**
+ * @file simTrace.cpp
+ * @brief 主机仿真输入轨迹读取与写出
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 格式说明见 simTrace.h。CSV 中的亮度百分比与 MQTT set_brightness 一致（感知亮度百分比）
+ */
+
+#include "simTrace.h"
+#include "brightnessArbiter.h"
+#include "perceptualDimming.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/**
+ * 来源名称 -> 来源编号，未知名称返回 BRIGHTNESS_SRC_COUNT
+ */
+static uint8_t parseSource(const char *name) {
+    for (uint8_t i = 0; i < BRIGHTNESS_SRC_COUNT; i++) {
+        if (strcmp(name, arbiterSourceName(i)) == 0) {
+            return i;
+        }
+    }
+    return BRIGHTNESS_SRC_COUNT;
+}
+
+/**
+ * 百分比 -> 16位感知亮度（与 MQTT 命令的换算一致）
+ */
+static uint16_t percentToLevel(long percent) {
+    if (percent < 0) {
+        percent = 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    return LEVEL_8_TO_16(percent * 255 / 100);
+}
+
+/**
+ * 解析一行 CSV，返回 false 表示格式错误
+ */
+static bool parseCsvLine(char *line, sim_event_t *event) {
+    char *fields[5] = {};
+    int count = 0;
+    for (char *token = strtok(line, ",\r\n"); token != nullptr && count < 5; token = strtok(nullptr, ",\r\n")) {
+        while (*token == ' ') {
+            token++;
+        }
+        fields[count++] = token;
+    }
+    if (count < 2) {
+        return false;
+    }
+    memset(event, 0, sizeof(*event));
+    event->timeMs = (uint32_t) strtoul(fields[0], nullptr, 10);
+    const char *type = fields[1];
+    if (strcmp(type, "lux") == 0 && count >= 3) {
+        event->type = SIM_EVENT_LUX;
+        event->value = strtof(fields[2], nullptr);
+    }
+    else if (strcmp(type, "motion") == 0) {
+        event->type = SIM_EVENT_MOTION;
+    }
+    else if (strcmp(type, "motion_clear") == 0) {
+        event->type = SIM_EVENT_MOTION_CLEAR;
+    }
+    else if (strcmp(type, "set") == 0 && count >= 4) {
+        event->type = SIM_EVENT_SET_SOURCE;
+        event->source = parseSource(fields[2]);
+        event->level = percentToLevel(strtol(fields[3], nullptr, 10));
+        event->ttlMs = count >= 5 ? (uint32_t) strtoul(fields[4], nullptr, 10) * 1000UL : 0;
+        return event->source < BRIGHTNESS_SRC_COUNT;
+    }
+    else if (strcmp(type, "clear") == 0 && count >= 3) {
+        event->type = SIM_EVENT_CLEAR_SOURCE;
+        event->source = parseSource(fields[2]);
+        return event->source < BRIGHTNESS_SRC_COUNT;
+    }
+    else if (strcmp(type, "daylight") == 0 && count >= 3) {
+        event->type = SIM_EVENT_DAYLIGHT;
+        event->source = (uint8_t) (strtol(fields[2], nullptr, 10) != 0);
+        event->value = count >= 4 ? strtof(fields[3], nullptr) : 0.0f;
+    }
+    else if (strcmp(type, "commission") == 0) {
+        event->type = SIM_EVENT_COMMISSION;
+    }
+    else if (strcmp(type, "weather") == 0 && count >= 3) {
+        event->type = SIM_EVENT_WEATHER;
+        event->value = strtof(fields[2], nullptr);
+        if (count >= 4) {
+            long pm25 = strtol(fields[3], nullptr, 10);
+            event->source = 1;
+            event->level = (uint16_t) (pm25 < 0 ? 0 : (pm25 > 65535 ? 65535 : pm25));
+        }
+    }
+    else if (strcmp(type, "end") == 0) {
+        event->type = SIM_EVENT_END;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 读取二进制轨迹（文件头已确认魔数）
+ */
+static bool loadBinary(FILE *file, std::vector<sim_event_t> &events) {
+    uint32_t header[3];
+    if (fread(header, sizeof(uint32_t), 3, file) != 3 || header[1] != SIM_TRACE_VERSION) {
+        fprintf(stderr, "二进制轨迹版本不支持\n");
+        return false;
+    }
+    events.resize(header[2]);
+    if (fread(events.data(), sizeof(sim_event_t), header[2], file) != header[2]) {
+        fprintf(stderr, "二进制轨迹长度不足\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 读取轨迹文件，按文件头自动识别 CSV / 二进制
+ * 返回值：false 表示文件无法打开、格式错误或时间倒序
+ */
+bool simTraceLoad(const char *path, std::vector<sim_event_t> &events) {
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "无法打开轨迹文件 %s\n", path);
+        return false;
+    }
+    events.clear();
+    uint32_t magic = 0;
+    bool ok = true;
+    if (fread(&magic, sizeof(magic), 1, file) == 1 && magic == SIM_TRACE_MAGIC) {
+        rewind(file);
+        ok = loadBinary(file, events);
+    }
+    else {
+        rewind(file);
+        char line[256];
+        int lineNumber = 0;
+        while (ok && fgets(line, sizeof(line), file) != nullptr) {
+            lineNumber++;
+            char *start = line;
+            while (*start == ' ' || *start == '\t') {
+                start++;
+            }
+            if (*start == '#' || *start == '\n' || *start == '\r' || *start == '\0') {
+                continue;       // 注释或空行
+            }
+            sim_event_t event;
+            if (!parseCsvLine(start, &event)) {
+                fprintf(stderr, "%s:%d: 无法解析的事件\n", path, lineNumber);
+                ok = false;
+            }
+            else {
+                events.push_back(event);
+            }
+        }
+    }
+    fclose(file);
+
+    for (size_t i = 1; ok && i < events.size(); i++) {
+        if (events[i].timeMs < events[i - 1].timeMs) {
+            fprintf(stderr, "轨迹时间倒序（第 %zu 个事件）\n", i + 1);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/**
+ * 写出二进制轨迹
+ */
+bool simTraceSaveBinary(const char *path, const std::vector<sim_event_t> &events) {
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        fprintf(stderr, "无法写入 %s\n", path);
+        return false;
+    }
+    uint32_t header[3] = {SIM_TRACE_MAGIC, SIM_TRACE_VERSION, (uint32_t) events.size()};
+    bool ok = fwrite(header, sizeof(uint32_t), 3, file) == 3 &&
+              fwrite(events.data(), sizeof(sim_event_t), events.size(), file) == events.size();
+    fclose(file);
+    return ok;
+}
+
+/**
+ * 轨迹时长：END 事件的时间，没有 END 事件时为最后一个事件的时间
+ */
+uint32_t simTraceDuration(const std::vector<sim_event_t> &events) {
+    for (const sim_event_t &event : events) {
+        if (event.type == SIM_EVENT_END) {
+            return event.timeMs;
+        }
+    }
+    return events.empty() ? 0 : events.back().timeMs;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file simTrace.h
+ * @brief 主机仿真输入轨迹（光照、运动、控制事件）头文件
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件为仿真输入轨迹头文件，包含如下内容：
+ * - 轨迹事件类型与事件结构体定义
+ * - CSV / 二进制轨迹的读取与二进制轨迹的写出函数声明
+ *
+ * @note
+ * CSV 格式（每行一个事件，# 开头为注释，时间单位为毫秒且不递减）：
+ * - 时间,lux,照度              环境光照度（不含灯自身光照）
+ * - 时间,motion                PIR 或 KEY1
+ * - 时间,motion_clear          KEY2
+ * - 时间,set,来源,百分比,秒    设置亮度来源（来源名见 arbiterSourceName，秒为有效期，0为长期）
+ * - 时间,clear,来源            清除亮度来源
+ * - 时间,daylight,0|1,目标照度  切换闭环日光补偿
+ * - 时间,commission            自身光照阶跃扫描
+ * - 时间,weather,湿度,PM2.5     相对湿度（%）与PM2.5（μg/m³，可省略），能见度补偿的输入
+ * - 时间,end                   仿真结束时间（缺省为最后一个事件时间）
+ * 二进制格式：魔数 "BSIM"、版本、事件数（均为 uint32 小端），随后为 sim_event_t 数组，
+ * 解析开销远小于 CSV，适合大规模参数扫描
+ */
+
+#ifndef LIGHTPROJECT_SIMTRACE_H
+#define LIGHTPROJECT_SIMTRACE_H
+
+#include <cstdint>
+#include <vector>
+
+#define SIM_TRACE_MAGIC 0x4D495342UL    // "BSIM"（小端）
+#define SIM_TRACE_VERSION 1
+
+/* 事件类型 */
+typedef enum {
+    SIM_EVENT_LUX = 0,          // 环境光照度变化（value）
+    SIM_EVENT_MOTION,           // 运动检测
+    SIM_EVENT_MOTION_CLEAR,     // 取消运动检测
+    SIM_EVENT_SET_SOURCE,       // 设置亮度来源（source/level/ttlMs）
+    SIM_EVENT_CLEAR_SOURCE,     // 清除亮度来源（source）
+    SIM_EVENT_DAYLIGHT,         // 切换闭环日光补偿（source 为开关，value 为目标照度）
+    SIM_EVENT_COMMISSION,       // 自身光照阶跃扫描
+    SIM_EVENT_END,              // 仿真结束
+    SIM_EVENT_WEATHER           // 湿度与PM2.5（value 为湿度，level 为PM2.5，source 为是否有PM2.5）
+} sim_event_type_t;
+
+/* 轨迹事件（16字节，二进制轨迹按此布局直接存储） */
+typedef struct {
+    uint32_t timeMs;            // 事件时间（毫秒，相对轨迹开始）
+    uint8_t type;               // 事件类型（sim_event_type_t）
+    uint8_t source;             // 亮度来源 / 开关
+    uint16_t level;             // 16位感知亮度
+    float value;                // 照度等数值参数
+    uint32_t ttlMs;             // 有效期（毫秒）
+} sim_event_t;
+
+static_assert(sizeof(sim_event_t) == 16, "sim_event_t 布局必须固定为16字节");
+
+bool simTraceLoad(const char *path, std::vector<sim_event_t> &events);              // 自动识别 CSV / 二进制
+bool simTraceSaveBinary(const char *path, const std::vector<sim_event_t> &events);  // 写出二进制轨迹
+uint32_t simTraceDuration(const std::vector<sim_event_t> &events);                  // 轨迹时长（毫秒）
+
+#endif //LIGHTPROJECT_SIMTRACE_H
@@ -37,6 +37,10 @@
 #include "adcReading.h"
 #include "brightnessConfig.h"   // 添加亮度配置模块头文件
 #include "getPM2dot5.h"         // 添加PM2.5模块头文件
+#include "motionInput.h"        // 添加运动检测与按键输入模块头文件
+#include "ledOutput.h"          // 添加LED输出模块头文件
+#include "clockSync.h"          // 添加时钟同步模块头文件
+#include "i2cBus.h"             // 添加I2C总线管理模块头文件
 
 #define timeout_seconds 20      // 超时时间（20s）
 #define panic_on_timeout true   // 超时后是否触发panic
@@ -44,15 +48,13 @@
 void setup() {
     Serial.begin(115200);       // 初始化串口速率
 #ifdef isJLC
-    Wire.begin(1, 2); // 初始化I2C总线 前者SDA 后者SCL, 立创开发板
+    i2cBusInit(JLC_I2C_SDA_PIN, JLC_I2C_SCL_PIN, I2C_BUS_FREQ_HZ);  // 初始化I2C总线（400kHz），立创开发板
 #else
-    Wire.begin(8, 9); // 初始化I2C总线 前者SDA 后者SCL, 自制核心板
+    i2cBusInit(I2C_SDA_PIN, I2C_SCL_PIN, I2C_BUS_FREQ_HZ);          // 初始化I2C总线（400kHz），自制核心板
 #endif
-    Wire.setClock(400000);      // 设置I2C时钟频率为400kHz
 
     Serial.println("初始化I2C总线设备");
-    lightMeter.begin();         // BH1750光照强度传感器初始化
-    aht.begin();                // AHT20温湿度传感器初始化
+    i2cSensorsInit();           // BH1750光照强度传感器与AHT20温湿度传感器初始化
 #ifdef useOLED
     OLED_Init();                // OLED显示屏初始化
 #endif
@@ -60,7 +62,10 @@ void setup() {
     showBootInfo();             // 显示启动信息1
 
     Serial.println("初始化亮度控制模块");
-    brightnessInit();           // 初始化亮度控制模块（包含运动检测中断）
+    brightnessInit();           // 初始化亮度控制模块
+    powerInit();                // 初始化能耗计量与功率预算
+    scheduleInit();             // 读取时间表配置
+    motionInputInit();          // 初始化运动检测与按键中断
     showBootInfo();             // 显示启动信息2
 
     Serial.println("初始化PM2.5传感器");
@@ -73,6 +78,7 @@ void setup() {
 
     Serial.println("初始化网络连接");
     wifiConfig();               // 连接网络
+    clockInit();                // 恢复保存的时间并启动SNTP校时
     showBootInfo();             // 显示启动信息5
     mqttConfig();               // 设置MQTT
     showBootInfo();             // 显示启动信息6
@@ -81,9 +87,7 @@ void setup() {
     // timerInit();
 
     Serial.println("初始化WS2812");
-    CFastLED::addLeds<WS2812, ledPin, GRB>(leds, LED_COUNT);     // 初始化FastLED
-    fill_solid(leds, LED_COUNT, CRGB(0, 0, 0));   // 全部清零（即设置亮度为0）
-    FastLED.show();             // 更新显示
+    ledOutputInit();            // 初始化FastLED、色温查找表与空间效果层
     showBootInfo();             // 显示启动信息7
 
     Serial.println("任务创建");
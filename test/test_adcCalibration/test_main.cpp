@@ -0,0 +1,131 @@
+/**
+ * @file test_main.cpp
+ * @brief ADC电压校准模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 adcCalibration（pio test -e native_test）：
+ * - 精度：用三次多项式参考曲线（与S3在11dB衰减下的实测形状相近）生成转换表，全部16位输入的查表结果与
+ *   参考电压之差不超过2毫伏
+ * - 两点校正：实际分压比比标称值大2%（电阻误差），校正前4.2V处偏差约80毫伏，两点校正后3.0~4.2V内不超过2毫伏
+ * - 兼容：理想曲线的转换表与原来的 (adc * 6600) >> 12 相同或高1毫伏
+ *
+ * @note
+ * 注意事项：
+ * - 参考曲线像 esp_adc_cal_raw_to_voltage 一样输出整数毫伏（再换算为微伏），精度比较使用未取整的参考值
+ * - 最后一段（16位输入 65280 以上）超出12位读数范围，由外推得到，不参与精度比较
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdlib>
+#include "adcCalibration.h"
+
+#define CAL_MAX_ERROR_MV 2.0            // 允许的最大误差（毫伏）
+#define CAL_INPUT_MAX 65520             // 16位过采样值的满量程（64 × 4095 >> 2）
+#define CAL_EXACT_INPUT_MAX 65280       // 该值以下的输入不涉及外推段
+#define DIVIDER_ACTUAL 2.04             // 实际分压比（标称 2:1，偏大2%）
+
+/**
+ * 参考曲线：12位读数 -> 引脚电压（毫伏，未取整）
+ */
+static double referenceMv(double raw) {
+    return 12.0 + 0.78 * raw + 1.2e-5 * raw * raw - 2.4e-9 * raw * raw * raw;
+}
+
+/**
+ * 转换表使用的曲线：与 esp_adc_cal 一样取整到毫伏，输出微伏
+ */
+static uint32_t referenceCurve(uint32_t raw, void *context) {
+    (void) context;
+    return (uint32_t) lround(referenceMv((double) raw)) * 1000U;
+}
+
+/**
+ * 16位输入对应的端子电压参考值（毫伏）
+ */
+static double terminalMv(uint32_t value, double divider) {
+    return divider * referenceMv((double) value / 16.0);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+/**
+ * 精度：未校正的转换表与参考曲线 × 标称分压比
+ */
+static void test_reference_curve_accuracy() {
+    adc_cal_table_t table;
+    adcCalBuild(&table, referenceCurve, nullptr, 2, 1, nullptr);
+    double maxError = 0.0;
+    for (uint32_t value = 0; value < CAL_EXACT_INPUT_MAX; value++) {
+        double error = fabs((double) adcCalConvert(&table, (uint16_t) value) - terminalMv(value, 2.0));
+        maxError = fmax(maxError, error);
+    }
+    TEST_ASSERT_TRUE(maxError <= CAL_MAX_ERROR_MV);
+    /* 满量程处（外推段）单调，不回绕 */
+    TEST_ASSERT_TRUE(adcCalConvert(&table, CAL_INPUT_MAX) >= adcCalConvert(&table, CAL_EXACT_INPUT_MAX));
+}
+
+/**
+ * 两点校正：分压比偏大2%，在3.0V与4.2V取点
+ */
+static void test_two_point_divider_correction() {
+    adc_cal_table_t base;
+    adcCalBuild(&base, referenceCurve, nullptr, 2, 1, nullptr);
+
+    /* 端子电压约3.0V与4.2V时的16位读数 */
+    uint16_t low = (uint16_t) (3000.0 / DIVIDER_ACTUAL / 0.8 * 16.0);
+    uint16_t high = (uint16_t) (4200.0 / DIVIDER_ACTUAL / 0.8 * 16.0);
+    double uncorrected = terminalMv(high, DIVIDER_ACTUAL) - adcCalConvert(&base, high);
+    TEST_ASSERT_TRUE(uncorrected > 60.0);          // 2%的分压误差在4.2V处约80毫伏
+
+    adc_cal_points_t points = {};
+    points.version = ADC_CAL_VERSION;
+    points.measured[0] = adcCalConvert(&base, low);
+    points.measured[1] = adcCalConvert(&base, high);
+    points.actual[0] = (uint16_t) lround(terminalMv(low, DIVIDER_ACTUAL));    // 万用表读数
+    points.actual[1] = (uint16_t) lround(terminalMv(high, DIVIDER_ACTUAL));
+    TEST_ASSERT_TRUE(adcCalPointsValid(&points));
+
+    adc_cal_table_t corrected;
+    adcCalBuild(&corrected, referenceCurve, nullptr, 2, 1, &points);
+    double maxError = 0.0;
+    for (uint32_t value = low; value <= high; value++) {
+        double error = fabs((double) adcCalConvert(&corrected, (uint16_t) value) - terminalMv(value, DIVIDER_ACTUAL));
+        maxError = fmax(maxError, error);
+    }
+    TEST_ASSERT_TRUE(maxError <= CAL_MAX_ERROR_MV);
+
+    /* 两点读数相同时无法确定直线，不校正 */
+    points.measured[1] = points.measured[0];
+    TEST_ASSERT_FALSE(adcCalPointsValid(&points));
+}
+
+/**
+ * 兼容：理想曲线与原来的 (adc * 6600) >> 12
+ */
+static void test_linear_curve_matches_legacy_formula() {
+    adc_cal_table_t table;
+    adcCalBuild(&table, adcCalLinearCurve, nullptr, 2, 1, nullptr);
+    for (uint32_t raw = 0; raw <= ADC_CAL_RAW_MAX; raw++) {
+        int32_t legacy = (int32_t) ((raw * 6600U) >> 12);
+        int32_t converted = adcCalConvert(&table, (uint16_t) (raw * 16));
+        TEST_ASSERT_TRUE(converted - legacy >= 0);
+        TEST_ASSERT_TRUE(converted - legacy <= 1);
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reference_curve_accuracy);
+    RUN_TEST(test_two_point_divider_correction);
+    RUN_TEST(test_linear_curve_matches_legacy_formula);
+    return UNITY_END();
+}
@@ -0,0 +1,211 @@
+/**
+ * @file test_main.cpp
+ * @brief 颗粒物滚动统计模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 airQuality（pio test -e native_test）：
+ * - 窗口边界：第一个样本在 millis() 回绕前2.5秒，样本在窗口边界前1毫秒仍然计入、到达边界时离开窗口
+ * - 随机核对：起点在回绕附近、间隔从几毫秒到超过24小时的随机样本，每个窗口的累加和与样本数与逐样本计算的参考结果完全相同
+ * - 长时间无数据：25小时没有样本后全部窗口为空、NowCast 与 AQI 无效，之后的新样本不混入旧数据
+ * - NowCast 与 AQI：稳定浓度下 NowCast 等于该浓度，AQI 分级边界与EPA 2024表一致，超出分级表时为500
+ *
+ * @note
+ * 注意事项：
+ * - 参考结果按“样本所在桶的编号（自第一个样本起按桶时长计数）晚于当前桶编号减桶数”筛选样本，与实现无关
+ * - 随机核对的单次运行跨度约16天，远小于 millis() 的回绕周期（约49.7天），样本时间差不会有歧义
+ */
+
+#include <unity.h>
+#include <vector>
+#include "airQuality.h"
+
+#define WRAP_START (0xFFFFFFFFu - 2500u)    // 回绕前2.5秒
+#define RANDOM_RUNS 200                     // 随机核对的运行次数
+#define RANDOM_SAMPLES 3000                 // 每次运行的样本数
+
+/* 与实现中的窗口参数相同（用于参考计算） */
+static const uint32_t bucketMs[AQ_WINDOWS] = {5000, 60000, 300000, 3600000};
+static const uint8_t bucketCount[AQ_WINDOWS] = {12, 15, 12, 24};
+
+static uint32_t rngState = 0x2468ACE1;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static air_quality_t aq;
+static air_quality_report_t report;
+
+static void reportAt(uint32_t nowMs) {
+    airQualityAdvance(&aq, nowMs);
+    airQualityReport(&aq, &report);
+}
+
+void setUp() {
+    airQualityInit(&aq);
+}
+
+void tearDown() {
+}
+
+/**
+ * 1分钟窗口（12个5秒桶）跨过 millis() 回绕时的边界
+ */
+static void test_window_edges_across_millis_wrap() {
+    airQualityAdd(&aq, 10.0f, -1.0f, WRAP_START);
+    airQualityAdd(&aq, 30.0f, -1.0f, WRAP_START + 5000u);         // 回绕后，下一个桶
+    reportAt(WRAP_START + 5000u);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, report.pm25Mean[AQ_WINDOW_1MIN]);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm10Mean[AQ_WINDOW_1MIN]);
+
+    reportAt(WRAP_START + 60000u - 1u);                           // 第一个桶仍在窗口内
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, report.pm25Mean[AQ_WINDOW_1MIN]);
+    reportAt(WRAP_START + 60000u);                                // 第一个桶离开窗口
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, report.pm25Mean[AQ_WINDOW_1MIN]);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, report.pm25Mean[AQ_WINDOW_15MIN]);
+    reportAt(WRAP_START + 65000u - 1u);
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, report.pm25Mean[AQ_WINDOW_1MIN]);
+    reportAt(WRAP_START + 65000u);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm25Mean[AQ_WINDOW_1MIN]);
+
+    /* 24小时窗口：第一个样本在第24个1小时桶开始时离开 */
+    reportAt(WRAP_START + 24u * 3600000u - 1u);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, report.pm25Mean[AQ_WINDOW_24H]);
+    reportAt(WRAP_START + 24u * 3600000u);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm25Mean[AQ_WINDOW_24H]);
+}
+
+/**
+ * 随机样本与参考结果核对（起点在回绕附近）
+ */
+static void test_random_samples_match_reference() {
+    struct sample_t {
+        uint32_t ms;
+        uint32_t tenths;
+    };
+    std::vector<sample_t> samples;
+    for (uint32_t run = 0; run < RANDOM_RUNS; run++) {
+        airQualityInit(&aq);
+        samples.clear();
+        uint32_t now = 0xFFFFFFFFu - rng() % 7200000u;
+        uint32_t first = 0;                             // 第一个样本的时间（窗口从这里开始分桶）
+        for (uint32_t n = 0; n < RANDOM_SAMPLES; n++) {
+            uint32_t kind = rng() % 100;
+            if (kind < 80) {
+                now += rng() % 3000;                    // 正常间隔
+            }
+            else if (kind < 99) {
+                now += rng() % 400000;                  // 跨过若干个桶
+            }
+            else {
+                now += rng() % (26u * 3600000u);       // 长时间无数据（可能超过24小时）
+            }
+            if (n == 0) {
+                first = now;
+            }
+            uint32_t tenths = rng() % 5000;
+            airQualityAdd(&aq, (float) tenths / 10.0f, -1.0f, now);
+            samples.push_back({now, tenths});
+            if (n % 97 != 0) {
+                continue;
+            }
+            uint32_t query = now + rng() % 600000;
+            airQualityAdvance(&aq, query);
+            for (uint8_t w = 0; w < AQ_WINDOWS; w++) {
+                uint32_t current = (query - first) / bucketMs[w];
+                uint32_t sum = 0, count = 0;
+                for (const sample_t &s : samples) {
+                    uint32_t index = (s.ms - first) / bucketMs[w];
+                    if (index + bucketCount[w] > current) {
+                        sum += s.tenths;
+                        count++;
+                    }
+                }
+                TEST_ASSERT_EQUAL_UINT32(count, aq.pm25[w].count);
+                TEST_ASSERT_EQUAL_UINT32(sum, aq.pm25[w].sum);
+            }
+            now = query;
+        }
+    }
+}
+
+/**
+ * 25小时无数据（跨过回绕）
+ */
+static void test_25h_silence_empties_all_windows() {
+    uint32_t now = WRAP_START - 3600000u;
+    for (uint32_t i = 0; i < 7200; i++) {               // 2小时 1Hz
+        airQualityAdd(&aq, 40.0f, 80.0f, now);
+        now += 1000;
+    }
+    reportAt(now);
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, report.pm25Mean[AQ_WINDOW_24H]);
+    TEST_ASSERT_TRUE(report.aqi > 0);
+
+    now += 25u * 3600000u;
+    reportAt(now);
+    for (uint8_t w = 0; w < AQ_WINDOWS; w++) {
+        TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm25Mean[w]);
+        TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm10Mean[w]);
+        TEST_ASSERT_EQUAL_UINT32(0, aq.pm25[w].sum);
+        TEST_ASSERT_EQUAL_UINT32(0, aq.pm25[w].count);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm25NowCast);
+    TEST_ASSERT_EQUAL_INT(-1, report.aqi);
+    TEST_ASSERT_EQUAL_INT(-1, report.aqi24h);
+
+    airQualityAdd(&aq, 5.0f, 10.0f, now);               // 新样本不混入旧数据
+    reportAt(now);
+    for (uint8_t w = 0; w < AQ_WINDOWS; w++) {
+        TEST_ASSERT_EQUAL_FLOAT(5.0f, report.pm25Mean[w]);
+        TEST_ASSERT_EQUAL_FLOAT(10.0f, report.pm10Mean[w]);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, report.pm25NowCast);     // 最近3小时只有1小时有数据
+}
+
+/**
+ * NowCast 与 AQI 分级
+ */
+static void test_nowcast_and_aqi_breakpoints() {
+    uint32_t now = WRAP_START;
+    for (uint32_t i = 0; i < 12u * 3600u; i++) {        // 12小时 1Hz
+        airQualityAdd(&aq, 20.0f, 60.0f, now);
+        now += 1000;
+    }
+    reportAt(now - 1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, report.pm25NowCast);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, report.pm10NowCast);
+    TEST_ASSERT_EQUAL_INT(aqiFromPm25(20.0f), report.aqi);     // PM2.5 的指数较高
+
+    TEST_ASSERT_EQUAL_INT(0, aqiFromPm25(0.0f));
+    TEST_ASSERT_EQUAL_INT(50, aqiFromPm25(9.0f));
+    TEST_ASSERT_EQUAL_INT(51, aqiFromPm25(9.1f));
+    TEST_ASSERT_EQUAL_INT(50, aqiFromPm25(9.05f));             // 截断到0.1μg/m³
+    TEST_ASSERT_EQUAL_INT(100, aqiFromPm25(35.4f));
+    TEST_ASSERT_EQUAL_INT(500, aqiFromPm25(325.4f));
+    TEST_ASSERT_EQUAL_INT(AQI_MAX, aqiFromPm25(325.5f));          // 超出分级表：不外推
+    TEST_ASSERT_EQUAL_INT(AQI_MAX, aqiFromPm25(500.0f));
+    TEST_ASSERT_EQUAL_INT(AQI_MAX, aqiFromPm25(AQ_MAX_CONCENTRATION));
+    TEST_ASSERT_EQUAL_INT(500, aqiFromPm10(604.0f));
+    TEST_ASSERT_EQUAL_INT(AQI_MAX, aqiFromPm10(605.0f));
+    TEST_ASSERT_EQUAL_INT(AQI_MAX, aqiFromPm10(1500.0f));
+    TEST_ASSERT_EQUAL_INT(50, aqiFromPm10(54.0f));
+    TEST_ASSERT_EQUAL_INT(51, aqiFromPm10(55.0f));
+    TEST_ASSERT_EQUAL_INT(-1, aqiFromPm25(-1.0f));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_window_edges_across_millis_wrap);
+    RUN_TEST(test_random_samples_match_reference);
+    RUN_TEST(test_25h_silence_empties_all_windows);
+    RUN_TEST(test_nowcast_and_aqi_breakpoints);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+/**
+ * @file test_main.cpp
+ * @brief 电池电量估计模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 batterySoc（pio test -e native_test）：
+ * - 4小时放电：每100ms更新一次（与采样任务相同），灯带每分钟开关一次（1.5W），端子电压含内阻压降与±10mV噪声，
+ *   时间跨过 millis() 回绕；估计电量单调不升、单步变化很小、第一小时之后与真实电量之差不超过 SOC_TRACK_ERROR
+ * - 负载补偿：满亮开灯瞬间端子电压跌落约0.38V，估计电量只按库仑计数下降，不跟随电压跌落
+ * - 充电：充电期间估计电量可以上升；长时间停顿后的一次更新按 SOC_MAX_STEP_MS 计算
+ *
+ * @note
+ * 注意事项：
+ * - 模拟电池的开路电压由OCV曲线反查得到，内阻与模块参数相同，因此误差只来自噪声、初始观测与滤波延迟
+ */
+
+#include <unity.h>
+#include <cmath>
+#include "batterySoc.h"
+
+#define SIM_STEP_MS 100                 // 更新周期（毫秒）
+#define SIM_HOURS 4                     // 放电时长（小时）
+#define SIM_LED_MW 1500.0f              // 开灯时的灯带功率（mW，4小时约放掉40%电量）
+#define SIM_LED_PERIOD_MS 60000u        // 灯带开、关各持续的时间
+#define SIM_NOISE_MV 10                 // 端子电压噪声幅度（mV）
+#define SIM_START_MS (0xFFFFFFFFu - 1800000u)  // 起始时间（半小时后 millis() 回绕）
+#define SOC_TRACK_ERROR 3.0f            // 允许的跟踪误差（%）
+#define SOC_MAX_STEP 0.05f              // 允许的单步变化（%）
+
+/**
+ * 电量 -> 开路电压（OCV曲线反查）
+ */
+static float ocvFromSoc(float soc) {
+    for (size_t i = 1; i < SOC_OCV_POINTS; i++) {
+        if (soc <= socOcvTable[i].percent) {
+            const soc_ocv_point_t &low = socOcvTable[i - 1];
+            const soc_ocv_point_t &high = socOcvTable[i];
+            return (float) low.mv + (soc - (float) low.percent) * (float) (high.mv - low.mv)
+                                    / (float) (high.percent - low.percent);
+        }
+    }
+    return (float) socOcvTable[SOC_OCV_POINTS - 1].mv;
+}
+
+/**
+ * 确定性的端子电压噪声（-SIM_NOISE_MV ~ +SIM_NOISE_MV）
+ */
+static float noiseMv(uint32_t step) {
+    return (float) ((int32_t) ((step * 7919u) % (2 * SIM_NOISE_MV + 1)) - SIM_NOISE_MV);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+/**
+ * 4小时放电：单调、平滑、跟踪真实电量
+ */
+static void test_4h_discharge_is_monotone_and_tracks() {
+    battery_soc_t est;
+    socInit(&est);
+    float trueSoc = 90.0f;
+    uint32_t now = SIM_START_MS;
+    float previous = 0.0f;
+    float maxStep = 0.0f;
+    float maxError = 0.0f;
+    uint32_t rises = 0;
+    const uint32_t steps = SIM_HOURS * 3600u * 1000u / SIM_STEP_MS;
+    for (uint32_t i = 0; i < steps; i++) {
+        uint32_t elapsed = i * SIM_STEP_MS;
+        bool ledOn = (elapsed / SIM_LED_PERIOD_MS) % 2 == 1;
+        float ocv = ocvFromSoc(trueSoc);
+        float loadMa = socBatteryCurrentMa(ocv, ledOn ? SIM_LED_MW : 0.0f);
+        float terminal = ocv - loadMa * SOC_INTERNAL_MOHM / 1000.0f + noiseMv(i);
+        float soc = socUpdate(&est, terminal, loadMa, false, now);
+        if (i > 0) {
+            if (soc > previous) {
+                rises++;
+            }
+            maxStep = fmaxf(maxStep, fabsf(soc - previous));
+        }
+        if (elapsed >= 3600000u) {
+            maxError = fmaxf(maxError, fabsf(soc - trueSoc));
+        }
+        previous = soc;
+        trueSoc -= loadMa * ((float) SIM_STEP_MS / 3600000.0f) / SOC_CAPACITY_MAH * 100.0f;
+        now += SIM_STEP_MS;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, rises);
+    TEST_ASSERT_TRUE(maxStep <= SOC_MAX_STEP);
+    TEST_ASSERT_TRUE(maxError <= SOC_TRACK_ERROR);
+    TEST_ASSERT_TRUE(trueSoc < 60.0f);                  // 确实放掉了可观的电量
+    TEST_ASSERT_FLOAT_WITHIN(SOC_TRACK_ERROR, trueSoc, est.soc);
+}
+
+/**
+ * 负载补偿：开灯时的电压跌落不被当成电量下降
+ */
+static void test_load_step_does_not_drop_soc() {
+    battery_soc_t est;
+    socInit(&est);
+    float ocv = ocvFromSoc(60.0f);
+    uint32_t now = 0;
+    float idleMa = socBatteryCurrentMa(ocv, 0.0f);
+    for (uint32_t i = 0; i < 600; i++) {                // 空载1分钟
+        socUpdate(&est, ocv - idleMa * SOC_INTERNAL_MOHM / 1000.0f, idleMa, false, now);
+        now += SIM_STEP_MS;
+    }
+    float before = est.soc;
+    float ledMa = socBatteryCurrentMa(ocv, 8000.0f);    // 满亮
+    float sag = (ledMa - idleMa) * SOC_INTERNAL_MOHM / 1000.0f;
+    TEST_ASSERT_TRUE(sag > 300.0f);                     // 未补偿时OCV观测会从60%跌到约11%
+    for (uint32_t i = 0; i < 50; i++) {                 // 开灯5秒
+        socUpdate(&est, ocv - ledMa * SOC_INTERNAL_MOHM / 1000.0f, ledMa, false, now);
+        now += SIM_STEP_MS;
+    }
+    float consumed = ledMa * (5.0f / 3600.0f) / SOC_CAPACITY_MAH * 100.0f;     // 5秒的库仑计数
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, before - consumed, est.soc);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 60.0f, est.ocvSoc);
+}
+
+/**
+ * 充电时可以上升；长时间停顿按 SOC_MAX_STEP_MS 计算
+ */
+static void test_charging_and_long_gap() {
+    battery_soc_t est;
+    socInit(&est);
+    uint32_t now = 0;
+    float idleMa = socBatteryCurrentMa(3700.0f, 0.0f);
+    socUpdate(&est, ocvFromSoc(40.0f), 0.0f, false, now);
+    float start = est.soc;
+    for (uint32_t i = 0; i < 36000; i++) {              // 充电1小时，开路电压对应的电量升到70%
+        now += SIM_STEP_MS;
+        socUpdate(&est, ocvFromSoc(40.0f + 30.0f * (float) i / 36000.0f), idleMa, true, now);
+    }
+    TEST_ASSERT_TRUE(est.soc > start + 5.0f);
+
+    /* 停顿1小时：库仑计数只按 SOC_MAX_STEP_MS 计算 */
+    float before = est.soc;
+    socUpdate(&est, ocvFromSoc(before), 1000.0f, false, now + 3600000u);
+    float maxDrop = 1000.0f * ((float) SOC_MAX_STEP_MS / 3600000.0f) / SOC_CAPACITY_MAH * 100.0f;
+    TEST_ASSERT_TRUE(before - est.soc <= maxDrop + 0.01f);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_4h_discharge_is_monotone_and_tracks);
+    RUN_TEST(test_load_step_does_not_drop_soc);
+    RUN_TEST(test_charging_and_long_gap);
+    return UNITY_END();
+}
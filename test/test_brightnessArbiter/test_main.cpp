@@ -0,0 +1,189 @@
+/**
+ * @file test_main.cpp
+ * @brief 亮度来源仲裁模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 brightnessArbiter（pio test -e native_test）：
+ * - 优先级：紧急 > 远程 > 时间表 > 运动 > 环境光，逐个清除时依次由下一级来源接管，忽略掩码跳过对应来源
+ * - 有效期：到期前1毫秒仍然有效、到期时刻失效并被清除，跨过 millis() 回绕同样成立；长期有效的来源不会到期
+ * - 同级替换：再次设置同一来源时亮度与有效期都以新的为准，旧的有效期不再生效
+ * - 上限：功率预算限制紧急照明以外的来源，时间表上限只限制运动增亮与环境光
+ *
+ * @note
+ * 注意事项：
+ * - 亮度控制模块在 arbiterResolve() 之后调用 arbiterApplyCaps()，这里按同样的顺序组合
+ */
+
+#include <unity.h>
+#include "brightnessArbiter.h"
+
+#define WRAP_START (0xFFFFFFFFu - 500u)     // 回绕前0.5秒
+#define LEVEL_AMBIENT 8000
+#define LEVEL_MOTION 40000
+#define LEVEL_SCHEDULE 30000
+#define LEVEL_REMOTE 20000
+#define LEVEL_EMERGENCY 65535
+#define NO_CAP 65535                        // 不限制
+
+static brightness_arbiter_t arbiter;
+
+void setUp() {
+    arbiterInit(&arbiter);
+}
+
+void tearDown() {
+}
+
+/**
+ * 仲裁并施加上限（与亮度控制模块的顺序相同）
+ */
+static uint16_t resolveCapped(uint32_t nowMs, uint16_t powerCap, uint16_t scheduleCap, uint8_t *source) {
+    uint16_t level;
+    *source = arbiterResolve(&arbiter, nowMs, 0, &level);
+    return arbiterApplyCaps(*source, level, powerCap, scheduleCap);
+}
+
+/**
+ * 优先级顺序与忽略掩码
+ */
+static void test_priority_order() {
+    uint16_t level = 1;
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_COUNT, arbiterResolve(&arbiter, 0, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(0, level);
+
+    /* 按优先级从低到高设置，每次都由新来源胜出 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_AMBIENT, LEVEL_AMBIENT, BRIGHTNESS_TTL_FOREVER, 0);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_AMBIENT, arbiterResolve(&arbiter, 0, 0, &level));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_MOTION, LEVEL_MOTION, 5000, 0);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_MOTION, arbiterResolve(&arbiter, 0, 0, &level));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_SCHEDULE, LEVEL_SCHEDULE, BRIGHTNESS_TTL_FOREVER, 0);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_SCHEDULE, arbiterResolve(&arbiter, 0, 0, &level));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, 3600000, 0);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_REMOTE, arbiterResolve(&arbiter, 0, 0, &level));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_EMERGENCY, LEVEL_EMERGENCY, BRIGHTNESS_TTL_FOREVER, 0);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_EMERGENCY, arbiterResolve(&arbiter, 0, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_EMERGENCY, level);
+
+    /* 低优先级的亮度更高也不能胜出（远程调暗时运动增亮不生效） */
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_EMERGENCY);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_REMOTE, arbiterResolve(&arbiter, 0, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_REMOTE, level);
+
+    /* 逐个清除，依次由下一级接管 */
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_REMOTE);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_SCHEDULE, arbiterResolve(&arbiter, 0, 0, &level));
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_SCHEDULE);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_MOTION, arbiterResolve(&arbiter, 0, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MOTION, level);
+
+    /* 白天忽略运动来源 */
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_AMBIENT,
+                            arbiterResolve(&arbiter, 0, 1U << BRIGHTNESS_SRC_MOTION, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_AMBIENT, level);
+    TEST_ASSERT_TRUE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_MOTION, 0));     // 被忽略的来源不会被清除
+
+    /* 无效的来源编号不影响仲裁 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_COUNT, LEVEL_EMERGENCY, BRIGHTNESS_TTL_FOREVER, 0);
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_COUNT);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_MOTION, arbiterResolve(&arbiter, 0, 0, &level));
+    TEST_ASSERT_FALSE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_COUNT, 0));
+}
+
+/**
+ * 有效期到期（跨过 millis() 回绕）
+ */
+static void test_ttl_expiry_across_wrap() {
+    uint16_t level;
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_AMBIENT, LEVEL_AMBIENT, BRIGHTNESS_TTL_FOREVER, WRAP_START);
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, 2000, WRAP_START);
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_MOTION, LEVEL_MOTION, 1000, WRAP_START);
+    TEST_ASSERT_EQUAL_UINT32(1000, arbiterNextExpiry(&arbiter, WRAP_START));        // 最近到期的是运动来源
+    TEST_ASSERT_EQUAL_UINT32(400, arbiterNextExpiry(&arbiter, WRAP_START + 600u));  // 已回绕
+
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_REMOTE, arbiterResolve(&arbiter, WRAP_START + 1999u, 0, &level));
+    TEST_ASSERT_FALSE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_MOTION, WRAP_START + 1000u));
+    TEST_ASSERT_EQUAL_UINT32(999, arbiterNextExpiry(&arbiter, WRAP_START + 1001u));
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_AMBIENT, arbiterResolve(&arbiter, WRAP_START + 2000u, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_AMBIENT, level);
+    TEST_ASSERT_FALSE(arbiter.slots[BRIGHTNESS_SRC_REMOTE].active);     // 过期的来源在仲裁时被清除
+    TEST_ASSERT_EQUAL_UINT32(BRIGHTNESS_NO_EXPIRY, arbiterNextExpiry(&arbiter, WRAP_START + 2000u));
+
+    /* 长期有效的来源在很久以后仍然有效 */
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_AMBIENT, arbiterResolve(&arbiter, WRAP_START + 0x7FFFFFFFu, 0, &level));
+
+    /* 过期但尚未被仲裁清除的来源不需要唤醒 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_MOTION, LEVEL_MOTION, 1000, 0);
+    TEST_ASSERT_EQUAL_UINT32(BRIGHTNESS_NO_EXPIRY, arbiterNextExpiry(&arbiter, 5000));
+}
+
+/**
+ * 同级替换：新的亮度与有效期覆盖旧的
+ */
+static void test_equal_priority_replacement() {
+    uint16_t level;
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, 1000, 0);
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_SCHEDULE, 5000, 800);     // 刷新：有效期从800毫秒起算
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_REMOTE, arbiterResolve(&arbiter, 1000, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_SCHEDULE, level);
+    TEST_ASSERT_EQUAL_UINT32(4800, arbiterNextExpiry(&arbiter, 1000));
+    TEST_ASSERT_TRUE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_REMOTE, 5799));
+    TEST_ASSERT_FALSE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_REMOTE, 5800));
+
+    /* 带有效期的来源被替换为长期有效 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, 1000, 6000);
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, BRIGHTNESS_TTL_FOREVER, 6500);
+    TEST_ASSERT_EQUAL_UINT32(BRIGHTNESS_NO_EXPIRY, arbiterNextExpiry(&arbiter, 6500));
+    TEST_ASSERT_TRUE(arbiterIsActive(&arbiter, BRIGHTNESS_SRC_REMOTE, 6000 + 3600000));
+
+    /* 清除后再设置：不保留旧值 */
+    arbiterClear(&arbiter, BRIGHTNESS_SRC_REMOTE);
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_COUNT, arbiterResolve(&arbiter, 7000, 0, &level));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, 0, 1000, 7000);                // 远程关灯同样是有效来源
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_REMOTE, arbiterResolve(&arbiter, 7000, 0, &level));
+    TEST_ASSERT_EQUAL_UINT16(0, level);
+}
+
+/**
+ * 上限：功率预算与时间表上限分别作用于哪些来源
+ */
+static void test_caps_by_source() {
+    const uint16_t powerCap = 25000;
+    const uint16_t scheduleCap = 10000;
+    uint8_t source;
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_AMBIENT, LEVEL_AMBIENT, BRIGHTNESS_TTL_FOREVER, 0);
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_MOTION, LEVEL_MOTION, 5000, 0);
+    TEST_ASSERT_EQUAL_UINT16(scheduleCap, resolveCapped(0, powerCap, scheduleCap, &source));       // 运动：两个上限取小者
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_MOTION, source);
+    TEST_ASSERT_EQUAL_UINT16(powerCap, resolveCapped(0, powerCap, NO_CAP, &source));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_AMBIENT, resolveCapped(5000, powerCap, scheduleCap, &source));  // 环境光低于上限
+    TEST_ASSERT_EQUAL_UINT16(5000, resolveCapped(5000, 5000, scheduleCap, &source));
+
+    /* 时间表来源与远程设置只受功率预算限制 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_SCHEDULE, LEVEL_SCHEDULE, BRIGHTNESS_TTL_FOREVER, 0);
+    TEST_ASSERT_EQUAL_UINT16(powerCap, resolveCapped(0, powerCap, scheduleCap, &source));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_SCHEDULE, resolveCapped(0, NO_CAP, scheduleCap, &source));
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_REMOTE, LEVEL_REMOTE, 1000, 0);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_REMOTE, resolveCapped(0, powerCap, scheduleCap, &source));
+    TEST_ASSERT_EQUAL_UINT16(15000, resolveCapped(0, 15000, scheduleCap, &source));
+
+    /* 紧急照明不受任何上限限制 */
+    arbiterSet(&arbiter, BRIGHTNESS_SRC_EMERGENCY, LEVEL_EMERGENCY, BRIGHTNESS_TTL_FOREVER, 0);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_EMERGENCY, resolveCapped(0, 0, 0, &source));
+    TEST_ASSERT_EQUAL_UINT8(BRIGHTNESS_SRC_EMERGENCY, source);
+
+    /* 没有有效来源时输出0 */
+    TEST_ASSERT_EQUAL_UINT16(0, arbiterApplyCaps(BRIGHTNESS_SRC_COUNT, 0, powerCap, scheduleCap));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_priority_order);
+    RUN_TEST(test_ttl_expiry_across_wrap);
+    RUN_TEST(test_equal_priority_replacement);
+    RUN_TEST(test_caps_by_source);
+    return UNITY_END();
+}
@@ -0,0 +1,240 @@
+/**
+ * @file test_main.cpp
+ * @brief 自适应运动保持时间模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 occupancyModel（pio test -e native_test），保持时间参数均取 brightnessConfig.h 中的默认值：
+ * - 样本不足：使用默认保持时间
+ * - 合成到达（指数分布间隔）：繁忙时段（平均12秒）延长保持且不超过能耗上限，冷清时段（平均5分钟）不短于默认值
+ * - 记录轨迹回放：sim/traces/busy_street.csv 满亮升亮次数比固定5秒保持至少减少25%；
+ *   sim/traces/night.csv 升亮次数与闪烁次数都不比固定保持多
+ *
+ * @note
+ * 注意事项：
+ * - 轨迹回放只模拟运动来源：最近一次运动后保持 hold 毫秒，之后经 BRIGHTNESS_DOWN_TIME_MS 下降；
+ *   保持到期后的运动记一次满亮升亮，其中下降尚未结束就又升亮的记一次闪烁（下降中途反转）
+ * - 与仿真器 --learn-nights 相同，先回放若干夜学习，最后一夜边学习边统计
+ * - 轨迹文件按测试源文件所在位置查找，找不到时按项目根目录查找
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "brightnessConfig.h"
+#include "occupancyModel.h"
+
+#define TRACE_START_HOUR 18                 // 轨迹从18:00开始
+#define LEARN_NIGHTS 5                      // 统计前的学习夜数
+#define BUSY_GAP_MS 12000.0f                // 合成繁忙时段的平均间隔
+#define SPARSE_GAP_MS 300000.0f             // 合成冷清时段的平均间隔
+
+/* 一夜回放的统计 */
+typedef struct {
+    uint32_t ramps;                 // 满亮升亮次数
+    uint32_t flickers;              // 下降中途又升亮的次数
+    uint64_t onMs;                  // 运动增亮的满亮时间累计
+} replay_stats_t;
+
+static occupancy_model_t model;
+static uint32_t randomState;
+
+/**
+ * 轨迹时间（毫秒）-> 小时（0~23）
+ */
+static int8_t hourAt(uint32_t timeMs) {
+    return (int8_t) ((TRACE_START_HOUR + timeMs / 3600000UL) % 24);
+}
+
+/**
+ * 打开轨迹文件（先按本文件所在位置，再按项目根目录）
+ */
+static FILE *openTrace(const char *name) {
+    std::string path = __FILE__;
+    size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        FILE *file = fopen((path.substr(0, slash) + "/../../" + name).c_str(), "r");
+        if (file != nullptr) {
+            return file;
+        }
+    }
+    return fopen(name, "r");
+}
+
+/**
+ * 读取轨迹中的运动事件时间
+ */
+static std::vector<uint32_t> loadMotion(const char *name) {
+    std::vector<uint32_t> motion;
+    FILE *file = openTrace(name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, name);
+    char line[128];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        unsigned long timeMs;
+        char kind[16];
+        if (sscanf(line, "%lu,%15[^,\n]", &timeMs, kind) == 2 && strcmp(kind, "motion") == 0) {
+            motion.push_back((uint32_t) timeMs);
+        }
+    }
+    fclose(file);
+    return motion;
+}
+
+/**
+ * 默认参数下的自适应保持时间
+ */
+static uint32_t defaultHold(int8_t hour) {
+    return occupancyHoldTime(&model, hour, MOTION_HOLD_MIN_MS, MOTION_HOLD_MAX_MS, MOTION_TIMEOUT_MS,
+                             MOTION_RAMP_COST_MS, MOTION_ENERGY_CAP);
+}
+
+/**
+ * 回放一夜运动事件（与 brightnessMotionDetected 相同：先记录，再计算保持时间）
+ * 参数：adaptive - false 时固定保持 MOTION_TIMEOUT_MS
+ */
+static replay_stats_t replayNight(const std::vector<uint32_t> &motion, bool adaptive) {
+    replay_stats_t stats = {0, 0, 0};
+    model.hasLastEvent = false;         // 每夜重新开机
+    bool lit = false;
+    uint32_t lastMotion = 0, holdMs = 0;
+    for (uint32_t timeMs : motion) {
+        int8_t hour = hourAt(timeMs);
+        occupancyRecord(&model, hour, timeMs);
+        uint32_t expiry = lastMotion + holdMs;
+        if (!lit || timeMs > expiry) {
+            stats.ramps++;
+            if (lit && timeMs - expiry < BRIGHTNESS_DOWN_TIME_MS) {
+                stats.flickers++;
+            }
+        }
+        if (lit) {
+            stats.onMs += (timeMs < expiry ? timeMs : expiry) - lastMotion;
+        }
+        holdMs = adaptive ? defaultHold(hour) : MOTION_TIMEOUT_MS;
+        lastMotion = timeMs;
+        lit = true;
+    }
+    stats.onMs += holdMs;
+    return stats;
+}
+
+/**
+ * 学习 LEARN_NIGHTS 夜后分别统计自适应与固定保持
+ */
+static void replayTrace(const char *name, replay_stats_t *adaptive, replay_stats_t *fixed) {
+    std::vector<uint32_t> motion = loadMotion(name);
+    TEST_ASSERT_TRUE(motion.size() > 50);
+    *fixed = replayNight(motion, false);
+    occupancyInit(&model, MOTION_TIMEOUT_MS);
+    for (uint8_t i = 0; i < LEARN_NIGHTS; i++) {
+        replayNight(motion, true);
+    }
+    *adaptive = replayNight(motion, true);
+}
+
+/**
+ * 指数分布的伪随机间隔（毫秒），固定种子保证结果可重复
+ */
+static uint32_t randomGap(float meanMs) {
+    randomState = randomState * 1664525UL + 1013904223UL;
+    float uniform = ((float) (randomState >> 8) + 0.5f) / 16777216.0f;
+    return (uint32_t) (-meanMs * logf(uniform)) + OCCUPANCY_MIN_GAP_MS;
+}
+
+/**
+ * 在一个小时桶中按平均间隔记录若干次到达
+ */
+static void feedHour(int8_t hour, float meanMs, uint16_t count) {
+    uint32_t timeMs = 0;
+    model.hasLastEvent = false;
+    for (uint16_t i = 0; i < count; i++) {
+        timeMs += randomGap(meanMs);
+        occupancyRecord(&model, hour, timeMs);
+    }
+}
+
+/**
+ * 期望满亮时间 E[min(间隔, 保持)]，用与模型相同的指数分布近似
+ */
+static float expectedOn(float meanMs, float holdMs) {
+    return meanMs * (1.0f - expf(-holdMs / meanMs));
+}
+
+void setUp() {
+    occupancyInit(&model, MOTION_TIMEOUT_MS);
+    randomState = 12345;
+}
+
+void tearDown() {
+}
+
+/**
+ * 样本不足时使用默认保持时间
+ */
+static void test_default_without_samples() {
+    TEST_ASSERT_EQUAL_UINT32(MOTION_TIMEOUT_MS, defaultHold(20));
+    TEST_ASSERT_EQUAL_UINT32(MOTION_TIMEOUT_MS, defaultHold(-1));
+    feedHour(20, BUSY_GAP_MS, OCCUPANCY_MIN_SAMPLES - 1);
+    TEST_ASSERT_EQUAL_UINT32(MOTION_TIMEOUT_MS, defaultHold(20));
+    TEST_ASSERT_EQUAL_UINT32(0, occupancyMedianGap(&model, 20));
+}
+
+/**
+ * 合成到达：繁忙时段延长保持，冷清时段保持默认值
+ */
+static void test_busy_extends_sparse_keeps_default() {
+    feedHour(20, BUSY_GAP_MS, 500);
+    feedHour(3, SPARSE_GAP_MS, 500);
+
+    uint32_t busy = defaultHold(20);
+    TEST_ASSERT_TRUE(busy > MOTION_TIMEOUT_MS);
+    TEST_ASSERT_TRUE(busy <= MOTION_HOLD_MAX_MS);
+    /* 能耗上限（留10%余量覆盖分位数估计误差） */
+    TEST_ASSERT_TRUE(expectedOn(BUSY_GAP_MS, (float) busy) <=
+                     1.1f * MOTION_ENERGY_CAP * expectedOn(BUSY_GAP_MS, (float) MOTION_TIMEOUT_MS));
+
+    TEST_ASSERT_EQUAL_UINT32(MOTION_TIMEOUT_MS, defaultHold(3));
+    TEST_ASSERT_TRUE(occupancyMedianGap(&model, 3) > occupancyMedianGap(&model, 20));
+
+    /* 能耗上限为1倍时不延长 */
+    TEST_ASSERT_EQUAL_UINT32(MOTION_TIMEOUT_MS,
+                             occupancyHoldTime(&model, 20, MOTION_HOLD_MIN_MS, MOTION_HOLD_MAX_MS, MOTION_TIMEOUT_MS,
+                                               MOTION_RAMP_COST_MS, 1.0f));
+}
+
+/**
+ * 繁忙街道：默认参数减少满亮升亮次数
+ */
+static void test_busy_street_fewer_ramps() {
+    replay_stats_t adaptive, fixed;
+    replayTrace("sim/traces/busy_street.csv", &adaptive, &fixed);
+    TEST_ASSERT_TRUE(adaptive.ramps * 4 <= fixed.ramps * 3);
+    TEST_ASSERT_TRUE(adaptive.flickers <= fixed.flickers);
+    TEST_ASSERT_TRUE(adaptive.onMs <= (uint64_t) (MOTION_ENERGY_CAP * (float) fixed.onMs));
+}
+
+/**
+ * 稀疏夜晚：升亮与闪烁都不增加
+ */
+static void test_night_no_extra_flicker() {
+    replay_stats_t adaptive, fixed;
+    replayTrace("sim/traces/night.csv", &adaptive, &fixed);
+    TEST_ASSERT_TRUE(adaptive.ramps <= fixed.ramps);
+    TEST_ASSERT_TRUE(adaptive.flickers <= fixed.flickers);
+    TEST_ASSERT_TRUE(adaptive.onMs >= fixed.onMs);      // 保持时间不短于固定值
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_without_samples);
+    RUN_TEST(test_busy_extends_sparse_keeps_default);
+    RUN_TEST(test_busy_street_fewer_ramps);
+    RUN_TEST(test_night_no_extra_flicker);
+    return UNITY_END();
+}
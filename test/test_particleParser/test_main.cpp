@@ -0,0 +1,354 @@
+/**
+ * @file test_main.cpp
+ * @brief 颗粒物帧解析模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 particleParser（pio test -e native_test）：
+ * - 模糊测试：20000段随机字节流（帧之间插入噪声、帧内插入/删除/翻转字节），检查不崩溃、未被破坏的帧都能解析出来、
+ *   多协议识别不会锁定错误的协议
+ * - 切分无关：整段输入与按随机长度切分输入的统计、样本与窗口完全相同
+ * - 字节守恒：有效帧数 × 帧长 + 丢弃字节数 + 窗口中的字节数 = 输入字节总数（每次输入后都成立）
+ * - 吞吐量：每个协议按64字节一段输入16MB干净数据，输出 MB/s
+ *
+ * @note
+ * 注意事项：
+ * - 随机数使用固定种子的 xorshift，每次运行的字节流相同，失败可以复现
+ * - 吞吐量下限（PARSER_MIN_MBPS）远低于普通PC的实际值，只用于发现退化到逐字节复制之类的问题；
+ *   9600波特率下串口每秒不到1KB
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "particleParser.h"
+
+#define FUZZ_STREAMS 20000              // 模糊测试的字节流数
+#define EQUIVALENCE_STREAMS 2000        // 切分测试的字节流数
+#define BENCH_BYTES (16u * 1024u * 1024u)   // 吞吐量测试的输入字节数
+#define BENCH_CHUNK 64                  // 吞吐量测试每次输入的字节数（与串口事件的数据块相当）
+#define PARSER_MIN_MBPS 20.0            // 吞吐量下限（MB/s）
+
+/* 固定种子的随机数 */
+static uint32_t rngState = 0x12345678;
+
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static uint32_t rngBelow(uint32_t limit) {
+    return rng() % limit;
+}
+
+/* ==================== 帧生成 ==================== */
+
+static void appendA5(std::vector<uint8_t> &out, uint16_t pm25) {
+    uint8_t high = (uint8_t) ((pm25 / 128) & 0x7F);
+    uint8_t low = (uint8_t) (pm25 % 128);
+    out.insert(out.end(), {0xA5, high, low, (uint8_t) ((0xA5 + high + low) & 0x7F)});
+}
+
+static void appendPms5003(std::vector<uint8_t> &out, uint16_t pm25) {
+    uint8_t frame[32] = {0x42, 0x4D, 0x00, 28};
+    for (size_t i = 4; i < 30; i++) {
+        frame[i] = (uint8_t) rng();
+    }
+    frame[12] = (uint8_t) (pm25 >> 8);
+    frame[13] = (uint8_t) pm25;
+    uint16_t sum = 0;
+    for (size_t i = 0; i < 30; i++) {
+        sum = (uint16_t) (sum + frame[i]);
+    }
+    frame[30] = (uint8_t) (sum >> 8);
+    frame[31] = (uint8_t) sum;
+    out.insert(out.end(), frame, frame + sizeof(frame));
+}
+
+static void appendSds011(std::vector<uint8_t> &out, uint16_t pm25) {
+    uint8_t frame[10] = {0xAA, 0xC0, (uint8_t) pm25, (uint8_t) (pm25 >> 8),
+                         (uint8_t) rng(), (uint8_t) rng(), (uint8_t) rng(), (uint8_t) rng(), 0, 0xAB};
+    uint8_t sum = 0;
+    for (size_t i = 2; i < 8; i++) {
+        sum = (uint8_t) (sum + frame[i]);
+    }
+    frame[8] = sum;
+    out.insert(out.end(), frame, frame + sizeof(frame));
+}
+
+static void appendFrame(std::vector<uint8_t> &out, uint8_t protocol, uint16_t pm25) {
+    switch (protocol) {
+        case PARTICLE_PROTOCOL_A5:
+            appendA5(out, pm25);
+            break;
+        case PARTICLE_PROTOCOL_PMS5003:
+            appendPms5003(out, pm25);
+            break;
+        default:
+            appendSds011(out, pm25);
+            break;
+    }
+}
+
+/* 噪声字节：不使用 0xA5，A5 帧内的数据与校验和都小于 0x80，这样噪声不会形成 A5 候选帧头 */
+static uint8_t noiseByte() {
+    uint8_t value = (uint8_t) rng();
+    return value == 0xA5 ? 0x5A : value;
+}
+
+/* 测试字节流 */
+typedef struct {
+    std::vector<uint8_t> bytes;
+    uint8_t protocol;
+    uint32_t intactFrames;              // 未被破坏的帧数
+    bool endsIntact;                    // 最后一帧未被破坏（其后没有噪声）
+    uint16_t lastPm25;                  // 最后一帧的 PM2.5 原始值
+} test_stream_t;
+
+/**
+ * 生成随机字节流：帧之间可能有噪声，约六分之一的帧被破坏（插入、删除或翻转一个字节）
+ */
+static void makeStream(test_stream_t *stream, uint8_t protocol, uint32_t frames) {
+    stream->bytes.clear();
+    stream->protocol = protocol;
+    stream->intactFrames = 0;
+    stream->endsIntact = false;
+    for (uint32_t i = rngBelow(6); i > 0; i--) {
+        stream->bytes.push_back(noiseByte());
+    }
+    for (uint32_t n = 0; n < frames; n++) {
+        uint16_t pm25 = (uint16_t) rngBelow(protocol == PARTICLE_PROTOCOL_A5 ? 16384 : 10000);
+        size_t start = stream->bytes.size();
+        appendFrame(stream->bytes, protocol, pm25);
+        size_t size = stream->bytes.size() - start;
+        bool intact = true;
+        switch (rngBelow(18)) {
+            case 0:     // 帧内插入一个字节
+                stream->bytes.insert(stream->bytes.begin() + (long) (start + 1 + rngBelow((uint32_t) size - 1)), noiseByte());
+                intact = false;
+                break;
+            case 1:     // 帧内删除一个字节
+                stream->bytes.erase(stream->bytes.begin() + (long) (start + 1 + rngBelow((uint32_t) size - 1)));
+                intact = false;
+                break;
+            case 2:     // 帧内翻转一个字节（不翻转帧头首字节，且不产生 0xA5）
+                stream->bytes[start + 1 + rngBelow((uint32_t) size - 1)] ^= (uint8_t) (1 + rngBelow(0x7F));
+                if (protocol == PARTICLE_PROTOCOL_A5) {
+                    for (size_t i = start + 1; i < stream->bytes.size(); i++) {
+                        stream->bytes[i] &= 0x7F;
+                    }
+                }
+                intact = false;
+                break;
+            default:
+                break;
+        }
+        if (intact) {
+            stream->intactFrames++;
+            stream->lastPm25 = pm25;
+        }
+        stream->endsIntact = intact;
+        if (rngBelow(8) == 0) {
+            for (uint32_t i = 1 + rngBelow(4); i > 0; i--) {
+                stream->bytes.push_back(noiseByte());
+            }
+            stream->endsIntact = false;
+        }
+    }
+}
+
+/* ==================== 检查 ==================== */
+
+template<typename Protocol>
+static void assertAccounting(const FrameParser<Protocol> &parser, size_t input) {
+    size_t accounted = parser.stats.goodFrames * Protocol::FRAME_SIZE + parser.stats.bytesDiscarded + parser.pending();
+    TEST_ASSERT_EQUAL_UINT32((uint32_t) input, (uint32_t) accounted);
+}
+
+/**
+ * 按随机长度（1~maxChunk 字节）切分输入，每次输入后检查字节守恒，返回解析出的帧数
+ */
+template<typename Protocol>
+static size_t feedChunked(FrameParser<Protocol> *parser, const std::vector<uint8_t> &bytes, uint32_t maxChunk) {
+    size_t frames = 0;
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        size_t chunk = 1 + rngBelow(maxChunk);
+        if (chunk > bytes.size() - offset) {
+            chunk = bytes.size() - offset;
+        }
+        frames += parser->feed(bytes.data() + offset, chunk);
+        offset += chunk;
+        assertAccounting(*parser, offset);
+    }
+    return frames;
+}
+
+static float expectedPm25(uint8_t protocol, uint16_t raw) {
+    return protocol == PARTICLE_PROTOCOL_SDS011 ? (float) raw / 10.0f : (float) raw;
+}
+
+/**
+ * 单协议解析器的模糊测试：守恒、未被破坏的帧全部解析出来、最后一帧解码正确
+ */
+template<typename Protocol>
+static void fuzzOne(const test_stream_t *stream) {
+    FrameParser<Protocol> parser;
+    parser.init();
+    size_t frames = feedChunked(&parser, stream->bytes, 48);
+    TEST_ASSERT_EQUAL_UINT32(parser.stats.goodFrames, (uint32_t) frames);
+    if (Protocol::PROTOCOL != stream->protocol) {
+        return;
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(stream->intactFrames, parser.stats.goodFrames);
+    if (stream->endsIntact) {
+        TEST_ASSERT_EQUAL_FLOAT(expectedPm25(stream->protocol, stream->lastPm25), parser.sample.pm25);
+    }
+}
+
+/* ==================== 测试用例 ==================== */
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+/**
+ * 模糊测试：三种协议的随机字节流同时交给三个单协议解析器与多协议解析器
+ */
+static void test_fuzz_streams() {
+    test_stream_t stream;
+    uint32_t wrongLocks = 0;
+    for (uint32_t i = 0; i < FUZZ_STREAMS; i++) {
+        uint8_t protocol = (uint8_t) (PARTICLE_PROTOCOL_A5 + i % 3);
+        makeStream(&stream, protocol, 1 + rngBelow(24));
+        fuzzOne<A5Protocol>(&stream);
+        fuzzOne<Pms5003Protocol>(&stream);
+        fuzzOne<Sds011Protocol>(&stream);
+
+        particle_parser_t parser;
+        particleParserInit(&parser);
+        size_t offset = 0;
+        while (offset < stream.bytes.size()) {
+            size_t chunk = 1 + rngBelow(32);
+            if (chunk > stream.bytes.size() - offset) {
+                chunk = stream.bytes.size() - offset;
+            }
+            particleParserFeed(&parser, stream.bytes.data() + offset, chunk, 0);
+            offset += chunk;
+        }
+        if (parser.protocol != PARTICLE_PROTOCOL_NONE && parser.protocol != protocol) {
+            wrongLocks++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, wrongLocks);
+}
+
+/**
+ * 切分无关：整段输入与随机切分输入的结果完全相同
+ */
+template<typename Protocol>
+static void equivalenceOne(uint8_t protocol) {
+    test_stream_t stream;
+    for (uint32_t i = 0; i < EQUIVALENCE_STREAMS; i++) {
+        makeStream(&stream, protocol, 1 + rngBelow(40));
+        /* 其他协议的字节也混进来，检查窗口中的重新搜索 */
+        if (rngBelow(4) == 0) {
+            appendFrame(stream.bytes, (uint8_t) (PARTICLE_PROTOCOL_A5 + rngBelow(3)), (uint16_t) rngBelow(1000));
+        }
+        FrameParser<Protocol> whole;
+        FrameParser<Protocol> chunked;
+        whole.init();
+        chunked.init();
+        size_t wholeFrames = whole.feed(stream.bytes.data(), stream.bytes.size());
+        assertAccounting(whole, stream.bytes.size());
+        size_t chunkedFrames = feedChunked(&chunked, stream.bytes, i % 2 == 0 ? 3 : 64);
+        TEST_ASSERT_EQUAL_UINT32((uint32_t) wholeFrames, (uint32_t) chunkedFrames);
+        TEST_ASSERT_EQUAL_MEMORY(&whole.stats, &chunked.stats, sizeof(particle_stats_t));
+        TEST_ASSERT_EQUAL_UINT32((uint32_t) whole.pending(), (uint32_t) chunked.pending());
+        TEST_ASSERT_EQUAL_UINT8(whole.streak, chunked.streak);
+        if (wholeFrames > 0) {
+            TEST_ASSERT_EQUAL_MEMORY(&whole.sample, &chunked.sample, sizeof(particle_sample_t));
+        }
+    }
+}
+
+static void test_chunked_equivalence() {
+    equivalenceOne<A5Protocol>(PARTICLE_PROTOCOL_A5);
+    equivalenceOne<Pms5003Protocol>(PARTICLE_PROTOCOL_PMS5003);
+    equivalenceOne<Sds011Protocol>(PARTICLE_PROTOCOL_SDS011);
+}
+
+/**
+ * 字节守恒：已知字节流逐字节输入，以及 reset() 丢弃窗口后
+ */
+static void test_byte_accounting() {
+    std::vector<uint8_t> bytes = {0x01, 0xA5};                  // 噪声 + 不完整的帧头
+    appendA5(bytes, 300);
+    bytes.insert(bytes.end(), {0xA5, 0x01, 0x02, 0x00});        // 校验和错误
+    appendA5(bytes, 1200);
+    bytes.insert(bytes.end(), {0xA5, 0x10});                    // 末尾不完整的帧
+
+    FrameParser<A5Protocol> parser;
+    parser.init();
+    for (size_t i = 0; i < bytes.size(); i++) {
+        parser.feed(&bytes[i], 1);
+        assertAccounting(parser, i + 1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, parser.stats.goodFrames);
+    TEST_ASSERT_EQUAL_UINT32(2, (uint32_t) parser.pending());
+    TEST_ASSERT_EQUAL_FLOAT(1200.0f, parser.sample.pm25);
+
+    parser.reset();                     // 输入不连续：窗口中的字节计入丢弃
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t) parser.pending());
+    assertAccounting(parser, bytes.size());
+}
+
+/**
+ * 吞吐量：干净数据按 BENCH_CHUNK 字节一段输入
+ */
+template<typename Protocol>
+static double benchmarkOne(uint8_t protocol) {
+    std::vector<uint8_t> bytes;
+    while (bytes.size() < BENCH_BYTES) {
+        appendFrame(bytes, protocol, (uint16_t) rngBelow(1000));
+    }
+    FrameParser<Protocol> parser;
+    parser.init();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < bytes.size(); offset += BENCH_CHUNK) {
+        size_t chunk = bytes.size() - offset < BENCH_CHUNK ? bytes.size() - offset : BENCH_CHUNK;
+        parser.feed(bytes.data() + offset, chunk);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    assertAccounting(parser, bytes.size());
+    TEST_ASSERT_EQUAL_UINT32(0, parser.stats.bytesDiscarded);
+
+    double mbps = (double) bytes.size() / (1024.0 * 1024.0) / seconds;
+    char message[80];
+    snprintf(message, sizeof(message), "%s: %.1f MB/s", particleProtocolName(protocol), mbps);
+    TEST_MESSAGE(message);
+    return mbps;
+}
+
+static void test_throughput() {
+    TEST_ASSERT_TRUE(benchmarkOne<A5Protocol>(PARTICLE_PROTOCOL_A5) > PARSER_MIN_MBPS);
+    TEST_ASSERT_TRUE(benchmarkOne<Pms5003Protocol>(PARTICLE_PROTOCOL_PMS5003) > PARSER_MIN_MBPS);
+    TEST_ASSERT_TRUE(benchmarkOne<Sds011Protocol>(PARTICLE_PROTOCOL_SDS011) > PARSER_MIN_MBPS);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fuzz_streams);
+    RUN_TEST(test_chunked_equivalence);
+    RUN_TEST(test_byte_accounting);
+    RUN_TEST(test_throughput);
+    return UNITY_END();
+}
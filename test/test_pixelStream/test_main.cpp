@@ -0,0 +1,249 @@
+/**
+ * @file test_main.cpp
+ * @brief UDP像素流接收模块主机测试（本地回环）
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 pixelStream（pio test -e native_test）：
+ * - 接收端绑定本地回环上的临时端口，测试中的发送端用UDP套接字向 127.0.0.1 发送DDP包
+ * - 偏移：多个包按偏移拼成一帧，带时间码的包头同样按偏移写入
+ * - 截断：超出像素缓冲区的数据被丢弃，缓冲区之后的保护字节不被改写；偏移在缓冲区外的包被接受但不写入
+ * - 丢弃：迟到、重复、查询、版本不符、目标不符与过短的包被读出丢弃，不影响其后的包
+ * - 超时：超过 PIXEL_STREAM_TIMEOUT_MS 没有数据时只报告一次超时，并重新开始序号判断
+ *
+ * @note
+ * 注意事项：
+ * - 端口号由系统分配（绑定端口0后用 getsockname 读取），不与本机上的DDP发送端或其他测试冲突
+ */
+
+#include <unity.h>
+#include <arpa/inet.h>
+#include <cstring>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "pixelStream.h"
+
+#define TEST_PIXELS 16                      // 测试像素缓冲区的像素数
+#define TEST_BUFFER_BYTES (TEST_PIXELS * 3) // 像素缓冲区字节数
+#define GUARD_BYTES 16                      // 缓冲区之后的保护字节数
+#define GUARD_VALUE 0xEE                    // 保护字节的值
+
+static pixel_stream_t stream;
+static int sender = -1;                     // 发送端套接字
+static struct sockaddr_in target = {};      // 接收端地址（127.0.0.1:临时端口）
+static uint8_t buffer[TEST_BUFFER_BYTES + GUARD_BYTES];
+
+/**
+ * 发送一个DDP包
+ */
+static void sendPacket(uint8_t flags, uint8_t sequence, uint8_t dataType, uint8_t id, uint32_t offset,
+                       const uint8_t *payload, uint16_t length) {
+    uint8_t packet[DDP_HEADER_LEN_TIMECODE + 512];
+    packet[0] = flags;
+    packet[1] = sequence;
+    packet[2] = dataType;
+    packet[3] = id;
+    packet[4] = (uint8_t) (offset >> 24);
+    packet[5] = (uint8_t) (offset >> 16);
+    packet[6] = (uint8_t) (offset >> 8);
+    packet[7] = (uint8_t) offset;
+    packet[8] = (uint8_t) (length >> 8);
+    packet[9] = (uint8_t) length;
+    size_t headerLen = DDP_HEADER_LEN;
+    if (flags & DDP_FLAGS_TIMECODE) {
+        memset(packet + DDP_HEADER_LEN, 0x77, DDP_HEADER_LEN_TIMECODE - DDP_HEADER_LEN);
+        headerLen = DDP_HEADER_LEN_TIMECODE;
+    }
+    memcpy(packet + headerLen, payload, length);
+    ssize_t sent = sendto(sender, packet, headerLen + length, 0, (struct sockaddr *) &target, sizeof(target));
+    TEST_ASSERT_EQUAL_INT((int) (headerLen + length), (int) sent);
+}
+
+/**
+ * 发送像素数据包（版本1、RGB 8位、默认输出设备）
+ */
+static void sendPixels(uint8_t flags, uint8_t sequence, uint32_t offset, const uint8_t *payload, uint16_t length) {
+    sendPacket((uint8_t) (DDP_FLAGS_VER1 | flags), sequence, DDP_TYPE_RGB8, DDP_ID_DISPLAY, offset, payload, length);
+}
+
+/**
+ * 接收一个包：peek 成功后读入像素缓冲区
+ * 返回值：PIXEL_STREAM_NONE 表示包被丢弃（或没有数据）
+ */
+static pixel_stream_result_t receive(uint32_t nowMs) {
+    ddp_header_t header;
+    if (!pixelStreamPeek(&stream, &header)) {
+        return PIXEL_STREAM_NONE;
+    }
+    return pixelStreamRead(&stream, &header, buffer, TEST_BUFFER_BYTES, nowMs);
+}
+
+/**
+ * 按位置生成的测试数据
+ */
+static void pattern(uint8_t *data, size_t length, uint8_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (uint8_t) (seed + i);
+    }
+}
+
+static void assertGuardIntact() {
+    for (size_t i = TEST_BUFFER_BYTES; i < sizeof(buffer); i++) {
+        TEST_ASSERT_EQUAL_UINT8(GUARD_VALUE, buffer[i]);
+    }
+}
+
+void setUp() {
+    TEST_ASSERT_TRUE(pixelStreamOpen(&stream, 0));
+    struct sockaddr_in bound = {};
+    socklen_t boundLen = sizeof(bound);
+    TEST_ASSERT_EQUAL_INT(0, getsockname(stream.fd, (struct sockaddr *) &bound, &boundLen));
+    target = {};
+    target.sin_family = AF_INET;
+    target.sin_port = bound.sin_port;
+    target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sender = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    TEST_ASSERT_TRUE(sender >= 0);
+    memset(buffer, 0, TEST_BUFFER_BYTES);
+    memset(buffer + TEST_BUFFER_BYTES, GUARD_VALUE, GUARD_BYTES);
+}
+
+void tearDown() {
+    if (sender >= 0) {
+        close(sender);
+        sender = -1;
+    }
+    pixelStreamClose(&stream);
+}
+
+/**
+ * 包头解析与序号比较（不经过套接字）
+ */
+static void test_header_and_sequence() {
+    const uint8_t packet[DDP_HEADER_LEN] = {DDP_FLAGS_VER1 | DDP_FLAGS_PUSH, 0x37, DDP_TYPE_RGB8_LEGACY, DDP_ID_DISPLAY,
+                                            0x00, 0x01, 0x02, 0x03, 0x01, 0x80};
+    ddp_header_t header;
+    TEST_ASSERT_TRUE(ddpParseHeader(packet, sizeof(packet), &header));
+    TEST_ASSERT_EQUAL_UINT8(7, header.sequence);            // 只取低4位
+    TEST_ASSERT_EQUAL_UINT32(0x00010203, header.offset);
+    TEST_ASSERT_EQUAL_UINT16(0x0180, header.length);
+    TEST_ASSERT_EQUAL_UINT8(DDP_HEADER_LEN, header.headerLen);
+    TEST_ASSERT_FALSE(ddpParseHeader(packet, DDP_HEADER_LEN - 1, &header));
+
+    TEST_ASSERT_FALSE(ddpSequenceIsLate(0, 5));             // 尚未收到过包
+    TEST_ASSERT_FALSE(ddpSequenceIsLate(5, 0));             // 发送端不使用序号
+    TEST_ASSERT_TRUE(ddpSequenceIsLate(5, 5));              // 重复
+    TEST_ASSERT_TRUE(ddpSequenceIsLate(5, 4));              // 迟到
+    TEST_ASSERT_TRUE(ddpSequenceIsLate(5, 13));             // 落后7个（跨过回绕）
+    TEST_ASSERT_FALSE(ddpSequenceIsLate(5, 12));            // 领先7个
+    TEST_ASSERT_FALSE(ddpSequenceIsLate(15, 1));            // 15 -> 1 回绕
+    TEST_ASSERT_TRUE(ddpSequenceIsLate(1, 15));
+}
+
+/**
+ * 偏移：三个包拼成一帧，最后一包带PUSH；带时间码的包头同样按偏移写入
+ */
+static void test_offsets_assemble_frame() {
+    uint8_t frame[TEST_BUFFER_BYTES];
+    pattern(frame, sizeof(frame), 1);
+    sendPixels(0, 1, 0, frame, 18);
+    sendPixels(DDP_FLAGS_TIMECODE, 2, 18, frame + 18, 15);
+    sendPixels(DDP_FLAGS_PUSH, 3, 33, frame + 33, 15);
+
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_DATA, receive(100));
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_DATA, receive(101));
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(102));
+    TEST_ASSERT_EQUAL_MEMORY(frame, buffer, TEST_BUFFER_BYTES);
+    assertGuardIntact();
+    TEST_ASSERT_EQUAL_UINT32(3, stream.packets);
+    TEST_ASSERT_EQUAL_UINT32(1, stream.frames);
+    TEST_ASSERT_EQUAL_UINT8(3, stream.lastSequence);
+    TEST_ASSERT_TRUE(stream.active);
+    TEST_ASSERT_EQUAL_UINT32(102, stream.lastPacketMs);
+}
+
+/**
+ * 截断：跨过缓冲区末尾的包只写入缓冲区内的部分；偏移在缓冲区外的包被接受但不写入
+ */
+static void test_end_of_buffer_clipping() {
+    uint8_t payload[60];
+    pattern(payload, sizeof(payload), 100);
+    sendPixels(0, 0, TEST_BUFFER_BYTES - 12, payload, sizeof(payload));
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_DATA, receive(10));
+    TEST_ASSERT_EQUAL_MEMORY(payload, buffer + TEST_BUFFER_BYTES - 12, 12);
+    for (size_t i = 0; i < TEST_BUFFER_BYTES - 12; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0, buffer[i]);
+    }
+    assertGuardIntact();
+
+    sendPixels(DDP_FLAGS_PUSH, 0, TEST_BUFFER_BYTES, payload, 30);     // 正好在缓冲区之后
+    sendPixels(DDP_FLAGS_PUSH, 0, 0x00FFFFF0, payload, 30);            // 远超缓冲区
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(11));
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(12));
+    assertGuardIntact();
+    TEST_ASSERT_EQUAL_UINT32(3, stream.packets);
+    TEST_ASSERT_EQUAL_UINT32(0, stream.invalid);
+}
+
+/**
+ * 丢弃：迟到、重复与不支持的包被读出丢弃，其后的包照常接收
+ */
+static void test_late_duplicate_and_unsupported_drops() {
+    uint8_t payload[6];
+    pattern(payload, sizeof(payload), 10);
+    sendPixels(0, 5, 0, payload, 6);                        // 接受
+    sendPixels(0, 5, 0, payload, 6);                        // 重复
+    sendPixels(0, 3, 0, payload, 6);                        // 迟到
+    sendPixels(DDP_FLAGS_QUERY, 6, 0, payload, 0);          // 查询包
+    sendPacket(0x80, 6, DDP_TYPE_RGB8, DDP_ID_DISPLAY, 0, payload, 6);      // 版本不符
+    sendPacket(DDP_FLAGS_VER1, 6, DDP_TYPE_RGB8, 2, 0, payload, 6);        // 其他输出设备
+    sendPacket(DDP_FLAGS_VER1, 6, 0x1B, DDP_ID_DISPLAY, 0, payload, 6);    // 不支持的数据类型
+    uint8_t runt[4] = {DDP_FLAGS_VER1, 6, DDP_TYPE_RGB8, DDP_ID_DISPLAY};
+    TEST_ASSERT_EQUAL_INT((int) sizeof(runt),
+                          (int) sendto(sender, runt, sizeof(runt), 0, (struct sockaddr *) &target, sizeof(target)));
+    pattern(payload, sizeof(payload), 200);
+    sendPixels(DDP_FLAGS_PUSH, 6, 0, payload, 6);           // 接受
+
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_DATA, receive(1));
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_NONE, receive(2));
+    }
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(3));
+    TEST_ASSERT_EQUAL_MEMORY(payload, buffer, sizeof(payload));     // 被丢弃的包没有写入缓冲区
+    TEST_ASSERT_EQUAL_UINT32(2, stream.late);
+    TEST_ASSERT_EQUAL_UINT32(5, stream.invalid);
+    TEST_ASSERT_EQUAL_UINT32(2, stream.packets);
+    TEST_ASSERT_EQUAL_UINT8(6, stream.lastSequence);
+}
+
+/**
+ * 超时：只报告一次，之后发送端可以从任意序号重新开始
+ */
+static void test_timeout_resets_sequence() {
+    uint8_t payload[3] = {1, 2, 3};
+    sendPixels(DDP_FLAGS_PUSH, 9, 0, payload, 3);
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(1000));
+    TEST_ASSERT_FALSE(pixelStreamTimedOut(&stream, 1000 + PIXEL_STREAM_TIMEOUT_MS - 1));
+    TEST_ASSERT_TRUE(pixelStreamTimedOut(&stream, 1000 + PIXEL_STREAM_TIMEOUT_MS));
+    TEST_ASSERT_FALSE(pixelStreamTimedOut(&stream, 1000 + PIXEL_STREAM_TIMEOUT_MS + 1));
+    TEST_ASSERT_FALSE(stream.active);
+
+    sendPixels(DDP_FLAGS_PUSH, 2, 0, payload, 3);           // 超时前会被当作迟到包
+    TEST_ASSERT_EQUAL_INT(PIXEL_STREAM_FRAME, receive(5000));
+    TEST_ASSERT_EQUAL_UINT32(0, stream.late);
+    TEST_ASSERT_TRUE(stream.active);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_header_and_sequence);
+    RUN_TEST(test_offsets_assemble_frame);
+    RUN_TEST(test_end_of_buffer_clipping);
+    RUN_TEST(test_late_duplicate_and_unsupported_drops);
+    RUN_TEST(test_timeout_resets_sequence);
+    return UNITY_END();
+}
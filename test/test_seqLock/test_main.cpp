@@ -0,0 +1,156 @@
+/**
+ * @file test_main.cpp
+ * @brief 顺序锁（seqlock）主机压力测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上对 SeqLock 做压力测试（pio test -e native_test）：
+ * - 一个写者线程连续发布至少 STRESS_WRITES 个值，直到每个读者都读取了 STRESS_MIN_READS 次；三个读者线程同时不停读取
+ * - 每个值的全部字段都由同一个计数派生，另带校验字段，读到的副本字段不一致即为撕裂读
+ * - 每个读者读到的计数只增不减，写者结束后读到的是最后一次写入的值
+ *
+ * @note
+ * 注意事项：
+ * - 多核主机上读写线程真正并行运行，与固件中采集任务（核心0）和其他核心上的读者的情况相同；
+ *   单核主机上写者定期让出CPU，读者在写入中途被调度时同样会遇到奇数序号
+ * - 载荷为32字节，大于一次原子访问的宽度，没有顺序锁时很容易读到一半新一半旧的副本
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include "seqLock.h"
+
+#define STRESS_WRITES 5000000u          // 写者发布的值的个数
+#define STRESS_READERS 3                // 读者线程数
+#define STRESS_MIN_READS 100000u        // 每个读者在写者结束前至少读取的次数
+#define STRESS_YIELD_WRITES 16384u      // 写者每写入这么多次让出一次CPU（单核主机上读者也能与写者交错）
+
+/* 测试载荷：全部字段由 counter 派生 */
+typedef struct {
+    uint32_t counter;
+    uint32_t words[6];
+    uint32_t check;                     // counter 与各字段的异或
+} payload_t;
+
+static payload_t makePayload(uint32_t counter) {
+    payload_t payload;
+    payload.counter = counter;
+    payload.check = counter;
+    for (uint32_t i = 0; i < 6; i++) {
+        payload.words[i] = counter * 2654435761u + i;
+        payload.check ^= payload.words[i];
+    }
+    return payload;
+}
+
+static bool payloadConsistent(const payload_t &payload) {
+    payload_t expected = makePayload(payload.counter);
+    return memcmp(&expected, &payload, sizeof(payload)) == 0;
+}
+
+/* 读者统计 */
+typedef struct {
+    std::atomic<uint64_t> reads;        // 读取次数（写者据此判断何时结束）
+    uint64_t torn;                      // 字段不一致的副本数
+    uint64_t backwards;                 // 计数比上一次读到的小的次数
+    uint64_t distinct;                  // 读到的不同值的个数
+} reader_stats_t;
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+/**
+ * 一个写者、多个读者并发
+ */
+static void test_concurrent_reads_are_never_torn() {
+    static SeqLock<payload_t> lock;
+    lock.write(makePayload(0));
+    std::atomic<bool> done{false};
+    static reader_stats_t stats[STRESS_READERS];
+    for (int r = 0; r < STRESS_READERS; r++) {
+        stats[r].reads.store(0);
+        stats[r].torn = 0;
+        stats[r].backwards = 0;
+        stats[r].distinct = 0;
+    }
+
+    std::thread readers[STRESS_READERS];
+    for (int r = 0; r < STRESS_READERS; r++) {
+        readers[r] = std::thread([&, r] {
+            reader_stats_t *s = &stats[r];
+            uint32_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                payload_t copy = lock.read();
+                s->reads.fetch_add(1, std::memory_order_relaxed);
+                if (!payloadConsistent(copy)) {
+                    s->torn++;
+                    continue;
+                }
+                if (copy.counter < last) {
+                    s->backwards++;
+                }
+                else if (copy.counter != last) {
+                    s->distinct++;
+                }
+                last = copy.counter;
+            }
+        });
+    }
+    uint32_t written = 0;
+    std::thread writer([&] {
+        bool readersDone = false;
+        while (written < STRESS_WRITES || !readersDone) {
+            lock.write(makePayload(++written));
+            if (written % STRESS_YIELD_WRITES != 0) {
+                continue;
+            }
+            std::this_thread::yield();
+            readersDone = true;
+            for (int r = 0; r < STRESS_READERS; r++) {
+                readersDone = readersDone && stats[r].reads.load(std::memory_order_relaxed) >= STRESS_MIN_READS;
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+    writer.join();
+    for (int r = 0; r < STRESS_READERS; r++) {
+        readers[r].join();
+    }
+
+    for (int r = 0; r < STRESS_READERS; r++) {
+        TEST_ASSERT_EQUAL_UINT32(0, (uint32_t) stats[r].torn);
+        TEST_ASSERT_EQUAL_UINT32(0, (uint32_t) stats[r].backwards);
+        TEST_ASSERT_TRUE(stats[r].reads.load() >= STRESS_MIN_READS);
+        TEST_ASSERT_TRUE(stats[r].distinct > 0);        // 读者与写者交错运行，读到了新值
+    }
+    payload_t final = lock.read();
+    TEST_ASSERT_EQUAL_UINT32(written, final.counter);
+    TEST_ASSERT_TRUE(payloadConsistent(final));
+}
+
+/**
+ * 没有写者时读取不重试，读到初始值与最后一次写入
+ */
+static void test_single_thread_round_trip() {
+    SeqLock<payload_t> lock;
+    payload_t initial = lock.read();
+    TEST_ASSERT_EQUAL_UINT32(0, initial.counter);
+    lock.write(makePayload(42));
+    TEST_ASSERT_EQUAL_UINT32(42, lock.read().counter);
+    TEST_ASSERT_TRUE(payloadConsistent(lock.read()));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_thread_round_trip);
+    RUN_TEST(test_concurrent_reads_are_never_torn);
+    return UNITY_END();
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_main.cpp
+ * @brief 太阳能收益统计模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 solarHarvest（pio test -e native_test）：
+ * - 跨小时：充电小时的收益等于 (电量净增量折算能量 + 负载能量) / 充电效率，净增量为负的小时按0计，不充电的小时为0
+ * - 跨日：每个本地零点恰好结束一天，记录覆盖1440分钟、不带标志；时间跳过若干天时新的一天标记为不完整
+ * - 对时：未对时期间只累计当天总量、不计入曲线，对时后当天记录标记为不完整，之后的小时正常计入曲线
+ * - 欠发判断：从最近一天往前数，不完整、电池充满与预报全阴的日子跳过，遇到达标的日子停止
+ *
+ * @note
+ * 注意事项：
+ * - 每10秒（SOLAR_MAX_STEP_MS）更新一次；每天8~16时充电，电量线性上升，16~24时放电回到起点
+ * - 跨过零点的那次更新使用前一天的预报系数，与固件中一天结束时的预报系数相同
+ */
+
+#include <unity.h>
+#include <cmath>
+#include "solarHarvest.h"
+#include "batterySoc.h"
+
+#define SIM_STEP_MS 10000u              // 更新周期（毫秒）
+#define SIM_DAY 20000u                  // 起始日期（自1970-01-01起的天数）
+#define SIM_START_MS (0xFFFFFFFFu - 3600000u)  // 起始时间（1小时后 millis() 回绕）
+#define SIM_BATTERY_MV 3700.0f          // 电池电压（与标称电压相同，便于核算）
+#define SIM_LOAD_MA 10.0f               // 充电期间的负载电流
+#define SIM_CHARGE_START_H 8            // 开始充电的小时
+#define SIM_CHARGE_END_H 16             // 结束充电的小时
+
+static const float mwhPerPercent = SOC_CAPACITY_MAH * SOLAR_BATTERY_NOMINAL_MV / 1000.0f / 100.0f;
+static const float loadMwhPerHour = SIM_LOAD_MA * SIM_BATTERY_MV / 1000.0f;
+
+static solar_harvest_t harvest;
+static uint32_t nowMs;
+
+/* 模拟的一天 */
+typedef struct {
+    float startSoc;                     // 零点时的电量
+    float gainPercent;                  // 充电期间的电量增量（可为负：负载大于太阳能输入）
+    float forecast;                     // 当天的预报系数
+} sim_day_t;
+
+/**
+ * 一天中某一时刻的电量
+ */
+static float socAt(const sim_day_t *day, uint32_t secondOfDay) {
+    const float chargeStart = SIM_CHARGE_START_H * 3600.0f;
+    const float chargeEnd = SIM_CHARGE_END_H * 3600.0f;
+    float t = (float) secondOfDay;
+    if (t <= chargeStart) {
+        return day->startSoc;
+    }
+    if (t <= chargeEnd) {
+        return day->startSoc + day->gainPercent * (t - chargeStart) / (chargeEnd - chargeStart);
+    }
+    return day->startSoc + day->gainPercent * (86400.0f - t) / (86400.0f - chargeEnd);
+}
+
+/**
+ * 一次更新
+ */
+static bool step(const sim_day_t *day, uint32_t localSeconds, uint32_t secondOfDay) {
+    uint32_t hour = secondOfDay / 3600 % 24;
+    bool charging = hour >= SIM_CHARGE_START_H && hour < SIM_CHARGE_END_H;
+    bool closed = solarHarvestUpdate(&harvest, nowMs, localSeconds, socAt(day, secondOfDay), SIM_BATTERY_MV,
+                                     charging ? SIM_LOAD_MA : 0.0f, charging, day->forecast);
+    nowMs += SIM_STEP_MS;
+    return closed;
+}
+
+/**
+ * 模拟一整天（从零点后的第一次更新到下一个零点），返回这一天结束的次数
+ */
+static uint32_t runDay(uint32_t dayIndex, const sim_day_t *day) {
+    uint32_t closed = 0;
+    for (uint32_t t = SIM_STEP_MS / 1000; t <= 86400; t += SIM_STEP_MS / 1000) {
+        closed += step(day, dayIndex * 86400 + t, t) ? 1 : 0;
+    }
+    return closed;
+}
+
+/**
+ * 从某天零点开始统计（启动日不完整）
+ */
+static void startAt(uint32_t dayIndex, const sim_day_t *day) {
+    solarHarvestInit(&harvest);
+    nowMs = SIM_START_MS;
+    step(day, dayIndex * 86400, 0);
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+/**
+ * 跨小时：收益曲线与当天总量
+ */
+static void test_hour_rollover() {
+    const sim_day_t sunny = {40.0f, 30.0f, 1.0f};
+    startAt(SIM_DAY, &sunny);
+    TEST_ASSERT_EQUAL_UINT32(1, runDay(SIM_DAY, &sunny));
+    const solar_day_t *day = solarHarvestDay(&harvest, 0);
+    TEST_ASSERT_NOT_NULL(day);
+
+    /* 充电中间的小时：(30% / 8小时 × 每%能量 + 负载) / 效率 */
+    float expectedHour = (sunny.gainPercent / 8.0f * mwhPerPercent + loadMwhPerHour) / SOLAR_CHARGER_EFFICIENCY;
+    for (uint8_t hour = SIM_CHARGE_START_H + 1; hour < SIM_CHARGE_END_H - 1; hour++) {
+        TEST_ASSERT_INT_WITHIN(1, (int) lroundf(expectedHour / SOLAR_HOUR_UNIT_MWH), day->hourly[hour]);
+    }
+    for (uint8_t hour = 0; hour + 1 < SIM_CHARGE_START_H; hour++) {
+        TEST_ASSERT_EQUAL_UINT16(0, day->hourly[hour]);
+    }
+    for (uint8_t hour = SIM_CHARGE_END_H; hour < 24; hour++) {
+        TEST_ASSERT_EQUAL_UINT16(0, day->hourly[hour]);
+    }
+    uint8_t peak = solarDayPeakHour(day);
+    TEST_ASSERT_TRUE(peak >= SIM_CHARGE_START_H && peak < SIM_CHARGE_END_H);
+
+    /* 当天总量：30%电量 + 8小时负载 */
+    float expectedCharge = sunny.gainPercent * mwhPerPercent;
+    float expectedSolar = (expectedCharge + 8.0f * loadMwhPerHour) / SOLAR_CHARGER_EFFICIENCY;
+    TEST_ASSERT_INT_WITHIN(8, (int) lroundf(expectedCharge), day->chargeMWh);
+    TEST_ASSERT_INT_WITHIN(8, (int) lroundf(expectedSolar), day->solarMWh);
+    TEST_ASSERT_EQUAL_UINT16((SIM_CHARGE_END_H - SIM_CHARGE_START_H) * 60, day->chargeMinutes);
+
+    /* 充电不足以覆盖负载：电量净增量按0计，收益只有负载能量 */
+    const sim_day_t overcast = {60.0f, -4.0f, 0.3f};
+    runDay(SIM_DAY + 1, &overcast);
+    day = solarHarvestDay(&harvest, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, day->chargeMWh);
+    TEST_ASSERT_INT_WITHIN(1, (int) lroundf(loadMwhPerHour / SOLAR_CHARGER_EFFICIENCY / SOLAR_HOUR_UNIT_MWH),
+                           day->hourly[12]);
+    TEST_ASSERT_EQUAL_UINT8(30, day->forecastPercent);
+}
+
+/**
+ * 跨日：每个零点结束一天，时间跳过若干天时新的一天不完整
+ */
+static void test_day_rollover() {
+    const sim_day_t sunny = {40.0f, 30.0f, 1.0f};
+    startAt(SIM_DAY, &sunny);
+    TEST_ASSERT_EQUAL_UINT32(1, runDay(SIM_DAY, &sunny));
+    TEST_ASSERT_EQUAL_UINT32(1, runDay(SIM_DAY + 1, &sunny));
+    TEST_ASSERT_EQUAL_UINT8(2, harvest.count);
+
+    const solar_day_t *first = solarHarvestDay(&harvest, 1);
+    const solar_day_t *second = solarHarvestDay(&harvest, 0);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY, first->day);
+    TEST_ASSERT_TRUE((first->flags & SOLAR_DAY_FLAG_PARTIAL) != 0);     // 启动日
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 1, second->day);
+    TEST_ASSERT_EQUAL_UINT8(0, second->flags);
+    TEST_ASSERT_EQUAL_UINT16(1440, second->coveredMinutes);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 2, harvest.today.day);
+    TEST_ASSERT_EQUAL_UINT8(0, harvest.today.flags);
+    TEST_ASSERT_NULL(solarHarvestDay(&harvest, 2));
+
+    /* 曲线之和与当天总量一致（每小时四舍五入到10mWh） */
+    uint32_t curve = 0;
+    for (uint8_t hour = 0; hour < 24; hour++) {
+        curve += second->hourly[hour] * SOLAR_HOUR_UNIT_MWH;
+    }
+    TEST_ASSERT_INT_WITHIN(24 * SOLAR_HOUR_UNIT_MWH / 2, (int) second->solarMWh, (int) curve);
+
+    /* 时间被向前修改了3天：结束当天，新的一天不完整 */
+    TEST_ASSERT_TRUE(step(&sunny, (SIM_DAY + 5) * 86400 + 600, 600));
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 2, solarHarvestDay(&harvest, 0)->day);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 5, harvest.today.day);
+    TEST_ASSERT_TRUE((harvest.today.flags & SOLAR_DAY_FLAG_PARTIAL) != 0);
+
+    /* 环形缓冲区只保留最近 SOLAR_HISTORY_DAYS 天 */
+    for (uint32_t d = SIM_DAY + 6; d < SIM_DAY + 6 + SOLAR_HISTORY_DAYS; d++) {
+        runDay(d, &sunny);
+    }
+    TEST_ASSERT_EQUAL_UINT8(SOLAR_HISTORY_DAYS, harvest.count);
+    for (uint8_t age = 0; age < SOLAR_HISTORY_DAYS; age++) {
+        TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 5 + SOLAR_HISTORY_DAYS - age, solarHarvestDay(&harvest, age)->day);
+    }
+}
+
+/**
+ * 未对时到对时
+ */
+static void test_unsynced_then_synced() {
+    const sim_day_t sunny = {40.0f, 30.0f, 1.0f};
+    solarHarvestInit(&harvest);
+    nowMs = SIM_START_MS;
+
+    /* 未对时：从10:00开始充电1小时（本地时间为0） */
+    const uint32_t syncSecond = 11 * 3600;
+    for (uint32_t t = 10 * 3600; t < syncSecond; t += SIM_STEP_MS / 1000) {
+        TEST_ASSERT_FALSE(step(&sunny, 0, t));
+    }
+    TEST_ASSERT_EQUAL_INT8(-1, harvest.hour);
+    TEST_ASSERT_EQUAL_UINT32(0, harvest.today.day);
+
+    /* 对时：未对时期间的能量并入当天总量，但不计入曲线 */
+    TEST_ASSERT_FALSE(step(&sunny, SIM_DAY * 86400 + syncSecond, syncSecond));
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY, harvest.today.day);
+    TEST_ASSERT_TRUE((harvest.today.flags & SOLAR_DAY_FLAG_PARTIAL) != 0);
+    TEST_ASSERT_EQUAL_INT8(11, harvest.hour);
+    float unsyncedSolar = (sunny.gainPercent / 8.0f * mwhPerPercent + loadMwhPerHour) / SOLAR_CHARGER_EFFICIENCY;
+    TEST_ASSERT_INT_WITHIN(3, (int) lroundf(unsyncedSolar), harvest.today.solarMWh);
+    for (uint8_t hour = 0; hour < 24; hour++) {
+        TEST_ASSERT_EQUAL_UINT16(0, harvest.today.hourly[hour]);
+    }
+
+    /* 之后的小时正常计入曲线，这一天结束时仍是不完整日 */
+    for (uint32_t t = syncSecond + SIM_STEP_MS / 1000; t <= 86400; t += SIM_STEP_MS / 1000) {
+        step(&sunny, SIM_DAY * 86400 + t, t);
+    }
+    const solar_day_t *day = solarHarvestDay(&harvest, 0);
+    TEST_ASSERT_NOT_NULL(day);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY, day->day);
+    TEST_ASSERT_TRUE((day->flags & SOLAR_DAY_FLAG_PARTIAL) != 0);
+    TEST_ASSERT_EQUAL_UINT16(0, day->hourly[10]);
+    TEST_ASSERT_TRUE(day->hourly[12] > 0);
+    TEST_ASSERT_TRUE(day->coveredMinutes < SOLAR_VALID_MINUTES);
+}
+
+/**
+ * 欠发判断：跳过不完整、充满与预报全阴的日子
+ */
+static void test_low_days_skip_rules() {
+    const sim_day_t good = {40.0f, 30.0f, 1.0f};        // 约4.5Wh
+    const sim_day_t low = {40.0f, 10.0f, 1.0f};         // 约1.8Wh
+    const sim_day_t saturated = {95.0f, 5.0f, 1.0f};    // 收益低，但电池充满（受负载限制）
+    const sim_day_t dark = {40.0f, 10.0f, 0.0f};        // 预报全阴
+    const sim_day_t *week[] = {&low, &good, &low, &saturated, &low, &dark, &low};   // 第一天是启动日（不完整）
+    startAt(SIM_DAY, week[0]);
+    for (uint32_t d = 0; d < 7; d++) {
+        runDay(SIM_DAY + d, week[d]);
+    }
+    TEST_ASSERT_TRUE((solarHarvestDay(&harvest, 3)->flags & SOLAR_DAY_FLAG_SATURATED) != 0);
+    TEST_ASSERT_EQUAL_UINT8(0, solarHarvestDay(&harvest, 1)->forecastPercent);
+
+    /* 期望5Wh，门限60%：达标3Wh */
+    solar_expectation_t expectation = {SOLAR_EXPECT_VERSION, 60, 3, 5};
+    TEST_ASSERT_TRUE(solarHarvestDay(&harvest, 5)->solarMWh >= 3000);
+    TEST_ASSERT_TRUE(solarHarvestDay(&harvest, 0)->solarMWh < 3000);
+    TEST_ASSERT_EQUAL_UINT8(3, solarHarvestLowDays(&harvest, &expectation));    // 第7、5、3天，遇到第2天停止
+
+    solar_report_t report;
+    solarHarvestReport(&harvest, &expectation, &report);
+    TEST_ASSERT_EQUAL_UINT8(3, report.lowDays);
+    TEST_ASSERT_TRUE(report.underperforming);
+    TEST_ASSERT_EQUAL_UINT32(SIM_DAY + 6, report.yesterday.day);
+    expectation.days = 4;
+    solarHarvestReport(&harvest, &expectation, &report);
+    TEST_ASSERT_FALSE(report.underperforming);
+
+    /* 期望降到2Wh（门限1.2Wh）：最近一天即达标 */
+    expectation.expectedWh = 2;
+    TEST_ASSERT_EQUAL_UINT8(0, solarHarvestLowDays(&harvest, &expectation));
+
+    /* 未设置或参数无效的期望不做判断 */
+    expectation = {0, 60, 3, 5};
+    TEST_ASSERT_EQUAL_UINT8(0, solarHarvestLowDays(&harvest, &expectation));
+    expectation = {SOLAR_EXPECT_VERSION, 0, 3, 5};
+    TEST_ASSERT_EQUAL_UINT8(0, solarHarvestLowDays(&harvest, &expectation));
+    TEST_ASSERT_EQUAL_UINT8(0, solarHarvestLowDays(&harvest, nullptr));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hour_rollover);
+    RUN_TEST(test_day_rollover);
+    RUN_TEST(test_unsynced_then_synced);
+    RUN_TEST(test_low_days_skip_rules);
+    return UNITY_END();
+}
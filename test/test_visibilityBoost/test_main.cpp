@@ -0,0 +1,264 @@
+/**
+ * @file test_main.cpp
+ * @brief 能见度补偿模块主机测试
+ * @author cepvor
+ * @version 1.0
+ * @date 2026/10/16
+ * @license MIT License
+ *
+ * @attention
+ * 本文件在主机上测试 visibilityBoost（pio test -e native_test）：
+ * - 记录轨迹回放：sim/traces/foggy_night.csv（起雾的一夜）每10秒更新一次，检查增益包络：
+ *   22:30 之前（含短时喷雾与重型车尾气）不补偿，起雾后在 23:30 之前开始补偿，雾中达到接近满额、不超过上限，
+ *   每次变化不超过限速；雾散后只剩PM2.5的轻度补偿，空气转好后回到1.0且只降不升
+ * - PM2.5失效：霾中PM2.5样本中断，VISIBILITY_STALE_UPDATES 次更新内保持，之后回到1.0；样本恢复后重新补偿
+ * - 湿度NaN：NaN 不进入滤波器，短时NaN不改变补偿，长时间NaN按没有湿度传感器处理
+ * - 严重程度：阈值两端、超出100%的湿度、负数与NaN输入
+ *
+ * @note
+ * 注意事项：
+ * - 轨迹文件按测试源文件所在位置查找，找不到时按项目根目录查找
+ * - 与模拟器相同，两次采样之间沿用最近一次的湿度与PM2.5
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "visibilityBoost.h"
+
+#define TRACE_NAME "sim/traces/foggy_night.csv"
+#define TRACE_START_HOUR 18                 // 轨迹从18:00开始
+#define GAIN_EPSILON 1e-4f                  // 浮点比较余量
+#define CLEAR_RH 60.0f                      // 空气转好后的湿度
+#define CLEAR_PM 20.0f                      // 空气转好后的PM2.5
+#define HAZE_PM 200.0f                      // 霾的PM2.5
+
+/* 轨迹中的一个天气采样 */
+typedef struct {
+    uint32_t timeMs;
+    float rh;
+    float pm25;
+} weather_sample_t;
+
+/* 回放得到的增益轨迹 */
+typedef struct {
+    uint32_t timeMs;
+    float gain;
+} gain_point_t;
+
+static visibility_boost_t boost;
+
+/**
+ * 轨迹时间（毫秒）-> 一天中的小时（可超过24）
+ */
+static float hourAt(uint32_t timeMs) {
+    return TRACE_START_HOUR + (float) timeMs / 3600000.0f;
+}
+
+/**
+ * 打开轨迹文件（先按本文件所在位置，再按项目根目录）
+ */
+static FILE *openTrace() {
+    std::string path = __FILE__;
+    size_t slash = path.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        FILE *file = fopen((path.substr(0, slash) + "/../../" TRACE_NAME).c_str(), "r");
+        if (file != nullptr) {
+            return file;
+        }
+    }
+    return fopen(TRACE_NAME, "r");
+}
+
+/**
+ * 读取轨迹中的天气采样，返回轨迹结束时间
+ */
+static uint32_t loadTrace(std::vector<weather_sample_t> *samples) {
+    FILE *file = openTrace();
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, "找不到 " TRACE_NAME);
+    uint32_t endMs = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        unsigned long timeMs;
+        char kind[16];
+        float rh, pm25;
+        int fields = sscanf(line, "%lu,%15[^,\n],%f,%f", &timeMs, kind, &rh, &pm25);
+        if (fields == 4 && strcmp(kind, "weather") == 0) {
+            samples->push_back({(uint32_t) timeMs, rh, pm25});
+        }
+        else if (fields >= 2 && strcmp(kind, "end") == 0) {
+            endMs = (uint32_t) timeMs;
+        }
+    }
+    fclose(file);
+    return endMs;
+}
+
+/**
+ * 以相同输入连续更新若干次，返回最后的增益
+ */
+static float hold(float rh, float pm25, uint32_t updates) {
+    float gain = boost.gain;
+    for (uint32_t i = 0; i < updates; i++) {
+        gain = visibilityBoostUpdate(&boost, rh, pm25);
+    }
+    return gain;
+}
+
+void setUp() {
+    visibilityBoostInit(&boost);
+}
+
+void tearDown() {
+}
+
+/**
+ * 记录轨迹回放：起雾的一夜
+ */
+static void test_foggy_night_trace_envelope() {
+    std::vector<weather_sample_t> samples;
+    uint32_t endMs = loadTrace(&samples);
+    TEST_ASSERT_TRUE(samples.size() > 600);
+    TEST_ASSERT_EQUAL_UINT32(12u * 3600000u, endMs);
+
+    std::vector<gain_point_t> trace;
+    float rh = -1.0f, pm25 = -1.0f;
+    size_t next = 0;
+    for (uint32_t t = 0; t <= endMs; t += VISIBILITY_UPDATE_MS) {
+        while (next < samples.size() && samples[next].timeMs <= t) {
+            rh = samples[next].rh;
+            pm25 = samples[next].pm25;
+            next++;
+        }
+        trace.push_back({t, visibilityBoostUpdate(&boost, rh, pm25)});
+    }
+
+    float previous = 1.0f, maxGain = 1.0f, maxStep = 0.0f;
+    uint32_t onsetMs = 0;
+    for (const gain_point_t &point : trace) {
+        TEST_ASSERT_TRUE(point.gain >= 1.0f && point.gain <= VISIBILITY_GAIN_MAX + GAIN_EPSILON);
+        maxStep = fmaxf(maxStep, fabsf(point.gain - previous));
+        maxGain = fmaxf(maxGain, point.gain);
+        if (onsetMs == 0 && point.gain > 1.0f) {
+            onsetMs = point.timeMs;
+        }
+        if (hourAt(point.timeMs) < 22.5f) {
+            TEST_ASSERT_EQUAL_FLOAT(1.0f, point.gain);      // 喷雾（19:30）与尾气（20:00）不引起补偿
+        }
+        previous = point.gain;
+    }
+    TEST_ASSERT_TRUE(maxStep <= VISIBILITY_GAIN_MAX_STEP + GAIN_EPSILON);
+    TEST_ASSERT_TRUE(hourAt(onsetMs) >= 22.5f && hourAt(onsetMs) < 23.5f);     // 起雾（23:30）之前已开始补偿
+    TEST_ASSERT_TRUE(maxGain >= VISIBILITY_GAIN_MAX - VISIBILITY_GAIN_QUANTUM);
+
+    /* 雾中（01:00~03:00）保持接近满额 */
+    for (const gain_point_t &point : trace) {
+        float hour = hourAt(point.timeMs);
+        if (hour >= 25.0f && hour < 27.0f) {
+            TEST_ASSERT_TRUE(point.gain >= VISIBILITY_GAIN_MAX - 2 * VISIBILITY_GAIN_QUANTUM);
+        }
+    }
+
+    /* 雾散后只剩PM2.5（约100μg/m³）的轻度补偿 */
+    float endGain = trace.back().gain;
+    float pmOnly = 1.0f + visibilitySeverity(-1.0f, boost.pmFiltered) * (VISIBILITY_GAIN_MAX - 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(VISIBILITY_GAIN_QUANTUM, pmOnly, endGain);
+    TEST_ASSERT_TRUE(endGain > 1.0f && endGain < 1.0f + 4 * VISIBILITY_GAIN_QUANTUM);
+
+    /* 空气转好：只降不升，1小时内回到1.0 */
+    previous = endGain;
+    for (uint32_t i = 0; i < 3600000u / VISIBILITY_UPDATE_MS; i++) {
+        float gain = visibilityBoostUpdate(&boost, CLEAR_RH, CLEAR_PM);
+        TEST_ASSERT_TRUE(gain <= previous);
+        previous = gain;
+    }
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, boost.gain);
+}
+
+/**
+ * 霾中PM2.5样本中断
+ */
+static void test_stale_pm_releases_boost() {
+    float boosted = hold(CLEAR_RH, HAZE_PM, 360);       // 霾1小时
+    TEST_ASSERT_TRUE(boosted >= 1.3f);
+
+    /* 样本中断：VISIBILITY_STALE_UPDATES 次更新内保持最后的滤波值 */
+    TEST_ASSERT_EQUAL_FLOAT(boosted, hold(CLEAR_RH, -1.0f, VISIBILITY_STALE_UPDATES - 1));
+    TEST_ASSERT_TRUE(boost.pmFiltered > 0.0f);
+    hold(CLEAR_RH, -1.0f, 1);
+    TEST_ASSERT_TRUE(boost.pmFiltered < 0.0f);          // 按没有PM2.5传感器处理
+
+    /* 经确认时间与限速回到1.0 */
+    uint32_t releaseUpdates = VISIBILITY_HOLD_UPDATES
+                              + (uint32_t) ceilf((boosted - 1.0f) / VISIBILITY_GAIN_MAX_STEP) + 1;
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, hold(CLEAR_RH, -1.0f, releaseUpdates));
+
+    /* 样本恢复：首个样本直接作为初值，确认后重新补偿 */
+    hold(CLEAR_RH, HAZE_PM, 1);
+    TEST_ASSERT_EQUAL_FLOAT(HAZE_PM, boost.pmFiltered);
+    TEST_ASSERT_TRUE(hold(CLEAR_RH, HAZE_PM, 360) >= 1.3f);
+
+    /* 偶尔缺一个样本（固件中两次更新之间没有新帧）不会累积到丢弃 */
+    for (uint32_t i = 0; i < 10 * VISIBILITY_STALE_UPDATES; i++) {
+        visibilityBoostUpdate(&boost, CLEAR_RH, i % 3 == 0 ? HAZE_PM : -1.0f);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(HAZE_PM, boost.pmFiltered);
+}
+
+/**
+ * 湿度为NaN（温湿度传感器读取失败）
+ */
+static void test_nan_humidity() {
+    /* 开机即为NaN：不补偿，滤波器保持未初始化 */
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, hold(NAN, -1.0f, 100));
+    TEST_ASSERT_TRUE(boost.rhFiltered < 0.0f);
+
+    /* 雾中短时NaN：滤波值不变，补偿不变 */
+    float fog = hold(99.0f, -1.0f, 360);
+    TEST_ASSERT_EQUAL_FLOAT(VISIBILITY_GAIN_MAX, fog);
+    float rhBefore = boost.rhFiltered;
+    TEST_ASSERT_EQUAL_FLOAT(fog, hold(NAN, -1.0f, 100));
+    TEST_ASSERT_EQUAL_FLOAT(rhBefore, boost.rhFiltered);
+    TEST_ASSERT_TRUE(std::isfinite(boost.rhFiltered));
+    hold(INFINITY, -1.0f, 10);
+    TEST_ASSERT_EQUAL_FLOAT(rhBefore, boost.rhFiltered);
+
+    /* 恢复正常读数后按滤波回落到1.0 */
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, hold(CLEAR_RH, -1.0f, 360));
+
+    /* 雾中湿度传感器失效：超过 VISIBILITY_STALE_UPDATES 后不再保持补偿 */
+    hold(99.0f, -1.0f, 360);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, hold(NAN, -1.0f, VISIBILITY_STALE_UPDATES + 360));
+    TEST_ASSERT_TRUE(boost.rhFiltered < 0.0f);
+}
+
+/**
+ * 严重程度的边界输入
+ */
+static void test_severity_edges() {
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, visibilitySeverity(VISIBILITY_RH_START, -1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(VISIBILITY_RH_FULL, -1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, visibilitySeverity((VISIBILITY_RH_START + VISIBILITY_RH_FULL) / 2.0f, -1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(120.0f, -1.0f));             // 超出100%的读数
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, visibilitySeverity(-1.0f, VISIBILITY_PM_START));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(-1.0f, VISIBILITY_PM_FULL));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(-1.0f, 2000.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, visibilitySeverity(-1.0f, -1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, visibilitySeverity(NAN, NAN));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(NAN, VISIBILITY_PM_FULL));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, visibilitySeverity(VISIBILITY_RH_FULL, NAN));
+    TEST_ASSERT_EQUAL_FLOAT(0.6f, visibilitySeverity(VISIBILITY_RH_START + 0.6f * (VISIBILITY_RH_FULL - VISIBILITY_RH_START),
+                                                     VISIBILITY_PM_START + 0.2f * (VISIBILITY_PM_FULL - VISIBILITY_PM_START)));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_foggy_night_trace_envelope);
+    RUN_TEST(test_stale_pm_releases_boost);
+    RUN_TEST(test_nan_humidity);
+    RUN_TEST(test_severity_edges);
+    return UNITY_END();
+}